@@ -87,6 +87,7 @@ main(int argc, char * argv[])
   dq->SetPhantomScale(scale);
   dq->SetOriginOffset(offset);
   dq->SetRotationMatrix(rot);
+  dq->SetSupersamplingFactor(args_info.supersampling_arg);
   dq->SetConfigFile(args_info.phantomfile_arg);
   dq->SetIsForbildConfigFile(args_info.forbild_flag);
   TRY_AND_EXIT_ON_ITK_EXCEPTION(dq->Update())
@@ -125,6 +125,11 @@ main(int argc, char * argv[])
   simplex->SetNumberOfIterations(args_info.niterations_arg);
   simplex->SetOptimizeWithRestarts(args_info.restarts_flag);
   simplex->SetIsSpectralCT(false);
+  simplex->SetUseLookupTable(args_info.lut_flag);
+  simplex->SetLookupTableNumberOfNodes(args_info.lutnodes_arg);
+  simplex->SetLookupTableMaximumLogTransform(args_info.lutmax_arg);
+  if (args_info.lutfile_given)
+    simplex->SetLookupTableFileName(args_info.lutfile_arg);
 
   TRY_AND_EXIT_ON_ITK_EXCEPTION(simplex->Update())
 
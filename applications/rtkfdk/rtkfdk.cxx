@@ -169,11 +169,19 @@ main(int argc, char * argv[])
     feldkamp = FDKCPUType::New();
     SET_FELDKAMP_OPTIONS(feldkamp);
 
+    // Displaced detector and short scan weights are applied with the FDK weights
+    feldkamp->SetInput(1, reader->GetOutput());
+    feldkamp->GetWeightFilter()->SetDisplacedDetectorFilter(ddf);
+    feldkamp->GetWeightFilter()->SetShortScanFilter(pssf);
+
     // Motion compensated CBCT settings
     if (args_info.signal_given && args_info.dvf_given)
     {
       dvfReader->SetFileName(args_info.dvf_arg);
       def->SetSignalFilename(args_info.signal_arg);
+      def->SetCacheMemoryBudget(static_cast<itk::SizeValueType>(args_info.dvfcache_arg) * 1024 * 1024);
+      def->SetPhaseTolerance(args_info.phasetol_arg);
+      def->SetCachePrecision(static_cast<rtk::ReducedPrecisionConverter::PrecisionType>(args_info.dvfprecision_arg));
       feldkamp->SetBackProjectionFilter(bp.GetPointer());
     }
     pfeldkamp = feldkamp->GetOutput();
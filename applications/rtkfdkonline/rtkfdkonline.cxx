@@ -0,0 +1,131 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "rtkfdkonline_ggo.h"
+#include "rtkGgoFunctions.h"
+#include "rtkConfiguration.h"
+
+#include "rtkThreeDCircularProjectionGeometryXMLFile.h"
+#include "rtkDisplacedDetectorForOffsetFieldOfViewImageFilter.h"
+#include "rtkParkerShortScanImageFilter.h"
+#include "rtkOnlineFDKConeBeamReconstruction.h"
+
+#include <itkImageFileWriter.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+int
+main(int argc, char * argv[])
+{
+  GGO(rtkfdkonline, args_info);
+
+  using OutputPixelType = float;
+  constexpr unsigned int Dimension = 3;
+  using OutputImageType = itk::Image<OutputPixelType, Dimension>;
+
+  // Projections reader, the file names are set file by file
+  using ReaderType = rtk::ProjectionsReader<OutputImageType>;
+  ReaderType::Pointer reader = ReaderType::New();
+  rtk::SetProjectionsReaderFromGgo<ReaderType, args_info_rtkfdkonline>(reader, args_info);
+
+  // Geometry
+  if (args_info.verbose_flag)
+    std::cout << "Reading geometry information from " << args_info.geometry_arg << "..." << std::endl;
+  rtk::ThreeDCircularProjectionGeometry::Pointer geometry;
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(geometry = rtk::ReadGeometry(args_info.geometry_arg));
+  const unsigned int nProj = geometry->GetGantryAngles().size();
+
+  // Create reconstructed image
+  using ConstantImageSourceType = rtk::ConstantImageSource<OutputImageType>;
+  ConstantImageSourceType::Pointer constantImageSource = ConstantImageSourceType::New();
+  rtk::SetConstantImageSourceFromGgo<ConstantImageSourceType, args_info_rtkfdkonline>(constantImageSource, args_info);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(constantImageSource->Update())
+
+  // Displaced detector and short scan weighting
+  using DDFType = rtk::DisplacedDetectorForOffsetFieldOfViewImageFilter<OutputImageType>;
+  DDFType::Pointer ddf = DDFType::New();
+  ddf->SetDisable(args_info.nodisplaced_flag);
+  using PSSFType = rtk::ParkerShortScanImageFilter<OutputImageType>;
+  PSSFType::Pointer pssf = PSSFType::New();
+  pssf->SetAngularGapThreshold(args_info.short_arg * itk::Math::pi / 180.);
+
+  // Online FDK reconstruction
+  using OnlineFDKType = rtk::OnlineFDKConeBeamReconstruction<OutputImageType>;
+  OnlineFDKType::Pointer feldkamp = OnlineFDKType::New();
+  feldkamp->SetGeometry(geometry);
+  feldkamp->GetWeightFilter()->SetDisplacedDetectorFilter(ddf);
+  feldkamp->GetWeightFilter()->SetShortScanFilter(pssf);
+  feldkamp->GetRampFilter()->SetTruncationCorrection(args_info.pad_arg);
+  feldkamp->GetRampFilter()->SetHannCutFrequency(args_info.hann_arg);
+  feldkamp->GetRampFilter()->SetHannCutFrequencyY(args_info.hannY_arg);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(feldkamp->SetVolume(constantImageSource->GetOutput()))
+
+  // Scan the directory until all projections of the geometry have been
+  // reconstructed. A file may contain several projections.
+  const auto   poll = std::chrono::duration<double>(args_info.poll_arg);
+  const auto   timeout = std::chrono::duration<double>(args_info.timeout_arg);
+  auto         lastFileTime = std::chrono::steady_clock::now();
+  unsigned int nFiles = 0;
+  while (feldkamp->GetNumberOfProjections() < nProj)
+  {
+    std::vector<std::string> fileNames;
+    TRY_AND_EXIT_ON_ITK_EXCEPTION(fileNames = rtk::GetProjectionsFileNamesFromGgo(args_info))
+    if (fileNames.size() <= nFiles)
+    {
+      if (std::chrono::steady_clock::now() - lastFileTime > timeout)
+      {
+        std::cerr << "No new projection file after " << args_info.timeout_arg << " s, "
+                  << feldkamp->GetNumberOfProjections() << " projection(s) out of " << nProj
+                  << " have been reconstructed." << std::endl;
+        break;
+      }
+      std::this_thread::sleep_for(poll);
+      continue;
+    }
+
+    for (; nFiles < fileNames.size() && feldkamp->GetNumberOfProjections() < nProj; nFiles++)
+    {
+      const unsigned int firstProjection = feldkamp->GetNumberOfProjections();
+      if (args_info.verbose_flag)
+        std::cout << "Reconstructing " << fileNames[nFiles] << " from projection #" << firstProjection << "..."
+                  << std::endl;
+      reader->SetFileNames(std::vector<std::string>(1, fileNames[nFiles]));
+      TRY_AND_EXIT_ON_ITK_EXCEPTION(reader->UpdateLargestPossibleRegion())
+      TRY_AND_EXIT_ON_ITK_EXCEPTION(feldkamp->AddProjections(reader->GetOutput(), firstProjection))
+
+      const unsigned int lastProjection = feldkamp->GetNumberOfProjections();
+      if (args_info.snapshot_arg > 0 &&
+          firstProjection / args_info.snapshot_arg != lastProjection / args_info.snapshot_arg)
+      {
+        if (args_info.verbose_flag)
+          std::cout << "Writing snapshot after " << lastProjection << " projections..." << std::endl;
+        TRY_AND_EXIT_ON_ITK_EXCEPTION(itk::WriteImage(feldkamp->GetSnapshot(), args_info.output_arg))
+      }
+    }
+    lastFileTime = std::chrono::steady_clock::now();
+  }
+
+  // Write
+  if (args_info.verbose_flag)
+    std::cout << "Writing... " << std::endl;
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(itk::WriteImage(feldkamp->GetSnapshot(), args_info.output_arg))
+
+  return EXIT_SUCCESS;
+}
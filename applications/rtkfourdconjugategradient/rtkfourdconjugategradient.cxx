@@ -118,6 +118,8 @@ main(int argc, char * argv[])
   conjugategradient->SetInputVolumeSeries(inputFilter->GetOutput());
   conjugategradient->SetNumberOfIterations(args_info.niterations_arg);
   conjugategradient->SetCudaConjugateGradient(args_info.cudacg_flag);
+  conjugategradient->SetStoragePrecision(
+    static_cast<rtk::ReducedPrecisionConverter::PrecisionType>(args_info.precision_arg));
   conjugategradient->SetDisableDisplacedDetectorFilter(args_info.nodisplaced_flag);
 
   // Set the newly ordered arguments
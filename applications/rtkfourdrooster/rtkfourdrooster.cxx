@@ -123,6 +123,7 @@ main(int argc, char * argv[])
   rooster->SetCudaConjugateGradient(args_info.cudacg_flag);
   rooster->SetUseCudaCyclicDeformation(args_info.cudadvfinterpolation_flag);
   rooster->SetDisableDisplacedDetectorFilter(args_info.nodisplaced_flag);
+  rooster->SetMemoryCap(static_cast<itk::SizeValueType>(args_info.memorycap_arg) * 1024 * 1024);
 
   REPORT_ITERATIONS(rooster, ROOSTERFilterType, VolumeSeriesType)
 
@@ -227,6 +228,11 @@ main(int argc, char * argv[])
     }
   }
 
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(rooster->UpdateOutputInformation())
+  if (args_info.verbose_flag)
+    std::cout << "Predicted memory peak of the internal pipeline: "
+              << rooster->GetMemoryPlanner()->GetPredictedPeak() / (1024 * 1024) << " MB" << std::endl;
+
   TRY_AND_EXIT_ON_ITK_EXCEPTION(rooster->Update())
 
   // Write
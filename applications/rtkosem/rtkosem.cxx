@@ -93,6 +93,7 @@ main(int argc, char * argv[])
   osem->SetInput(1, reader->GetOutput());
   if (args_info.attenuationmap_given)
     osem->SetInput(2, attenuationMap);
+  osem->SetAttenuationCacheMemoryBudget(static_cast<itk::SizeValueType>(args_info.attcache_arg) * 1024 * 1024);
   if (args_info.sigmazero_given)
     osem->SetSigmaZero(args_info.sigmazero_arg);
   if (args_info.alphapsf_given)
@@ -103,6 +104,16 @@ main(int argc, char * argv[])
 
   osem->SetNumberOfIterations(args_info.niterations_arg);
   osem->SetNumberOfProjectionsPerSubset(args_info.nprojpersubset_arg);
+  osem->SetFusedSubsets(args_info.fused_flag);
+  osem->SetMomentum(args_info.momentum_flag);
+  osem->SetMomentumRestart(static_cast<rtk::NesterovMomentum::RestartType>(args_info.restart_arg));
+  osem->SetMomentumPerSubset(args_info.subsetmomentum_flag);
+  if (args_info.sensitivitycache_given)
+  {
+    rtk::SensitivityImageCache::Pointer cache = rtk::SensitivityImageCache::New();
+    cache->SetDirectory(args_info.sensitivitycache_arg);
+    osem->SetSensitivityCache(cache);
+  }
 
   REPORT_ITERATIONS(osem, rtk::OSEMConeBeamReconstructionFilter<OutputImageType>, OutputImageType)
 
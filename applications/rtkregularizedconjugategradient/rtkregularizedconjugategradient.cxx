@@ -136,6 +136,7 @@ main(int argc, char * argv[])
   {
     regularizedConjugateGradient->SetGammaTV(args_info.gammatv_arg);
     regularizedConjugateGradient->SetTV_iterations(args_info.tviter_arg);
+    regularizedConjugateGradient->SetTVMomentum(args_info.tvmomentum_flag);
     regularizedConjugateGradient->SetPerformTVSpatialDenoising(true);
   }
   else
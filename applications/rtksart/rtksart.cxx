@@ -21,6 +21,7 @@
 
 #include "rtkThreeDCircularProjectionGeometryXMLFile.h"
 #include "rtkSARTConeBeamReconstructionFilter.h"
+#include "rtkMultiResolutionConeBeamReconstructionFilter.h"
 #include "rtkPhaseGatingImageFilter.h"
 #include "rtkIterationCommands.h"
 
@@ -122,12 +123,40 @@ main(int argc, char * argv[])
     sart->SetDivisionThreshold(args_info.divisionthreshold_arg);
   }
 
+  sart->SetMomentum(args_info.momentum_flag);
+  sart->SetMomentumRestart(static_cast<rtk::NesterovMomentum::RestartType>(args_info.restart_arg));
+  sart->SetMomentumPerSubset(args_info.subsetmomentum_flag);
+
+  if (args_info.sensitivitycache_given)
+  {
+    rtk::SensitivityImageCache::Pointer cache = rtk::SensitivityImageCache::New();
+    cache->SetDirectory(args_info.sensitivitycache_arg);
+    sart->SetSensitivityCache(cache);
+  }
+
   REPORT_ITERATIONS(sart, rtk::SARTConeBeamReconstructionFilter<OutputImageType>, OutputImageType)
 
-  TRY_AND_EXIT_ON_ITK_EXCEPTION(sart->Update())
+  // Coarse-to-fine reconstruction
+  using MultiResolutionType = rtk::MultiResolutionConeBeamReconstructionFilter<OutputImageType>;
+  MultiResolutionType::Pointer multiResolution = MultiResolutionType::New();
+  itk::ImageSource<OutputImageType>::Pointer reconstruction = sart.GetPointer();
+  if (args_info.shrinkfactors_given)
+  {
+    multiResolution->SetInput(sart->GetInput(0));
+    multiResolution->SetInput(1, sart->GetInput(1));
+    multiResolution->SetReconstructionFilter(sart);
+    std::vector<unsigned int> shrinkFactors(args_info.shrinkfactors_arg,
+                                            args_info.shrinkfactors_arg + args_info.shrinkfactors_given);
+    std::vector<unsigned int> levelIterations(args_info.leveliterations_arg,
+                                              args_info.leveliterations_arg + args_info.leveliterations_given);
+    multiResolution->SetSchedule(shrinkFactors, levelIterations);
+    reconstruction = multiResolution.GetPointer();
+  }
+
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(reconstruction->Update())
 
   // Write
-  TRY_AND_EXIT_ON_ITK_EXCEPTION(itk::WriteImage(sart->GetOutput(), args_info.output_arg))
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(itk::WriteImage(reconstruction->GetOutput(), args_info.output_arg))
 
   return EXIT_SUCCESS;
 }
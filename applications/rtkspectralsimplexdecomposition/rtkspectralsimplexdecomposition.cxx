@@ -123,6 +123,12 @@ main(int argc, char * argv[])
   simplex->SetOptimizeWithRestarts(args_info.restarts_flag);
   simplex->SetLogTransformEachBin(args_info.log_flag);
   simplex->SetIsSpectralCT(true);
+  simplex->SetUseLookupTable(args_info.lut_flag);
+  simplex->SetLookupTableNumberOfNodes(args_info.lutnodes_arg);
+  simplex->SetLookupTableMaximumLogTransform(args_info.lutmax_arg);
+  simplex->SetNumberOfNewtonIterations(args_info.newton_arg);
+  if (args_info.lutfile_given)
+    simplex->SetLookupTableFileName(args_info.lutfile_arg);
 
   // Note: The simplex filter is set to perform several searches for each pixel,
   // with different initializations, and keep the best one (SetOptimizeWithRestart(true)).
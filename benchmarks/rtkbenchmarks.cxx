@@ -0,0 +1,787 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "rtkConfiguration.h"
+#include "rtkMacro.h"
+#include "rtkConstantImageSource.h"
+#include "rtkDrawSheppLoganFilter.h"
+#include "rtkSheppLoganPhantomFilter.h"
+#include "rtkThreeDCircularProjectionGeometry.h"
+#include "rtkJosephForwardProjectionImageFilter.h"
+#include "rtkJosephBackProjectionImageFilter.h"
+#include "rtkZengForwardProjectionImageFilter.h"
+#include "rtkZengBackProjectionImageFilter.h"
+#include "rtkFDKBackProjectionImageFilter.h"
+#include "rtkFFTRampImageFilter.h"
+#include "rtkConjugateGradientConeBeamReconstructionFilter.h"
+#include "rtkTotalVariationDenoisingBPDQImageFilter.h"
+#include "rtkDeconstructSoftThresholdReconstructImageFilter.h"
+#include "rtkInterpolatorWithKnownWeightsImageFilter.h"
+#include "rtkSplatWithKnownWeightsImageFilter.h"
+#include "rtkProjectionsReader.h"
+
+#include <itkMultiThreaderBase.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * \file rtkbenchmarks.cxx
+ *
+ * \brief Performance suite of the projectors, filters and readers of RTK.
+ *
+ * Each benchmark builds its pipeline on synthetic data, a Shepp-Logan phantom
+ * drawn or projected with rtk::DrawSheppLoganFilter and
+ * rtk::SheppLoganPhantomFilter, for a size parameter n, i.e., n^3 volumes and
+ * n projections of n^2 pixels. The pipeline is run once to warm up, e.g., to
+ * plan the FFTs, then repeatedly, and the median time is reported for each
+ * size and each number of threads with the throughputs in voxels/s, rays/s and
+ * GB/s. Voxels/s counts voxel updates, e.g., the number of voxels times the
+ * number of projections for the projectors, rays/s counts projection pixels
+ * and GB/s counts the bytes of the images read and written by the pipeline.
+ *
+ * The command line options follow Google Benchmark:
+ *   --benchmark_filter=<regex>     Run the benchmarks whose name matches
+ *   --benchmark_repetitions=<n>    Number of timed runs, 5 by default
+ *   --benchmark_out=<file>         Write the results in a JSON file
+ *   --benchmark_list_tests         List the benchmarks and exit
+ *   --benchmark_sizes=<n1,n2,...>  Size parameters, 64,128 by default
+ *   --benchmark_threads=<t1,t2,..> Numbers of threads, 1 and all by default
+ *   --benchmark_tmpdir=<dir>       Directory of the synthetic raw files
+ *
+ * The JSON file has the layout of Google Benchmark outputs so that the results
+ * of two releases can be compared with the same tools.
+ */
+
+namespace
+{
+
+constexpr unsigned int Dimension = 3;
+using PixelType = float;
+using ImageType = itk::Image<PixelType, Dimension>;
+using VolumeSeriesType = itk::Image<PixelType, Dimension + 1>;
+using GradientImageType = itk::Image<itk::CovariantVector<PixelType, Dimension>, Dimension>;
+using GeometryType = rtk::ThreeDCircularProjectionGeometry;
+
+/** Parameters and measures of one benchmark for one size and one number of
+ * threads. The benchmark function sets the amount of work done by one run of
+ * its pipeline and passes the pipeline to Run. */
+struct BenchmarkState
+{
+  unsigned int        Size;
+  unsigned int        Threads;
+  unsigned int        Repetitions;
+  std::string         TemporaryDirectory;
+  double              VoxelsProcessed{ 0. };
+  double              RaysProcessed{ 0. };
+  double              BytesProcessed{ 0. };
+  std::vector<double> Times;
+
+  template <class TFunction>
+  void
+  Run(TFunction function)
+  {
+    function();
+    for (unsigned int i = 0; i < Repetitions; i++)
+    {
+      const auto start = std::chrono::steady_clock::now();
+      function();
+      Times.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+  }
+
+  double
+  GetMedianTime() const
+  {
+    std::vector<double> times(Times);
+    std::sort(times.begin(), times.end());
+    return (times.size() % 2) ? times[times.size() / 2]
+                              : 0.5 * (times[times.size() / 2 - 1] + times[times.size() / 2]);
+  }
+};
+
+using BenchmarkFunction = std::function<void(BenchmarkState &)>;
+
+struct Benchmark
+{
+  std::string       Name;
+  BenchmarkFunction Function;
+};
+
+//--------------------------------------------------------------------
+// Synthetic data
+
+template <class TImage>
+typename TImage::Pointer
+ConstantImage(const typename TImage::SizeType & size, double spacing, PixelType constant)
+{
+  typename TImage::PointType   origin;
+  typename TImage::SpacingType spacings;
+  for (unsigned int i = 0; i < TImage::ImageDimension; i++)
+  {
+    spacings[i] = spacing;
+    origin[i] = -0.5 * (size[i] - 1) * spacing;
+  }
+
+  using ConstantImageSourceType = rtk::ConstantImageSource<TImage>;
+  auto source = ConstantImageSourceType::New();
+  source->SetOrigin(origin);
+  source->SetSpacing(spacings);
+  source->SetSize(size);
+  source->SetConstant(constant);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(source->Update())
+  return source->GetOutput();
+}
+
+ImageType::SizeType
+CubeSize(unsigned int n)
+{
+  ImageType::SizeType size;
+  size.Fill(n);
+  return size;
+}
+
+/** Volume of n^3 voxels covering 256 mm. */
+ImageType::Pointer
+Volume(unsigned int n, bool sheppLogan)
+{
+  ImageType::Pointer volume = ConstantImage<ImageType>(CubeSize(n), 256. / n, 0.);
+  if (!sheppLogan)
+    return volume;
+
+  using DSLType = rtk::DrawSheppLoganFilter<ImageType, ImageType>;
+  auto dsl = DSLType::New();
+  dsl->SetInput(volume);
+  dsl->SetPhantomScale(128.);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(dsl->Update())
+  return dsl->GetOutput();
+}
+
+/** Full scan of n projections, cone-beam with a magnification of 1.5 or
+ * parallel if sdd is 0. */
+GeometryType::Pointer
+Geometry(unsigned int n, double sdd = 1500.)
+{
+  auto geometry = GeometryType::New();
+  for (unsigned int i = 0; i < n; i++)
+    geometry->AddProjection(1000., sdd, i * 360. / n);
+  return geometry;
+}
+
+/** n projections of n^2 pixels which cover the magnified volume, or the
+ * volume itself in parallel geometry. */
+ImageType::Pointer
+Projections(unsigned int n, const GeometryType * geometry, bool sheppLogan)
+{
+  const double       spacing = (geometry->GetSourceToDetectorDistances()[0] == 0.) ? 256. / n : 400. / n;
+  ImageType::Pointer projections = ConstantImage<ImageType>(CubeSize(n), spacing, 0.);
+  if (!sheppLogan)
+    return projections;
+
+  using SLPType = rtk::SheppLoganPhantomFilter<ImageType, ImageType>;
+  auto slp = SLPType::New();
+  slp->SetInput(projections);
+  slp->SetGeometry(geometry);
+  slp->SetPhantomScale(128.);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(slp->Update())
+  return slp->GetOutput();
+}
+
+double
+NumberOfBytes(const itk::ImageBase<Dimension + 1> * image)
+{
+  return image->GetBufferedRegion().GetNumberOfPixels() * sizeof(PixelType);
+}
+
+double
+NumberOfBytes(const itk::ImageBase<Dimension> * image)
+{
+  return image->GetBufferedRegion().GetNumberOfPixels() * sizeof(PixelType);
+}
+
+template <class TFilter>
+void
+RunFilter(BenchmarkState & state, TFilter * filter)
+{
+  state.Run([&]() {
+    filter->Modified();
+    TRY_AND_EXIT_ON_ITK_EXCEPTION(filter->Update())
+  });
+}
+
+//--------------------------------------------------------------------
+// Projectors
+
+template <class TForwardProjection>
+void
+ForwardProjection(BenchmarkState & state, double sdd)
+{
+  const unsigned int    n = state.Size;
+  GeometryType::Pointer geometry = Geometry(n, sdd);
+  ImageType::Pointer    volume = Volume(n, true);
+  ImageType::Pointer    projections = Projections(n, geometry, false);
+
+  auto fp = TForwardProjection::New();
+  fp->SetInput(0, projections);
+  fp->SetInput(1, volume);
+  fp->SetGeometry(geometry);
+  fp->InPlaceOff();
+
+  state.VoxelsProcessed = double(n) * n * n * n;
+  state.RaysProcessed = double(n) * n * n;
+  state.BytesProcessed = NumberOfBytes(volume) + 2. * NumberOfBytes(projections);
+  RunFilter(state, fp.GetPointer());
+}
+
+template <class TBackProjection>
+void
+BackProjection(BenchmarkState & state, double sdd)
+{
+  const unsigned int    n = state.Size;
+  GeometryType::Pointer geometry = Geometry(n, sdd);
+  ImageType::Pointer    volume = Volume(n, false);
+  ImageType::Pointer    projections = Projections(n, geometry, true);
+
+  auto bp = TBackProjection::New();
+  bp->SetInput(0, volume);
+  bp->SetInput(1, projections);
+  bp->SetGeometry(geometry);
+  bp->InPlaceOff();
+
+  state.VoxelsProcessed = double(n) * n * n * n;
+  state.RaysProcessed = double(n) * n * n;
+  state.BytesProcessed = 2. * NumberOfBytes(volume) + NumberOfBytes(projections);
+  RunFilter(state, bp.GetPointer());
+}
+
+void
+JosephForwardProjection(BenchmarkState & state)
+{
+  ForwardProjection<rtk::JosephForwardProjectionImageFilter<ImageType, ImageType>>(state, 1500.);
+}
+
+void
+JosephBackProjection(BenchmarkState & state)
+{
+  BackProjection<rtk::JosephBackProjectionImageFilter<ImageType, ImageType>>(state, 1500.);
+}
+
+void
+ZengForwardProjection(BenchmarkState & state)
+{
+  ForwardProjection<rtk::ZengForwardProjectionImageFilter<ImageType, ImageType>>(state, 0.);
+}
+
+void
+ZengBackProjection(BenchmarkState & state)
+{
+  BackProjection<rtk::ZengBackProjectionImageFilter<ImageType, ImageType>>(state, 0.);
+}
+
+void
+FDKBackProjection(BenchmarkState & state)
+{
+  BackProjection<rtk::FDKBackProjectionImageFilter<ImageType, ImageType>>(state, 1500.);
+}
+
+//--------------------------------------------------------------------
+// Filters
+
+void
+RampFilter(BenchmarkState & state)
+{
+  const unsigned int    n = state.Size;
+  GeometryType::Pointer geometry = Geometry(n);
+  ImageType::Pointer    projections = Projections(n, geometry, true);
+
+  using RampFilterType = rtk::FFTRampImageFilter<ImageType, ImageType, double>;
+  auto ramp = RampFilterType::New();
+  ramp->SetInput(projections);
+
+  state.VoxelsProcessed = double(n) * n * n;
+  state.RaysProcessed = double(n) * n * n;
+  state.BytesProcessed = 2. * NumberOfBytes(projections);
+  RunFilter(state, ramp.GetPointer());
+}
+
+void
+ConjugateGradient(BenchmarkState & state)
+{
+  constexpr unsigned int nIterations = 2;
+  const unsigned int     n = state.Size;
+  GeometryType::Pointer  geometry = Geometry(n);
+  ImageType::Pointer     volume = Volume(n, false);
+  ImageType::Pointer     projections = Projections(n, geometry, true);
+  ImageType::Pointer     weights = ConstantImage<ImageType>(CubeSize(n), 400. / n, 1.);
+
+  using ConjugateGradientType = rtk::ConjugateGradientConeBeamReconstructionFilter<ImageType>;
+  auto cg = ConjugateGradientType::New();
+  cg->SetInput(0, volume);
+  cg->SetInput(1, projections);
+  cg->SetInput(2, weights);
+  cg->SetGeometry(geometry);
+  cg->SetNumberOfIterations(nIterations);
+  cg->SetForwardProjectionFilter(ConjugateGradientType::FP_JOSEPH);
+  cg->SetBackProjectionFilter(ConjugateGradientType::BP_JOSEPH);
+
+  // One forward and one back projection per iteration
+  state.VoxelsProcessed = 2. * nIterations * n * n * n * n;
+  state.RaysProcessed = 2. * nIterations * n * n * n;
+  state.BytesProcessed = nIterations * (3. * NumberOfBytes(volume) + 4. * NumberOfBytes(projections));
+  RunFilter(state, cg.GetPointer());
+}
+
+void
+TotalVariationDenoising(BenchmarkState & state)
+{
+  constexpr unsigned int nIterations = 10;
+  const unsigned int     n = state.Size;
+  ImageType::Pointer     volume = Volume(n, true);
+
+  using TVDenoisingFilterType = rtk::TotalVariationDenoisingBPDQImageFilter<ImageType, GradientImageType>;
+  auto tv = TVDenoisingFilterType::New();
+  tv->SetInput(volume);
+  tv->SetNumberOfIterations(nIterations);
+  tv->SetGamma(0.3);
+
+  // Gradient and divergence of a vector image of Dimension components
+  state.VoxelsProcessed = double(nIterations) * n * n * n;
+  state.BytesProcessed = nIterations * (2. * Dimension + 2.) * NumberOfBytes(volume);
+  RunFilter(state, tv.GetPointer());
+}
+
+void
+WaveletsDenoising(BenchmarkState & state)
+{
+  const unsigned int n = state.Size;
+  ImageType::Pointer volume = Volume(n, true);
+
+  using WaveletsFilterType = rtk::DeconstructSoftThresholdReconstructImageFilter<ImageType>;
+  auto wavelets = WaveletsFilterType::New();
+  wavelets->SetInput(volume);
+  wavelets->SetNumberOfLevels(3);
+  wavelets->SetOrder(3);
+  wavelets->SetThreshold(0.01);
+
+  state.VoxelsProcessed = double(n) * n * n;
+  state.BytesProcessed = 2. * NumberOfBytes(volume);
+  RunFilter(state, wavelets.GetPointer());
+}
+
+//--------------------------------------------------------------------
+// 4D
+
+/** Each projection is interpolated between two consecutive frames. */
+itk::Array2D<float>
+InterpolationWeights(unsigned int nFrames, unsigned int nProjections)
+{
+  itk::Array2D<float> weights(nFrames, nProjections);
+  weights.Fill(0.);
+  for (unsigned int p = 0; p < nProjections; p++)
+  {
+    weights[p % nFrames][p] = 0.5;
+    weights[(p + 1) % nFrames][p] = 0.5;
+  }
+  return weights;
+}
+
+constexpr unsigned int NumberOfFrames = 8;
+
+VolumeSeriesType::Pointer
+VolumeSeries(unsigned int n, PixelType constant)
+{
+  VolumeSeriesType::SizeType size;
+  size.Fill(n);
+  size[Dimension] = NumberOfFrames;
+  return ConstantImage<VolumeSeriesType>(size, 256. / n, constant);
+}
+
+void
+Interpolate(BenchmarkState & state)
+{
+  const unsigned int        n = state.Size;
+  ImageType::Pointer        volume = Volume(n, false);
+  VolumeSeriesType::Pointer volumeSeries = VolumeSeries(n, 1.);
+
+  using InterpolateFilterType = rtk::InterpolatorWithKnownWeightsImageFilter<ImageType, VolumeSeriesType>;
+  auto interp = InterpolateFilterType::New();
+  interp->SetInputVolume(volume);
+  interp->SetInputVolumeSeries(volumeSeries);
+  interp->SetWeights(InterpolationWeights(NumberOfFrames, n));
+  interp->SetProjectionNumber(0);
+  interp->InPlaceOff();
+
+  state.VoxelsProcessed = double(NumberOfFrames) * n * n * n;
+  state.BytesProcessed = NumberOfBytes(volumeSeries) + 2. * NumberOfBytes(volume);
+  RunFilter(state, interp.GetPointer());
+}
+
+void
+Splat(BenchmarkState & state)
+{
+  const unsigned int        n = state.Size;
+  ImageType::Pointer        volume = Volume(n, true);
+  VolumeSeriesType::Pointer volumeSeries = VolumeSeries(n, 0.);
+
+  using SplatFilterType = rtk::SplatWithKnownWeightsImageFilter<VolumeSeriesType, ImageType>;
+  auto splat = SplatFilterType::New();
+  splat->SetInputVolumeSeries(volumeSeries);
+  splat->SetInputVolume(volume);
+  splat->SetWeights(InterpolationWeights(NumberOfFrames, n));
+  splat->SetProjectionNumber(0);
+  splat->InPlaceOff();
+
+  state.VoxelsProcessed = double(NumberOfFrames) * n * n * n;
+  state.BytesProcessed = 2. * NumberOfBytes(volumeSeries) + NumberOfBytes(volume);
+  RunFilter(state, splat.GetPointer());
+}
+
+//--------------------------------------------------------------------
+// Readers of raw projection files. The files are written with the minimal
+// headers of each format and read with rtk::ProjectionsReader. They are
+// likely in the page cache of the system so the benchmarks measure the
+// decoding and the conversion of the raw data rather than the disk.
+
+template <class T>
+void
+WriteValue(std::ofstream & file, T value)
+{
+  file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <class T>
+void
+WriteValueAt(std::vector<char> & header, size_t offset, T value)
+{
+  std::copy_n(reinterpret_cast<const char *>(&value), sizeof(T), header.begin() + offset);
+}
+
+/** Heimann His: a 68-byte header followed by the uint16 pixels. */
+void
+WriteHis(const std::string & fileName, unsigned int n)
+{
+  std::vector<char> header(68, 0);
+  WriteValueAt<uint16_t>(header, 0, 0x7000);
+  WriteValueAt<uint16_t>(header, 2, 0x0044);
+  WriteValueAt<uint16_t>(header, 16, n - 1); // brx
+  WriteValueAt<uint16_t>(header, 18, n - 1); // bry
+  WriteValueAt<uint16_t>(header, 20, 1);     // number of frames
+  header[32] = 4;                            // uint16 pixels
+
+  std::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary);
+  file.write(header.data(), header.size());
+  for (unsigned int i = 0; i < n * n; i++)
+    WriteValue<uint16_t>(file, 1000 + i % 1000);
+}
+
+/** Writes the pixels compressed as in Varian Hnd and Xim files, i.e., the
+ * first row and one pixel in uint32 then the differences of the other pixels
+ * with their prediction, all encoded on 1 byte. */
+void
+WriteVarianCompressedPixels(std::ofstream & file, unsigned int n)
+{
+  for (unsigned int i = 0; i < n + 1; i++)
+    WriteValue<uint32_t>(file, 1000 + i);
+  for (unsigned int i = 0; i < n * (n - 1); i++)
+    WriteValue<int8_t>(file, static_cast<int>(i % 3) - 1);
+}
+
+/** Varian Hnd: a 1024-byte header then the lookup table of the compression
+ * with all differences on 1 byte. */
+void
+WriteHnd(const std::string & fileName, unsigned int n)
+{
+  std::vector<char> header(1024, 0);
+  WriteValueAt<uint32_t>(header, 120, n);      // SizeX
+  WriteValueAt<uint32_t>(header, 124, n);      // SizeY
+  WriteValueAt<double>(header, 352, 400. / n); // dIDUResolutionX
+  WriteValueAt<double>(header, 360, 400. / n); // dIDUResolutionY
+
+  std::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary);
+  file.write(header.data(), header.size());
+  file.write(std::vector<char>(n * (n - 1) / 4, 0).data(), n * (n - 1) / 4);
+  WriteVarianCompressedPixels(file, n);
+}
+
+/** Varian Xim: same compression as Hnd with the pixel spacing in the
+ * properties which follow the pixels. */
+void
+WriteXim(const std::string & fileName, unsigned int n)
+{
+  std::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary);
+  file.write("PACKED_I", 8);
+  WriteValue<int32_t>(file, 1); // version
+  WriteValue<int32_t>(file, n);
+  WriteValue<int32_t>(file, n);
+  WriteValue<int32_t>(file, 32); // bits per pixel
+  WriteValue<int32_t>(file, 4);  // bytes per pixel
+  WriteValue<int32_t>(file, 1);  // compressed
+  WriteValue<int32_t>(file, n * (n - 1) / 4);
+  file.write(std::vector<char>(n * (n - 1) / 4, 0).data(), n * (n - 1) / 4);
+  WriteValue<int32_t>(file, (n + 1) * 4 + n * (n - 1));
+  WriteVarianCompressedPixels(file, n);
+  WriteValue<int32_t>(file, n * n * 4); // uncompressed size
+  WriteValue<int32_t>(file, 0);         // bins of the histogram
+  WriteValue<int32_t>(file, 2);         // properties
+  for (const std::string name : { "PixelWidth", "PixelHeight" })
+  {
+    WriteValue<int32_t>(file, name.size());
+    file.write(name.c_str(), name.size());
+    WriteValue<int32_t>(file, 1); // double
+    WriteValue<double>(file, 40. / n);
+  }
+}
+
+template <void (*TWriter)(const std::string &, unsigned int)>
+void
+Reader(BenchmarkState & state, const std::string & extension)
+{
+  constexpr unsigned int   nFiles = 16;
+  const unsigned int       n = state.Size;
+  std::vector<std::string> fileNames;
+  double                   bytes = 0.;
+  for (unsigned int i = 0; i < nFiles; i++)
+  {
+    std::ostringstream fileName;
+    fileName << state.TemporaryDirectory << "/rtkbenchmark" << std::setw(3) << std::setfill('0') << i << '.'
+             << extension;
+    fileNames.push_back(fileName.str());
+    TWriter(fileNames.back(), n);
+    std::ifstream file(fileNames.back().c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+    bytes += file.tellg();
+  }
+
+  // A new reader is created for each run to read the headers too
+  state.VoxelsProcessed = double(nFiles) * n * n;
+  state.RaysProcessed = double(nFiles) * n * n;
+  state.BytesProcessed = bytes + nFiles * n * n * sizeof(PixelType);
+  state.Run([&]() {
+    using ReaderType = rtk::ProjectionsReader<ImageType>;
+    auto reader = ReaderType::New();
+    reader->SetFileNames(fileNames);
+    TRY_AND_EXIT_ON_ITK_EXCEPTION(reader->Update())
+  });
+
+  for (const std::string & fileName : fileNames)
+    std::remove(fileName.c_str());
+}
+
+void
+HisReader(BenchmarkState & state)
+{
+  Reader<WriteHis>(state, "his");
+}
+
+void
+HndReader(BenchmarkState & state)
+{
+  Reader<WriteHnd>(state, "hnd");
+}
+
+void
+XimReader(BenchmarkState & state)
+{
+  Reader<WriteXim>(state, "xim");
+}
+
+//--------------------------------------------------------------------
+// Command line and outputs
+
+std::vector<Benchmark>
+GetBenchmarks()
+{
+  return { { "JosephForwardProjection", JosephForwardProjection },
+           { "JosephBackProjection", JosephBackProjection },
+           { "ZengForwardProjection", ZengForwardProjection },
+           { "ZengBackProjection", ZengBackProjection },
+           { "FDKBackProjection", FDKBackProjection },
+           { "RampFilter", RampFilter },
+           { "ConjugateGradient", ConjugateGradient },
+           { "TotalVariationDenoising", TotalVariationDenoising },
+           { "WaveletsDenoising", WaveletsDenoising },
+           { "Interpolate", Interpolate },
+           { "Splat", Splat },
+           { "HisReader", HisReader },
+           { "HndReader", HndReader },
+           { "XimReader", XimReader } };
+}
+
+std::vector<unsigned int>
+ParseList(const std::string & list)
+{
+  std::vector<unsigned int> values;
+  std::istringstream        stream(list);
+  std::string               value;
+  while (std::getline(stream, value, ','))
+    values.push_back(std::stoul(value));
+  return values;
+}
+
+std::string
+GetDate()
+{
+  const std::time_t now = std::time(nullptr);
+  char              date[32];
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+  return date;
+}
+
+void
+WriteJSON(std::ostream & os, const std::vector<std::pair<std::string, BenchmarkState>> & results)
+{
+  os << "{\n  \"context\": {\n";
+  os << "    \"date\": \"" << GetDate() << "\",\n";
+  os << "    \"executable\": \"rtkBenchmarks\",\n";
+  os << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+  os << "    \"library_version\": \"" << RTK_VERSION_MAJOR << '.' << RTK_VERSION_MINOR << '.' << RTK_VERSION_PATCH
+     << "\",\n";
+#ifdef NDEBUG
+  os << "    \"library_build_type\": \"release\"\n";
+#else
+  os << "    \"library_build_type\": \"debug\"\n";
+#endif
+  os << "  },\n  \"benchmarks\": [";
+  for (size_t i = 0; i < results.size(); i++)
+  {
+    const std::string &    name = results[i].first;
+    const BenchmarkState & state = results[i].second;
+    const double           time = state.GetMedianTime();
+    os << (i ? ",\n" : "\n") << "    {\n";
+    os << "      \"name\": \"" << name << "\",\n";
+    os << "      \"run_name\": \"" << name << "\",\n";
+    os << "      \"run_type\": \"aggregate\",\n";
+    os << "      \"aggregate_name\": \"median\",\n";
+    os << "      \"repetitions\": " << state.Repetitions << ",\n";
+    os << "      \"threads\": " << state.Threads << ",\n";
+    os << "      \"size\": " << state.Size << ",\n";
+    os << "      \"iterations\": 1,\n";
+    os << "      \"real_time\": " << time * 1e3 << ",\n";
+    os << "      \"min_time\": " << *std::min_element(state.Times.begin(), state.Times.end()) * 1e3 << ",\n";
+    os << "      \"max_time\": " << *std::max_element(state.Times.begin(), state.Times.end()) * 1e3 << ",\n";
+    os << "      \"time_unit\": \"ms\",\n";
+    os << "      \"voxels_per_second\": " << state.VoxelsProcessed / time << ",\n";
+    os << "      \"rays_per_second\": " << state.RaysProcessed / time << ",\n";
+    os << "      \"bytes_per_second\": " << state.BytesProcessed / time << "\n";
+    os << "    }";
+  }
+  os << "\n  ]\n}\n";
+}
+
+} // namespace
+
+int
+main(int argc, char * argv[])
+{
+  std::string               filter = ".*";
+  std::string               outputFileName;
+  std::string               temporaryDirectory = ".";
+  unsigned int              repetitions = 5;
+  bool                      list = false;
+  std::vector<unsigned int> sizes = { 64, 128 };
+  std::vector<unsigned int> threads = { 1 };
+  if (itk::MultiThreaderBase::GetGlobalDefaultNumberOfThreads() > 1)
+    threads.push_back(itk::MultiThreaderBase::GetGlobalDefaultNumberOfThreads());
+
+  for (int i = 1; i < argc; i++)
+  {
+    const std::string arg(argv[i]);
+    const std::string value = arg.substr(arg.find('=') + 1);
+    if (arg.find("--benchmark_filter=") == 0)
+      filter = value;
+    else if (arg.find("--benchmark_repetitions=") == 0)
+      repetitions = std::max(1ul, std::stoul(value));
+    else if (arg.find("--benchmark_out=") == 0)
+      outputFileName = value;
+    else if (arg == "--benchmark_list_tests")
+      list = true;
+    else if (arg.find("--benchmark_sizes=") == 0)
+      sizes = ParseList(value);
+    else if (arg.find("--benchmark_threads=") == 0)
+      threads = ParseList(value);
+    else if (arg.find("--benchmark_tmpdir=") == 0)
+      temporaryDirectory = value;
+    else
+    {
+      std::cerr << "Usage: " << argv[0]
+                << " [--benchmark_filter=<regex>] [--benchmark_repetitions=<n>] [--benchmark_out=<file>]"
+                << " [--benchmark_list_tests] [--benchmark_sizes=<n1,n2,...>] [--benchmark_threads=<t1,t2,...>]"
+                << " [--benchmark_tmpdir=<dir>]" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  const std::regex                                    regex(filter);
+  std::vector<std::pair<std::string, BenchmarkState>> results;
+  std::cout << std::left << std::setw(48) << "Benchmark" << std::right << std::setw(12) << "Time (ms)"
+            << std::setw(14) << "Gvoxels/s" << std::setw(12) << "Mrays/s" << std::setw(10) << "GB/s" << std::endl;
+  for (const Benchmark & benchmark : GetBenchmarks())
+  {
+    if (!std::regex_search(benchmark.Name, regex))
+      continue;
+    if (list)
+    {
+      std::cout << benchmark.Name << std::endl;
+      continue;
+    }
+    for (unsigned int size : sizes)
+    {
+      for (unsigned int nThreads : threads)
+      {
+        // The filters take their number of work units from the global default
+        // when they are created by the benchmark function
+        itk::MultiThreaderBase::SetGlobalDefaultNumberOfThreads(nThreads);
+        BenchmarkState state{ size, nThreads, repetitions, temporaryDirectory };
+        benchmark.Function(state);
+
+        std::ostringstream name;
+        name << benchmark.Name << '/' << size << "/threads:" << nThreads;
+        const double time = state.GetMedianTime();
+        std::cout << std::left << std::setw(48) << name.str() << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(12) << time * 1e3 << std::setw(14) << state.VoxelsProcessed / time * 1e-9
+                  << std::setw(12) << state.RaysProcessed / time * 1e-6 << std::setw(10)
+                  << state.BytesProcessed / time * 1e-9 << std::endl;
+        results.emplace_back(name.str(), state);
+      }
+    }
+  }
+
+  if (!outputFileName.empty())
+  {
+    std::ofstream file(outputFileName.c_str());
+    WriteJSON(file, results);
+    if (file.fail())
+    {
+      std::cerr << "Could not write " << outputFileName << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
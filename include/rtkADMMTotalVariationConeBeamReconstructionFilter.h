@@ -193,6 +193,11 @@ public:
 
   itkSetMacro(AL_iterations, float);
   itkGetMacro(AL_iterations, float);
+  void
+  SetNumberOfOuterIterations(unsigned int n) override
+  {
+    this->SetAL_iterations(n);
+  }
 
   itkSetMacro(CG_iterations, float);
   itkGetMacro(CG_iterations, float);
@@ -51,6 +51,7 @@ ADMMTotalVariationConeBeamReconstructionFilter<TOutputImage,
   m_DivergenceFilter = ImageDivergenceFilterType::New();
   m_ConjugateGradientFilter = ConjugateGradientFilterType::New();
   m_SoftThresholdFilter = SoftThresholdTVFilterType::New();
+  this->WatchTelemetrySection(m_SoftThresholdFilter, IterationTelemetry::REGULARIZATION);
   m_CGOperator = CGOperatorFilterType::New();
   m_ConjugateGradientFilter->SetA(m_CGOperator.GetPointer());
   m_DisplacedDetectorFilter = DisplacedDetectorFilterType::New();
@@ -92,6 +93,10 @@ ADMMTotalVariationConeBeamReconstructionFilter<TOutputImage,
   m_SoftThresholdFilter->ReleaseDataFlagOff(); // Output is g_k+1
   m_SubtractFilter2->ReleaseDataFlagOff();     // Output is d_k+1
   m_DisplacedDetectorFilter->ReleaseDataFlagOn();
+
+  // Image types of the internal pipeline
+  this->m_MemoryPlanner->template RegisterImageType<TOutputImage>();
+  this->m_MemoryPlanner->template RegisterImageType<TGradientOutputImage>();
 }
 
 template <typename TOutputImage, typename TGradientOutputImage>
@@ -202,6 +207,19 @@ ADMMTotalVariationConeBeamReconstructionFilter<TOutputImage, TGradientOutputImag
   // Have the last filter calculate its output information
   m_SubtractFilter2->UpdateOutputInformation();
 
+  // Plan the buffers of the internal pipeline. f_k+1 and g_k+1 are plugged
+  // back as inputs, the back projection does not change with the iterations
+  // and the conjugate gradient stores three volumes while it iterates.
+  this->m_MemoryPlanner->Initialize();
+  this->m_MemoryPlanner->SetMemoryCap(this->m_MemoryCap);
+  this->m_MemoryPlanner->AddOutput(m_SubtractFilter2->GetOutput());
+  this->m_MemoryPlanner->AddRetainedData(m_ConjugateGradientFilter->GetOutput());
+  this->m_MemoryPlanner->AddRetainedData(m_SoftThresholdFilter->GetOutput());
+  this->m_MemoryPlanner->AddRetainedData(m_BackProjectionFilter->GetOutput());
+  this->m_MemoryPlanner->AddTransientMemory(m_ConjugateGradientFilter,
+                                            3 * this->m_MemoryPlanner->GetBytes(this->GetInput(0)));
+  this->m_MemoryPlanner->Plan(this);
+
   // Copy it as the output information of the composite filter
   this->GetOutput()->CopyInformation(m_SubtractFilter2->GetOutput());
 }
@@ -238,6 +256,8 @@ ADMMTotalVariationConeBeamReconstructionFilter<TOutputImage, TGradientOutputImag
     m_SubtractFilter2->Update();
     this->GraftOutput(m_ConjugateGradientFilter->GetOutput());
     iterationReporter.CompletedStep();
+    if (this->GetTelemetryStopRequested())
+      break;
   }
 }
 
@@ -39,6 +39,7 @@ ADMMWaveletsConeBeamReconstructionFilter<TOutputImage>::ADMMWaveletsConeBeamReco
   m_AddFilter2 = AddFilterType::New();
   m_ConjugateGradientFilter = ConjugateGradientFilterType::New();
   m_SoftThresholdFilter = SoftThresholdFilterType::New();
+  this->WatchTelemetrySection(m_SoftThresholdFilter, IterationTelemetry::REGULARIZATION);
   m_CGOperator = CGOperatorFilterType::New();
   m_ConjugateGradientFilter->SetA(m_CGOperator.GetPointer());
   m_DisplacedDetectorFilter = DisplacedDetectorFilterType::New();
@@ -190,6 +191,8 @@ ADMMWaveletsConeBeamReconstructionFilter<TOutputImage>::GenerateData()
     m_SubtractFilter2->Update();
     this->GraftOutput(m_ConjugateGradientFilter->GetOutput());
     iterationReporter.CompletedStep();
+    if (this->GetTelemetryStopRequested())
+      break;
   }
 }
 
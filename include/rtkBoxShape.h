@@ -77,6 +77,10 @@ public:
                      double &           nearDist,
                      double &           farDist) const override;
 
+  /** See rtk::ConvexShape::ComputeBoundingBox. */
+  void
+  ComputeBoundingBox(PointType & bbMin, PointType & bbMax) const override;
+
   /** Rescale object along each direction by a 3D vector. */
   void
   Rescale(const VectorType & r) override;
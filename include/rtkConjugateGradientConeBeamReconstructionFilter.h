@@ -182,6 +182,11 @@ public:
 
   itkSetMacro(NumberOfIterations, int);
   itkGetMacro(NumberOfIterations, int);
+  void
+  SetNumberOfOuterIterations(unsigned int n) override
+  {
+    this->SetNumberOfIterations(n);
+  }
 
   itkSetMacro(IterationCosts, bool);
   itkGetMacro(IterationCosts, bool);
@@ -268,6 +273,13 @@ protected:
   void
   ReportProgress(itk::Object *, const itk::EventObject &);
 
+  /** Norm of the residual of the normal equations, b - Ax. */
+  double
+  GetTelemetryResidualNorm() override
+  {
+    return m_ConjugateGradientFilter->GetResidualNorm();
+  }
+
 private:
   ThreeDCircularProjectionGeometry::ConstPointer m_Geometry;
 
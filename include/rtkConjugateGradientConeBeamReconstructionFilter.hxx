@@ -322,6 +322,8 @@ ConjugateGradientConeBeamReconstructionFilter<TOutputImage, TSingleComponentImag
   {
     this->GraftOutput(cgCaller->GetOutput());
     m_IterationReporter.CompletedStep();
+    if (this->GetTelemetryStopRequested())
+      cgCaller->StopIterations();
   }
 }
 
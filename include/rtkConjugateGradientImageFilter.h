@@ -24,6 +24,7 @@
 #include <itkTimeProbe.h>
 
 #include "rtkSumOfSquaresImageFilter.h"
+#include "rtkReducedPrecisionConverter.h"
 
 #include "rtkConjugateGradientGetR_kPlusOneImageFilter.h"
 #include "rtkConjugateGradientGetX_kPlusOneImageFilter.h"
@@ -39,6 +40,13 @@ namespace rtk
  * ConjugateGradientImageFilter implements the algorithm described
  * in http://en.wikipedia.org/wiki/Conjugate_gradient_method
  *
+ * The residual Rk can be stored in float16 or bfloat16 with
+ * SetStoragePrecision to halve its memory footprint and bandwidth. It is
+ * widened to float in the computations. The conjugate direction Pk is kept in
+ * full precision since it is the input of the operator A.
+ *
+ * \test rtkconjugategradienttest.cxx
+ *
  * \ingroup RTK
  */
 
@@ -56,6 +64,7 @@ public:
   using ConjugateGradientOperatorType = ConjugateGradientOperator<OutputImageType>;
   using ConjugateGradientOperatorPointerType = typename ConjugateGradientOperatorType::Pointer;
   using OutputImagePointer = typename OutputImageType::Pointer;
+  using StoragePrecisionType = ReducedPrecisionConverter::PrecisionType;
 
   /** Method for creation through the object factory. */
   itkNewMacro(Self);
@@ -71,6 +80,11 @@ public:
   itkGetMacro(IterationCosts, bool);
   itkSetMacro(IterationCosts, bool);
 
+  /** Get / Set the precision of the storage of the residual, FLOAT32
+   * (default), FLOAT16 or BFLOAT16. */
+  itkGetMacro(StoragePrecision, StoragePrecisionType);
+  itkSetMacro(StoragePrecision, StoragePrecisionType);
+
   void
   SetA(ConjugateGradientOperatorPointerType _arg);
 
@@ -92,6 +106,17 @@ public:
   const std::vector<double> &
   GetResidualCosts();
 
+  /** Norm of the residual B - AX after the last iteration. */
+  itkGetConstMacro(ResidualNorm, double);
+
+  /** Stops the iterations at the end of the current one, e.g., from an
+   * observer of the IterationEvent. */
+  void
+  StopIterations()
+  {
+    m_StopIterations = true;
+  }
+
 protected:
   ConjugateGradientImageFilter();
   ~ConjugateGradientImageFilter() override = default;
@@ -111,12 +136,21 @@ protected:
   void
   GenerateOutputInformation() override;
 
+  /** Runs the iterations with the residual stored in an image of type
+   * TResidualImage through converter. */
+  template <class TResidualImage, class TConverter>
+  void
+  Iterate(const TConverter & converter);
+
   ConjugateGradientOperatorPointerType m_A;
 
-  int                 m_NumberOfIterations;
-  bool                m_IterationCosts;
-  std::vector<double> m_ResidualCosts;
-  double              m_C;
+  int                  m_NumberOfIterations;
+  bool                 m_IterationCosts;
+  std::vector<double>  m_ResidualCosts;
+  double               m_C;
+  double               m_ResidualNorm{ 0. };
+  bool                 m_StopIterations{ false };
+  StoragePrecisionType m_StoragePrecision{ ReducedPrecisionConverter::FLOAT32 };
 };
 } // namespace rtk
 
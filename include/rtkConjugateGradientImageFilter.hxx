@@ -22,6 +22,8 @@
 #include <itkMultiThreaderBase.h>
 #include <mutex>
 #include <itkIterationReporter.h>
+#include <algorithm>
+#include <cmath>
 
 namespace rtk
 {
@@ -130,13 +132,61 @@ ConjugateGradientImageFilter<OutputImageType>::GenerateOutputInformation()
 template <typename OutputImageType>
 void
 ConjugateGradientImageFilter<OutputImageType>::GenerateData()
+{
+  // In rtkConjugateGradientConeBeamReconstructionFilter, B is not updated
+  // So at this point, it is only an empty shell. Let's update it
+  this->GetB()->Update();
+  m_A->Update();
+
+  if (m_StoragePrecision == ReducedPrecisionConverter::FLOAT32)
+  {
+    this->template Iterate<OutputImageType>(FullPrecisionConverter());
+    return;
+  }
+
+  // The scale of float16 is set from the initial residual B - AX, the
+  // residual then decreases along the iterations
+  using PixelType = typename OutputImageType::PixelType;
+  double                          maximum = 0.;
+  std::mutex                      accumulationLock;
+  itk::MultiThreaderBase::Pointer mt = itk::MultiThreaderBase::New();
+  mt->template ParallelizeImageRegion<OutputImageType::ImageDimension>(
+    this->GetOutput()->GetLargestPossibleRegion(),
+    [this, &maximum, &accumulationLock](const typename OutputImageType::RegionType & outputRegionForThread) {
+      itk::ImageRegionConstIterator<OutputImageType> itB(this->GetB(), outputRegionForThread);
+      itk::ImageRegionConstIterator<OutputImageType> itA_out(this->m_A->GetOutput(), outputRegionForThread);
+      double                                         currentThreadMaximum = 0.;
+      while (!itB.IsAtEnd())
+      {
+        const PixelType r = itB.Get() - itA_out.Get();
+        currentThreadMaximum = std::max(currentThreadMaximum, ReducedPrecisionConverter::GetMaximumAbsoluteValue(r));
+        ++itB;
+        ++itA_out;
+      }
+
+      std::lock_guard<std::mutex> mutexHolder(accumulationLock);
+      maximum = std::max(maximum, currentThreadMaximum);
+    },
+    nullptr);
+
+  using StorageImageType =
+    itk::Image<typename ReducedPrecisionPixelTraits<PixelType>::StorageType, OutputImageType::ImageDimension>;
+  const float scale = ReducedPrecisionConverter::ComputeScale(m_StoragePrecision, maximum);
+  this->template Iterate<StorageImageType>(ReducedPrecisionConverter(m_StoragePrecision, scale));
+}
+
+template <typename OutputImageType>
+template <class TResidualImage, class TConverter>
+void
+ConjugateGradientImageFilter<OutputImageType>::Iterate(const TConverter & converter)
 {
   typename OutputImageType::RegionType largest = this->GetOutput()->GetLargestPossibleRegion();
   using DataType = typename itk::PixelTraits<typename OutputImageType::PixelType>::ValueType;
+  using PixelType = typename OutputImageType::PixelType;
 
   // Create and allocate images
   typename OutputImageType::Pointer Pk = OutputImageType::New();
-  typename OutputImageType::Pointer Rk = OutputImageType::New();
+  typename TResidualImage::Pointer  Rk = TResidualImage::New();
   Pk->SetRegions(largest);
   Rk->SetRegions(largest);
   this->GetOutput()->SetRegions(largest);
@@ -146,11 +196,6 @@ ConjugateGradientImageFilter<OutputImageType>::GenerateData()
   Pk->CopyInformation(this->GetOutput());
   Rk->CopyInformation(this->GetOutput());
 
-  // In rtkConjugateGradientConeBeamReconstructionFilter, B is not updated
-  // So at this point, it is only an empty shell. Let's update it
-  this->GetB()->Update();
-  m_A->Update();
-
   // Declare intermediate variables
   DataType numerator, denominator, alpha, beta;
   DataType eps = itk::NumericTraits<DataType>::min();
@@ -162,17 +207,18 @@ ConjugateGradientImageFilter<OutputImageType>::GenerateData()
   // Compute Xk+1
   mt->template ParallelizeImageRegion<OutputImageType::ImageDimension>(
     largest,
-    [this, Pk, Rk](const typename OutputImageType::RegionType & outputRegionForThread) {
+    [this, Pk, Rk, &converter](const typename OutputImageType::RegionType & outputRegionForThread) {
       itk::ImageRegionIterator<OutputImageType> itP(Pk, outputRegionForThread);
-      itk::ImageRegionIterator<OutputImageType> itR(Rk, outputRegionForThread);
+      itk::ImageRegionIterator<TResidualImage>  itR(Rk, outputRegionForThread);
       itk::ImageRegionIterator<OutputImageType> itB(this->GetB(), outputRegionForThread);
       itk::ImageRegionIterator<OutputImageType> itA_out(this->m_A->GetOutput(), outputRegionForThread);
       itk::ImageRegionIterator<OutputImageType> itIn(this->GetX(), outputRegionForThread);
       itk::ImageRegionIterator<OutputImageType> itX(this->GetOutput(), outputRegionForThread);
       while (!itP.IsAtEnd())
       {
-        itR.Set(itB.Get() - itA_out.Get());
-        itP.Set(itR.Get());
+        const PixelType r = itB.Get() - itA_out.Get();
+        itR.Set(converter.Encode(r));
+        itP.Set(r);
         itX.Set(itIn.Get());
         ++itP;
         ++itR;
@@ -185,8 +231,8 @@ ConjugateGradientImageFilter<OutputImageType>::GenerateData()
     nullptr);
 
   itk::IterationReporter iterationReporter(this, 0, 1);
-  bool                   stopIterations = false;
-  for (int iter = 0; (iter < m_NumberOfIterations) && !stopIterations; iter++)
+  m_StopIterations = false;
+  for (int iter = 0; (iter < m_NumberOfIterations) && !m_StopIterations; iter++)
   {
     // Compute A * Pk
     m_A->SetX(Pk);
@@ -197,16 +243,17 @@ ConjugateGradientImageFilter<OutputImageType>::GenerateData()
     denominator = 0;
     mt->template ParallelizeImageRegion<OutputImageType::ImageDimension>(
       largest,
-      [this, Pk, Rk, &numerator, &denominator, &accumulationLock](
+      [this, Pk, Rk, &converter, &numerator, &denominator, &accumulationLock](
         const typename OutputImageType::RegionType & outputRegionForThread) {
         itk::ImageRegionIterator<OutputImageType> itP(Pk, outputRegionForThread);
-        itk::ImageRegionIterator<OutputImageType> itR(Rk, outputRegionForThread);
+        itk::ImageRegionIterator<TResidualImage>  itR(Rk, outputRegionForThread);
         itk::ImageRegionIterator<OutputImageType> itA_out(this->m_A->GetOutput(), outputRegionForThread);
         DataType                                  currentThreadNumerator = 0.0;
         DataType                                  currentThreadDenominator = 0.0;
         while (!itP.IsAtEnd())
         {
-          currentThreadNumerator += itR.Get() * itR.Get();
+          const PixelType r = converter.Decode(itR.Get());
+          currentThreadNumerator += r * r;
           currentThreadDenominator += itP.Get() * itA_out.Get();
           ++itR;
           ++itA_out;
@@ -240,15 +287,16 @@ ConjugateGradientImageFilter<OutputImageType>::GenerateData()
     numerator = 0;
     mt->template ParallelizeImageRegion<OutputImageType::ImageDimension>(
       largest,
-      [this, Rk, &numerator, &accumulationLock, alpha](
+      [this, Rk, &converter, &numerator, &accumulationLock, alpha](
         const typename OutputImageType::RegionType & outputRegionForThread) {
-        itk::ImageRegionIterator<OutputImageType> itR(Rk, outputRegionForThread);
+        itk::ImageRegionIterator<TResidualImage>  itR(Rk, outputRegionForThread);
         itk::ImageRegionIterator<OutputImageType> itA_out(this->m_A->GetOutput(), outputRegionForThread);
         DataType                                  currentThreadNumerator = 0.0;
         while (!itR.IsAtEnd())
         {
-          itR.Set(itR.Get() - alpha * itA_out.Get());
-          currentThreadNumerator += itR.Get() * itR.Get();
+          const PixelType r = converter.Decode(itR.Get()) - alpha * itA_out.Get();
+          itR.Set(converter.Encode(r));
+          currentThreadNumerator += r * r;
           ++itR;
           ++itA_out;
         }
@@ -258,15 +306,17 @@ ConjugateGradientImageFilter<OutputImageType>::GenerateData()
       },
       nullptr);
     beta = numerator / (denominator + eps);
+    m_ResidualNorm = std::sqrt(static_cast<double>(numerator));
 
     mt->template ParallelizeImageRegion<OutputImageType::ImageDimension>(
       largest,
-      [Rk, Pk, beta](const typename OutputImageType::RegionType & outputRegionForThread) {
-        itk::ImageRegionIterator<OutputImageType> itR(Rk, outputRegionForThread);
+      [Rk, Pk, beta, &converter](const typename OutputImageType::RegionType & outputRegionForThread) {
+        itk::ImageRegionIterator<TResidualImage>  itR(Rk, outputRegionForThread);
         itk::ImageRegionIterator<OutputImageType> itP(Pk, outputRegionForThread);
         while (!itR.IsAtEnd())
         {
-          itP.Set(itR.Get() + beta * itP.Get());
+          const PixelType r = converter.Decode(itR.Get());
+          itP.Set(r + beta * itP.Get());
           ++itR;
           ++itP;
         }
@@ -80,6 +80,14 @@ public:
                      double &           nearDist,
                      double &           farDist) const;
 
+  /** Computes an axis-aligned box containing the object. The bounds are set
+   * to -/+ itk::NumericTraits<ScalarType>::max() along the directions in
+   * which the object is unbounded or its extent is not known. The box is empty,
+   * i.e., bbMin[i]>bbMax[i], if the object is known to be empty. The base
+   * implementation only accounts for the clip planes orthogonal to an axis. */
+  virtual void
+  ComputeBoundingBox(PointType & bbMin, PointType & bbMax) const;
+
   /** Rescale object along each direction by a 3D vector. */
   virtual void
   Rescale(const VectorType & r);
@@ -23,6 +23,9 @@
 
 #include "rtkConfiguration.h"
 #include "rtkMacro.h"
+#include "rtkReducedPrecisionConverter.h"
+
+#include <list>
 
 namespace rtk
 {
@@ -40,6 +43,16 @@ namespace rtk
  * This cyclic deformation model has been described in [Rit et al, TMI, 2009] and
  * [Rit et al, Med Phys, 2009].
  *
+ * The interpolated DVFs can be kept in a cache with a least recently used
+ * policy, see SetCacheMemoryBudget, since the same phases recur over the
+ * projections and over the iterations / streamed divisions of a
+ * reconstruction. Phases may be rounded with SetPhaseTolerance to increase the
+ * number of reused DVFs. Cached DVFs are shared with the output, which must
+ * therefore not be modified in place by downstream filters. The cached DVFs
+ * can be stored in float16 or bfloat16 with SetCachePrecision to fit twice as
+ * many DVFs in the budget, they are then widened to float in a new buffer when
+ * they are reused.
+ *
  * \test rtkmotioncompensatedfdktest.cxx
  *
  * \author Simon Rit
@@ -60,6 +73,7 @@ public:
   using Pointer = itk::SmartPointer<Self>;
   using ConstPointer = itk::SmartPointer<const Self>;
   using OutputImageRegionType = typename OutputImageType::RegionType;
+  using CachePrecisionType = ReducedPrecisionConverter::PrecisionType;
 
   /** Method for creation through the object factory. */
   itkNewMacro(Self);
@@ -80,6 +94,34 @@ public:
   itkGetMacro(Frame, unsigned int);
   itkSetMacro(Frame, unsigned int);
 
+  /** Get / Set the memory budget of the cache of interpolated DVFs, in bytes.
+   * Default is 0, i.e., DVFs are not cached. The cache is only used by the CPU
+   * implementation when the largest possible region is requested. */
+  itkGetMacro(CacheMemoryBudget, itk::SizeValueType);
+  itkSetMacro(CacheMemoryBudget, itk::SizeValueType);
+
+  /** Get / Set the tolerance on the phase. When strictly positive, the phase is
+   * rounded to the closest multiple of the tolerance before interpolation.
+   * Default is 0, i.e., no rounding. */
+  itkGetMacro(PhaseTolerance, double);
+  itkSetMacro(PhaseTolerance, double);
+
+  /** Get / Set the precision of the cached DVFs, FLOAT32 (default), FLOAT16
+   * or BFLOAT16. */
+  itkGetMacro(CachePrecision, CachePrecisionType);
+  itkSetMacro(CachePrecision, CachePrecisionType);
+
+  /** Number of interpolated DVFs currently in the cache. */
+  itk::SizeValueType
+  GetNumberOfCachedFields() const
+  {
+    return m_Cache.size();
+  }
+
+  /** Release all cached DVFs. */
+  void
+  ClearCache();
+
 protected:
   CyclicDeformationImageFilter() = default;
   ~CyclicDeformationImageFilter() override = default;
@@ -89,10 +131,16 @@ protected:
   void
   GenerateInputRequestedRegion() override;
   void
+  GenerateData() override;
+  void
   BeforeThreadedGenerateData() override;
   void
   DynamicThreadedGenerateData(const OutputImageRegionType & outputRegionForThread) override;
 
+  /** Phase of the current frame, rounded according to PhaseTolerance. */
+  double
+  ComputePhase() const;
+
   // Linear interpolation position and weights
   unsigned int m_FrameInf;
   unsigned int m_FrameSup;
@@ -100,10 +148,32 @@ protected:
   double       m_WeightSup;
 
 private:
+  using PixelContainerPointer = typename OutputImageType::PixelContainerPointer;
+  struct CachedField
+  {
+    double                     Phase;
+    PixelContainerPointer      Buffer;
+    std::vector<std::uint16_t> ReducedBuffer;
+    ReducedPrecisionConverter  Converter;
+  };
+
+  using ValueType = typename itk::PixelTraits<typename OutputImageType::PixelType>::ValueType;
+
+  static itk::SizeValueType
+  GetCachedFieldSize(const CachedField & field);
+
   unsigned int m_Frame{ 0 };
 
   std::string         m_SignalFilename;
   std::vector<double> m_Signal;
+
+  // Cache of interpolated DVFs, most recently used first
+  std::list<CachedField> m_Cache;
+  itk::SizeValueType     m_CacheMemoryBudget{ 0 };
+  double                 m_PhaseTolerance{ 0. };
+  CachePrecisionType     m_CachePrecision{ ReducedPrecisionConverter::FLOAT32 };
+  const InputImageType * m_CachedInput{ nullptr };
+  itk::TimeStamp         m_CacheTime;
 };
 
 } // end namespace rtk
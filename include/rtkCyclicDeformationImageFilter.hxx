@@ -25,6 +25,8 @@
 #include <itkImageRegionConstIterator.h>
 #include <itkImageRegionIterator.h>
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 
 namespace rtk
@@ -61,18 +63,133 @@ CyclicDeformationImageFilter<TInputImage, TOutputImage>::GenerateInputRequestedR
 
 template <class TInputImage, class TOutputImage>
 void
-CyclicDeformationImageFilter<TInputImage, TOutputImage>::BeforeThreadedGenerateData()
+CyclicDeformationImageFilter<TInputImage, TOutputImage>::GenerateData()
 {
-  unsigned int nframe = this->GetInput()->GetLargestPossibleRegion().GetSize(OutputImageType::ImageDimension);
-  if (this->GetFrame() > m_Signal.size())
+  OutputImageType * output = this->GetOutput();
+  if (m_CacheMemoryBudget == 0 || output->GetRequestedRegion() != output->GetLargestPossibleRegion())
+  {
+    Superclass::GenerateData();
+    return;
+  }
+
+  // The cached DVFs are only valid for the 4D DVF they have been computed from
+  const InputImageType * input = this->GetInput();
+  if (input != m_CachedInput || input->GetMTime() > m_CacheTime.GetMTime() ||
+      input->GetUpdateMTime() > m_CacheTime.GetMTime())
+  {
+    this->ClearCache();
+    m_CachedInput = input;
+    m_CacheTime.Modified();
+  }
+
+  // Reuse the cached DVF if the phase has already been interpolated
+  const double phase = this->ComputePhase();
+  for (auto it = m_Cache.begin(); it != m_Cache.end(); ++it)
+  {
+    if (it->Phase == phase)
+    {
+      m_Cache.splice(m_Cache.begin(), m_Cache, it);
+      output->SetBufferedRegion(output->GetLargestPossibleRegion());
+      if (it->Buffer.IsNotNull())
+      {
+        output->SetPixelContainer(it->Buffer);
+        return;
+      }
+
+      // Widen the reduced precision DVF in a new buffer
+      output->SetPixelContainer(OutputImageType::PixelContainer::New());
+      output->Allocate();
+      auto *                             values = reinterpret_cast<ValueType *>(output->GetBufferPointer());
+      const std::vector<std::uint16_t> & reduced = it->ReducedBuffer;
+      const ReducedPrecisionConverter &  converter = it->Converter;
+      this->GetMultiThreader()->ParallelizeArray(
+        0,
+        reduced.size(),
+        [values, &reduced, &converter](itk::SizeValueType i) { values[i] = converter.Decode(reduced[i]); },
+        nullptr);
+      return;
+    }
+  }
+
+  // Interpolate in a new buffer to leave the cached ones untouched
+  output->SetPixelContainer(OutputImageType::PixelContainer::New());
+  Superclass::GenerateData();
+  if (m_CachePrecision == ReducedPrecisionConverter::FLOAT32)
+    m_Cache.push_front({ phase, output->GetPixelContainer(), {}, ReducedPrecisionConverter() });
+  else
+  {
+    // Store the components of the DVF in 16 bits
+    using PixelType = typename OutputImageType::PixelType;
+    const ValueType *        values = reinterpret_cast<const ValueType *>(output->GetBufferPointer());
+    const itk::SizeValueType nValues = output->GetPixelContainer()->Size() * itk::PixelTraits<PixelType>::Dimension;
+    double                   maximum = 0.;
+    for (itk::SizeValueType i = 0; i < nValues; i++)
+      maximum = std::max(maximum, std::abs(static_cast<double>(values[i])));
+    const ReducedPrecisionConverter converter(m_CachePrecision,
+                                              ReducedPrecisionConverter::ComputeScale(m_CachePrecision, maximum));
+    std::vector<std::uint16_t>      reduced(nValues);
+    this->GetMultiThreader()->ParallelizeArray(
+      0,
+      nValues,
+      [values, &reduced, &converter](itk::SizeValueType i) { reduced[i] = converter.Encode(values[i]); },
+      nullptr);
+    m_Cache.push_front({ phase, nullptr, std::move(reduced), converter });
+  }
+
+  // Discard the least recently used DVFs until the budget is met
+  itk::SizeValueType cacheSize = 0;
+  for (const CachedField & field : m_Cache)
+    cacheSize += GetCachedFieldSize(field);
+  while (!m_Cache.empty() && cacheSize > m_CacheMemoryBudget)
+  {
+    cacheSize -= GetCachedFieldSize(m_Cache.back());
+    m_Cache.pop_back();
+  }
+}
+
+template <class TInputImage, class TOutputImage>
+itk::SizeValueType
+CyclicDeformationImageFilter<TInputImage, TOutputImage>::GetCachedFieldSize(const CachedField & field)
+{
+  if (field.Buffer.IsNotNull())
+    return field.Buffer->Size() * sizeof(typename OutputImageType::PixelType);
+  return field.ReducedBuffer.size() * sizeof(std::uint16_t);
+}
+
+template <class TInputImage, class TOutputImage>
+void
+CyclicDeformationImageFilter<TInputImage, TOutputImage>::ClearCache()
+{
+  m_Cache.clear();
+  m_CachedInput = nullptr;
+}
+
+template <class TInputImage, class TOutputImage>
+double
+CyclicDeformationImageFilter<TInputImage, TOutputImage>::ComputePhase() const
+{
+  if (this->GetFrame() >= m_Signal.size())
     itkGenericExceptionMacro(<< "Frame number #" << this->GetFrame() << " is larger than phase signal which has size "
-                             << m_SignalFilename);
+                             << m_Signal.size());
 
   double sigValue = m_Signal[this->GetFrame()];
   if (sigValue < 0. || sigValue >= 1.)
     itkGenericExceptionMacro(<< "Signal value #" << this->GetFrame() << " is " << sigValue << " which is not in [0,1)");
 
-  sigValue *= nframe;
+  if (m_PhaseTolerance > 0.)
+  {
+    sigValue = std::round(sigValue / m_PhaseTolerance) * m_PhaseTolerance;
+    sigValue -= std::floor(sigValue);
+  }
+  return sigValue;
+}
+
+template <class TInputImage, class TOutputImage>
+void
+CyclicDeformationImageFilter<TInputImage, TOutputImage>::BeforeThreadedGenerateData()
+{
+  unsigned int nframe = this->GetInput()->GetLargestPossibleRegion().GetSize(OutputImageType::ImageDimension);
+  double       sigValue = this->ComputePhase() * nframe;
   m_FrameInf = itk::Math::Floor<unsigned int, double>(sigValue);
   m_FrameSup = itk::Math::Floor<unsigned int, double>(sigValue + 1.);
   m_WeightInf = m_FrameSup - sigValue;
@@ -21,6 +21,7 @@
 
 #include "rtkForwardDifferenceGradientImageFilter.h"
 #include "rtkBackwardDifferenceDivergenceImageFilter.h"
+#include "rtkNesterovMomentum.h"
 
 #include <itkCastImageFilter.h>
 #include <itkSubtractImageFilter.h>
@@ -32,6 +33,13 @@ namespace rtk
 /** \class DenoisingBPDQImageFilter
  * \brief Base class for Basis Pursuit DeQuantization denoising filters
  *
+ * The iterations are projected gradient steps on the dual variable, a
+ * gradient image. With Momentum, they are accelerated with the FISTA momentum
+ * of rtk::NesterovMomentum with gradient restart, i.e., the fast gradient
+ * projection of [Beck and Teboulle, IEEE TIP, 2009]. The subtraction of the
+ * gradients then no longer runs in place, which requires two more gradient
+ * images in memory. The GPU implementations ignore Momentum.
+ *
  * \author Cyril Mory
  *
  * \ingroup RTK IntensityImageFilters
@@ -73,6 +81,15 @@ public:
   itkSetMacro(Gamma, double);
   itkGetMacro(Gamma, double);
 
+  /** Get / Set whether the iterations are accelerated with a FISTA momentum.
+   * Default is false. */
+  itkGetMacro(Momentum, bool);
+  itkSetMacro(Momentum, bool);
+  itkBooleanMacro(Momentum);
+
+  /** Number of restarts of the momentum during the last update. */
+  itkGetConstMacro(NumberOfMomentumRestarts, unsigned int);
+
 protected:
   DenoisingBPDQImageFilter();
   ~DenoisingBPDQImageFilter() override = default;
@@ -102,6 +119,9 @@ protected:
   int    m_NumberOfIterations;
   bool   m_DimensionsProcessed[TOutputImage::ImageDimension];
 
+  bool         m_Momentum{ false };
+  unsigned int m_NumberOfMomentumRestarts{ 0 };
+
 private:
   virtual void
   SetPipelineForFirstIteration();
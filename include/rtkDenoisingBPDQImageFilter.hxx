@@ -128,6 +128,13 @@ DenoisingBPDQImageFilter<TOutputImage, TGradientImage>::GenerateData()
 {
   typename TGradientImage::Pointer pimg;
 
+  // With momentum, the next iteration starts from the extrapolated dual
+  // variable, which must not be overwritten in place
+  NesterovMomentum                      momentum(NesterovMomentum::GRADIENT_RESTART);
+  typename TGradientImage::ConstPointer start;
+  this->GetMultiThreader()->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+  m_SubtractGradientFilter->SetInPlace(!m_Momentum);
+
   // The first iteration only updates intermediate variables, not the output
   // The output is updated m_NumberOfIterations-1 times, therefore an additional
   // iteration must be performed so that even m_NumberOfIterations=1 has an effect
@@ -140,9 +147,19 @@ DenoisingBPDQImageFilter<TOutputImage, TGradientImage>::GenerateData()
 
     pimg = this->GetThresholdFilter()->GetOutput();
     pimg->DisconnectPipeline();
-    m_DivergenceFilter->SetInput(pimg);
-    m_SubtractGradientFilter->SetInput1(pimg);
+    typename TGradientImage::Pointer next = pimg;
+    if (m_Momentum)
+    {
+      next = momentum.Extrapolate(pimg.GetPointer(), start.GetPointer(), this->GetMultiThreader());
+      start = next;
+    }
+    m_DivergenceFilter->SetInput(next);
+    m_SubtractGradientFilter->SetInput1(next);
   }
+  m_NumberOfMomentumRestarts = momentum.GetNumberOfRestarts();
+
+  // The output is computed from the last iterate, not from its extrapolation
+  m_DivergenceFilter->SetInput(pimg);
   m_DivergenceFilter->Update();
   pimg->ReleaseData();
 
@@ -65,6 +65,12 @@ public:
   /** Runtime information support. */
   itkTypeMacro(DisplacedDetectorForOffsetFieldOfViewImageFilter, ImageToImageFilter);
 
+  bool
+  IsDisplaced() const override;
+
+  void
+  ComputeWeights(unsigned int iProj, double x, double spacing, unsigned int n, double * weights) const override;
+
 protected:
   DisplacedDetectorForOffsetFieldOfViewImageFilter();
   ~DisplacedDetectorForOffsetFieldOfViewImageFilter() override = default;
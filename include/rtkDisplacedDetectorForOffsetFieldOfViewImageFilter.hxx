@@ -22,7 +22,6 @@
 #include "math.h"
 
 
-#include <itkImageRegionIteratorWithIndex.h>
 #include <itkImageRegionConstIterator.h>
 #include <itkImageRegionIterator.h>
 
@@ -113,6 +112,86 @@ DisplacedDetectorForOffsetFieldOfViewImageFilter<TInputImage, TOutputImage>::Gen
   outputPtr->SetLargestPossibleRegion(outputLargestPossibleRegion);
 }
 
+template <class TInputImage, class TOutputImage>
+bool
+DisplacedDetectorForOffsetFieldOfViewImageFilter<TInputImage, TOutputImage>::IsDisplaced() const
+{
+  return !this->GetDisable() && this->GetInput()->GetLargestPossibleRegion().GetSize()[0] !=
+                                  this->GetOutput()->GetLargestPossibleRegion().GetSize()[0];
+}
+
+template <class TInputImage, class TOutputImage>
+void
+DisplacedDetectorForOffsetFieldOfViewImageFilter<TInputImage, TOutputImage>::ComputeWeights(unsigned int iProj,
+                                                                                            double       x,
+                                                                                            double       spacing,
+                                                                                            unsigned int n,
+                                                                                            double *     weights) const
+{
+  typename GeometryType::HomogeneousVectorType sourcePosition;
+  sourcePosition = this->GetGeometry()->GetSourcePosition(iProj);
+  double oppInvNormSource = -1. / (sourcePosition[0] * sourcePosition[0] + sourcePosition[2] * sourcePosition[2]);
+  const double sourceToCenterFOVX = m_FOVCenterX - sourcePosition[0];
+  const double sourceToCenterFOVZ = m_FOVCenterZ - sourcePosition[2];
+  double       invNormSourceCenterFOV =
+    1. / sqrt(sourceToCenterFOVX * sourceToCenterFOVX + sourceToCenterFOVZ * sourceToCenterFOVZ);
+  double centerFOVAngle =
+    atan2(sourceToCenterFOVZ * invNormSourceCenterFOV, sourceToCenterFOVX * invNormSourceCenterFOV) -
+    atan2(sourcePosition[2] * oppInvNormSource, sourcePosition[0] * oppInvNormSource);
+  if (centerFOVAngle > itk::Math::pi)
+    centerFOVAngle -= 2 * itk::Math::pi;
+  if (centerFOVAngle < -itk::Math::pi)
+    centerFOVAngle += 2 * itk::Math::pi;
+  double theta2 =
+    asin(m_FOVRadius / sqrt(pow(m_FOVCenterX - sourcePosition[0], 2.) + pow(m_FOVCenterZ - sourcePosition[2], 2.)));
+  double theta1 = -1. * theta2;
+  theta1 += centerFOVAngle;
+  theta2 += centerFOVAngle;
+
+  // Prepare weights for current slice (depends on ProjectionOffsetsX)
+  const double sx = this->GetGeometry()->GetSourceOffsetsX()[iProj];
+  double       sid = this->GetGeometry()->GetSourceToIsocenterDistances()[iProj];
+  sid = sqrt(sid * sid + sx * sx); // To untilted situation
+  const double liml1 = tan(theta1) * sid;
+  const double liml2 = tan(theta2) * sid;
+  double       invsid = 0.;
+  double       piOverDen = 0.;
+  if (sid != 0.)
+  {
+    invsid = 1. / sid;
+    piOverDen = itk::Math::pi_over_2 *
+                sqrt(sourceToCenterFOVX * sourceToCenterFOVX + sourceToCenterFOVZ * sourceToCenterFOVZ) / m_FOVRadius;
+  }
+
+  if (this->GetInput()->GetLargestPossibleRegion().GetIndex()[0] !=
+      this->GetOutput()->GetLargestPossibleRegion().GetIndex()[0])
+  {
+    for (unsigned int i = 0; i < n; i++, x += spacing)
+    {
+      const double l = this->GetGeometry()->ToUntiltedCoordinateAtIsocenter(iProj, x);
+      if (l <= liml1)
+        weights[i] = 0.;
+      else if (l >= liml2)
+        weights[i] = 2.;
+      else
+        weights[i] = sin(sin(atan(l * invsid) - centerFOVAngle) * piOverDen) + 1.;
+    }
+  }
+  else
+  {
+    for (unsigned int i = 0; i < n; i++, x += spacing)
+    {
+      const double l = this->GetGeometry()->ToUntiltedCoordinateAtIsocenter(iProj, x);
+      if (l <= liml1)
+        weights[i] = 2.0;
+      else if (l >= liml2)
+        weights[i] = 0.0;
+      else
+        weights[i] = 1. - sin(sin(atan(l * invsid) - centerFOVAngle) * piOverDen);
+    }
+  }
+}
+
 template <class TInputImage, class TOutputImage>
 void
 DisplacedDetectorForOffsetFieldOfViewImageFilter<TInputImage, TOutputImage>::DynamicThreadedGenerateData(
@@ -134,9 +213,7 @@ DisplacedDetectorForOffsetFieldOfViewImageFilter<TInputImage, TOutputImage>::Dyn
   itk::ImageRegionConstIterator<InputImageType> itIn(this->GetInput(), overlapRegion);
 
   // Not displaced, nothing to do
-  if (this->GetInput()->GetLargestPossibleRegion().GetSize()[0] ==
-        this->GetOutput()->GetLargestPossibleRegion().GetSize()[0] ||
-      this->GetDisable())
+  if (!this->IsDisplaced())
   {
     // If not in place, copy is required
     if (this->GetInput() != this->GetOutput())
@@ -151,92 +228,13 @@ DisplacedDetectorForOffsetFieldOfViewImageFilter<TInputImage, TOutputImage>::Dyn
     return;
   }
 
-  // Weight image parameters
-  typename WeightImageType::RegionType  region;
-  typename WeightImageType::SpacingType spacing;
-  typename WeightImageType::PointType   origin;
-  region.SetSize(0, overlapRegion.GetSize(0));
-  region.SetIndex(0, overlapRegion.GetIndex(0));
-  spacing[0] = this->GetInput()->GetSpacing()[0];
-  origin[0] = this->GetInput()->GetOrigin()[0];
-
-  // Create one line of weights
-  typename WeightImageType::Pointer weights = WeightImageType::New();
-  weights->SetSpacing(spacing);
-  weights->SetOrigin(origin);
-  weights->SetRegions(region);
-  weights->Allocate();
-  typename itk::ImageRegionIteratorWithIndex<WeightImageType> itWeights(weights, weights->GetLargestPossibleRegion());
-  for (unsigned int k = 0; k < overlapRegion.GetSize(2); k++, itWeights.GoToBegin())
+  // One line of weights
+  std::vector<double> weights(overlapRegion.GetSize(0));
+  const double        spacing = this->GetInput()->GetSpacing()[0];
+  const double        x = this->GetInput()->GetOrigin()[0] + spacing * overlapRegion.GetIndex(0);
+  for (unsigned int k = 0; k < overlapRegion.GetSize(2); k++)
   {
-    typename GeometryType::HomogeneousVectorType sourcePosition;
-    sourcePosition = this->GetGeometry()->GetSourcePosition(itIn.GetIndex()[2]);
-    double oppInvNormSource = -1. / (sourcePosition[0] * sourcePosition[0] + sourcePosition[2] * sourcePosition[2]);
-    const double sourceToCenterFOVX = m_FOVCenterX - sourcePosition[0];
-    const double sourceToCenterFOVZ = m_FOVCenterZ - sourcePosition[2];
-    double       invNormSourceCenterFOV =
-      1. / sqrt(sourceToCenterFOVX * sourceToCenterFOVX + sourceToCenterFOVZ * sourceToCenterFOVZ);
-    double centerFOVAngle =
-      atan2(sourceToCenterFOVZ * invNormSourceCenterFOV, sourceToCenterFOVX * invNormSourceCenterFOV) -
-      atan2(sourcePosition[2] * oppInvNormSource, sourcePosition[0] * oppInvNormSource);
-    if (centerFOVAngle > itk::Math::pi)
-      centerFOVAngle -= 2 * itk::Math::pi;
-    if (centerFOVAngle < -itk::Math::pi)
-      centerFOVAngle += 2 * itk::Math::pi;
-    double theta2 =
-      asin(m_FOVRadius / sqrt(pow(m_FOVCenterX - sourcePosition[0], 2.) + pow(m_FOVCenterZ - sourcePosition[2], 2.)));
-    double theta1 = -1. * theta2;
-    theta1 += centerFOVAngle;
-    theta2 += centerFOVAngle;
-
-    // Prepare weights for current slice (depends on ProjectionOffsetsX)
-    const double sx = this->GetGeometry()->GetSourceOffsetsX()[itIn.GetIndex()[2]];
-    double       sid = this->GetGeometry()->GetSourceToIsocenterDistances()[itIn.GetIndex()[2]];
-    sid = sqrt(sid * sid + sx * sx); // To untilted situation
-    const double liml1 = tan(theta1) * sid;
-    const double liml2 = tan(theta2) * sid;
-    double       invsid = 0.;
-    double       piOverDen = 0.;
-    if (sid != 0.)
-    {
-      invsid = 1. / sid;
-      piOverDen = itk::Math::pi_over_2 *
-                  sqrt(sourceToCenterFOVX * sourceToCenterFOVX + sourceToCenterFOVZ * sourceToCenterFOVZ) / m_FOVRadius;
-    }
-    typename WeightImageType::PointType point;
-    weights->TransformIndexToPhysicalPoint(itWeights.GetIndex(), point);
-
-    if (this->GetInput()->GetLargestPossibleRegion().GetIndex()[0] !=
-        this->GetOutput()->GetLargestPossibleRegion().GetIndex()[0])
-    {
-      while (!itWeights.IsAtEnd())
-      {
-        const double l = this->GetGeometry()->ToUntiltedCoordinateAtIsocenter(itIn.GetIndex()[2], point[0]);
-        if (l <= liml1)
-          itWeights.Set(0.);
-        else if (l >= liml2)
-          itWeights.Set(2.);
-        else
-          itWeights.Set(sin(sin(atan(l * invsid) - centerFOVAngle) * piOverDen) + 1.);
-        ++itWeights;
-        point[0] += spacing[0];
-      }
-    }
-    else
-    {
-      while (!itWeights.IsAtEnd())
-      {
-        const double l = this->GetGeometry()->ToUntiltedCoordinateAtIsocenter(itIn.GetIndex()[2], point[0]);
-        if (l <= liml1)
-          itWeights.Set(2.0);
-        else if (l >= liml2)
-          itWeights.Set(0.0);
-        else
-          itWeights.Set(1. - sin(sin(atan(l * invsid) - centerFOVAngle) * piOverDen));
-        ++itWeights;
-        point[0] += spacing[0];
-      }
-    }
+    this->ComputeWeights(itIn.GetIndex()[2], x, spacing, weights.size(), weights.data());
 
     // Multiply each line of the current slice
     for (unsigned int j = 0; j < overlapRegion.GetSize(1); j++)
@@ -248,11 +246,9 @@ DisplacedDetectorForOffsetFieldOfViewImageFilter<TInputImage, TOutputImage>::Dyn
         ++itOut;
       }
 
-      itWeights.GoToBegin();
-      while (!itWeights.IsAtEnd())
+      for (const double w : weights)
       {
-        itOut.Set(itIn.Get() * itWeights.Get());
-        ++itWeights;
+        itOut.Set(itIn.Get() * w);
         ++itIn;
         ++itOut;
       }
@@ -107,6 +107,19 @@ public:
   itkGetMacro(Disable, bool);
   itkSetMacro(Disable, bool);
 
+  /** Whether the projections are weighted, i.e., the filter is not disabled
+   * and the detector is displaced by more than 10% of its size. Requires the
+   * output information. */
+  virtual bool
+  IsDisplaced() const;
+
+  /** Computes the weights of n consecutive columns of projection iProj, the
+   * first one at coordinate x along the detector rows and the next ones
+   * separated by spacing. Requires the output information of a displaced
+   * detector. */
+  virtual void
+  ComputeWeights(unsigned int iProj, double x, double spacing, unsigned int n, double * weights) const;
+
 protected:
   DisplacedDetectorImageFilter();
 
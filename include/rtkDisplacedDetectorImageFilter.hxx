@@ -20,7 +20,6 @@
 #define rtkDisplacedDetectorImageFilter_hxx
 
 
-#include <itkImageRegionIteratorWithIndex.h>
 #include <itkImageRegionConstIterator.h>
 #include <itkImageRegionIterator.h>
 
@@ -179,6 +178,62 @@ DisplacedDetectorImageFilter<TInputImage, TOutputImage>::GenerateOutputInformati
   outputPtr->SetLargestPossibleRegion(outputLargestPossibleRegion);
 }
 
+template <class TInputImage, class TOutputImage>
+bool
+DisplacedDetectorImageFilter<TInputImage, TOutputImage>::IsDisplaced() const
+{
+  return !m_Disable && itk::Math::abs(m_InferiorCorner + m_SuperiorCorner) >=
+                         0.1 * itk::Math::abs(m_SuperiorCorner - m_InferiorCorner);
+}
+
+template <class TInputImage, class TOutputImage>
+void
+DisplacedDetectorImageFilter<TInputImage, TOutputImage>::ComputeWeights(unsigned int iProj,
+                                                                        double       x,
+                                                                        double       spacing,
+                                                                        unsigned int n,
+                                                                        double *     weights) const
+{
+  const double theta = std::min(-1 * m_InferiorCorner, m_SuperiorCorner);
+  const double sx = m_Geometry->GetSourceOffsetsX()[iProj];
+  double       sid = m_Geometry->GetSourceToIsocenterDistances()[iProj];
+  sid = sqrt(sid * sid + sx * sx); // To untilted situation
+  double invsid = 0.;
+  double invden = 0.;
+  if (sid != 0.)
+  {
+    invsid = 1. / sid;
+    invden = 1. / (2. * std::atan(theta * invsid));
+  }
+
+  if (m_SuperiorCorner + m_InferiorCorner > 0.)
+  {
+    for (unsigned int i = 0; i < n; i++, x += spacing)
+    {
+      const double l = m_Geometry->ToUntiltedCoordinateAtIsocenter(iProj, x);
+      if (l <= -1 * theta)
+        weights[i] = 0.0;
+      else if (l >= theta)
+        weights[i] = 2.0;
+      else
+        weights[i] = sin(itk::Math::pi * atan(l * invsid) * invden) + 1;
+    }
+  }
+  else
+  {
+    for (unsigned int i = 0; i < n; i++, x += spacing)
+    {
+      const double l = m_Geometry->ToUntiltedCoordinateAtIsocenter(iProj, x);
+      if (l <= -1 * theta)
+        weights[i] = 2.0;
+      else if (l >= theta)
+        weights[i] = 0.0;
+      else
+        weights[i] = 1 - sin(itk::Math::pi * atan(l * invsid) * invden);
+    }
+  }
+}
+
 template <class TInputImage, class TOutputImage>
 void
 DisplacedDetectorImageFilter<TInputImage, TOutputImage>::DynamicThreadedGenerateData(
@@ -205,9 +260,7 @@ DisplacedDetectorImageFilter<TInputImage, TOutputImage>::DynamicThreadedGenerate
   itk::ImageRegionConstIterator<InputImageType> itIn(this->GetInput(), overlapRegion);
 
   // Not displaced, nothing to do
-  if ((itk::Math::abs(m_InferiorCorner + m_SuperiorCorner) <
-       0.1 * itk::Math::abs(m_SuperiorCorner - m_InferiorCorner)) ||
-      m_Disable)
+  if (!this->IsDisplaced())
   {
     // If not in place, copy is required
     if (this->GetInput() != this->GetOutput())
@@ -222,74 +275,18 @@ DisplacedDetectorImageFilter<TInputImage, TOutputImage>::DynamicThreadedGenerate
     return;
   }
 
-  // Weight image parameters
-  typename WeightImageType::RegionType  region;
-  typename WeightImageType::SpacingType spacing;
-  typename WeightImageType::PointType   origin;
-  region.SetSize(0, overlapRegion.GetSize(0));
-  region.SetIndex(0, overlapRegion.GetIndex(0));
-  spacing[0] = this->GetInput()->GetSpacing()[0];
-  origin[0] = this->GetInput()->GetOrigin()[0];
-
-  // Create one line of weights
-  typename WeightImageType::Pointer weights = WeightImageType::New();
-  weights->SetSpacing(spacing);
-  weights->SetOrigin(origin);
-  weights->SetRegions(region);
-  weights->Allocate();
-  typename itk::ImageRegionIteratorWithIndex<WeightImageType> itWeights(weights, weights->GetLargestPossibleRegion());
-
-  double       theta = std::min(-1 * m_InferiorCorner, m_SuperiorCorner);
+  // One line of weights
+  std::vector<double> weights(overlapRegion.GetSize(0));
+  const double        spacing = this->GetInput()->GetSpacing()[0];
+  const double        x = this->GetInput()->GetOrigin()[0] + spacing * overlapRegion.GetIndex(0);
+
   unsigned int nLinesPerProjection = overlapRegion.GetNumberOfPixels();
   nLinesPerProjection /= overlapRegion.GetSize(0);
   nLinesPerProjection /= overlapRegion.GetSize(NDimension - 1);
   for (unsigned int k = 0; k < overlapRegion.GetSize(NDimension - 1); k++)
   {
     // Prepare weights for current slice (depends on ProjectionOffsetsX)
-    const double sx = m_Geometry->GetSourceOffsetsX()[itIn.GetIndex()[NDimension - 1]];
-    double       sid = m_Geometry->GetSourceToIsocenterDistances()[itIn.GetIndex()[NDimension - 1]];
-    sid = sqrt(sid * sid + sx * sx); // To untilted situation
-    double invsid = 0.;
-    double invden = 0.;
-    if (sid != 0.)
-    {
-      invsid = 1. / sid;
-      invden = 1. / (2. * std::atan(theta * invsid));
-    }
-    typename WeightImageType::PointType point;
-    weights->TransformIndexToPhysicalPoint(itWeights.GetIndex(), point);
-
-    if (m_SuperiorCorner + m_InferiorCorner > 0.)
-    {
-      itWeights.GoToBegin();
-      while (!itWeights.IsAtEnd())
-      {
-        const double l = m_Geometry->ToUntiltedCoordinateAtIsocenter(itIn.GetIndex()[NDimension - 1], point[0]);
-        if (l <= -1 * theta)
-          itWeights.Set(0.0);
-        else if (l >= theta)
-          itWeights.Set(2.0);
-        else
-          itWeights.Set(sin(itk::Math::pi * atan(l * invsid) * invden) + 1);
-        ++itWeights;
-        point[0] += spacing[0];
-      }
-    }
-    else
-    {
-      while (!itWeights.IsAtEnd())
-      {
-        const double l = m_Geometry->ToUntiltedCoordinateAtIsocenter(itIn.GetIndex()[NDimension - 1], point[0]);
-        if (l <= -1 * theta)
-          itWeights.Set(2.0);
-        else if (l >= theta)
-          itWeights.Set(0.0);
-        else
-          itWeights.Set(1 - sin(itk::Math::pi * atan(l * invsid) * invden));
-        ++itWeights;
-        point[0] += spacing[0];
-      }
-    }
+    this->ComputeWeights(itIn.GetIndex()[NDimension - 1], x, spacing, weights.size(), weights.data());
 
     // Multiply each line of the current 2D or 3D slice
     for (unsigned int j = 0; j < nLinesPerProjection; j++)
@@ -302,11 +299,9 @@ DisplacedDetectorImageFilter<TInputImage, TOutputImage>::DynamicThreadedGenerate
         ++itOut;
       }
 
-      itWeights.GoToBegin();
-      while (!itWeights.IsAtEnd())
+      for (const double w : weights)
       {
-        itOut.Set(itIn.Get() * itWeights.Get());
-        ++itWeights;
+        itOut.Set(itIn.Get() * w);
         ++itIn;
         ++itOut;
       }
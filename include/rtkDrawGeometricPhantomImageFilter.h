@@ -29,6 +29,12 @@ namespace rtk
 /** \class DrawGeometricPhantomImageFilter
  * \brief Draws a GeometricPhantom in a 3D image
  *
+ * The volume is drawn in a single pass. The bounding box of each ConvexShape
+ * is computed beforehand and the output is processed by bricks of voxels, the
+ * inside test being only evaluated for the shapes whose box overlaps the
+ * brick. Each voxel can optionally be supersampled to obtain partial volume
+ * values at the edges of the shapes.
+ *
  * \test rtkprojectgeometricphantomtest.cxx, rtkforbildtest.cxx
  *
  * \author Marc Vila, Simon Rit
@@ -53,6 +59,8 @@ public:
   using VectorType = ConvexShape::VectorType;
   using RotationMatrixType = ConvexShape::RotationMatrixType;
   using ScalarType = ConvexShape::ScalarType;
+  using PointType = ConvexShape::PointType;
+  using OutputImageRegionType = typename TOutputImage::RegionType;
 
   /** Method for creation through the object factory. */
   itkNewMacro(Self);
@@ -101,13 +109,25 @@ public:
   void
   SetClipPlanes(const std::vector<VectorType> & dir, const std::vector<ScalarType> & pos);
 
+  /** Get / Set the number of samples along each direction of a voxel. The
+   * voxel value is the average of the densities at the samples, i.e., an
+   * approximation of the partial volume of each shape. Default is 1, i.e., the
+   * density at the center of the voxel. */
+  itkSetMacro(SupersamplingFactor, unsigned int);
+  itkGetConstMacro(SupersamplingFactor, unsigned int);
+
 protected:
   DrawGeometricPhantomImageFilter();
   ~DrawGeometricPhantomImageFilter() override = default;
 
+  /** Reads the phantom, transforms its shapes and computes their bounding
+   * boxes before drawing them. */
   void
   GenerateData() override;
 
+  void
+  DynamicThreadedGenerateData(const OutputImageRegionType & outputRegionForThread) override;
+
 private:
   GeometricPhantomConstPointer m_GeometricPhantom;
   StringType                   m_ConfigFile;
@@ -117,6 +137,12 @@ private:
   RotationMatrixType           m_RotationMatrix;
   std::vector<VectorType>      m_PlaneDirections;
   std::vector<ScalarType>      m_PlanePositions;
+  unsigned int                 m_SupersamplingFactor{ 1 };
+
+  /** Transformed shapes and their bounding boxes, computed in GenerateData */
+  std::vector<ConvexShape::Pointer> m_Shapes;
+  std::vector<PointType>            m_ShapesBoxMin;
+  std::vector<PointType>            m_ShapesBoxMax;
 };
 
 } // end namespace rtk
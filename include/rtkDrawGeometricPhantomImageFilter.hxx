@@ -21,13 +21,13 @@
 
 #include "rtkGeometricPhantomFileReader.h"
 #include "rtkForbildPhantomFileReader.h"
-#include "rtkDrawConvexImageFilter.h"
+#include "rtkHomogeneousMatrix.h"
 
-#include <iostream>
-#include <fstream>
-#include <sstream>
-#include <cstdio>
-#include <cstdlib>
+#include <itkImageScanlineConstIterator.h>
+#include <itkImageScanlineIterator.h>
+
+#include <algorithm>
+#include <cmath>
 
 namespace rtk
 {
@@ -67,8 +67,10 @@ DrawGeometricPhantomImageFilter<TInputImage, TOutputImage>::GenerateData()
   if (cov.empty())
     itkExceptionMacro(<< "Empty phantom");
 
-  // Create one add filter per convex object
-  std::vector<typename itk::ImageSource<TOutputImage>::Pointer> drawers;
+  // Transform each convex object and compute its bounding box
+  m_Shapes.clear();
+  m_ShapesBoxMin.clear();
+  m_ShapesBoxMax.clear();
   for (const auto & convexShape : cov)
   {
     ConvexShape::Pointer co = convexShape->Clone();
@@ -78,27 +80,149 @@ DrawGeometricPhantomImageFilter<TInputImage, TOutputImage>::GenerateData()
     for (size_t i = 0; i < m_PlaneDirections.size(); i++)
       co->AddClipPlane(m_PlaneDirections[i], m_PlanePositions[i]);
 
-    if (!drawers.empty())
+    PointType bbMin, bbMax;
+    co->ComputeBoundingBox(bbMin, bbMax);
+    m_Shapes.push_back(co);
+    m_ShapesBoxMin.push_back(bbMin);
+    m_ShapesBoxMax.push_back(bbMax);
+  }
+
+  // Allocate the output and draw all shapes in one pass
+  Superclass::GenerateData();
+
+  m_Shapes.clear();
+  m_ShapesBoxMin.clear();
+  m_ShapesBoxMax.clear();
+}
+
+template <class TInputImage, class TOutputImage>
+void
+DrawGeometricPhantomImageFilter<TInputImage, TOutputImage>::DynamicThreadedGenerateData(
+  const OutputImageRegionType & outputRegionForThread)
+{
+  constexpr unsigned int   Dimension = TOutputImage::ImageDimension;
+  constexpr unsigned int   BrickSize = 16;
+  const TInputImage *      input = this->GetInput();
+  TOutputImage *           output = this->GetOutput();
+  const unsigned int       factor = std::max(m_SupersamplingFactor, 1u);
+  const itk::SizeValueType nSubSamples = static_cast<itk::SizeValueType>(std::pow(factor, Dimension));
+
+  // Points are computed incrementally with the index to physical point matrix
+  const itk::Matrix<double, Dimension + 1, Dimension + 1> indexToPP =
+    GetIndexToPhysicalPointMatrix<TOutputImage>(output);
+  VectorType step;
+  for (unsigned int i = 0; i < Dimension; i++)
+    step[i] = indexToPP[i][0];
+
+  // Offsets of the samples relative to the voxel center, in physical coordinates
+  std::vector<VectorType> subOffsets(nSubSamples);
+  for (itk::SizeValueType s = 0; s < nSubSamples; s++)
+  {
+    itk::SizeValueType rem = s;
+    for (unsigned int i = 0; i < Dimension; i++)
+      subOffsets[s][i] = 0.;
+    for (unsigned int j = 0; j < Dimension; j++, rem /= factor)
     {
-      using RCOIType = DrawConvexImageFilter<TOutputImage, TOutputImage>;
-      typename RCOIType::Pointer rcoi = RCOIType::New();
-      rcoi->SetInput(drawers.back()->GetOutput());
-      rcoi->SetConvexShape(co);
-      drawers.push_back(rcoi.GetPointer());
+      const double subIndex = (rem % factor + 0.5) / factor - 0.5;
+      for (unsigned int i = 0; i < Dimension; i++)
+        subOffsets[s][i] += indexToPP[i][j] * subIndex;
     }
-    else
+  }
+
+  // The bricks are enlarged by the extent of the samples and a small tolerance
+  // to account for rounding errors in the bounding boxes of the shapes
+  const double margin = 0.5 - 0.5 / factor + 0.01;
+
+  // Split the region into bricks
+  itk::Size<Dimension> nBricks;
+  itk::SizeValueType   nBricksTotal = 1;
+  for (unsigned int i = 0; i < Dimension; i++)
+  {
+    nBricks[i] = (outputRegionForThread.GetSize(i) + BrickSize - 1) / BrickSize;
+    nBricksTotal *= nBricks[i];
+  }
+
+  std::vector<const ConvexShape *> candidates;
+  candidates.reserve(m_Shapes.size());
+  for (itk::SizeValueType b = 0; b < nBricksTotal; b++)
+  {
+    OutputImageRegionType brick;
+    itk::SizeValueType    rem = b;
+    for (unsigned int i = 0; i < Dimension; i++)
     {
-      using RCOIType = DrawConvexImageFilter<TInputImage, TOutputImage>;
-      typename RCOIType::Pointer rcoi = RCOIType::New();
-      rcoi->SetInput(this->GetInput());
-      rcoi->SetConvexShape(co);
-      drawers.push_back(rcoi.GetPointer());
+      const itk::SizeValueType bi = rem % nBricks[i];
+      rem /= nBricks[i];
+      brick.SetIndex(i, outputRegionForThread.GetIndex(i) + bi * BrickSize);
+      brick.SetSize(i, std::min<itk::SizeValueType>(BrickSize, outputRegionForThread.GetSize(i) - bi * BrickSize));
+    }
+
+    // Physical bounding box of the brick
+    PointType brickMin, brickMax;
+    brickMin.Fill(itk::NumericTraits<ScalarType>::max());
+    brickMax.Fill(-itk::NumericTraits<ScalarType>::max());
+    for (unsigned int c = 0; c < (1u << Dimension); c++)
+    {
+      for (unsigned int i = 0; i < Dimension; i++)
+      {
+        double coord = indexToPP[i][Dimension];
+        for (unsigned int j = 0; j < Dimension; j++)
+        {
+          const double corner = (c & (1u << j)) ? brick.GetIndex(j) + brick.GetSize(j) - 1 + margin
+                                                : brick.GetIndex(j) - margin;
+          coord += indexToPP[i][j] * corner;
+        }
+        brickMin[i] = std::min(brickMin[i], coord);
+        brickMax[i] = std::max(brickMax[i], coord);
+      }
     }
-  }
 
-  drawers.back()->GetOutput()->SetRequestedRegion(this->GetOutput()->GetRequestedRegion());
-  drawers.back()->Update();
-  this->GraftOutput(drawers.back()->GetOutput());
+    // Shapes which may contain a sample of the brick
+    candidates.clear();
+    for (size_t n = 0; n < m_Shapes.size(); n++)
+    {
+      bool overlap = true;
+      for (unsigned int i = 0; i < Dimension; i++)
+        overlap = overlap && m_ShapesBoxMin[n][i] <= brickMax[i] && m_ShapesBoxMax[n][i] >= brickMin[i];
+      if (overlap)
+        candidates.push_back(m_Shapes[n].GetPointer());
+    }
+
+    itk::ImageScanlineConstIterator<TInputImage> itIn(input, brick);
+    itk::ImageScanlineIterator<TOutputImage>     itOut(output, brick);
+    while (!itOut.IsAtEnd())
+    {
+      // Physical point of the first voxel of the line
+      PointType point;
+      for (unsigned int i = 0; i < Dimension; i++)
+      {
+        point[i] = indexToPP[i][Dimension];
+        for (unsigned int j = 0; j < Dimension; j++)
+          point[i] += indexToPP[i][j] * itOut.GetIndex()[j];
+      }
+
+      while (!itOut.IsAtEndOfLine())
+      {
+        double density = 0.;
+        if (!candidates.empty())
+        {
+          for (const VectorType & subOffset : subOffsets)
+          {
+            const PointType p = point + subOffset;
+            for (const ConvexShape * shape : candidates)
+              if (shape->IsInside(p))
+                density += shape->GetDensity();
+          }
+          density /= nSubSamples;
+        }
+        itOut.Set(itIn.Get() + density);
+        point += step;
+        ++itIn;
+        ++itOut;
+      }
+      itIn.NextLine();
+      itOut.NextLine();
+    }
+  }
 }
 
 template <class TInputImage, class TOutputImage>
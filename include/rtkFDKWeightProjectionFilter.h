@@ -21,6 +21,8 @@
 
 #include <itkInPlaceImageFilter.h>
 #include "rtkThreeDCircularProjectionGeometry.h"
+#include "rtkDisplacedDetectorImageFilter.h"
+#include "rtkParkerShortScanImageFilter.h"
 #include "rtkConfiguration.h"
 
 namespace rtk
@@ -39,6 +41,13 @@ namespace rtk
  * SouceOffsets and ProjectionOffsets are accounted for on a per
  * projection basis but InPlaneRotation and OutOfPlaneRotation are not
  * accounted for.
+ *
+ * The weights of a DisplacedDetectorImageFilter and of a
+ * ParkerShortScanImageFilter can be applied in the same pass by setting
+ * DisplacedDetectorFilter and ShortScanFilter, which are then only used to
+ * compute the weights and are not updated. The output is then zero padded as
+ * by the displaced detector filter. All weights are factored, for each
+ * projection, in tables of factors of the columns and of the rows.
  * \author Simon Rit
  *
  * \test rtkfdktest.cxx, rtkrampfiltertest.cxx, rtkdisplaceddetectortest.cxx,
@@ -63,6 +72,8 @@ public:
   using InputImageType = TInputImage;
   using OutputImageType = TOutputImage;
   using OutputImageRegionType = typename OutputImageType::RegionType;
+  using DisplacedDetectorFilterType = DisplacedDetectorImageFilter<TInputImage, TOutputImage>;
+  using ShortScanFilterType = ParkerShortScanImageFilter<TInputImage, TOutputImage>;
 
   /** Standard New method. */
   itkNewMacro(Self);
@@ -74,6 +85,21 @@ public:
   itkGetMacro(Geometry, ThreeDCircularProjectionGeometry::Pointer);
   itkSetObjectMacro(Geometry, ThreeDCircularProjectionGeometry);
 
+  /** Get / Set the displaced detector filter whose weights are applied with
+   * the FDK weights. Default is nullptr, i.e., no displaced detector weights. */
+  itkGetModifiableObjectMacro(DisplacedDetectorFilter, DisplacedDetectorFilterType);
+  itkSetObjectMacro(DisplacedDetectorFilter, DisplacedDetectorFilterType);
+
+  /** Get / Set the short scan filter whose weights are applied with the FDK
+   * weights. Default is nullptr, i.e., no short scan weights. */
+  itkGetModifiableObjectMacro(ShortScanFilter, ShortScanFilterType);
+  itkSetObjectMacro(ShortScanFilter, ShortScanFilterType);
+
+  /** The filter cannot run in place when the displaced detector filter pads
+   * the projections. */
+  bool
+  CanRunInPlace() const override;
+
 protected:
   FDKWeightProjectionFilter() = default;
   ~FDKWeightProjectionFilter() override = default;
@@ -82,6 +108,12 @@ protected:
   void
   VerifyPreconditions() ITKv5_CONST override;
 
+  void
+  GenerateOutputInformation() override;
+
+  void
+  GenerateInputRequestedRegion() override;
+
   void
   BeforeThreadedGenerateData() override;
 
@@ -97,6 +129,10 @@ private:
 
   /** Geometrical description of the system */
   ThreeDCircularProjectionGeometry::Pointer m_Geometry;
+
+  /** Filters providing the displaced detector and short scan weights */
+  typename DisplacedDetectorFilterType::Pointer m_DisplacedDetectorFilter;
+  typename ShortScanFilterType::Pointer         m_ShortScanFilter;
 }; // end of class
 
 } // end namespace rtk
@@ -22,6 +22,8 @@
 
 #include <itkImageRegionIterator.h>
 
+#include <algorithm>
+
 namespace rtk
 {
 
@@ -35,10 +37,57 @@ FDKWeightProjectionFilter<TInputImage, TOutputImage>::VerifyPreconditions() ITKv
     itkExceptionMacro(<< "Geometry has not been set.");
 }
 
+template <class TInputImage, class TOutputImage>
+void
+FDKWeightProjectionFilter<TInputImage, TOutputImage>::GenerateOutputInformation()
+{
+  Superclass::GenerateOutputInformation();
+
+  // The displaced detector filter computes the zero padding of the projections
+  if (m_DisplacedDetectorFilter.IsNotNull())
+  {
+    m_DisplacedDetectorFilter->SetInput(this->GetInput());
+    m_DisplacedDetectorFilter->SetGeometry(m_Geometry);
+    m_DisplacedDetectorFilter->UpdateOutputInformation();
+    this->GetOutput()->SetLargestPossibleRegion(m_DisplacedDetectorFilter->GetOutput()->GetLargestPossibleRegion());
+  }
+}
+
+template <class TInputImage, class TOutputImage>
+bool
+FDKWeightProjectionFilter<TInputImage, TOutputImage>::CanRunInPlace() const
+{
+  if (!itk::InPlaceImageFilter<TInputImage, TOutputImage>::CanRunInPlace())
+    return false;
+  if (m_DisplacedDetectorFilter.IsNull() || this->GetInput() == nullptr)
+    return true;
+  return this->GetInput()->GetLargestPossibleRegion() == this->GetOutput()->GetLargestPossibleRegion();
+}
+
+template <class TInputImage, class TOutputImage>
+void
+FDKWeightProjectionFilter<TInputImage, TOutputImage>::GenerateInputRequestedRegion()
+{
+  typename Superclass::InputImagePointer inputPtr = const_cast<TInputImage *>(this->GetInput());
+  if (!inputPtr)
+    return;
+
+  // Account for the zero padding
+  typename TInputImage::RegionType inputRequestedRegion = this->GetOutput()->GetRequestedRegion();
+  inputRequestedRegion.Crop(inputPtr->GetLargestPossibleRegion());
+  inputPtr->SetRequestedRegion(inputRequestedRegion);
+}
+
 template <class TInputImage, class TOutputImage>
 void
 FDKWeightProjectionFilter<TInputImage, TOutputImage>::BeforeThreadedGenerateData()
 {
+  if (m_ShortScanFilter.IsNotNull())
+  {
+    m_ShortScanFilter->SetGeometry(m_Geometry);
+    m_ShortScanFilter->ComputeShortScanParameters(this->GetOutput());
+  }
+
   // Get angular weights from geometry
   m_ConstantProjectionFactor = m_Geometry->GetAngularGaps(m_Geometry->GetSourceAngles());
   m_TiltAngles = m_Geometry->GetTiltAngles();
@@ -67,6 +116,22 @@ void
 FDKWeightProjectionFilter<TInputImage, TOutputImage>::DynamicThreadedGenerateData(
   const OutputImageRegionType & outputRegionForThread)
 {
+  // Columns of the input, the other columns of the output are zero padded
+  using OutputIterator = itk::ImageRegionIterator<OutputImageType>;
+  OutputIterator        itO(this->GetOutput(), outputRegionForThread);
+  OutputImageRegionType overlapRegion = outputRegionForThread;
+  if (!overlapRegion.Crop(this->GetInput()->GetLargestPossibleRegion()))
+  {
+    for (; !itO.IsAtEnd(); ++itO)
+      itO.Set(0);
+    return;
+  }
+  using InputConstIterator = itk::ImageRegionConstIterator<InputImageType>;
+  InputConstIterator itI(this->GetInput(), overlapRegion);
+  const unsigned int nColumns = outputRegionForThread.GetSize(0);
+  const unsigned int iFirst = overlapRegion.GetIndex(0) - outputRegionForThread.GetIndex(0);
+  const unsigned int iLast = iFirst + overlapRegion.GetSize(0);
+
   // Prepare point increment (TransformIndexToPhysicalPoint too slow)
   typename InputImageType::PointType pointBase, pointIncrement;
   typename InputImageType::IndexType index = outputRegionForThread.GetIndex();
@@ -77,24 +142,35 @@ FDKWeightProjectionFilter<TInputImage, TOutputImage>::DynamicThreadedGenerateDat
   for (int i = 0; i < 3; i++)
     pointIncrement[i] -= pointBase[i];
 
-  // Iterators
-  using InputConstIterator = itk::ImageRegionConstIterator<InputImageType>;
-  InputConstIterator itI(this->GetInput(), outputRegionForThread);
-  using OutputIterator = itk::ImageRegionIterator<OutputImageType>;
-  OutputIterator itO(this->GetOutput(), outputRegionForThread);
-  itI.GoToBegin();
-  itO.GoToBegin();
+  // The weight of pixel (i,j) is columnFactors[i] / sqrt(rowTerms[j] + columnTerms[i])
+  std::vector<double> columnFactors(nColumns);
+  std::vector<double> columnTerms(nColumns);
+  std::vector<double> rowTerms(outputRegionForThread.GetSize(1));
+  std::vector<double> weights(nColumns);
 
   // Go over output, compute weights and avoid redundant computation
   for (int k = outputRegionForThread.GetIndex(2);
        k < outputRegionForThread.GetIndex(2) + (int)outputRegionForThread.GetSize(2);
        k++)
   {
+    // Angular weights, displaced detector and short scan weights of the columns
+    std::fill(columnFactors.begin(), columnFactors.end(), m_ConstantProjectionFactor[k]);
+    if (m_DisplacedDetectorFilter.IsNotNull() && m_DisplacedDetectorFilter->IsDisplaced())
+    {
+      m_DisplacedDetectorFilter->ComputeWeights(k, pointBase[0], pointIncrement[0], nColumns, weights.data());
+      for (unsigned int i = 0; i < nColumns; i++)
+        columnFactors[i] *= weights[i];
+    }
+    if (m_ShortScanFilter.IsNotNull() && m_ShortScanFilter->GetIsShortScan())
+    {
+      m_ShortScanFilter->ComputeWeights(k, pointBase[0], pointIncrement[0], nColumns, weights.data());
+      for (unsigned int i = 0; i < nColumns; i++)
+        columnFactors[i] *= weights[i];
+    }
+
     const double sdd = m_Geometry->GetSourceToDetectorDistances()[k];
     if (sdd != 0.) // Divergent
     {
-      typename InputImageType::PointType point = pointBase;
-      point[1] = pointBase[1] + m_Geometry->GetProjectionOffsetsY()[k] - m_Geometry->GetSourceOffsetsY()[k];
       const double cosa = cos(m_TiltAngles[k]);
       const double sina = sin(m_TiltAngles[k]);
       const double tana = tan(m_TiltAngles[k]);
@@ -105,26 +181,31 @@ FDKWeightProjectionFilter<TInputImage, TOutputImage>::DynamicThreadedGenerateDat
       const double numpart1 = sdd * (cosa + tana * sina);
       const double sddtana = sdd * tana;
 
-      for (unsigned int j = 0; j < outputRegionForThread.GetSize(1); j++, point[1] += pointIncrement[1])
+      double x = pointBase[0] + m_Geometry->GetProjectionOffsetsX()[k] + tana * RD;
+      for (unsigned int i = 0; i < nColumns; i++, x += pointIncrement[0])
       {
-        point[0] = pointBase[0] + m_Geometry->GetProjectionOffsetsX()[k] + tana * RD;
-        const double sdd2y2 = sdd2 + point[1] * point[1];
-        for (unsigned int i = 0; i < outputRegionForThread.GetSize(0); i++, ++itI, ++itO, point[0] += pointIncrement[0])
-        {
-          const double denom = sqrt(sdd2y2 + pow(point[0] - sddtana, 2.));
-          const double cosGamma = (numpart1 - point[0] * sina) / denom;
-          itO.Set(itI.Get() * m_ConstantProjectionFactor[k] * cosGamma);
-        }
+        columnFactors[i] *= numpart1 - x * sina;
+        columnTerms[i] = (x - sddtana) * (x - sddtana);
       }
+      double y = pointBase[1] + m_Geometry->GetProjectionOffsetsY()[k] - m_Geometry->GetSourceOffsetsY()[k];
+      for (unsigned int j = 0; j < rowTerms.size(); j++, y += pointIncrement[1])
+        rowTerms[j] = sdd2 + y * y;
     }
     else // Parallel
     {
-      double weight = m_ConstantProjectionFactor[k];
-      for (unsigned int j = 0; j < outputRegionForThread.GetSize(1); j++)
-      {
-        for (unsigned int i = 0; i < outputRegionForThread.GetSize(0); i++, ++itI, ++itO)
-          itO.Set(itI.Get() * weight);
-      }
+      std::fill(columnTerms.begin(), columnTerms.end(), 0.);
+      std::fill(rowTerms.begin(), rowTerms.end(), 1.);
+    }
+
+    for (unsigned int j = 0; j < rowTerms.size(); j++)
+    {
+      unsigned int i = 0;
+      for (; i < iFirst; i++, ++itO)
+        itO.Set(0);
+      for (; i < iLast; i++, ++itI, ++itO)
+        itO.Set(itI.Get() * columnFactors[i] / sqrt(rowTerms[j] + columnTerms[i]));
+      for (; i < nColumns; i++, ++itO)
+        itO.Set(0);
     }
   }
 }
@@ -139,6 +139,11 @@ protected:
    */
   virtual FFTInputImagePointer
   PadInputImageRegion(const RegionType & inputRegion);
+
+  /** Same as PadInputImageRegion but in paddedImage, whose buffer is reused if
+   * it is already large enough. */
+  void
+  PadInputImageRegionInto(const RegionType & inputRegion, FFTInputImageType * paddedImage);
   RegionType
   GetPaddedImageRegion(const RegionType & inputRegion);
 
@@ -203,12 +203,22 @@ template <class TInputImage, class TOutputImage, class TFFTPrecision>
 typename FFTProjectionsConvolutionImageFilter<TInputImage, TOutputImage, TFFTPrecision>::FFTInputImagePointer
 FFTProjectionsConvolutionImageFilter<TInputImage, TOutputImage, TFFTPrecision>::PadInputImageRegion(
   const RegionType & inputRegion)
+{
+  // Create padded image (spacing and origin do not matter)
+  FFTInputImagePointer paddedImage = FFTInputImageType::New();
+  PadInputImageRegionInto(inputRegion, paddedImage);
+  return paddedImage;
+}
+
+template <class TInputImage, class TOutputImage, class TFFTPrecision>
+void
+FFTProjectionsConvolutionImageFilter<TInputImage, TOutputImage, TFFTPrecision>::PadInputImageRegionInto(
+  const RegionType &  inputRegion,
+  FFTInputImageType * paddedImage)
 {
   UpdateTruncationMirrorWeights();
   RegionType paddedRegion = GetPaddedImageRegion(inputRegion);
 
-  // Create padded image (spacing and origin do not matter)
-  FFTInputImagePointer paddedImage = FFTInputImageType::New();
   paddedImage->SetRegions(paddedRegion);
   paddedImage->Allocate();
   paddedImage->FillBuffer(0);
@@ -272,8 +282,7 @@ FFTProjectionsConvolutionImageFilter<TInputImage, TOutputImage, TFFTPrecision>::
     ++itS;
     ++itD;
   }
-
-  return paddedImage;
+  paddedImage->Modified();
 }
 
 template <class TInputImage, class TOutputImage, class TFFTPrecision>
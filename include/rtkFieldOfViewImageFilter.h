@@ -38,6 +38,12 @@ namespace rtk
  * InPlaneAngle. The rest is accounted for but the fov is assumed to be
  * cylindrical.
  *
+ * When the volume has the identity direction, the range of y indices in the
+ * field of view is computed once per column of voxels parallel to the y axis
+ * and the output is written by runs of consecutive voxels along x. These runs
+ * are available with GetRuns after an update so that downstream filters can
+ * skip the voxels outside the field of view.
+ *
  * \test rtkfovtest.cxx, rtkfdktest.cxx, rtkmotioncompensatedfdktest.cxx
  *
  * \author Marc Vila
@@ -63,6 +69,15 @@ public:
   using GeometryConstPointer = typename GeometryType::ConstPointer;
   using FOVRadiusType = enum { RADIUSINF, RADIUSSUP, RADIUSBOTH };
 
+  /** Run of Length consecutive voxels in the field of view along x, starting
+   * at Index. */
+  struct RunType
+  {
+    typename TOutputImage::IndexType Index;
+    itk::SizeValueType               Length;
+  };
+  using RunsType = std::vector<RunType>;
+
 
   /** Method for creation through the object factory. */
   itkNewMacro(Self);
@@ -118,6 +133,13 @@ public:
   void
   AddCollimationConstraints(const FOVRadiusType type, _lprec * lp);
 
+  /** Run-length encoding of the field of view in region, ordered by row. It
+   * is only available after an update of the filter with a volume of identity
+   * direction and for a region inside the requested region of that update,
+   * the returned vector is empty otherwise. */
+  RunsType
+  GetRuns(const OutputImageRegionType & region) const;
+
 protected:
   FieldOfViewImageFilter();
   ~FieldOfViewImageFilter() override = default;
@@ -148,6 +170,11 @@ private:
   bool                    m_DisplacedDetector{ false };
   double                  m_InsideValue{ 1. };
   double                  m_OutsideValue{ 0. };
+
+  /** First and last y indices in the field of view of each column of voxels
+   * of m_ColumnsRegion, x being the fastest index */
+  std::vector<std::pair<itk::IndexValueType, itk::IndexValueType>> m_Columns;
+  OutputImageRegionType                                            m_ColumnsRegion;
 };
 
 } // end namespace rtk
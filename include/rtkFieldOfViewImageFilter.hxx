@@ -25,6 +25,8 @@
 #include <itkImageRegionConstIterator.h>
 #include <itkImageRegionConstIteratorWithIndex.h>
 
+#include <algorithm>
+
 #include "lp_lib.h"
 
 #include "rtkProjectionsReader.h"
@@ -269,6 +271,102 @@ FieldOfViewImageFilter<TInputImage, TOutputImage>::BeforeThreadedGenerateData()
         m_HatTangentSup = 0.;
     }
   }
+
+  // With the identity direction, the field of view is, for each column of
+  // voxels parallel to the y axis, a range of y indices which only depends on
+  // the distance of the column to the center
+  m_Columns.clear();
+  const typename TInputImage::DirectionType d = this->GetInput()->GetDirection();
+  if (d[0][0] == 1. && d[0][1] == 0. && d[0][2] == 0. && d[1][0] == 0. && d[1][1] == 1. && d[1][2] == 0. &&
+      d[2][0] == 0. && d[2][1] == 0. && d[2][2] == 1.)
+  {
+    m_ColumnsRegion = this->GetOutput()->GetRequestedRegion();
+    m_Columns.resize(m_ColumnsRegion.GetSize(0) * m_ColumnsRegion.GetSize(2));
+    const typename TOutputImage::PointType   origin = this->GetInput()->GetOrigin();
+    const typename TOutputImage::SpacingType spacing = this->GetInput()->GetSpacing();
+    const itk::IndexValueType                jFirst = m_ColumnsRegion.GetIndex(1);
+    const itk::IndexValueType                jLast = jFirst + m_ColumnsRegion.GetSize(1) - 1;
+    auto                                     column = m_Columns.begin();
+    for (unsigned int k = 0; k < m_ColumnsRegion.GetSize(2); k++)
+    {
+      const double z = origin[2] + spacing[2] * (m_ColumnsRegion.GetIndex(2) + k);
+      for (unsigned int i = 0; i < m_ColumnsRegion.GetSize(0); i++, ++column)
+      {
+        const double x = origin[0] + spacing[0] * (m_ColumnsRegion.GetIndex(0) + i);
+        const double radius = std::sqrt((m_CenterX - x) * (m_CenterX - x) + (m_CenterZ - z) * (m_CenterZ - z));
+        auto         inside = [&](itk::IndexValueType j) {
+          const double y = origin[1] + spacing[1] * j;
+          return radius <= m_Radius && radius * m_HatTangentInf >= m_HatHeightInf - y &&
+                 radius * m_HatTangentSup <= m_HatHeightSup - y;
+        };
+
+        // Empty range by default
+        column->first = jLast + 1;
+        column->second = jLast;
+        if (radius > m_Radius)
+          continue;
+
+        // Closed form bounds, then corrected for rounding with the predicate
+        const double yInf = m_HatHeightInf - radius * m_HatTangentInf;
+        const double ySup = m_HatHeightSup - radius * m_HatTangentSup;
+        auto jInf =
+          static_cast<itk::IndexValueType>(std::max<double>(jFirst, std::ceil((yInf - origin[1]) / spacing[1])));
+        auto jSup =
+          static_cast<itk::IndexValueType>(std::min<double>(jLast, std::floor((ySup - origin[1]) / spacing[1])));
+        while (jInf <= jSup && !inside(jInf))
+          jInf++;
+        while (jInf > jFirst && inside(jInf - 1))
+          jInf--;
+        while (jSup >= jInf && !inside(jSup))
+          jSup--;
+        while (jSup < jLast && jSup >= jInf && inside(jSup + 1))
+          jSup++;
+        if (jInf <= jSup)
+        {
+          column->first = jInf;
+          column->second = jSup;
+        }
+      }
+    }
+  }
+}
+
+template <class TInputImage, class TOutputImage>
+typename FieldOfViewImageFilter<TInputImage, TOutputImage>::RunsType
+FieldOfViewImageFilter<TInputImage, TOutputImage>::GetRuns(const OutputImageRegionType & region) const
+{
+  RunsType runs;
+  if (m_Columns.empty() || !m_ColumnsRegion.IsInside(region))
+    return runs;
+
+  for (unsigned int k = 0; k < region.GetSize(2); k++)
+    for (unsigned int j = 0; j < region.GetSize(1); j++)
+    {
+      RunType run;
+      run.Index = region.GetIndex();
+      run.Index[1] += j;
+      run.Index[2] += k;
+      run.Length = 0;
+      const auto * column = &(m_Columns[region.GetIndex(0) - m_ColumnsRegion.GetIndex(0) +
+                                        (run.Index[2] - m_ColumnsRegion.GetIndex(2)) * m_ColumnsRegion.GetSize(0)]);
+      for (unsigned int i = 0; i < region.GetSize(0); i++, column++)
+      {
+        if (column->first <= run.Index[1] && run.Index[1] <= column->second)
+        {
+          if (run.Length == 0)
+            run.Index[0] = region.GetIndex(0) + i;
+          run.Length++;
+        }
+        else if (run.Length)
+        {
+          runs.push_back(run);
+          run.Length = 0;
+        }
+      }
+      if (run.Length)
+        runs.push_back(run);
+    }
+  return runs;
 }
 
 template <class TInputImage, class TOutputImage>
@@ -276,62 +374,37 @@ void
 FieldOfViewImageFilter<TInputImage, TOutputImage>::DynamicThreadedGenerateData(
   const OutputImageRegionType & outputRegionForThread)
 {
-  typename TInputImage::DirectionType d = this->GetInput()->GetDirection();
-  if (d[0][0] == 1. && d[0][1] == 0. && d[0][2] == 0. && d[1][0] == 0. && d[1][1] == 1. && d[1][2] == 0. &&
-      d[2][0] == 0. && d[2][1] == 0. && d[2][2] == 1.)
-
+  if (!m_Columns.empty())
   {
-    // Prepare point increment (TransformIndexToPhysicalPoint too slow)
-    typename TInputImage::PointType pointBase, pointIncrement;
-    typename TInputImage::IndexType index = outputRegionForThread.GetIndex();
-    this->GetInput()->TransformIndexToPhysicalPoint(index, pointBase);
-    for (unsigned int i = 0; i < TInputImage::GetImageDimension(); i++)
-      index[i]++;
-    this->GetInput()->TransformIndexToPhysicalPoint(index, pointIncrement);
-    for (unsigned int i = 0; i < TInputImage::GetImageDimension(); i++)
-      pointIncrement[i] -= pointBase[i];
-
-    // Iterators
-    using InputConstIterator = itk::ImageRegionConstIterator<TInputImage>;
-    InputConstIterator itIn(this->GetInput(0), outputRegionForThread);
-    itIn.GoToBegin();
-    using OutputIterator = itk::ImageRegionIterator<TOutputImage>;
-    OutputIterator itOut(this->GetOutput(), outputRegionForThread);
-    itOut.GoToBegin();
-
-    // Go over output, compute weights and avoid redundant computation
-    typename TInputImage::PointType point = pointBase;
+    // Fill the runs of each row, the outside values between them
+    const RunsType               runs = this->GetRuns(outputRegionForThread);
+    typename RunsType::size_type r = 0;
+    const itk::SizeValueType     nx = outputRegionForThread.GetSize(0);
     for (unsigned int k = 0; k < outputRegionForThread.GetSize(2); k++)
-    {
-      double zsquare = m_CenterZ - point[2];
-      zsquare *= zsquare;
-      point[1] = pointBase[1];
       for (unsigned int j = 0; j < outputRegionForThread.GetSize(1); j++)
       {
-        point[0] = pointBase[0];
-        for (unsigned int i = 0; i < outputRegionForThread.GetSize(0); i++)
+        typename TOutputImage::IndexType rowIndex = outputRegionForThread.GetIndex();
+        rowIndex[1] += j;
+        rowIndex[2] += k;
+        typename TOutputImage::PixelType * out =
+          this->GetOutput()->GetBufferPointer() + this->GetOutput()->ComputeOffset(rowIndex);
+        const typename TInputImage::PixelType * in =
+          this->GetInput()->GetBufferPointer() + this->GetInput()->ComputeOffset(rowIndex);
+        itk::SizeValueType i = 0;
+        for (; r < runs.size() && runs[r].Index[1] == rowIndex[1] && runs[r].Index[2] == rowIndex[2]; r++)
         {
-          double xsquare = m_CenterX - point[0];
-          xsquare *= xsquare;
-          double radius = std::sqrt(xsquare + zsquare);
-          if (radius <= m_Radius && radius * m_HatTangentInf >= m_HatHeightInf - point[1] &&
-              radius * m_HatTangentSup <= m_HatHeightSup - point[1])
-          {
-            if (m_Mask)
-              itOut.Set(this->m_InsideValue);
-            else
-              itOut.Set(itIn.Get());
-          }
-          else
-            itOut.Set(this->m_OutsideValue);
-          ++itIn;
-          ++itOut;
-          point[0] += pointIncrement[0];
+          const itk::SizeValueType begin = runs[r].Index[0] - rowIndex[0];
+          std::fill(out + i, out + begin, static_cast<typename TOutputImage::PixelType>(m_OutsideValue));
+          if (m_Mask)
+            std::fill(out + begin,
+                      out + begin + runs[r].Length,
+                      static_cast<typename TOutputImage::PixelType>(m_InsideValue));
+          else if (!this->GetRunningInPlace())
+            std::copy(in + begin, in + begin + runs[r].Length, out + begin);
+          i = begin + runs[r].Length;
         }
-        point[1] += pointIncrement[1];
+        std::fill(out + i, out + nx, static_cast<typename TOutputImage::PixelType>(m_OutsideValue));
       }
-      point[2] += pointIncrement[2];
-    }
   }
   else
   {
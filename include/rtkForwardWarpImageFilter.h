@@ -32,6 +32,11 @@ namespace rtk
  * Deforms an image using a Displacement Vector Field. Adjoint operator
  * of the itkWarpImageFilter
  *
+ * The splat is multithreaded without locks: the input is split in chunks
+ * along its last dimension, each chunk splats in private slices of the
+ * output, and the slices are reduced and normalized by the splat weights
+ * in a single parallel pass.
+ *
  * \test rtkfourdroostertest
  *
  * \author Cyril Mory
@@ -28,6 +28,9 @@
 #include <itkLinearInterpolateImageFunction.h>
 #include <itkMacro.h>
 
+#include <algorithm>
+#include <vector>
+
 namespace rtk
 {
 
@@ -137,6 +140,9 @@ template <class TInputImage, class TOutputImage, class TDVF>
 void
 ForwardWarpImageFilter<TInputImage, TOutputImage, TDVF>::GenerateData()
 {
+  constexpr unsigned int Dimension = TInputImage::ImageDimension;
+  using OutputPixelType = typename TOutputImage::PixelType;
+
   Superclass::BeforeThreadedGenerateData();
   const DisplacementFieldType * fieldPtr = this->GetDisplacementField();
 
@@ -150,161 +156,224 @@ ForwardWarpImageFilter<TInputImage, TOutputImage, TDVF>::GenerateData()
   typename Superclass::InputImageConstPointer inputPtr = this->GetInput();
   typename Superclass::OutputImagePointer     outputPtr = this->GetOutput();
 
-  outputPtr->SetRegions(outputPtr->GetRequestedRegion());
+  const typename TOutputImage::RegionType outputRegion = outputPtr->GetRequestedRegion();
+  outputPtr->SetRegions(outputRegion);
   outputPtr->Allocate();
-  outputPtr->FillBuffer(0);
 
   // Allocate an image with the same metadata as the output
   // to accumulate the weights during splat, and divide by the total weights at the end
   typename TOutputImage::Pointer accumulate = TOutputImage::New();
-  accumulate->SetRegions(outputPtr->GetRequestedRegion());
+  accumulate->SetRegions(outputRegion);
   accumulate->Allocate();
-  accumulate->FillBuffer(0);
-
-  // iterator for the output image
-  itk::ImageRegionConstIteratorWithIndex<TOutputImage>       inputIt(inputPtr, inputPtr->GetBufferedRegion());
-  itk::ImageRegionConstIterator<const DisplacementFieldType> fieldIt(fieldPtr, fieldPtr->GetBufferedRegion());
-  typename TOutputImage::IndexType                           index;
-  typename TOutputImage::IndexType                           baseIndex;
-  typename TOutputImage::IndexType                           neighIndex;
-  double                                                     distance[TInputImage::ImageDimension];
-  typename TOutputImage::PointType                           point;
-  typename Superclass::DisplacementType                      displacement;
-  itk::NumericTraits<typename Superclass::DisplacementType>::SetLength(displacement, TInputImage::ImageDimension);
-
-  unsigned int numNeighbors(1 << TInputImage::ImageDimension);
 
   // There is a bug in the ITK WarpImageFilter: m_DefFieldSizeSame
   // is computed without taking origin, spacing and direction into
   // account. So we perform a more thorough comparison between
   // output and DVF than in itkWarpImageFilter::BeforeThreadedGenerateData()
-  bool skipEvaluateDisplacementAtContinuousIndex =
+  const bool skipEvaluateDisplacementAtContinuousIndex =
     ((outputPtr->GetLargestPossibleRegion() == this->GetDisplacementField()->GetLargestPossibleRegion()) &&
      (outputPtr->GetSpacing() == this->GetDisplacementField()->GetSpacing()) &&
      (outputPtr->GetOrigin() == this->GetDisplacementField()->GetOrigin()) &&
-     (outputPtr->GetDirection() == this->GetDisplacementField()->GetDirection()));
-
-  while (!inputIt.IsAtEnd())
-  {
-    // get the input image index
-    index = inputIt.GetIndex();
-    inputPtr->TransformIndexToPhysicalPoint(index, point);
-
-    if (skipEvaluateDisplacementAtContinuousIndex)
-      displacement = fieldIt.Get();
-    else
-      this->Protected_EvaluateDisplacementAtPhysicalPoint(point, displacement);
-
-    for (unsigned int j = 0; j < TInputImage::ImageDimension; j++)
-      point[j] += displacement[j];
-
-    itk::ContinuousIndex<double, TInputImage::ImageDimension> continuousIndexInOutput;
-    outputPtr->TransformPhysicalPointToContinuousIndex(point, continuousIndexInOutput);
+     (outputPtr->GetDirection() == this->GetDisplacementField()->GetDirection()) &&
+     fieldPtr->GetBufferedRegion().IsInside(inputPtr->GetBufferedRegion()));
+
+  // The splat is multithreaded without lock by splitting the input along its
+  // last dimension in chunks. Each chunk splats in its own buffers, one per
+  // output slice along the last dimension, which are allocated the first
+  // time the slice is hit. With smooth displacements, each chunk therefore
+  // only allocates the slices facing it plus a few slices on its borders.
+  const typename TInputImage::RegionType inputRegion = inputPtr->GetBufferedRegion();
+  const unsigned int                     nInputSlices = inputRegion.GetSize(Dimension - 1);
+  const unsigned int                     nChunks = std::max(1u, std::min(nInputSlices, this->GetNumberOfWorkUnits()));
+  const unsigned int                     nOutputSlices = outputRegion.GetSize(Dimension - 1);
+  const itk::SizeValueType               sliceSize = outputRegion.GetNumberOfPixels() / std::max(1u, nOutputSlices);
+
+  // Splat buffers, per chunk and per output slice
+  std::vector<std::vector<std::vector<OutputPixelType>>> chunkValues(nChunks);
+  std::vector<std::vector<std::vector<OutputPixelType>>> chunkWeights(nChunks);
+
+  this->GetMultiThreader()->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    nChunks,
+    [&](itk::SizeValueType chunk) {
+      std::vector<std::vector<OutputPixelType>> & values = chunkValues[chunk];
+      std::vector<std::vector<OutputPixelType>> & weights = chunkWeights[chunk];
+      values.resize(nOutputSlices);
+      weights.resize(nOutputSlices);
+
+      typename TInputImage::RegionType chunkRegion = inputRegion;
+      const unsigned int               firstSlice = chunk * nInputSlices / nChunks;
+      chunkRegion.SetIndex(Dimension - 1, inputRegion.GetIndex(Dimension - 1) + firstSlice);
+      chunkRegion.SetSize(Dimension - 1, (chunk + 1) * nInputSlices / nChunks - firstSlice);
+
+      itk::ImageRegionConstIteratorWithIndex<TInputImage> inputIt(inputPtr, chunkRegion);
+      itk::ImageRegionConstIterator<DisplacementFieldType> fieldIt;
+      if (skipEvaluateDisplacementAtContinuousIndex)
+        fieldIt = itk::ImageRegionConstIterator<DisplacementFieldType>(fieldPtr, chunkRegion);
+
+      typename TOutputImage::IndexType      baseIndex;
+      typename TOutputImage::IndexType      neighIndex;
+      double                                distance[Dimension];
+      typename TOutputImage::PointType      point;
+      typename Superclass::DisplacementType displacement;
+      itk::NumericTraits<typename Superclass::DisplacementType>::SetLength(displacement, Dimension);
+      itk::ContinuousIndex<double, Dimension> continuousIndexInOutput;
+      const unsigned int                      numNeighbors(1 << Dimension);
+
+      for (; !inputIt.IsAtEnd(); ++inputIt)
+      {
+        // get the input image index
+        inputPtr->TransformIndexToPhysicalPoint(inputIt.GetIndex(), point);
 
-    // compute the base index in output, ie the closest index below point
-    // Check if the baseIndex is in the output's requested region, otherwise skip the splat part
-    bool skip = false;
+        if (skipEvaluateDisplacementAtContinuousIndex)
+        {
+          displacement = fieldIt.Get();
+          ++fieldIt;
+        }
+        else
+          this->Protected_EvaluateDisplacementAtPhysicalPoint(point, displacement);
 
-    for (unsigned int j = 0; j < TInputImage::ImageDimension; j++)
-    {
-      baseIndex[j] = itk::Math::Floor<int, double>(continuousIndexInOutput[j]);
-      distance[j] = continuousIndexInOutput[j] - static_cast<double>(baseIndex[j]);
-      if ((baseIndex[j] < outputPtr->GetRequestedRegion().GetIndex()[j] - 1) ||
-          (baseIndex[j] >=
-           outputPtr->GetRequestedRegion().GetIndex()[j] + (int)outputPtr->GetRequestedRegion().GetSize()[j]))
-        skip = true;
-    }
+        for (unsigned int j = 0; j < Dimension; j++)
+          point[j] += displacement[j];
+        outputPtr->TransformPhysicalPointToContinuousIndex(point, continuousIndexInOutput);
 
-    if (!skip)
-    {
-      // get the splat weights as the overlapping areas between
-      for (unsigned int counter = 0; counter < numNeighbors; counter++)
-      {
-        double       overlap = 1.0;   // fraction overlap
-        unsigned int upper = counter; // each bit indicates upper/lower neighbour
+        // compute the base index in output, ie the closest index below point
+        // Check if the baseIndex is in the output's requested region, otherwise skip the splat part
+        bool skip = false;
+        for (unsigned int j = 0; j < Dimension; j++)
+        {
+          baseIndex[j] = itk::Math::Floor<int, double>(continuousIndexInOutput[j]);
+          distance[j] = continuousIndexInOutput[j] - static_cast<double>(baseIndex[j]);
+          if ((baseIndex[j] < outputRegion.GetIndex()[j] - 1) ||
+              (baseIndex[j] >= outputRegion.GetIndex()[j] + (int)outputRegion.GetSize()[j]))
+            skip = true;
+        }
+        if (skip)
+          continue;
 
-        // get neighbor weights as the fraction of overlap
-        // of the neighbor pixels with a pixel centered on point
-        for (unsigned int dim = 0; dim < TInputImage::ImageDimension; dim++)
+        // get the splat weights as the overlapping areas between
+        for (unsigned int counter = 0; counter < numNeighbors; counter++)
         {
-          if (upper & 1)
+          double       overlap = 1.0;   // fraction overlap
+          unsigned int upper = counter; // each bit indicates upper/lower neighbour
+
+          // get neighbor weights as the fraction of overlap
+          // of the neighbor pixels with a pixel centered on point
+          for (unsigned int dim = 0; dim < Dimension; dim++)
           {
-            neighIndex[dim] = baseIndex[dim] + 1;
-            overlap *= distance[dim];
+            if (upper & 1)
+            {
+              neighIndex[dim] = baseIndex[dim] + 1;
+              overlap *= distance[dim];
+            }
+            else
+            {
+              neighIndex[dim] = baseIndex[dim];
+              overlap *= 1.0 - distance[dim];
+            }
+
+            upper >>= 1;
           }
-          else
+
+          if (outputRegion.IsInside(neighIndex))
           {
-            neighIndex[dim] = baseIndex[dim];
-            overlap *= 1.0 - distance[dim];
+            // Perform splat with this weight, both in the values and in the
+            // weights of the slice of this chunk
+            const itk::OffsetValueType offset = outputPtr->ComputeOffset(neighIndex);
+            const itk::OffsetValueType slice = offset / sliceSize;
+            if (values[slice].empty())
+            {
+              values[slice].assign(sliceSize, 0);
+              weights[slice].assign(sliceSize, 0);
+            }
+            values[slice][offset - slice * sliceSize] += overlap * inputIt.Get();
+            weights[slice][offset - slice * sliceSize] += overlap;
           }
-
-          upper >>= 1;
         }
-
-        if (outputPtr->GetRequestedRegion().IsInside(neighIndex))
+      }
+    },
+    nullptr);
+
+  // Reduce the chunks slice by slice and divide the output by the accumulated
+  // weights, if they are non-zero, in the same pass
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    nOutputSlices,
+    [&](itk::SizeValueType slice) {
+      OutputPixelType * out = outputPtr->GetBufferPointer() + slice * sliceSize;
+      OutputPixelType * acc = accumulate->GetBufferPointer() + slice * sliceSize;
+      std::fill(out, out + sliceSize, 0);
+      std::fill(acc, acc + sliceSize, 0);
+      for (unsigned int chunk = 0; chunk < nChunks; chunk++)
+      {
+        if (chunkValues[chunk].empty() || chunkValues[chunk][slice].empty())
+          continue;
+        const OutputPixelType * values = chunkValues[chunk][slice].data();
+        const OutputPixelType * weights = chunkWeights[chunk][slice].data();
+        for (itk::SizeValueType i = 0; i < sliceSize; i++)
         {
-          // Perform splat with this weight, both in output and in the temporary
-          // image that accumulates weights
-          outputPtr->SetPixel(neighIndex, outputPtr->GetPixel(neighIndex) + overlap * inputIt.Get());
-          accumulate->SetPixel(neighIndex, accumulate->GetPixel(neighIndex) + overlap);
+          out[i] += values[i];
+          acc[i] += weights[i];
         }
+        std::vector<OutputPixelType>().swap(chunkValues[chunk][slice]);
+        std::vector<OutputPixelType>().swap(chunkWeights[chunk][slice]);
       }
-    }
-
-    ++inputIt;
-    ++fieldIt;
-  }
-
-  // Divide the output by the accumulated weights, if they are non-zero
-  itk::ImageRegionIterator<TOutputImage> outputIt(outputPtr, outputPtr->GetRequestedRegion());
-  itk::ImageRegionIterator<TOutputImage> accIt(accumulate, outputPtr->GetRequestedRegion());
-  while (!outputIt.IsAtEnd())
-  {
-    if (accIt.Get())
-      outputIt.Set(outputIt.Get() / accIt.Get());
-
-    ++outputIt;
-    ++accIt;
-  }
-
-  // Replace the holes with the weighted mean of their neighbors
+      for (itk::SizeValueType i = 0; i < sliceSize; i++)
+        if (acc[i])
+          out[i] /= acc[i];
+    },
+    nullptr);
+
+  // Replace the holes with the weighted mean of their neighbors. Only the
+  // holes are written and only the non-holes are read, so the work units
+  // do not interfere.
   itk::Size<TOutputImage::ImageDimension> radius;
   radius.Fill(3);
   unsigned int pixelsInNeighborhood = 1;
   for (unsigned int dim = 0; dim < TOutputImage::ImageDimension; dim++)
     pixelsInNeighborhood *= 2 * radius[dim] + 1;
 
-  itk::NeighborhoodIterator<TOutputImage> outputIt2(radius, outputPtr, outputPtr->GetRequestedRegion());
-  itk::NeighborhoodIterator<TOutputImage> accIt2(radius, accumulate, outputPtr->GetRequestedRegion());
+  this->GetMultiThreader()->template ParallelizeImageRegion<TOutputImage::ImageDimension>(
+    outputRegion,
+    [&](const typename TOutputImage::RegionType & outputRegionForThread) {
+      itk::NeighborhoodIterator<TOutputImage> outputIt2(radius, outputPtr, outputRegionForThread);
+      itk::NeighborhoodIterator<TOutputImage> accIt2(radius, accumulate, outputRegionForThread);
 
-  itk::ZeroFluxNeumannBoundaryCondition<TInputImage> zeroFlux;
-  outputIt2.OverrideBoundaryCondition(&zeroFlux);
+      itk::ZeroFluxNeumannBoundaryCondition<TInputImage> zeroFlux;
+      outputIt2.OverrideBoundaryCondition(&zeroFlux);
 
-  itk::ConstantBoundaryCondition<TInputImage> constant;
-  accIt2.OverrideBoundaryCondition(&constant);
+      itk::ConstantBoundaryCondition<TInputImage> constant;
+      accIt2.OverrideBoundaryCondition(&constant);
 
-  while (!outputIt2.IsAtEnd())
-  {
-    if (!accIt2.GetCenterPixel())
-    {
-      // Compute the mean of the neighboring pixels, weighted by the accumulated weights
-      typename TOutputImage::PixelType value = 0;
-      typename TOutputImage::PixelType weight = 0;
-      for (unsigned int idx = 0; idx < pixelsInNeighborhood; idx++)
+      while (!outputIt2.IsAtEnd())
       {
-        value += accIt2.GetPixel(idx) * outputIt2.GetPixel(idx);
-        weight += accIt2.GetPixel(idx);
-      }
+        if (!accIt2.GetCenterPixel())
+        {
+          // Compute the mean of the neighboring pixels, weighted by the accumulated weights
+          OutputPixelType value = 0;
+          OutputPixelType weight = 0;
+          for (unsigned int idx = 0; idx < pixelsInNeighborhood; idx++)
+          {
+            const OutputPixelType w = accIt2.GetPixel(idx);
+            if (w)
+            {
+              value += w * outputIt2.GetPixel(idx);
+              weight += w;
+            }
+          }
 
-      // Replace the hole with this value, or zero (if all surrounding pixels were holes)
-      if (weight)
-        outputIt2.SetCenterPixel(value / weight);
-      else
-        outputIt2.SetCenterPixel(0);
-    }
-    ++outputIt2;
-    ++accIt2;
-  }
+          // Replace the hole with this value, or zero (if all surrounding pixels were holes)
+          if (weight)
+            outputIt2.SetCenterPixel(value / weight);
+          else
+            outputIt2.SetCenterPixel(0);
+        }
+        ++outputIt2;
+        ++accIt2;
+      }
+    },
+    nullptr);
 
   Superclass::AfterThreadedGenerateData();
 }
@@ -151,6 +151,11 @@ public:
   itkGetMacro(CudaConjugateGradient, bool);
   itkSetMacro(CudaConjugateGradient, bool);
 
+  /** Get / Set the precision of the storage of the 4D residual of the CPU
+   * conjugate gradient, see ConjugateGradientImageFilter. Default is FLOAT32. */
+  itkGetMacro(StoragePrecision, typename ConjugateGradientFilterType::StoragePrecisionType);
+  itkSetMacro(StoragePrecision, typename ConjugateGradientFilterType::StoragePrecisionType);
+
   /** Set/Get the 4D image to be updated.*/
   void
   SetInputVolumeSeries(const VolumeSeriesType * VolumeSeries);
@@ -221,10 +226,19 @@ private:
   /** Number of conjugate gradient descent iterations */
   unsigned int m_NumberOfIterations;
 
+  typename ConjugateGradientFilterType::StoragePrecisionType m_StoragePrecision{ ReducedPrecisionConverter::FLOAT32 };
+
   /** Iteration reporter */
   void
   ReportProgress(itk::Object *, const itk::EventObject &);
 
+  /** Norm of the residual of the normal equations, b - Ax. */
+  double
+  GetTelemetryResidualNorm() override
+  {
+    return m_ConjugateGradientFilter->GetResidualNorm();
+  }
+
 }; // end of class
 
 } // end namespace rtk
@@ -150,6 +150,7 @@ FourDConjugateGradientConeBeamReconstructionFilter<VolumeSeriesType, ProjectionS
 
   // Set runtime parameters
   m_ConjugateGradientFilter->SetNumberOfIterations(this->m_NumberOfIterations);
+  m_ConjugateGradientFilter->SetStoragePrecision(m_StoragePrecision);
   m_DisplacedDetectorFilter->SetDisable(m_DisableDisplacedDetectorFilter);
   m_CGOperator->SetDisableDisplacedDetectorFilter(m_DisableDisplacedDetectorFilter);
 
@@ -242,6 +243,8 @@ FourDConjugateGradientConeBeamReconstructionFilter<VolumeSeriesType, ProjectionS
     {
       this->GraftOutput(cgCaller->GetOutput());
       m_IterationReporter.CompletedStep();
+      if (this->GetTelemetryStopRequested())
+        cgCaller->StopIterations();
     }
   }
 }
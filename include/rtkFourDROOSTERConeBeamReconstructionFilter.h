@@ -196,6 +196,11 @@ namespace rtk
  * }
  * \enddot
  *
+ * The predicted memory peak of the MemoryPlanner is the one of the first main
+ * loop iteration. The next iterations also hold the output of the previous
+ * one, which is fed back to the conjugate gradient, i.e., one more volume
+ * series.
+ *
  * \test rtkfourdroostertest.cxx
  *
  * \author Cyril Mory
@@ -77,9 +77,19 @@ FourDROOSTERConeBeamReconstructionFilter<VolumeSeriesType,
   m_AddFilter = AddFilterType::New();
   m_L0DenoisingTime = TemporalL0DenoisingFilterType::New();
   m_TNVDenoising = TNVDenoisingFilterType::New();
+  this->WatchTelemetrySection(m_TVDenoisingTime, IterationTelemetry::REGULARIZATION);
+  this->WatchTelemetrySection(m_TVDenoisingSpace, IterationTelemetry::REGULARIZATION);
+  this->WatchTelemetrySection(m_WaveletsDenoisingSpace, IterationTelemetry::REGULARIZATION);
+  this->WatchTelemetrySection(m_L0DenoisingTime, IterationTelemetry::REGULARIZATION);
+  this->WatchTelemetrySection(m_TNVDenoising, IterationTelemetry::REGULARIZATION);
 
   // Initialize downstream filter
   m_DownstreamFilter = m_FourDCGFilter;
+
+  // Image types of the internal pipeline
+  this->m_MemoryPlanner->template RegisterImageType<VolumeSeriesType>();
+  this->m_MemoryPlanner->template RegisterImageType<VolumeType>();
+  this->m_MemoryPlanner->template RegisterImageType<DVFSequenceImageType>();
 }
 
 template <typename VolumeSeriesType, typename ProjectionStackType>
@@ -244,6 +254,7 @@ FourDROOSTERConeBeamReconstructionFilter<VolumeSeriesType, ProjectionStackType>:
   // Set projection filters
   m_FourDCGFilter->SetForwardProjectionFilter(this->m_CurrentForwardProjectionConfiguration);
   m_FourDCGFilter->SetBackProjectionFilter(this->m_CurrentBackProjectionConfiguration);
+  m_FourDCGFilter->SetTelemetry(this->GetTelemetry());
 
   // The 4D conjugate gradient filter is the only part that must be in the pipeline
   // whatever was the user wants
@@ -453,6 +464,19 @@ FourDROOSTERConeBeamReconstructionFilter<VolumeSeriesType, ProjectionStackType>:
   m_DownstreamFilter->ReleaseDataFlagOff();
   m_DownstreamFilter->UpdateOutputInformation();
 
+  // Plan the buffers of the internal pipeline. The conjugate gradient stores
+  // three volume series while it iterates. The output is disconnected and fed
+  // back to the conjugate gradient at each main loop iteration. The plan only
+  // covers the first iteration: the fed-back volume series then replaces the
+  // input volume series and adds its size to the memory peak.
+  this->m_MemoryPlanner->Initialize();
+  this->m_MemoryPlanner->SetMemoryCap(this->m_MemoryCap);
+  this->m_MemoryPlanner->AddOutput(m_DownstreamFilter->GetOutput());
+  this->m_MemoryPlanner->AddRetainedData(m_DownstreamFilter->GetOutput());
+  this->m_MemoryPlanner->AddTransientMemory(
+    m_FourDCGFilter, 3 * this->m_MemoryPlanner->GetBytes(this->GetInputVolumeSeries().GetPointer()));
+  this->m_MemoryPlanner->Plan(this);
+
   // Copy it as the output information of the composite filter
   this->GetOutput()->CopyInformation(m_DownstreamFilter->GetOutput());
 }
@@ -483,6 +507,8 @@ FourDROOSTERConeBeamReconstructionFilter<VolumeSeriesType, ProjectionStackType>:
     m_DownstreamFilter->Update();
     this->GraftOutput(m_DownstreamFilter->GetOutput());
     iterationReporter.CompletedStep();
+    if (this->GetTelemetryStopRequested())
+      break;
   }
 }
 
@@ -389,6 +389,8 @@ FourDSARTConeBeamReconstructionFilter<VolumeSeriesType, ProjectionStackType>::Ge
       }
     }
     iterationReporter.CompletedStep();
+    if (this->GetTelemetryStopRequested())
+      break;
   }
 }
 
@@ -22,6 +22,10 @@
 #include "rtkResourceProbesCollector.h"
 #include "rtkWatcherForResourceProbe.h"
 #include "RTKExport.h"
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <memory>
 #include <mutex>
 
 namespace rtk
@@ -29,6 +33,26 @@ namespace rtk
 /** \class GlobalResourceProbe
  * \brief
  *
+ * The probes of Start and Stop are aggregated per name, i.e., per class of
+ * filter for the watched filters, see Report. In tracing mode, each run of a
+ * watched filter is also recorded as an event with its instance, the run of
+ * the filter which contains it (e.g., the FDK mini-pipeline of an iterative
+ * filter), its thread, its number of work units, the number of pixels of its
+ * requested region, the memory allocated by the process during the run and
+ * the iteration of the innermost enclosing iterative filter. The events are
+ * appended without lock to a buffer per thread. The memory is read from the
+ * system at the start and at the end of the runs which are not nested in
+ * another run of the same thread, and at most every 10 ms for the nested
+ * runs, whose allocated memory may then be reported as 0. The trace can be
+ * written in the Chrome trace event format, which Perfetto and
+ * chrome://tracing read, and summarized in a CSV file with percentiles of the
+ * run times.
+ *
+ * Filters are watched if RTK is built with RTK_PROBE_EACH_FILTER or with
+ * Watch. Tracing is enabled with SetTracing or by setting the environment
+ * variables RTK_PROBE_TRACE and / or RTK_PROBE_TRACE_SUMMARY to the file
+ * names of the trace and of its summary, which are then written at exit.
+ *
  * \ingroup RTK OSSystemObjects
  * \ingroup RTK ITKCommon
  */
@@ -76,8 +100,8 @@ public:
   virtual void
   Report(std::ostream & os = std::cout) const;
 
-  /** Destroy the set of probes. New probes can be created after invoking this
-    method. */
+  /** Destroy the set of probes and the trace. New probes can be created after
+    invoking this method. No filter must be running. */
   virtual void
   Clear();
 
@@ -89,6 +113,37 @@ public:
   virtual void
   Remove(const rtk::WatcherForResourceProbe * w);
 
+  /** Set / Get the tracing mode. */
+  itkSetMacro(Tracing, bool);
+  itkGetConstMacro(Tracing, bool);
+
+  /** New identifier of a watched filter in the trace */
+  itk::SizeValueType
+  GetNewTraceInstance();
+
+  /** Record the start and the end of a run of a watched filter, and the end
+   * of an iteration of an iterative filter. These functions are called by
+   * the watchers from the thread running the filter. */
+  virtual void
+  StartTrace(itk::ProcessObject * o, itk::SizeValueType instance);
+  virtual void
+  StopTrace(itk::ProcessObject * o);
+  virtual void
+  IterationTrace(itk::ProcessObject * o);
+
+  /** Write the trace in the Chrome trace event JSON format. No filter must
+   * be running. */
+  virtual void
+  WriteChromeTrace(std::ostream & os) const;
+
+  /** Write a CSV summary of the trace with one line per class of filter:
+   * number of runs, total and self (without nested runs) times, mean,
+   * median, 90th and 99th percentiles and maximum of the run times, mean
+   * number of work units, pixels and allocated bytes. No filter must be
+   * running. */
+  virtual void
+  WriteTraceSummary(std::ostream & os) const;
+
 protected:
   GlobalResourceProbe();
   ~GlobalResourceProbe() override;
@@ -99,9 +154,30 @@ protected:
   ResourceProbesCollector                     m_ResourceProbesCollector;
   std::vector<rtk::WatcherForResourceProbe *> m_Watchers;
 
+  bool m_Tracing{ false };
+
 private:
+  struct TraceEvent;
+  struct TraceBuffer;
+
+  /** Buffer of the calling thread, created at its first call after the
+   * construction of the probe or after Clear */
+  TraceBuffer &
+  GetTraceBuffer();
+
+  /** All events sorted by start time */
+  std::vector<TraceEvent>
+  GetTraceEvents() const;
+
   static Pointer m_Instance;
   std::mutex     m_Mutex;
+
+  std::list<std::unique_ptr<TraceBuffer>> m_TraceBuffers;
+  std::atomic<itk::SizeValueType>         m_TraceCounter{ 0 };
+  std::atomic<itk::SizeValueType>         m_TraceGeneration{ 0 };
+  std::chrono::steady_clock::time_point   m_TraceOrigin;
+  std::string                             m_TraceFileName;
+  std::string                             m_TraceSummaryFileName;
 };
 } // namespace rtk
 
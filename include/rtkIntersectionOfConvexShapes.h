@@ -70,6 +70,10 @@ public:
                      ScalarType &       nearDist,
                      ScalarType &       farDist) const override;
 
+  /** See rtk::ConvexShape::ComputeBoundingBox. */
+  void
+  ComputeBoundingBox(PointType & bbMin, PointType & bbMax) const override;
+
   /** Add convex object to phantom. */
   void
   AddConvexShape(const ConvexShape * co);
@@ -0,0 +1,317 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef rtkIterationTelemetry_h
+#define rtkIterationTelemetry_h
+
+#include "RTKExport.h"
+
+#include <itkMemoryUsageObserver.h>
+#include <itkObject.h>
+#include <itkObjectFactory.h>
+
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace rtk
+{
+
+/** \brief Measures of one iteration, or of one subset of an iteration, of an
+ * iterative reconstruction filter. Times are wall-clock times in seconds since
+ * the previous record of the same kind. The numbers of projector runs are
+ * counted since the start of the reconstruction. */
+struct IterationTelemetryRecord
+{
+  std::string  Filter;
+  unsigned int Iteration{ 0 };
+  int          Subset{ -1 }; // -1 for a complete iteration
+  double       Time{ 0. };
+  double       ForwardProjectionTime{ 0. };
+  double       BackProjectionTime{ 0. };
+  double       RegularizationTime{ 0. };
+  double       ResidualNorm{ 0. };        // NaN if the filter does not compute it
+  double       MemoryHighWaterMark{ 0. }; // In bytes
+  unsigned int ForwardProjections{ 0 };
+  unsigned int BackProjections{ 0 };
+};
+
+/** \class IterationTelemetrySink
+ * \brief Abstract destination of the records of rtk::IterationTelemetry.
+ *
+ * Each record is passed to Write as soon as it is complete. Derived classes
+ * write them to FileName, or to the standard output if it is empty.
+ *
+ * \ingroup RTK
+ */
+class RTK_EXPORT IterationTelemetrySink : public itk::Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(IterationTelemetrySink);
+
+  /** Standard class type alias. */
+  using Self = IterationTelemetrySink;
+  using Superclass = itk::Object;
+  using Pointer = itk::SmartPointer<Self>;
+  using ConstPointer = itk::SmartPointer<const Self>;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(IterationTelemetrySink, itk::Object);
+
+  /** Get / Set the output file name, the standard output by default. */
+  itkGetStringMacro(FileName);
+  itkSetStringMacro(FileName);
+
+  virtual void
+  Write(const IterationTelemetryRecord & record) = 0;
+
+protected:
+  IterationTelemetrySink() = default;
+  ~IterationTelemetrySink() override = default;
+
+  /** Stream of FileName, opened at the first call. */
+  std::ostream &
+  GetStream();
+
+private:
+  std::string   m_FileName;
+  std::string   m_OpenedFileName;
+  std::ofstream m_File;
+};
+
+/** \class CSVIterationTelemetrySink
+ * \brief Writes the records of rtk::IterationTelemetry as the rows of a CSV
+ * table with a header line.
+ *
+ * \ingroup RTK
+ */
+class RTK_EXPORT CSVIterationTelemetrySink : public IterationTelemetrySink
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(CSVIterationTelemetrySink);
+
+  /** Standard class type alias. */
+  using Self = CSVIterationTelemetrySink;
+  using Superclass = IterationTelemetrySink;
+  using Pointer = itk::SmartPointer<Self>;
+  using ConstPointer = itk::SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(CSVIterationTelemetrySink, IterationTelemetrySink);
+
+  void
+  Write(const IterationTelemetryRecord & record) override;
+
+protected:
+  CSVIterationTelemetrySink() = default;
+  ~CSVIterationTelemetrySink() override = default;
+
+private:
+  bool m_HeaderWritten{ false };
+};
+
+/** \class JSONIterationTelemetrySink
+ * \brief Writes the records of rtk::IterationTelemetry as JSON lines, i.e.,
+ * one JSON object per line, which can be parsed while the reconstruction is
+ * running.
+ *
+ * \ingroup RTK
+ */
+class RTK_EXPORT JSONIterationTelemetrySink : public IterationTelemetrySink
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(JSONIterationTelemetrySink);
+
+  /** Standard class type alias. */
+  using Self = JSONIterationTelemetrySink;
+  using Superclass = IterationTelemetrySink;
+  using Pointer = itk::SmartPointer<Self>;
+  using ConstPointer = itk::SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(JSONIterationTelemetrySink, IterationTelemetrySink);
+
+  void
+  Write(const IterationTelemetryRecord & record) override;
+
+protected:
+  JSONIterationTelemetrySink() = default;
+  ~JSONIterationTelemetrySink() override = default;
+};
+
+/** \class IterationTelemetry
+ * \brief Per-iteration timing and convergence measures of iterative
+ * reconstruction filters.
+ *
+ * An IterationTelemetry is passed to an
+ * rtk::IterativeConeBeamReconstructionFilter with SetTelemetry. The filter then
+ * reports the time spent in its forward projections, back projections and
+ * regularization, the norm of its residual when it computes one and the memory
+ * high-water mark, sampled at the end of each of these steps. The runs of the
+ * forward and back projectors are also counted since they are the unit of
+ * cost to compare the convergence of algorithms or of their accelerated
+ * variants, e.g., with momentum, at equal cost. A record is
+ * created at the end of each iteration and, for the filters processing the
+ * projections by subsets (SART, OSEM), at the end of each subset. Records are
+ * stored and written to the Sink, if any.
+ *
+ * The telemetry can also stop the iterations early, at the end of an
+ * iteration, when the reconstruction has run for more than TimeBudget seconds
+ * or when the residual norm has decreased by less than
+ * ResidualPlateauTolerance (relative) over the last ResidualPlateauWindow
+ * iterations. Both criteria are disabled with their default value 0.
+ *
+ * Only the outermost iterative filter creates records when iterative filters
+ * are nested, e.g., in rtk::FourDROOSTERConeBeamReconstructionFilter, but the
+ * times of the inner filters are included.
+ *
+ * \ingroup RTK
+ */
+class RTK_EXPORT IterationTelemetry : public itk::Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(IterationTelemetry);
+
+  /** Standard class type alias. */
+  using Self = IterationTelemetry;
+  using Superclass = itk::Object;
+  using Pointer = itk::SmartPointer<Self>;
+  using ConstPointer = itk::SmartPointer<const Self>;
+  using RecordType = IterationTelemetryRecord;
+
+  /** Steps of an iteration which are timed separately. */
+  typedef enum
+  {
+    FORWARD_PROJECTION = 0,
+    BACK_PROJECTION = 1,
+    REGULARIZATION = 2
+  } SectionType;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(IterationTelemetry, itk::Object);
+
+  /** Get / Set the destination of the records. */
+  itkGetModifiableObjectMacro(Sink, IterationTelemetrySink);
+  itkSetObjectMacro(Sink, IterationTelemetrySink);
+
+  /** Get / Set the wall-clock budget in seconds, 0 (default) for none. */
+  itkGetMacro(TimeBudget, double);
+  itkSetMacro(TimeBudget, double);
+
+  /** Get / Set the relative decrease of the residual norm below which the
+   * iterations stop, 0 (default) for none. */
+  itkGetMacro(ResidualPlateauTolerance, double);
+  itkSetMacro(ResidualPlateauTolerance, double);
+
+  /** Get / Set the number of iterations over which the decrease of the
+   * residual norm is measured. Default is 3. */
+  itkGetMacro(ResidualPlateauWindow, unsigned int);
+  itkSetMacro(ResidualPlateauWindow, unsigned int);
+
+  /** Called by the reconstruction filters when they start and end. The first
+   * caller owns the telemetry until it ends, the other callers are nested. */
+  void
+  StartReconstruction(const itk::Object * filter);
+  void
+  EndReconstruction(const itk::Object * filter);
+
+  /** Called at the start and at the end of a timed step. */
+  void
+  StartSection(SectionType section);
+  void
+  EndSection(SectionType section);
+
+  /** Creates the record of a subset or of an iteration of filter, which is
+   * ignored if filter is nested. */
+  void
+  CompleteSubset(const itk::Object * filter, unsigned int iteration, unsigned int subset, double residualNorm);
+  void
+  CompleteIteration(const itk::Object * filter, unsigned int iteration, double residualNorm);
+
+  /** True when a criterion of early stop has been met. Reset by
+   * StartReconstruction. */
+  itkGetConstMacro(StopRequested, bool);
+
+  /** Description of the criterion which has stopped the iterations. */
+  itkGetStringMacro(StopReason);
+
+  /** All records since the last StartReconstruction of the owner. */
+  const std::vector<RecordType> &
+  GetRecords() const
+  {
+    return m_Records;
+  }
+
+protected:
+  IterationTelemetry() = default;
+  ~IterationTelemetry() override = default;
+
+  void
+  PrintSelf(std::ostream & os, itk::Indent indent) const override;
+
+private:
+  using ClockType = std::chrono::steady_clock;
+
+  static constexpr unsigned int NumberOfSections = 3;
+
+  struct Accumulator
+  {
+    ClockType::time_point Start;
+    double                Sections[NumberOfSections];
+  };
+
+  void
+  Complete(const itk::Object * filter, RecordType & record, Accumulator & accumulator);
+  void
+  ResetAccumulator(Accumulator & accumulator);
+  void
+  SampleMemory();
+
+  IterationTelemetrySink::Pointer m_Sink;
+  double                          m_TimeBudget{ 0. };
+  double                          m_ResidualPlateauTolerance{ 0. };
+  unsigned int                    m_ResidualPlateauWindow{ 3 };
+
+  const itk::Object *      m_Owner{ nullptr };
+  ClockType::time_point    m_ReconstructionStart;
+  ClockType::time_point    m_SectionStart[NumberOfSections];
+  unsigned int             m_SectionDepth[NumberOfSections]{};
+  unsigned int             m_SectionCount[NumberOfSections]{};
+  Accumulator              m_Subset;
+  Accumulator              m_Iteration;
+  itk::MemoryUsageObserver m_MemoryObserver;
+  double                   m_MemoryHighWaterMark{ 0. };
+  std::vector<double>      m_ResidualNorms;
+  std::vector<RecordType>  m_Records;
+  bool                     m_StopRequested{ false };
+  std::string              m_StopReason;
+};
+
+} // end namespace rtk
+
+#endif
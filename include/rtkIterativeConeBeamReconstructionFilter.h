@@ -23,6 +23,9 @@
 
 // Forward projection filters
 #include "rtkConfiguration.h"
+#include "rtkIterationTelemetry.h"
+#include "rtkMemoryPlanner.h"
+#include "rtkSensitivityImageCache.h"
 #include "rtkJosephForwardAttenuatedProjectionImageFilter.h"
 #include "rtkZengForwardProjectionImageFilter.h"
 // Back projection filters
@@ -37,6 +40,7 @@
 
 #include <random>
 #include <algorithm>
+#include <limits>
 
 namespace rtk
 {
@@ -49,6 +53,18 @@ namespace rtk
  * and/or back projection filter(s) of a IterativeConeBeamReconstructionFilter
  * at runtime
  *
+ * An rtk::IterationTelemetry can be set to record the time spent in the
+ * forward projections, back projections and regularization of each iteration
+ * and to stop the iterations early.
+ *
+ * An rtk::SensitivityImageCache can be set to reuse the data-independent
+ * normalization images of the filters which compute such images, e.g., SART
+ * and OSEM, across iterations, runs and filters.
+ *
+ * The composite filters with a large internal pipeline plan its buffers with
+ * an rtk::MemoryPlanner which reports the predicted memory peak and enforces
+ * MemoryCap.
+ *
  * \author Cyril Mory
  *
  * \ingroup RTK ReconstructionAlgorithm
@@ -113,6 +129,33 @@ public:
     return m_CurrentBackProjectionConfiguration;
   }
 
+  /** Get / Set the telemetry of the iterations, see rtk::IterationTelemetry. */
+  itkGetModifiableObjectMacro(Telemetry, IterationTelemetry);
+  itkSetObjectMacro(Telemetry, IterationTelemetry);
+
+  /** Get / Set the cache of the normalization images, see
+   * rtk::SensitivityImageCache. */
+  itkGetModifiableObjectMacro(SensitivityCache, SensitivityImageCache);
+  itkSetObjectMacro(SensitivityCache, SensitivityImageCache);
+
+  /** Get / Set the memory cap of the internal pipeline in bytes, 0 (default)
+   * for no cap. Only used by the filters which plan their memory. */
+  itkGetMacro(MemoryCap, itk::SizeValueType);
+  itkSetMacro(MemoryCap, itk::SizeValueType);
+
+  /** Memory plan of the internal pipeline, e.g., its predicted peak, after
+   * the output information has been updated. */
+  itkGetConstObjectMacro(MemoryPlanner, MemoryPlanner);
+
+  /** Sets the number of iterations of the main loop, e.g., of SART or OSEM or
+   * of the augmented Lagrangian of ADMM, for generic drivers such as
+   * rtk::MultiResolutionConeBeamReconstructionFilter. */
+  virtual void
+  SetNumberOfOuterIterations(unsigned int itkNotUsed(n))
+  {
+    itkExceptionMacro(<< "The number of iterations of " << this->GetNameOfClass() << " cannot be set generically.");
+  }
+
 protected:
   IterativeConeBeamReconstructionFilter();
   ~IterativeConeBeamReconstructionFilter() override = default;
@@ -127,11 +170,59 @@ protected:
   virtual ForwardProjectionPointerType
   InstantiateForwardProjectionFilter(int fwtype);
 
+  /** Times the runs of filter in section of the telemetry, if any. The
+   * forward and back projection filters are watched when they are created. */
+  void
+  WatchTelemetrySection(itk::Object * filter, IterationTelemetry::SectionType section);
+
+  /** Records a subset of the current iteration in the telemetry, if any. */
+  void
+  ReportTelemetrySubset(unsigned int subset, double residualNorm = std::numeric_limits<double>::quiet_NaN());
+
+  /** Residual norm of the iteration which has just been completed, reported
+   * to the telemetry. NaN by default, i.e., unknown. */
+  virtual double
+  GetTelemetryResidualNorm()
+  {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+
+  /** True if the telemetry has met a criterion of early stop. The iterations
+   * must then stop after the current one. */
+  bool
+  GetTelemetryStopRequested() const
+  {
+    return m_Telemetry.IsNotNull() && m_Telemetry->GetStopRequested();
+  }
+
+  /** True if a sensitivity cache is set and if the back projection of ones
+   * does not depend on an attenuation map. */
+  bool
+  GetUseSensitivityCache();
+
+  /** Key in the sensitivity cache of the back projection of ones, with the
+   * current back projector, of the projections of geometry with the grid of
+   * input 1 into the grid of input 0. Filters with other parameters of the
+   * back projector append them to the key. */
+  virtual SensitivityImageCache::KeyType
+  GetBackProjectionOfOnesKey(const ThreeDCircularProjectionGeometry * geometry,
+                             const std::vector<unsigned int> &        projections);
+
   /** Internal variables storing the current forward
     and back projection methods */
   ForwardProjectionType m_CurrentForwardProjectionConfiguration;
   BackProjectionType    m_CurrentBackProjectionConfiguration;
 
+  /** Telemetry of the iterations and number of iterations completed since the
+   * start of the last update */
+  IterationTelemetry::Pointer m_Telemetry;
+  unsigned int                m_TelemetryIteration{ 0 };
+
+  SensitivityImageCache::Pointer m_SensitivityCache;
+
+  itk::SizeValueType     m_MemoryCap{ 0 };
+  MemoryPlanner::Pointer m_MemoryPlanner{ MemoryPlanner::New() };
+
   /** A random generating engine is needed to use the C++17 comliant code for std::shuffle.
    */
   std::default_random_engine m_DefaultRandomEngine = std::default_random_engine{};
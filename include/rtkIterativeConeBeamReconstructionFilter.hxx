@@ -28,6 +28,22 @@ IterativeConeBeamReconstructionFilter<TOutputImage, ProjectionStackType>::Iterat
 {
   m_CurrentForwardProjectionConfiguration = FP_JOSEPH;
   m_CurrentBackProjectionConfiguration = BP_VOXELBASED;
+
+  // Telemetry of the iterations reported by subclasses
+  this->AddObserver(itk::StartEvent(), [this](const itk::EventObject &) {
+    m_TelemetryIteration = 0;
+    if (m_Telemetry.IsNotNull())
+      m_Telemetry->StartReconstruction(this);
+  });
+  this->AddObserver(itk::IterationEvent(), [this](const itk::EventObject &) {
+    if (m_Telemetry.IsNotNull())
+      m_Telemetry->CompleteIteration(this, m_TelemetryIteration, this->GetTelemetryResidualNorm());
+    m_TelemetryIteration++;
+  });
+  this->AddObserver(itk::EndEvent(), [this](const itk::EventObject &) {
+    if (m_Telemetry.IsNotNull())
+      m_Telemetry->EndReconstruction(this);
+  });
 }
 
 template <class TOutputImage, class ProjectionStackType>
@@ -52,6 +68,8 @@ IterativeConeBeamReconstructionFilter<TOutputImage, ProjectionStackType>::Instan
     default:
       itkGenericExceptionMacro(<< "Unhandled --fp value.");
   }
+  if (fw.IsNotNull())
+    this->WatchTelemetrySection(fw, IterationTelemetry::FORWARD_PROJECTION);
   return fw;
 }
 
@@ -83,6 +101,8 @@ IterativeConeBeamReconstructionFilter<TOutputImage, ProjectionStackType>::Instan
     default:
       itkGenericExceptionMacro(<< "Unhandled --bp value.");
   }
+  if (bp.IsNotNull())
+    this->WatchTelemetrySection(bp, IterationTelemetry::BACK_PROJECTION);
   return bp;
 }
 
@@ -110,6 +130,60 @@ IterativeConeBeamReconstructionFilter<TOutputImage, ProjectionStackType>::SetBac
   }
 }
 
+template <class TOutputImage, class ProjectionStackType>
+void
+IterativeConeBeamReconstructionFilter<TOutputImage, ProjectionStackType>::WatchTelemetrySection(
+  itk::Object *                   filter,
+  IterationTelemetry::SectionType section)
+{
+  filter->AddObserver(itk::StartEvent(), [this, section](const itk::EventObject &) {
+    if (m_Telemetry.IsNotNull())
+      m_Telemetry->StartSection(section);
+  });
+  filter->AddObserver(itk::EndEvent(), [this, section](const itk::EventObject &) {
+    if (m_Telemetry.IsNotNull())
+      m_Telemetry->EndSection(section);
+  });
+}
+
+template <class TOutputImage, class ProjectionStackType>
+void
+IterativeConeBeamReconstructionFilter<TOutputImage, ProjectionStackType>::ReportTelemetrySubset(
+  unsigned int subset,
+  double       residualNorm)
+{
+  if (m_Telemetry.IsNotNull())
+    m_Telemetry->CompleteSubset(this, m_TelemetryIteration, subset, residualNorm);
+}
+
+template <class TOutputImage, class ProjectionStackType>
+bool
+IterativeConeBeamReconstructionFilter<TOutputImage, ProjectionStackType>::GetUseSensitivityCache()
+{
+  if (m_SensitivityCache.IsNull())
+    return false;
+
+  // Attenuated back projections depend on the attenuation map
+  return this->GetInput(2) == nullptr || (m_CurrentBackProjectionConfiguration != BP_JOSEPHATTENUATED &&
+                                          m_CurrentBackProjectionConfiguration != BP_ZENG);
+}
+
+template <class TOutputImage, class ProjectionStackType>
+SensitivityImageCache::KeyType
+IterativeConeBeamReconstructionFilter<TOutputImage, ProjectionStackType>::GetBackProjectionOfOnesKey(
+  const ThreeDCircularProjectionGeometry * geometry,
+  const std::vector<unsigned int> &        projections)
+{
+  SensitivityImageCache::KeyType key;
+  key.push_back(SensitivityImageCache::BACK_PROJECTION_OF_ONES);
+  key.push_back(m_CurrentBackProjectionConfiguration);
+  SensitivityImageCache::AppendImageInformation(key, this->GetInput(0));
+  SensitivityImageCache::AppendImageInformation(
+    key, static_cast<const ProjectionStackType *>(this->itk::ProcessObject::GetInput(1)));
+  SensitivityImageCache::AppendGeometry(key, geometry, projections);
+  return key;
+}
+
 } // end namespace rtk
 
 #endif // rtkIterativeConeBeamReconstructionFilter_hxx
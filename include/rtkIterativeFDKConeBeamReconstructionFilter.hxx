@@ -181,7 +181,7 @@ IterativeFDKConeBeamReconstructionFilter<TInputImage, TOutputImage, TFFTPrecisio
   iterationReporter.CompletedStep();
 
   // For each iteration over 1, go over each projection
-  for (unsigned int iter = 1; iter < m_NumberOfIterations; iter++)
+  for (unsigned int iter = 1; iter < m_NumberOfIterations && !this->GetTelemetryStopRequested(); iter++)
   {
     m_DivideFilter->Update();
 
@@ -218,6 +218,8 @@ IterativeFDKConeBeamReconstructionFilter<TInputImage, TOutputImage, TFFTPrecisio
     }
 
     iterationReporter.CompletedStep();
+    if (this->GetTelemetryStopRequested())
+      break;
   }
 }
 
@@ -0,0 +1,253 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef rtkJosephAttenuationCache_h
+#define rtkJosephAttenuationCache_h
+
+#include "RTKExport.h"
+#include "rtkThreeDCircularProjectionGeometry.h"
+
+#include <itkImageBase.h>
+#include <itkImageRegion.h>
+#include <itkObject.h>
+#include <itkObjectFactory.h>
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace rtk
+{
+
+/** \class JosephAttenuationCache
+ * \brief Cache of the attenuation weights of the rays of the attenuated
+ * Joseph projectors.
+ *
+ * JosephForwardAttenuatedProjectionImageFilter and
+ * JosephBackAttenuatedProjectionImageFilter weight each step of a ray by a
+ * factor which only depends on the attenuation map along the ray [Gullberg,
+ * Phys. Med. Biol., 1985]. These weights are stored per projection in a
+ * compressed row table (one row per pixel) so that the next projections of the
+ * same rays, e.g., at the next subsets and iterations of OSEM, reduce to a
+ * weighted Joseph traversal of the emission volume.
+ *
+ * A table is identified by the attenuation map (pointer and modification
+ * time) and by a key computed by ComputeKey which describes the rays. The
+ * least recently used tables are discarded when the cache exceeds
+ * MemoryBudget.
+ *
+ * \ingroup RTK
+ */
+class RTK_EXPORT JosephAttenuationCache : public itk::Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(JosephAttenuationCache);
+
+  /** Standard class type alias. */
+  using Self = JosephAttenuationCache;
+  using Superclass = itk::Object;
+  using Pointer = itk::SmartPointer<Self>;
+  using ConstPointer = itk::SmartPointer<const Self>;
+  using KeyType = std::vector<double>;
+  using RegionType = itk::ImageRegion<3>;
+
+  /** Weights of the steps of the rays of a projection. The weights of pixel p
+   * are Weights[Offsets[p]] to Weights[Offsets[p+1]-1]. */
+  struct TableType
+  {
+    std::vector<itk::SizeValueType> Offsets;
+    std::vector<float>              Weights;
+  };
+  using TablePointer = std::shared_ptr<const TableType>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(JosephAttenuationCache, itk::Object);
+
+  /** Get / Set the memory budget of the cache in bytes. Default is 512 MB. */
+  itkGetConstMacro(MemoryBudget, itk::SizeValueType);
+  virtual void
+  SetMemoryBudget(itk::SizeValueType budget);
+
+  /** Returns the cached table of a projection, nullptr if it is not cached. */
+  TablePointer
+  Find(const itk::Object * attenuationMap, const KeyType & key);
+
+  /** Stores the table of a projection and discards the least recently used
+   * tables, or the tables of another attenuation map, if needed. */
+  void
+  Insert(const itk::Object * attenuationMap, const KeyType & key, TablePointer table);
+
+  /** Number of cached projections and memory used by the cache in bytes. */
+  unsigned int
+  GetNumberOfEntries() const;
+  itk::SizeValueType
+  GetMemoryUsage() const;
+
+  /** Release all cached tables. */
+  void
+  Clear();
+
+  /** Describes the rays of projection iProj, restricted to projectionRegion
+   * of the projection stack projections, through volumeRegion of volume with
+   * the clipping of the projectors. backProjection distinguishes the two
+   * projectors which do not accumulate the attenuation identically on the
+   * borders of the volume. */
+  static KeyType
+  ComputeKey(bool                                     backProjection,
+             const ThreeDCircularProjectionGeometry * geometry,
+             unsigned int                             iProj,
+             const itk::ImageBase<3> *                projections,
+             const RegionType &                       projectionRegion,
+             const itk::ImageBase<3> *                volume,
+             const RegionType &                       volumeRegion,
+             double                                   inferiorClip,
+             double                                   superiorClip);
+
+protected:
+  JosephAttenuationCache() = default;
+  ~JosephAttenuationCache() override = default;
+
+  void
+  PrintSelf(std::ostream & os, itk::Indent indent) const override;
+
+private:
+  struct Entry
+  {
+    const itk::Object *   AttenuationMap;
+    itk::ModifiedTimeType AttenuationMapTime;
+    KeyType               Key;
+    TablePointer          Table;
+  };
+
+  static itk::SizeValueType
+  GetTableSize(const TableType & table);
+
+  void
+  Evict(itk::SizeValueType budget);
+
+  itk::SizeValueType m_MemoryBudget{ 512 * 1024 * 1024 };
+  itk::SizeValueType m_MemoryUsage{ 0 };
+  std::list<Entry>   m_Entries;
+  mutable std::mutex m_Mutex;
+};
+
+/** \class JosephAttenuationTables
+ * \brief Attenuation weights of the rays of a stack of projections during
+ * one update of an attenuated Joseph projector.
+ *
+ * If the tables of all projections of the stack are cached, the functors of
+ * the projector replay the weights of each ray. Otherwise, they record the
+ * weights in a single buffer, with the offset and the number of weights of
+ * each ray, which is then split into tables with GetRecordedTable. Rays are
+ * identified by the linear offset of their pixel in the buffer of the stack.
+ *
+ * Recording stops, and the recorded weights are released, as soon as the
+ * tables of the stack exceed the memory budget of the cache since they could
+ * then not be replayed.
+ *
+ * \ingroup RTK
+ */
+class RTK_EXPORT JosephAttenuationTables
+{
+public:
+  using TablePointer = JosephAttenuationCache::TablePointer;
+
+  /** Replays cachedTables, one per projection, if none is nullptr, otherwise
+   * records the weights of the pixelsPerProjection rays of each projection
+   * within memoryBudget bytes. numberOfThreads ray buffers are allocated for
+   * threaded projectors. */
+  void
+  Initialize(unsigned int                      numberOfThreads,
+             itk::SizeValueType                pixelsPerProjection,
+             const std::vector<TablePointer> & cachedTables,
+             itk::SizeValueType                memoryBudget);
+
+  /** Neither records nor replays. */
+  void
+  Reset();
+
+  bool
+  IsRecording() const
+  {
+    return m_Recording;
+  }
+  bool
+  IsReplaying() const
+  {
+    return m_Replaying;
+  }
+
+  /** Work buffer of a thread for the ray being traversed: the weights of the
+   * steps when recording, the projected values of the steps when replaying. */
+  std::vector<double> &
+  GetRayBuffer(unsigned int threadId)
+  {
+    return m_RayBuffers[threadId];
+  }
+
+  /** Records the weights of the steps of the ray of pixel. Thread safe. */
+  void
+  RecordRay(itk::SizeValueType pixel, const std::vector<double> & weights);
+
+  /** Records the weights of the ray of pixel one step at a time, for the
+   * projectors which traverse the rays one after the other. Not thread safe. */
+  void
+  BeginRay(itk::SizeValueType pixel);
+  void
+  RecordWeight(double weight);
+
+  /** Table of the rays recorded for a projection of the stack. */
+  TablePointer
+  GetRecordedTable(unsigned int projection) const;
+
+  /** Weights replayed for the ray of pixel, numberOfWeights is set to their
+   * number. */
+  const float *
+  GetWeights(itk::SizeValueType pixel, itk::SizeValueType & numberOfWeights) const;
+
+  /** Weighted sum of the values of the steps of the ray of pixel. */
+  double
+  ReplayRay(itk::SizeValueType pixel, const std::vector<double> & values) const;
+
+private:
+  /** Checks that numberOfWeights more weights fit in the memory budget,
+   * otherwise stops recording. */
+  bool
+  ReserveWeights(itk::SizeValueType numberOfWeights);
+
+  std::atomic<bool>                m_Recording{ false };
+  bool                             m_Replaying{ false };
+  itk::SizeValueType               m_PixelsPerProjection{ 0 };
+  std::vector<TablePointer>        m_Tables;
+  std::vector<float>               m_RecordedWeights;
+  std::vector<itk::SizeValueType>  m_RayOffsets;
+  std::vector<itk::SizeValueType>  m_RayLengths;
+  itk::SizeValueType               m_CurrentRay{ 0 };
+  itk::SizeValueType               m_MaximumNumberOfWeights{ 0 };
+  std::mutex                       m_RecordMutex;
+  std::vector<std::vector<double>> m_RayBuffers;
+};
+
+} // end namespace rtk
+
+#endif
@@ -20,6 +20,7 @@
 #define rtkJosephBackAttenuatedProjectionImageFilter_h
 
 #include "rtkConfiguration.h"
+#include "rtkJosephAttenuationCache.h"
 #include "rtkJosephBackProjectionImageFilter.h"
 #include "rtkThreeDCircularProjectionGeometry.h"
 
@@ -57,12 +58,23 @@ public:
   inline TOutput
   operator()(const double stepLengthInVoxel, const TCoordRepType weight, const TInput * p, const int i)
   {
+    if (m_SkipAttenuation)
+      return 0;
+
     const double w = weight * stepLengthInVoxel;
 
     m_AttenuationPixel += w * (p + m_AttenuationMinusEmissionMapsPtrDiff)[i];
     return w * (p + m_AttenuationMinusEmissionMapsPtrDiff)[i];
   }
 
+  /** The attenuation map is not read when the attenuation weights are
+   * replayed from JosephAttenuationTables. */
+  void
+  SetSkipAttenuation(bool skip)
+  {
+    m_SkipAttenuation = skip;
+  }
+
   void
   SetAttenuationMinusEmissionMapsPtrDiff(std::ptrdiff_t pd)
   {
@@ -76,6 +88,7 @@ public:
 
 private:
   std::ptrdiff_t m_AttenuationMinusEmissionMapsPtrDiff;
+  bool           m_SkipAttenuation{ false };
   TInput         m_AttenuationPixel;
 };
 
@@ -108,13 +121,30 @@ public:
   }
 
   inline TOutput
-  operator()(const TInput rayValue, const TInput attenuationRay, const VectorType & stepInMM, bool & isNewRay)
+  operator()(const TInput & rayValue, const TInput attenuationRay, const VectorType & stepInMM, bool & isNewRay)
   {
     if (isNewRay)
     {
       m_Ex1 = 1;
       isNewRay = false;
+      if (m_Tables)
+      {
+        // The ray is identified by its pixel in the projection buffer, rayValue
+        // must therefore be a reference to the buffer
+        const std::ptrdiff_t offset = &rayValue - m_ProjectionBuffer;
+        itkAssertInDebugAndIgnoreInReleaseMacro(offset >= 0 &&
+                                                static_cast<itk::SizeValueType>(offset) < m_NumberOfPixels);
+        const auto pixel = static_cast<itk::SizeValueType>(offset);
+        m_Step = 0;
+        if (m_Tables->IsReplaying())
+          m_Weights = m_Tables->GetWeights(pixel, m_NumberOfWeights);
+        else
+          m_Tables->BeginRay(pixel);
+      }
     }
+    if (m_Tables && m_Tables->IsReplaying())
+      return (m_Step < m_NumberOfWeights) ? m_Weights[m_Step++] * rayValue : 0;
+
     TInput ex2 = exp(-attenuationRay * stepInMM.GetNorm());
     TInput wf;
     if (*m_AttenuationPixel > 0)
@@ -128,6 +158,8 @@ public:
 
     m_Ex1 = ex2;
     *m_AttenuationPixel = 0;
+    if (m_Tables && m_Tables->IsRecording())
+      m_Tables->RecordWeight(wf);
     return wf * rayValue;
   }
 
@@ -136,10 +168,25 @@ public:
   {
     m_AttenuationPixel = attenuationPixel;
   }
+  void
+  SetAttenuationTables(JosephAttenuationTables * tables,
+                       const TInput *            projectionBuffer,
+                       itk::SizeValueType        numberOfPixels)
+  {
+    m_Tables = tables;
+    m_ProjectionBuffer = projectionBuffer;
+    m_NumberOfPixels = numberOfPixels;
+  }
 
 private:
-  TInput   m_Ex1;
-  TInput * m_AttenuationPixel;
+  TInput                    m_Ex1;
+  TInput *                  m_AttenuationPixel;
+  JosephAttenuationTables * m_Tables{ nullptr };
+  const TInput *            m_ProjectionBuffer{ nullptr };
+  itk::SizeValueType        m_NumberOfPixels{ 0 };
+  const float *             m_Weights{ nullptr };
+  itk::SizeValueType        m_NumberOfWeights{ 0 };
+  itk::SizeValueType        m_Step{ 0 };
 };
 
 /** \class SplatWeightMultiplicationAttenuated
@@ -187,6 +234,11 @@ public:
  * using [Joseph, IEEE TMI, 1982] and [Gullberg, Phys. Med. Biol., 1985]. The back projector is the adjoint operator of
  * the forward attenuated projector
  *
+ * If an AttenuationCache is set, the attenuation weights of the steps of the
+ * rays of each projection are recorded in the cache at the first back
+ * projection and replayed at the next ones, which then do not read the
+ * attenuation map.
+ *
  * \test rtkbackprojectiontest.cxx
  *
  * \author Antoine Robert
@@ -240,6 +292,11 @@ public:
   /** Run-time type information (and related methods). */
   itkTypeMacro(JosephBackAttenuatedProjectionImageFilter, JosephBackProjectionImageFilter);
 
+  /** Get / Set the cache of the attenuation weights of the rays. Default is
+   * nullptr, i.e., the weights are recomputed at each update. */
+  itkSetObjectMacro(AttenuationCache, JosephAttenuationCache);
+  itkGetModifiableObjectMacro(AttenuationCache, JosephAttenuationCache);
+
 protected:
   JosephBackAttenuatedProjectionImageFilter();
   ~JosephBackAttenuatedProjectionImageFilter() override = default;
@@ -258,6 +315,11 @@ protected:
 
   void
   Init();
+
+private:
+  JosephAttenuationCache::Pointer              m_AttenuationCache;
+  JosephAttenuationTables                      m_AttenuationTables;
+  std::vector<JosephAttenuationCache::KeyType> m_AttenuationKeys;
 };
 } // end namespace rtk
 
@@ -169,6 +169,37 @@ JosephBackAttenuatedProjectionImageFilter<TInputImage,
   this->m_InterpolationWeightMultiplication.SetAttenuationMinusEmissionMapsPtrDiff(
     this->GetInput(2)->GetBufferPointer() - this->GetInput(0)->GetBufferPointer());
   this->m_SumAlongRay.SetAttenuationPixel(this->m_InterpolationWeightMultiplication.GetAttenuationPixel());
+
+  // Look for the attenuation weights of the projections in the cache
+  m_AttenuationTables.Reset();
+  m_AttenuationKeys.clear();
+  if (m_AttenuationCache.IsNotNull())
+  {
+    const typename TInputImage::RegionType region = this->GetInput(1)->GetBufferedRegion();
+    typename TInputImage::RegionType       sliceRegion = region;
+    sliceRegion.SetSize(2, 1);
+    std::vector<JosephAttenuationCache::TablePointer> tables;
+    for (unsigned int k = 0; k < region.GetSize(2); k++)
+    {
+      sliceRegion.SetIndex(2, region.GetIndex(2) + k);
+      m_AttenuationKeys.push_back(JosephAttenuationCache::ComputeKey(true,
+                                                                     this->GetGeometry(),
+                                                                     sliceRegion.GetIndex(2),
+                                                                     this->GetInput(1),
+                                                                     sliceRegion,
+                                                                     this->GetInput(0),
+                                                                     this->GetOutput()->GetRequestedRegion(),
+                                                                     this->m_InferiorClip,
+                                                                     this->m_SuperiorClip));
+      tables.push_back(m_AttenuationCache->Find(this->GetInput(2), m_AttenuationKeys.back()));
+    }
+    m_AttenuationTables.Initialize(
+      1, region.GetSize(0) * region.GetSize(1), tables, m_AttenuationCache->GetMemoryBudget());
+  }
+  this->m_InterpolationWeightMultiplication.SetSkipAttenuation(m_AttenuationTables.IsReplaying());
+  this->m_SumAlongRay.SetAttenuationTables(m_AttenuationCache.IsNotNull() ? &m_AttenuationTables : nullptr,
+                                           this->GetInput(1)->GetBufferPointer(),
+                                           this->GetInput(1)->GetBufferedRegion().GetNumberOfPixels());
 }
 
 template <class TInputImage,
@@ -185,6 +216,12 @@ JosephBackAttenuatedProjectionImageFilter<TInputImage,
 {
   Init();
   Superclass::GenerateData();
+
+  // Store the recorded attenuation weights in the cache
+  if (m_AttenuationTables.IsRecording())
+    for (unsigned int k = 0; k < m_AttenuationKeys.size(); k++)
+      m_AttenuationCache->Insert(this->GetInput(2), m_AttenuationKeys[k], m_AttenuationTables.GetRecordedTable(k));
+  m_AttenuationTables.Reset();
 }
 } // end namespace rtk
 
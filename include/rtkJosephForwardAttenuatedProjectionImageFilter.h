@@ -21,6 +21,7 @@
 
 #include "rtkConfiguration.h"
 #include "rtkForwardProjectionImageFilter.h"
+#include "rtkJosephAttenuationCache.h"
 #include "rtkJosephForwardProjectionImageFilter.h"
 #include "rtkMacro.h"
 #include <itkPixelTraits.h>
@@ -73,13 +74,24 @@ public:
              const TInput *      p,
              const int           i)
   {
-    const double w = weight * stepLengthInVoxel;
+    if (!m_SkipAttenuation)
+    {
+      const double w = weight * stepLengthInVoxel;
 
-    m_AttenuationRay[threadId] += w * (p + m_AttenuationMinusEmissionMapsPtrDiff)[i];
-    m_AttenuationPixel[threadId] += w * (p + m_AttenuationMinusEmissionMapsPtrDiff)[i];
+      m_AttenuationRay[threadId] += w * (p + m_AttenuationMinusEmissionMapsPtrDiff)[i];
+      m_AttenuationPixel[threadId] += w * (p + m_AttenuationMinusEmissionMapsPtrDiff)[i];
+    }
     return weight * p[i];
   }
 
+  /** The attenuation map is not read when the attenuation weights are
+   * replayed from JosephAttenuationTables. */
+  void
+  SetSkipAttenuation(bool skip)
+  {
+    m_SkipAttenuation = skip;
+  }
+
   void
   SetAttenuationMinusEmissionMapsPtrDiff(std::ptrdiff_t pd)
   {
@@ -103,6 +115,7 @@ public:
 
 private:
   std::ptrdiff_t m_AttenuationMinusEmissionMapsPtrDiff;
+  bool           m_SkipAttenuation{ false };
   TInput         m_AttenuationRay[itk::ITK_MAX_THREADS];
   TInput         m_AttenuationPixel[itk::ITK_MAX_THREADS];
   TInput         m_Ex1[itk::ITK_MAX_THREADS];
@@ -138,6 +151,13 @@ public:
   inline TOutput
   operator()(const ThreadIdType threadId, const TInput volumeValue, const VectorType & stepInMM)
   {
+    // The weights are applied when the ray is accumulated
+    if (m_Tables && m_Tables->IsReplaying())
+    {
+      m_Tables->GetRayBuffer(threadId).push_back(volumeValue);
+      return 0;
+    }
+
     TInput ex2 = exp(-m_AttenuationRay[threadId] * stepInMM.GetNorm());
     TInput wf;
 
@@ -152,6 +172,8 @@ public:
 
     m_Ex1[threadId] = ex2;
     m_AttenuationPixel[threadId] = 0;
+    if (m_Tables && m_Tables->IsRecording())
+      m_Tables->GetRayBuffer(threadId).push_back(wf);
     return wf * volumeValue;
   }
 
@@ -170,11 +192,17 @@ public:
   {
     m_Ex1 = ex1;
   }
+  void
+  SetAttenuationTables(JosephAttenuationTables * tables)
+  {
+    m_Tables = tables;
+  }
 
 private:
-  TInput * m_AttenuationRay;
-  TInput * m_AttenuationPixel;
-  TInput * m_Ex1;
+  TInput *                  m_AttenuationRay;
+  TInput *                  m_AttenuationPixel;
+  TInput *                  m_Ex1;
+  JosephAttenuationTables * m_Tables{ nullptr };
 };
 
 /** \class ProjectedValueAccumulationAttenuated
@@ -216,6 +244,21 @@ public:
              const VectorType & itkNotUsed(farthestPoint))
   {
     output = input + rayCastValue;
+    if (m_Tables)
+    {
+      // The ray is identified by its pixel in the output buffer, output must
+      // therefore be a reference to the buffer
+      const std::ptrdiff_t offset = &output - m_OutputBuffer;
+      itkAssertInDebugAndIgnoreInReleaseMacro(offset >= 0 &&
+                                              static_cast<itk::SizeValueType>(offset) < m_NumberOfPixels);
+      const auto            pixel = static_cast<itk::SizeValueType>(offset);
+      std::vector<double> & rayBuffer = m_Tables->GetRayBuffer(threadId);
+      if (m_Tables->IsReplaying())
+        output = input + m_Tables->ReplayRay(pixel, rayBuffer);
+      else
+        m_Tables->RecordRay(pixel, rayBuffer);
+      rayBuffer.clear();
+    }
     m_Attenuation[threadId] = 0;
     m_Ex1[threadId] = 1;
   }
@@ -230,10 +273,22 @@ public:
   {
     m_Ex1 = ex1;
   }
+  void
+  SetAttenuationTables(JosephAttenuationTables * tables,
+                       const TOutput *           outputBuffer,
+                       itk::SizeValueType        numberOfPixels)
+  {
+    m_Tables = tables;
+    m_OutputBuffer = outputBuffer;
+    m_NumberOfPixels = numberOfPixels;
+  }
 
 private:
-  TInput * m_Attenuation;
-  TInput * m_Ex1;
+  TInput *                  m_Attenuation;
+  TInput *                  m_Ex1;
+  JosephAttenuationTables * m_Tables{ nullptr };
+  const TOutput *           m_OutputBuffer{ nullptr };
+  itk::SizeValueType        m_NumberOfPixels{ 0 };
 };
 } // end namespace Functor
 
@@ -245,6 +300,10 @@ private:
  * has been placed after the source and the volume. If the detector is in the volume
  * the ray tracing is performed only until that point.
  *
+ * If an AttenuationCache is set, the attenuation weights of the steps of the
+ * rays of each projection are recorded in the cache at the first projection
+ * and replayed at the next ones, which then do not read the attenuation map.
+ *
  * \test rtkforwardattenuatedprojectiontest.cxx
  *
  * \author Antoine Robert
@@ -296,6 +355,11 @@ public:
   /** Run-time type information (and related methods). */
   itkTypeMacro(JosephForwardAttenuatedProjectionImageFilter, JosephForwardProjectionImageFilter);
 
+  /** Get / Set the cache of the attenuation weights of the rays. Default is
+   * nullptr, i.e., the weights are recomputed at each update. */
+  itkSetObjectMacro(AttenuationCache, JosephAttenuationCache);
+  itkGetModifiableObjectMacro(AttenuationCache, JosephAttenuationCache);
+
 protected:
   JosephForwardAttenuatedProjectionImageFilter();
   ~JosephForwardAttenuatedProjectionImageFilter() override = default;
@@ -307,10 +371,19 @@ protected:
   void
   BeforeThreadedGenerateData() override;
 
+  /** Stores the recorded attenuation weights in the cache. */
+  void
+  AfterThreadedGenerateData() override;
+
   /** Only the last two inputs should be in the same space so we need
    * to overwrite the method. */
   void
   VerifyInputInformation() const override;
+
+private:
+  JosephAttenuationCache::Pointer              m_AttenuationCache;
+  JosephAttenuationTables                      m_AttenuationTables;
+  std::vector<JosephAttenuationCache::KeyType> m_AttenuationKeys;
 };
 } // end namespace rtk
 
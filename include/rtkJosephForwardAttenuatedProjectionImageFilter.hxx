@@ -179,6 +179,59 @@ JosephForwardAttenuatedProjectionImageFilter<TInputImage,
   this->GetSumAlongRay().SetAttenuationPixelVector(this->GetInterpolationWeightMultiplication().GetAttenuationPixel());
   this->GetProjectedValueAccumulation().SetEx1(this->GetInterpolationWeightMultiplication().GetEx1());
   this->GetSumAlongRay().SetEx1(this->GetInterpolationWeightMultiplication().GetEx1());
+
+  // Look for the attenuation weights of the projections in the cache
+  m_AttenuationTables.Reset();
+  m_AttenuationKeys.clear();
+  if (m_AttenuationCache.IsNotNull())
+  {
+    const OutputImageRegionType region = this->GetOutput()->GetBufferedRegion();
+    OutputImageRegionType       sliceRegion = region;
+    sliceRegion.SetSize(2, 1);
+    std::vector<JosephAttenuationCache::TablePointer> tables;
+    for (unsigned int k = 0; k < region.GetSize(2); k++)
+    {
+      sliceRegion.SetIndex(2, region.GetIndex(2) + k);
+      m_AttenuationKeys.push_back(JosephAttenuationCache::ComputeKey(false,
+                                                                     this->GetGeometry(),
+                                                                     sliceRegion.GetIndex(2),
+                                                                     this->GetOutput(),
+                                                                     sliceRegion,
+                                                                     this->GetInput(1),
+                                                                     this->GetInput(1)->GetBufferedRegion(),
+                                                                     this->GetInferiorClip(),
+                                                                     this->GetSuperiorClip()));
+      tables.push_back(m_AttenuationCache->Find(this->GetInput(2), m_AttenuationKeys.back()));
+    }
+    m_AttenuationTables.Initialize(this->GetNumberOfWorkUnits(),
+                                   region.GetSize(0) * region.GetSize(1),
+                                   tables,
+                                   m_AttenuationCache->GetMemoryBudget());
+  }
+  this->GetInterpolationWeightMultiplication().SetSkipAttenuation(m_AttenuationTables.IsReplaying());
+  this->GetSumAlongRay().SetAttenuationTables(m_AttenuationCache.IsNotNull() ? &m_AttenuationTables : nullptr);
+  this->GetProjectedValueAccumulation().SetAttenuationTables(
+    m_AttenuationCache.IsNotNull() ? &m_AttenuationTables : nullptr,
+    this->GetOutput()->GetBufferPointer(),
+    this->GetOutput()->GetBufferedRegion().GetNumberOfPixels());
+}
+
+template <class TInputImage,
+          class TOutputImage,
+          class TInterpolationWeightMultiplication,
+          class TProjectedValueAccumulation,
+          class TComputeAttenuationCorrection>
+void
+JosephForwardAttenuatedProjectionImageFilter<TInputImage,
+                                             TOutputImage,
+                                             TInterpolationWeightMultiplication,
+                                             TProjectedValueAccumulation,
+                                             TComputeAttenuationCorrection>::AfterThreadedGenerateData()
+{
+  if (m_AttenuationTables.IsRecording())
+    for (unsigned int k = 0; k < m_AttenuationKeys.size(); k++)
+      m_AttenuationCache->Insert(this->GetInput(2), m_AttenuationKeys[k], m_AttenuationTables.GetRecordedTable(k));
+  m_AttenuationTables.Reset();
 }
 } // end namespace rtk
 
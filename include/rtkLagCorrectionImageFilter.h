@@ -44,6 +44,12 @@ namespace rtk
  * The parameters are typically estimated from either RSRF (Rising Step RF) or FSRF (Falling Step RF) response
  * functions.
  *
+ * The state of each pixel depends on all previous projections but not on the
+ * other pixels. When a block of projections is requested, the state of a tile
+ * of TileSize pixels is therefore updated with all projections of the block
+ * before moving to the next tile, which keeps it in cache. The result is
+ * identical to a projection by projection correction.
+ *
  * \test rtklagcorrectiontest.cxx
  *
  * \author Sebastien Brousmiche
@@ -95,6 +101,11 @@ public:
     }
   }
 
+  /** Get / Set the number of pixels of a tile of the state. Default is 4096,
+   * i.e., 64 kB of state for a 4th order model. */
+  itkGetConstMacro(TileSize, unsigned int);
+  itkSetMacro(TileSize, unsigned int);
+
 protected:
   LagCorrectionImageFilter();
   ~LagCorrectionImageFilter() override = default;
@@ -125,8 +136,9 @@ protected:
   FloatVectorType m_S; // State variable
 
 private:
-  bool      m_NewParamJustReceived; // For state/correction initialization
-  IndexType m_StartIdx;             // To account for cropping
+  bool         m_NewParamJustReceived; // For state/correction initialization
+  IndexType    m_StartIdx;             // To account for cropping
+  unsigned int m_TileSize{ 4096 };     // Number of pixels of a tile of the state
 };
 
 } // namespace rtk
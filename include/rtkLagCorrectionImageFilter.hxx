@@ -22,6 +22,7 @@
 
 #include "itkImageRegionIterator.h"
 #include "itkImageRegionConstIterator.h"
+#include <algorithm>
 #include <iterator>
 
 namespace rtk
@@ -124,51 +125,71 @@ LagCorrectionImageFilter<TImage, VModelOrder>::ThreadedGenerateData(const ImageR
     return;
   }
 
-  ImageSizeType SizeInput = this->GetInput()->GetLargestPossibleRegion().GetSize();
-
-  for (unsigned int k = 0; k < thRegion.GetSize(2); ++k)
+  // Local copies of the coefficients for the vectorization of the loops over
+  // the exponentials
+  float expmA[VModelOrder], B[VModelOrder];
+  for (unsigned int n = 0; n < VModelOrder; n++)
+  {
+    expmA[n] = m_ExpmA[n];
+    B[n] = m_B[n];
+  }
+  const float sumB = m_SumB;
+
+  ImageSizeType     SizeInput = this->GetInput()->GetLargestPossibleRegion().GetSize();
+  ImageSizeType     inBufferSize = this->GetInput()->GetBufferedRegion().GetSize();
+  ImageSizeType     outBufferSize = this->GetOutput()->GetBufferedRegion().GetSize();
+  const PixelType * inBuffer = this->GetInput()->GetBufferPointer();
+  PixelType *       outBuffer = this->GetOutput()->GetBufferPointer();
+  inBuffer += this->GetInput()->ComputeOffset(thRegion.GetIndex());
+  outBuffer += this->GetOutput()->ComputeOffset(thRegion.GetIndex());
+
+  // Tiles of tileRows rows of tileColumns pixels. All projections of the
+  // thread region are applied to a tile before moving to the next one.
+  const unsigned int tileColumns = std::min<unsigned int>(thRegion.GetSize(0), std::max(1u, m_TileSize));
+  const unsigned int tileRows = std::max(1u, m_TileSize / tileColumns);
+  for (unsigned int j0 = 0; j0 < thRegion.GetSize(1); j0 += tileRows)
   {
-    unsigned int jj = (thRegion.GetIndex()[1] - m_StartIdx[1]) * SizeInput[0];
-    for (unsigned int j = 0; j < thRegion.GetSize(1); ++j)
+    const unsigned int j1 = std::min<unsigned int>(j0 + tileRows, thRegion.GetSize(1));
+    for (unsigned int i0 = 0; i0 < thRegion.GetSize(0); i0 += tileColumns)
     {
-      unsigned int ii = thRegion.GetIndex()[0] - m_StartIdx[0];
-      for (unsigned int i = 0; i < thRegion.GetSize(0); ++i, ++ii)
+      const unsigned int ni = std::min<unsigned int>(tileColumns, thRegion.GetSize(0) - i0);
+      for (unsigned int k = 0; k < thRegion.GetSize(2); ++k)
       {
-        unsigned idx_s = (jj + ii) * VModelOrder;
-
-        // Get measured pixel value y[k]
-        auto yk = static_cast<float>(itIn.Get());
-
-        // Computes correction
-        float      xk = yk; // Initial corrected pixel
-        VectorType Sa;      // Update of the state
-        for (unsigned int n = 0; n < VModelOrder; n++)
+        for (unsigned int j = j0; j < j1; ++j)
         {
-          // Compute the update of internal state for nth exponential
-          Sa[n] = m_ExpmA[n] * m_S[idx_s + n];
-
-          // Update x[k] by removing contribution of the nth exponential
-          xk -= m_B[n] * Sa[n];
+          const PixelType * in = inBuffer + (k * inBufferSize[1] + j) * inBufferSize[0] + i0;
+          PixelType *       out = outBuffer + (k * outBufferSize[1] + j) * outBufferSize[0] + i0;
+          unsigned int      jj = (thRegion.GetIndex()[1] - m_StartIdx[1] + j) * SizeInput[0];
+          unsigned int      ii = thRegion.GetIndex()[0] - m_StartIdx[0] + i0;
+          float *           S = &m_S[(jj + ii) * VModelOrder];
+          for (unsigned int i = 0; i < ni; ++i, S += VModelOrder)
+          {
+            // Get measured pixel value y[k]
+            auto yk = static_cast<float>(in[i]);
+
+            // Compute the update of internal state for each exponential
+            float Sa[VModelOrder];
+            for (unsigned int n = 0; n < VModelOrder; n++)
+              Sa[n] = expmA[n] * S[n];
+
+            // Computes correction by removing the contribution of each
+            // exponential, in the same order as the sequential recurrence
+            float xk = yk;
+            for (unsigned int n = 0; n < VModelOrder; n++)
+              xk -= B[n] * Sa[n];
+
+            // Apply normalization factor
+            xk = xk / sumB;
+
+            // Update internal state Snk
+            for (unsigned int n = 0; n < VModelOrder; n++)
+              S[n] = xk + Sa[n];
+
+            // Avoid negative values
+            out[i] = static_cast<PixelType>((xk < 0.0f) ? 0.f : xk);
+          }
         }
-
-        // Apply normalization factor
-        xk = xk / m_SumB;
-
-        // Update internal state Snk
-        for (unsigned int n = 0; n < VModelOrder; n++)
-        {
-          m_S[idx_s + n] = xk + Sa[n];
-        }
-
-        // Avoid negative values
-        xk = (xk < 0.0f) ? 0.f : xk;
-
-        itOut.Set(static_cast<PixelType>(xk));
-
-        ++itIn;
-        ++itOut;
       }
-      jj += SizeInput[0];
     }
   }
 }
@@ -19,7 +19,8 @@
 #define rtkLastDimensionL0GradientDenoisingImageFilter_hxx
 
 #include "itkImageRegionIteratorWithIndex.h"
-#include "itkImageRegionIterator.h"
+
+#include <vector>
 
 namespace rtk
 {
@@ -149,63 +150,49 @@ LastDimensionL0GradientDenoisingImageFilter<TInputImage>::ThreadedGenerateData(
   const typename TInputImage::RegionType & outputRegionForThread,
   itk::ThreadIdType                        itkNotUsed(threadId))
 {
-  // Walks the first frame of the outputRegionForThread
-  // For each voxel, creates an input iterator that walks
-  // the last dimension and computes the average, and
-  // a similar output iterator that replaces the output
-  // by their average along last dimension if ROI=1
-
-  // Create a region containing only the first frame of outputRegionForThread
-  typename TInputImage::RegionType FirstFrameRegion = outputRegionForThread;
-  FirstFrameRegion.SetSize(TInputImage::ImageDimension - 1, 1);
-
-  // Iterate on this region
-  itk::ImageRegionIteratorWithIndex<TInputImage> FakeIterator(this->GetOutput(), FirstFrameRegion);
-
-  // Create a single-voxel region traversing last dimension
-  typename TInputImage::RegionType SingleVoxelRegion = outputRegionForThread;
-  for (unsigned int dim = 0; dim < TInputImage::ImageDimension - 1; dim++)
-  {
-    SingleVoxelRegion.SetSize(dim, 1);
-    SingleVoxelRegion.SetIndex(dim, 0);
-  }
-
+  // The signals along the last dimension are strided by a whole frame in memory.
+  // Instead of walking them one voxel at a time, whole rows of voxels are read
+  // frame by frame, transposed in a buffer where each signal is contiguous,
+  // regularized, and transposed back into the output.
+  constexpr unsigned int Dimension = TInputImage::ImageDimension;
+  const unsigned int     nFrames = outputRegionForThread.GetSize(Dimension - 1);
+  const unsigned int     rowLength = outputRegionForThread.GetSize(0);
+
+  const TInputImage *        input = this->GetInput();
+  TInputImage *              output = this->GetOutput();
+  const itk::OffsetValueType inputFrameStride = input->GetOffsetTable()[Dimension - 1];
+  const itk::OffsetValueType outputFrameStride = output->GetOffsetTable()[Dimension - 1];
+
+  // Buffer of the signals of one row, signal after signal
+  std::vector<InputPixelType> signals(rowLength * nFrames);
+
+  // Region containing the first voxel of each row of the first frame
+  typename TInputImage::RegionType rowStartsRegion = outputRegionForThread;
+  rowStartsRegion.SetSize(0, 1);
+  rowStartsRegion.SetSize(Dimension - 1, 1);
+
+  // Iterate on this region, only to get the indices of the rows
+  itk::ImageRegionIteratorWithIndex<TInputImage> FakeIterator(output, rowStartsRegion);
   while (!FakeIterator.IsAtEnd())
   {
-    // Configure the SingleVoxelRegion correctly to follow the FakeIterator
-    // It is the only purpose of this FakeIterator
-    SingleVoxelRegion.SetIndex(FakeIterator.GetIndex());
-
-    // Walk the input along last dimension for this voxel, filling an array with the values read
-    itk::ImageRegionConstIterator<TInputImage> inputIterator(this->GetInput(), SingleVoxelRegion);
-    auto * toBeRegularized = new InputPixelType[outputRegionForThread.GetSize(TInputImage::ImageDimension - 1)];
-
-    unsigned int i = 0;
-    while (!inputIterator.IsAtEnd())
-    {
-      toBeRegularized[i] = inputIterator.Get();
-      i++;
-      ++inputIterator;
-    }
-
-    // Perform regularization (in place) on this array
-    OneDimensionMinimizeL0NormOfGradient(toBeRegularized,
-                                         outputRegionForThread.GetSize(TInputImage::ImageDimension - 1),
-                                         this->GetLambda(),
-                                         this->GetNumberOfIterations());
-
-    // Walk the output along last dimension for this voxel,
-    // replacing voxel with their regularized value
-    itk::ImageRegionIterator<TInputImage> outputIterator(this->GetOutput(), SingleVoxelRegion);
-    i = 0;
-    while (!outputIterator.IsAtEnd())
-    {
-      outputIterator.Set(toBeRegularized[i]);
-      i++;
-      ++outputIterator;
-    }
-
-    delete[] toBeRegularized;
+    const typename TInputImage::IndexType rowStart = FakeIterator.GetIndex();
+
+    // Gather the row in every frame
+    const InputPixelType * in = input->GetBufferPointer() + input->ComputeOffset(rowStart);
+    for (unsigned int t = 0; t < nFrames; t++, in += inputFrameStride)
+      for (unsigned int x = 0; x < rowLength; x++)
+        signals[x * nFrames + t] = in[x];
+
+    // Perform regularization (in place) on each contiguous signal
+    for (unsigned int x = 0; x < rowLength; x++)
+      OneDimensionMinimizeL0NormOfGradient(
+        &(signals[x * nFrames]), nFrames, this->GetLambda(), this->GetNumberOfIterations());
+
+    // Scatter the regularized signals back into the output
+    InputPixelType * out = output->GetBufferPointer() + output->ComputeOffset(rowStart);
+    for (unsigned int t = 0; t < nFrames; t++, out += outputFrameStride)
+      for (unsigned int x = 0; x < rowLength; x++)
+        out[x] = signals[x * nFrames + t];
 
     ++FakeIterator;
   }
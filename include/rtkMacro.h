@@ -24,6 +24,7 @@
 #include <itkImageBase.h>
 #include "rtkGgoArgsInfoManager.h"
 #include "rtkIterationCommands.h"
+#include "rtkIterationTelemetry.h"
 
 //--------------------------------------------------------------------
 #ifndef CLANG_PRAGMA_PUSH
@@ -231,6 +232,26 @@
       outputIterationCommand->SetFileFormat("iter%d.mha");                                                             \
     }                                                                                                                  \
     filter->AddObserver(itk::IterationEvent(), outputIterationCommand);                                                \
+  }                                                                                                                    \
+  if (args_info.telemetry_given || args_info.time_budget_given || args_info.plateau_given)                             \
+  {                                                                                                                    \
+    rtk::IterationTelemetry::Pointer telemetry = rtk::IterationTelemetry::New();                                       \
+    if (args_info.telemetry_given)                                                                                     \
+    {                                                                                                                  \
+      std::string                          telemetryFileName(args_info.telemetry_arg);                                 \
+      rtk::IterationTelemetrySink::Pointer telemetrySink;                                                              \
+      if (telemetryFileName.size() >= 5 && telemetryFileName.substr(telemetryFileName.size() - 5) == ".json")          \
+        telemetrySink = rtk::JSONIterationTelemetrySink::New();                                                        \
+      else                                                                                                             \
+        telemetrySink = rtk::CSVIterationTelemetrySink::New();                                                         \
+      telemetrySink->SetFileName(telemetryFileName);                                                                   \
+      telemetry->SetSink(telemetrySink);                                                                               \
+    }                                                                                                                  \
+    if (args_info.time_budget_given)                                                                                   \
+      telemetry->SetTimeBudget(args_info.time_budget_arg);                                                             \
+    if (args_info.plateau_given)                                                                                       \
+      telemetry->SetResidualPlateauTolerance(args_info.plateau_arg);                                                   \
+    filter->SetTelemetry(telemetry);                                                                                   \
   }
 //--------------------------------------------------------------------
 
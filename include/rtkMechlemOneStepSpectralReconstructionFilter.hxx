@@ -69,6 +69,12 @@ MechlemOneStepSpectralReconstructionFilter<TOutputImage, TPhotonCounts, TSpectru
   m_HessiansSource->SetConstant(
     itk::NumericTraits<typename MechlemOneStepSpectralReconstructionFilter<TOutputImage, TPhotonCounts, TSpectrum>::
                          THessiansImage::PixelType>::ZeroValue());
+
+  // Image types of the internal pipeline
+  this->m_MemoryPlanner->template RegisterImageType<TOutputImage>();
+  this->m_MemoryPlanner->template RegisterImageType<THessiansImage>();
+  this->m_MemoryPlanner->template RegisterImageType<SingleComponentImageType>();
+  this->m_MemoryPlanner->template RegisterImageType<TPhotonCounts>();
 }
 
 template <class TOutputImage, class TPhotonCounts, class TSpectrum>
@@ -417,6 +423,19 @@ MechlemOneStepSpectralReconstructionFilter<TOutputImage, TPhotonCounts, TSpectru
   // Have the last filter calculate its output information
   lastOutput->UpdateOutputInformation();
 
+  // Plan the buffers of the internal pipeline. The back projections are
+  // accumulated by the loop over the projections and the Nesterov filter
+  // stores two volumes between its iterations.
+  this->m_MemoryPlanner->Initialize();
+  this->m_MemoryPlanner->SetMemoryCap(this->m_MemoryCap);
+  this->m_MemoryPlanner->AddOutput(lastOutput);
+  this->m_MemoryPlanner->AddRetainedData(m_NesterovFilter->GetOutput());
+  this->m_MemoryPlanner->AddRetainedData(m_GradientsBackProjectionFilter->GetOutput());
+  this->m_MemoryPlanner->AddRetainedData(m_HessiansBackProjectionFilter->GetOutput());
+  this->m_MemoryPlanner->AddTransientMemory(
+    m_NesterovFilter, 2 * this->m_MemoryPlanner->GetBytes(this->GetInputMaterialVolumes().GetPointer()));
+  this->m_MemoryPlanner->Plan(this);
+
   // Copy it as the output information of the composite filter
   this->GetOutput()->CopyInformation(lastOutput);
 }
@@ -510,6 +529,8 @@ MechlemOneStepSpectralReconstructionFilter<TOutputImage, TPhotonCounts, TSpectru
       }
       this->GraftOutput(Next_Zk);
       iterationReporter.CompletedStep();
+      if (this->GetTelemetryStopRequested())
+        return;
     }
   }
 }
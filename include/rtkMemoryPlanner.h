@@ -0,0 +1,274 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef rtkMemoryPlanner_h
+#define rtkMemoryPlanner_h
+
+#include "RTKExport.h"
+
+#include <itkDataObject.h>
+#include <itkInPlaceImageFilter.h>
+#include <itkObject.h>
+#include <itkObjectFactory.h>
+#include <itkProcessObject.h>
+#include <itkVectorImage.h>
+
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace rtk
+{
+
+/** \class MemoryPlanner
+ * \brief Plans the image buffers of the internal pipeline of a composite filter.
+ *
+ * The planner walks the internal pipeline from its outputs up to the inputs of
+ * the composite filter and orders the internal filters as the pipeline
+ * executes them. Each image produced by a filter lives from its production to
+ * its last consumer if its ReleaseDataFlag is on, or is consumed by a filter
+ * running in place, and until the end of the pipeline otherwise. The images
+ * are then assigned to a pool of buffers by their lifetimes, as a register
+ * allocator would do, and the predicted peak is the largest sum of the sizes
+ * of the images alive at the same time, plus the working memory of nested
+ * composite filters declared with AddTransientMemory.
+ *
+ * If MemoryCap is set and the predicted peak exceeds it, the images with a
+ * single consumer are released after it and the consumers which can run in
+ * place on them are switched to in-place. The images read by the composite
+ * filter itself, e.g., to plug them back as inputs, must be declared with
+ * AddRetainedData so that they are never released. A warning is issued if the
+ * cap cannot be met. The flags switched by a plan are switched back by the
+ * next plan, before the cap is applied again, so that a plan without cap
+ * leaves the pipeline as it was built.
+ *
+ * Sizes and in-place filters are only known for the image types registered
+ * with RegisterImageType, the images of other types count for 0 byte.
+ *
+ * \ingroup RTK
+ */
+class RTK_EXPORT MemoryPlanner : public itk::Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(MemoryPlanner);
+
+  /** Standard class type alias. */
+  using Self = MemoryPlanner;
+  using Superclass = itk::Object;
+  using Pointer = itk::SmartPointer<Self>;
+  using ConstPointer = itk::SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(MemoryPlanner, itk::Object);
+
+  /** Get / Set the memory cap of the internal pipeline in bytes, 0 (default)
+   * for no cap. */
+  itkGetMacro(MemoryCap, itk::SizeValueType);
+  itkSetMacro(MemoryCap, itk::SizeValueType);
+
+  /** Registers the image type TImage and the in-place filters from and to
+   * TImage. */
+  template <class TImage>
+  void
+  RegisterImageType();
+
+  /** Removes the outputs, the retained data and the transient memory of the
+   * previous plan. The registered types are kept. */
+  void
+  Initialize();
+
+  /** Output of the internal pipeline, alive until the end of the pipeline. */
+  void
+  AddOutput(itk::DataObject * output);
+
+  /** Image of the internal pipeline read by the composite filter, never
+   * released. */
+  void
+  AddRetainedData(itk::DataObject * data);
+
+  /** Working memory in bytes allocated by filter while it runs, e.g., by a
+   * nested composite filter. */
+  void
+  AddTransientMemory(const itk::ProcessObject * filter, itk::SizeValueType bytes);
+
+  /** Analyzes the internal pipeline of owner which computes the outputs,
+   * applies the MemoryCap if any and assigns the buffers. */
+  void
+  Plan(itk::ProcessObject * owner);
+
+  /** Size in bytes of the largest possible region of data, 0 if its type is
+   * not registered. */
+  itk::SizeValueType
+  GetBytes(const itk::DataObject * data) const;
+
+  /** Results of the last plan. */
+  itkGetConstMacro(PredictedPeak, itk::SizeValueType);
+  itkGetConstMacro(PoolSize, itk::SizeValueType);
+  unsigned int
+  GetNumberOfBuffers() const
+  {
+    return m_BufferSizes.size();
+  }
+  unsigned int
+  GetNumberOfSteps() const
+  {
+    return m_Steps.size();
+  }
+
+protected:
+  MemoryPlanner() = default;
+  ~MemoryPlanner() override = default;
+
+  void
+  PrintSelf(std::ostream & os, itk::Indent indent) const override;
+
+private:
+  using SizeFunctionType = std::function<bool(const itk::DataObject *, itk::SizeValueType &)>;
+
+  /** Returns false if filter is not an in-place filter of the type or if
+   * input is not its primary input. Otherwise, returns in inPlace whether it
+   * runs in place after having switched it to in-place if enable is true. */
+  using InPlaceFunctionType =
+    std::function<bool(itk::ProcessObject * filter, const itk::DataObject * input, bool enable, bool & inPlace)>;
+
+  /** Returns false if filter is not an in-place filter of the type.
+   * Otherwise, returns its InPlace flag in inPlaceFlag and then sets it to
+   * newInPlaceFlag if not null. */
+  using InPlaceFlagFunctionType =
+    std::function<bool(itk::ProcessObject * filter, bool & inPlaceFlag, const bool * newInPlaceFlag)>;
+
+  /** Image produced by the internal pipeline. */
+  struct Interval
+  {
+    itk::DataObject *  Data;
+    std::string        Producer;
+    itk::SizeValueType Bytes;
+    unsigned int       Start;
+    unsigned int       End;
+    int                Buffer;
+  };
+
+  template <class TImage>
+  static itk::SizeValueType
+  GetPixelBytes(const TImage *)
+  {
+    return sizeof(typename TImage::PixelType);
+  }
+  template <class TValue, unsigned int VDimension>
+  static itk::SizeValueType
+  GetPixelBytes(const itk::VectorImage<TValue, VDimension> * image)
+  {
+    return sizeof(TValue) * image->GetNumberOfComponentsPerPixel();
+  }
+
+  /** Orders the internal filters upstream of filter. */
+  void
+  Visit(itk::ProcessObject * filter);
+
+  /** Computes the lifetimes of the images and the predicted peak. */
+  void
+  Analyze();
+
+  /** Releases the images with a single consumer and runs their consumer in
+   * place when possible. */
+  void
+  ReduceMemory();
+
+  /** Assigns the images to buffers by their lifetimes. */
+  void
+  AssignBuffers();
+
+  /** Switches back the flags switched by the last ReduceMemory. */
+  void
+  RestoreFlags();
+
+  bool
+  IsInternal(const itk::DataObject * data) const;
+  bool
+  RunsInPlace(itk::ProcessObject * filter, const itk::DataObject * input, bool enable) const;
+  bool
+  GetInPlaceFlag(itk::ProcessObject * filter, bool & inPlaceFlag, const bool * newInPlaceFlag = nullptr) const;
+
+  itk::SizeValueType m_MemoryCap{ 0 };
+  itk::SizeValueType m_PredictedPeak{ 0 };
+  itk::SizeValueType m_PoolSize{ 0 };
+
+  std::vector<SizeFunctionType>        m_SizeFunctions;
+  std::vector<InPlaceFunctionType>     m_InPlaceFunctions;
+  std::vector<InPlaceFlagFunctionType> m_InPlaceFlagFunctions;
+
+  std::vector<itk::DataObject *>                               m_Outputs;
+  std::set<const itk::DataObject *>                            m_RetainedData;
+  std::map<const itk::ProcessObject *, itk::SizeValueType>     m_TransientMemory;
+  std::set<const itk::DataObject *>                            m_Boundary;
+  std::vector<itk::ProcessObject *>                            m_Steps;
+  std::map<const itk::ProcessObject *, unsigned int>           m_StepIndices;
+  std::map<const itk::DataObject *, std::vector<unsigned int>> m_Consumers;
+  std::vector<Interval>                                        m_Intervals;
+  std::vector<itk::SizeValueType>                              m_BufferSizes;
+
+  /** Images released and filters switched to in-place by ReduceMemory. The
+   * images are identified by their producer, which is held, because they may
+   * have been replaced in the meantime, e.g., by DisconnectPipeline. */
+  std::vector<std::pair<itk::ProcessObject::Pointer, const itk::DataObject *>> m_ReleasedData;
+  std::vector<itk::ProcessObject::Pointer>                                     m_InPlaceFilters;
+};
+
+template <class TImage>
+void
+MemoryPlanner::RegisterImageType()
+{
+  m_SizeFunctions.push_back([](const itk::DataObject * data, itk::SizeValueType & bytes) {
+    const auto * image = dynamic_cast<const TImage *>(data);
+    if (image == nullptr)
+      return false;
+    bytes = image->GetLargestPossibleRegion().GetNumberOfPixels() * GetPixelBytes(image);
+    return true;
+  });
+
+  using InPlaceFilterType = itk::InPlaceImageFilter<TImage, TImage>;
+  m_InPlaceFunctions.push_back(
+    [](itk::ProcessObject * filter, const itk::DataObject * input, bool enable, bool & inPlace) {
+      auto * inPlaceFilter = dynamic_cast<InPlaceFilterType *>(filter);
+      if (inPlaceFilter == nullptr || inPlaceFilter->GetInput() != input)
+        return false;
+      if (enable)
+        inPlaceFilter->InPlaceOn();
+      inPlace = inPlaceFilter->GetInPlace() && inPlaceFilter->CanRunInPlace();
+      return true;
+    });
+  m_InPlaceFlagFunctions.push_back([](itk::ProcessObject * filter, bool & inPlaceFlag, const bool * newInPlaceFlag) {
+    auto * inPlaceFilter = dynamic_cast<InPlaceFilterType *>(filter);
+    if (inPlaceFilter == nullptr)
+      return false;
+    inPlaceFlag = inPlaceFilter->GetInPlace();
+    if (newInPlaceFlag != nullptr)
+      inPlaceFilter->SetInPlace(*newInPlaceFlag);
+    return true;
+  });
+}
+
+} // end namespace rtk
+
+#endif
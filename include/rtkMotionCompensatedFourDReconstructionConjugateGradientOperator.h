@@ -20,7 +20,8 @@
 
 #include "rtkFourDReconstructionConjugateGradientOperator.h"
 #include "rtkCyclicDeformationImageFilter.h"
-#include "rtkJosephForwardProjectionImageFilter.h"
+#include "rtkWarpForwardProjectionImageFilter.h"
+#include "rtkWarpBackProjectionImageFilter.h"
 
 #ifdef RTK_USE_CUDA
 #  include "rtkCudaWarpForwardProjectionImageFilter.h"
@@ -124,18 +125,23 @@ public:
     typename std::conditional<std::is_same<VolumeSeriesType, CPUVolumeSeriesType>::value,
                               itk::Image<VectorForDVF, VolumeSeriesType::ImageDimension - 1>,
                               itk::CudaImage<VectorForDVF, VolumeSeriesType::ImageDimension - 1>>::type DVFImageType;
+  using CPUWarpForwardProjectionImageFilterType =
+    WarpForwardProjectionImageFilter<ProjectionStackType, ProjectionStackType, DVFImageType>;
+  using CPUWarpBackProjectionImageFilterType = WarpBackProjectionImageFilter<VolumeType, VolumeType, DVFImageType>;
   typedef typename std::conditional<std::is_same<VolumeSeriesType, CPUVolumeSeriesType>::value,
-                                    JosephForwardProjectionImageFilter<ProjectionStackType, ProjectionStackType>,
+                                    CPUWarpForwardProjectionImageFilterType,
                                     CudaWarpForwardProjectionImageFilter>::type WarpForwardProjectionImageFilterType;
   typedef typename std::conditional<std::is_same<VolumeSeriesType, CPUVolumeSeriesType>::value,
-                                    BackProjectionImageFilter<VolumeType, VolumeType>,
+                                    CPUWarpBackProjectionImageFilterType,
                                     CudaWarpBackProjectionImageFilter>::type    WarpBackProjectionImageFilterType;
 #else
   using DVFSequenceImageType = itk::Image<VectorForDVF, VolumeSeriesType::ImageDimension>;
   using DVFImageType = itk::Image<VectorForDVF, VolumeSeriesType::ImageDimension - 1>;
-  using WarpForwardProjectionImageFilterType =
-    JosephForwardProjectionImageFilter<ProjectionStackType, ProjectionStackType>;
-  using WarpBackProjectionImageFilterType = BackProjectionImageFilter<VolumeType, VolumeType>;
+  using CPUWarpForwardProjectionImageFilterType =
+    WarpForwardProjectionImageFilter<ProjectionStackType, ProjectionStackType, DVFImageType>;
+  using CPUWarpBackProjectionImageFilterType = WarpBackProjectionImageFilter<VolumeType, VolumeType, DVFImageType>;
+  using WarpForwardProjectionImageFilterType = CPUWarpForwardProjectionImageFilterType;
+  using WarpBackProjectionImageFilterType = CPUWarpBackProjectionImageFilterType;
 #endif
   using CPUDVFInterpolatorType = CyclicDeformationImageFilter<DVFSequenceImageType, DVFImageType>;
 #ifdef RTK_USE_CUDA
@@ -19,8 +19,6 @@
 #define rtkMotionCompensatedFourDReconstructionConjugateGradientOperator_hxx
 
 
-#include "rtkJosephForwardProjectionImageFilter.h"
-
 namespace rtk
 {
 
@@ -34,10 +32,6 @@ MotionCompensatedFourDReconstructionConjugateGradientOperator<VolumeSeriesType,
 
   this->m_ForwardProjectionFilter = WarpForwardProjectionImageFilterType::New();
   this->m_BackProjectionFilter = WarpBackProjectionImageFilterType::New();
-  if (std::is_same<VolumeSeriesType, CPUVolumeSeriesType>::value)
-    itkWarningMacro("The warp forward and back project image filters exist only"
-                    << " in CUDA. Ignoring the displacement vector field and using CPU"
-                    << "Joseph forward projection and CPU voxel-based back projection");
 }
 
 template <typename VolumeSeriesType, typename ProjectionStackType>
@@ -106,17 +100,28 @@ MotionCompensatedFourDReconstructionConjugateGradientOperator<VolumeSeriesType,
   m_InverseDVFInterpolatorFilter->SetFrame(0);
 
 #ifdef RTK_USE_CUDA
-  CudaWarpForwardProjectionImageFilter * wfp;
-  wfp = dynamic_cast<CudaWarpForwardProjectionImageFilter *>(this->m_ForwardProjectionFilter.GetPointer());
-  using CudaDVFImageType = itk::CudaImage<VectorForDVF, VolumeSeriesType::ImageDimension - 1>;
-  CudaDVFImageType * cudvf;
-  cudvf = dynamic_cast<CudaDVFImageType *>(m_InverseDVFInterpolatorFilter->GetOutput());
-  wfp->SetDisplacementField(cudvf);
-  CudaWarpBackProjectionImageFilter * wbp;
-  wbp = dynamic_cast<CudaWarpBackProjectionImageFilter *>(this->m_BackProjectionFilter.GetPointer());
-  cudvf = dynamic_cast<CudaDVFImageType *>(m_DVFInterpolatorFilter->GetOutput());
-  wbp->SetDisplacementField(cudvf);
+  if (!std::is_same<VolumeSeriesType, CPUVolumeSeriesType>::value)
+  {
+    CudaWarpForwardProjectionImageFilter * wfp;
+    wfp = dynamic_cast<CudaWarpForwardProjectionImageFilter *>(this->m_ForwardProjectionFilter.GetPointer());
+    using CudaDVFImageType = itk::CudaImage<VectorForDVF, VolumeSeriesType::ImageDimension - 1>;
+    CudaDVFImageType * cudvf;
+    cudvf = dynamic_cast<CudaDVFImageType *>(m_InverseDVFInterpolatorFilter->GetOutput());
+    wfp->SetDisplacementField(cudvf);
+    CudaWarpBackProjectionImageFilter * wbp;
+    wbp = dynamic_cast<CudaWarpBackProjectionImageFilter *>(this->m_BackProjectionFilter.GetPointer());
+    cudvf = dynamic_cast<CudaDVFImageType *>(m_DVFInterpolatorFilter->GetOutput());
+    wbp->SetDisplacementField(cudvf);
+  }
 #endif
+  // The forward projection follows the inverse deformation, the back
+  // projection the direct one
+  auto * cpuwfp = dynamic_cast<CPUWarpForwardProjectionImageFilterType *>(this->m_ForwardProjectionFilter.GetPointer());
+  if (cpuwfp)
+    cpuwfp->SetDisplacementField(m_InverseDVFInterpolatorFilter->GetOutput());
+  auto * cpuwbp = dynamic_cast<CPUWarpBackProjectionImageFilterType *>(this->m_BackProjectionFilter.GetPointer());
+  if (cpuwbp)
+    cpuwbp->SetDisplacementField(m_DVFInterpolatorFilter->GetOutput());
 
   Superclass::GenerateOutputInformation();
 }
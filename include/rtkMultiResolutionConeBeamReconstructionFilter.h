@@ -0,0 +1,174 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef rtkMultiResolutionConeBeamReconstructionFilter_h
+#define rtkMultiResolutionConeBeamReconstructionFilter_h
+
+#include "rtkIterativeConeBeamReconstructionFilter.h"
+
+#include <itkBinShrinkImageFilter.h>
+#include <itkResampleImageFilter.h>
+
+#include <vector>
+
+namespace rtk
+{
+
+/** \class MultiResolutionConeBeamReconstructionFilter
+ * \brief Coarse-to-fine driver of an iterative cone-beam reconstruction filter.
+ *
+ * The reconstruction filter, e.g., rtk::SARTConeBeamReconstructionFilter,
+ * rtk::OSEMConeBeamReconstructionFilter,
+ * rtk::ConjugateGradientConeBeamReconstructionFilter or the ADMM filters, is
+ * run once per level of a schedule, from the coarsest level to the finest
+ * one. At a level with a shrink factor f, the volume (input 0) and the
+ * projections (input 1) are binned by f with itk::BinShrinkImageFilter, in
+ * the three dimensions of the volume and in the two dimensions of the
+ * detector, and the reconstruction runs for the number of iterations of the
+ * level. The geometry is unchanged since the binned images cover the same
+ * physical extent. The result initializes the next level after linear
+ * resampling on its grid. The last level must have a shrink factor of 1 and
+ * its output is the output of the filter.
+ *
+ * The low frequencies, which converge slowly, are then mostly recovered at
+ * the cheap coarse levels and few iterations are needed at full resolution.
+ * The number of iterations of each level is set with
+ * SetNumberOfOuterIterations of the reconstruction filter. The other inputs
+ * of the reconstruction filter, e.g., the weights of
+ * rtk::ConjugateGradientConeBeamReconstructionFilter, are binned with the
+ * projections if they have the grid of the projections and with the volume
+ * if they have the grid of the volume, i.e., the same origin, spacing and
+ * size. An exception is thrown for other grids. Binning averages the pixels,
+ * the weights are therefore not rescaled for the lower noise of the binned
+ * projections.
+ *
+ * \dot
+ * digraph MultiResolutionConeBeamReconstructionFilter {
+ *
+ * Input0 [label="Input 0 (Volume)"];
+ * Input0 [shape=Box];
+ * Input1 [label="Input 1 (Projections)"];
+ * Input1 [shape=Box];
+ * Output [label="Output (Reconstruction)"];
+ * Output [shape=Box];
+ *
+ * node [shape=box];
+ * VolumeBinning [label="itk::BinShrinkImageFilter (volume)" URL="\ref itk::BinShrinkImageFilter"];
+ * ProjectionBinning [label="itk::BinShrinkImageFilter (projections)" URL="\ref itk::BinShrinkImageFilter"];
+ * Reconstruction [label="rtk::IterativeConeBeamReconstructionFilter"
+ *                 URL="\ref rtk::IterativeConeBeamReconstructionFilter"];
+ * Resample [label="itk::ResampleImageFilter" URL="\ref itk::ResampleImageFilter"];
+ *
+ * Input0 -> VolumeBinning;
+ * Input1 -> ProjectionBinning;
+ * VolumeBinning -> Reconstruction [label="First level"];
+ * VolumeBinning -> Resample [label="Output grid"];
+ * Resample -> Reconstruction [label="Next levels"];
+ * ProjectionBinning -> Reconstruction;
+ * Reconstruction -> Resample;
+ * Reconstruction -> Output [label="Last level"];
+ * }
+ * \enddot
+ *
+ * \test rtkmultiresolutiontest.cxx
+ *
+ * \ingroup RTK ReconstructionAlgorithm
+ */
+template <class TOutputImage>
+class ITK_TEMPLATE_EXPORT MultiResolutionConeBeamReconstructionFilter
+  : public itk::ImageToImageFilter<TOutputImage, TOutputImage>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(MultiResolutionConeBeamReconstructionFilter);
+
+  /** Standard class type alias. */
+  using Self = MultiResolutionConeBeamReconstructionFilter;
+  using Superclass = itk::ImageToImageFilter<TOutputImage, TOutputImage>;
+  using Pointer = itk::SmartPointer<Self>;
+  using ConstPointer = itk::SmartPointer<const Self>;
+
+  /** Typedefs of the subfilters */
+  using ReconstructionFilterType = IterativeConeBeamReconstructionFilter<TOutputImage, TOutputImage>;
+  using BinShrinkFilterType = itk::BinShrinkImageFilter<TOutputImage, TOutputImage>;
+  using ResampleFilterType = itk::ResampleImageFilter<TOutputImage, TOutputImage>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(MultiResolutionConeBeamReconstructionFilter, itk::ImageToImageFilter);
+
+  /** Get / Set the reconstruction filter run at each level. Its geometry, its
+   * projectors and its other parameters must be set beforehand. */
+  itkGetModifiableObjectMacro(ReconstructionFilter, ReconstructionFilterType);
+  itkSetObjectMacro(ReconstructionFilter, ReconstructionFilterType);
+
+  /** Sets the schedule: the shrink factor of each level, in strictly
+   * decreasing order and ending with 1, and the number of iterations of each
+   * level. Default is a single full resolution level of 1 iteration. */
+  virtual void
+  SetSchedule(const std::vector<unsigned int> & shrinkFactors, const std::vector<unsigned int> & numberOfIterations);
+  const std::vector<unsigned int> &
+  GetShrinkFactors() const
+  {
+    return m_ShrinkFactors;
+  }
+  const std::vector<unsigned int> &
+  GetNumberOfIterations() const
+  {
+    return m_NumberOfIterations;
+  }
+
+  /** Level being reconstructed, e.g., in an observer of the IterationEvent
+   * invoked at the end of each level. */
+  itkGetConstMacro(CurrentLevel, unsigned int);
+
+protected:
+  MultiResolutionConeBeamReconstructionFilter();
+  ~MultiResolutionConeBeamReconstructionFilter() override = default;
+
+  /** Checks that the reconstruction filter and a valid schedule are set. */
+  void
+  VerifyPreconditions() ITKv5_CONST override;
+
+  /** The whole volume and projections are required. */
+  void
+  GenerateInputRequestedRegion() override;
+
+  void
+  GenerateData() override;
+
+  /** Returns image binned by factor, in all dimensions for a volume and in
+   * the two dimensions of the detector for projections. */
+  typename TOutputImage::Pointer
+  Bin(TOutputImage * image, unsigned int factor, bool projections);
+
+  typename ReconstructionFilterType::Pointer m_ReconstructionFilter;
+
+private:
+  std::vector<unsigned int> m_ShrinkFactors{ 1 };
+  std::vector<unsigned int> m_NumberOfIterations{ 1 };
+  unsigned int              m_CurrentLevel{ 0 };
+};
+} // namespace rtk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "rtkMultiResolutionConeBeamReconstructionFilter.hxx"
+#endif
+
+#endif
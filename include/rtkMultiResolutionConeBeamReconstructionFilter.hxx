@@ -0,0 +1,185 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef rtkMultiResolutionConeBeamReconstructionFilter_hxx
+#define rtkMultiResolutionConeBeamReconstructionFilter_hxx
+
+#include <itkLinearInterpolateImageFunction.h>
+#include <itkNearestNeighborExtrapolateImageFunction.h>
+
+#include <cmath>
+
+namespace rtk
+{
+
+template <class TOutputImage>
+MultiResolutionConeBeamReconstructionFilter<TOutputImage>::MultiResolutionConeBeamReconstructionFilter()
+{
+  this->SetNumberOfRequiredInputs(2);
+}
+
+template <class TOutputImage>
+void
+MultiResolutionConeBeamReconstructionFilter<TOutputImage>::SetSchedule(
+  const std::vector<unsigned int> & shrinkFactors,
+  const std::vector<unsigned int> & numberOfIterations)
+{
+  m_ShrinkFactors = shrinkFactors;
+  m_NumberOfIterations = numberOfIterations;
+  this->Modified();
+}
+
+template <class TOutputImage>
+void
+MultiResolutionConeBeamReconstructionFilter<TOutputImage>::VerifyPreconditions() ITKv5_CONST
+{
+  this->Superclass::VerifyPreconditions();
+
+  if (m_ReconstructionFilter.IsNull())
+    itkExceptionMacro(<< "ReconstructionFilter has not been set.");
+  if (m_ShrinkFactors.empty() || m_ShrinkFactors.size() != m_NumberOfIterations.size())
+    itkExceptionMacro(<< "The schedule must have as many shrink factors as numbers of iterations.");
+  for (unsigned int i = 1; i < m_ShrinkFactors.size(); i++)
+    if (m_ShrinkFactors[i] >= m_ShrinkFactors[i - 1])
+      itkExceptionMacro(<< "The shrink factors of the schedule must be strictly decreasing.");
+  if (m_ShrinkFactors.back() != 1)
+    itkExceptionMacro(<< "The last level of the schedule must have a shrink factor of 1.");
+}
+
+template <class TOutputImage>
+void
+MultiResolutionConeBeamReconstructionFilter<TOutputImage>::GenerateInputRequestedRegion()
+{
+  for (unsigned int i = 0; i < 2; i++)
+  {
+    typename TOutputImage::Pointer inputPtr = const_cast<TOutputImage *>(this->GetInput(i));
+    if (!inputPtr)
+      return;
+    inputPtr->SetRequestedRegion(inputPtr->GetLargestPossibleRegion());
+  }
+}
+
+template <class TOutputImage>
+typename TOutputImage::Pointer
+MultiResolutionConeBeamReconstructionFilter<TOutputImage>::Bin(TOutputImage * image,
+                                                                unsigned int   factor,
+                                                                bool           projections)
+{
+  if (factor == 1)
+    return image;
+
+  typename BinShrinkFilterType::ShrinkFactorsType factors;
+  factors.Fill(factor);
+  if (projections)
+    factors[TOutputImage::ImageDimension - 1] = 1;
+
+  typename BinShrinkFilterType::Pointer binShrink = BinShrinkFilterType::New();
+  binShrink->SetInput(image);
+  binShrink->SetShrinkFactors(factors);
+  binShrink->Update();
+  typename TOutputImage::Pointer binned = binShrink->GetOutput();
+  binned->DisconnectPipeline();
+  return binned;
+}
+
+template <class TOutputImage>
+void
+MultiResolutionConeBeamReconstructionFilter<TOutputImage>::GenerateData()
+{
+  auto * volume = const_cast<TOutputImage *>(this->GetInput(0));
+  auto * projections = const_cast<TOutputImage *>(this->GetInput(1));
+
+  // Other inputs of the reconstruction filter, binned with the projections if
+  // they have the grid of the projections and with the volume if they have the
+  // grid of the volume
+  auto sameGrid = [](const TOutputImage * a, const TOutputImage * b) {
+    if (a->GetLargestPossibleRegion().GetSize() != b->GetLargestPossibleRegion().GetSize())
+      return false;
+    for (unsigned int d = 0; d < TOutputImage::ImageDimension; d++)
+    {
+      const double tolerance = 1e-6 * std::abs(b->GetSpacing()[d]);
+      if (std::abs(a->GetSpacing()[d] - b->GetSpacing()[d]) > tolerance ||
+          std::abs(a->GetOrigin()[d] - b->GetOrigin()[d]) > tolerance)
+        return false;
+    }
+    return true;
+  };
+  std::vector<typename TOutputImage::Pointer> otherInputs;
+  std::vector<bool>                           otherInputsAreProjections;
+  const itk::ProcessObject::DataObjectPointerArray indexedInputs = m_ReconstructionFilter->GetIndexedInputs();
+  for (unsigned int i = 2; i < indexedInputs.size(); i++)
+  {
+    auto * image = dynamic_cast<TOutputImage *>(indexedInputs[i].GetPointer());
+    if (indexedInputs[i].IsNotNull() && image == nullptr && m_ShrinkFactors.front() > 1)
+      itkExceptionMacro(<< "Input " << i << " of " << m_ReconstructionFilter->GetNameOfClass()
+                        << " cannot be binned.");
+    if (image != nullptr)
+    {
+      image->Update();
+      if (!sameGrid(image, projections) && !sameGrid(image, volume))
+        itkExceptionMacro(<< "Input " << i << " of " << m_ReconstructionFilter->GetNameOfClass()
+                          << " has neither the grid of the projections nor the grid of the volume.");
+    }
+    otherInputs.push_back(image);
+    otherInputsAreProjections.push_back(image != nullptr && sameGrid(image, projections));
+  }
+
+  typename TOutputImage::Pointer estimate;
+  for (m_CurrentLevel = 0; m_CurrentLevel < m_ShrinkFactors.size(); m_CurrentLevel++)
+  {
+    const unsigned int factor = m_ShrinkFactors[m_CurrentLevel];
+
+    // The first level is initialized with the binned input volume, the next
+    // ones with the upsampled reconstruction of the previous level
+    typename TOutputImage::Pointer levelVolume = this->Bin(volume, factor, false);
+    if (estimate.IsNotNull())
+    {
+      typename ResampleFilterType::Pointer resample = ResampleFilterType::New();
+      resample->SetInput(estimate);
+      resample->SetOutputParametersFromImage(levelVolume);
+      resample->SetInterpolator(itk::LinearInterpolateImageFunction<TOutputImage, double>::New());
+      resample->SetExtrapolator(itk::NearestNeighborExtrapolateImageFunction<TOutputImage, double>::New());
+      resample->Update();
+      levelVolume = resample->GetOutput();
+      levelVolume->DisconnectPipeline();
+    }
+
+    m_ReconstructionFilter->SetInput(0, levelVolume);
+    m_ReconstructionFilter->SetInput(1, this->Bin(projections, factor, true));
+    for (unsigned int i = 0; i < otherInputs.size(); i++)
+      if (otherInputs[i].IsNotNull())
+        m_ReconstructionFilter->SetInput(i + 2, this->Bin(otherInputs[i], factor, otherInputsAreProjections[i]));
+    m_ReconstructionFilter->SetNumberOfOuterIterations(m_NumberOfIterations[m_CurrentLevel]);
+    m_ReconstructionFilter->Update();
+
+    estimate = m_ReconstructionFilter->GetOutput();
+    estimate->DisconnectPipeline();
+    this->InvokeEvent(itk::IterationEvent());
+  }
+
+  // Leave the reconstruction filter with the full resolution inputs
+  for (unsigned int i = 0; i < otherInputs.size(); i++)
+    if (otherInputs[i].IsNotNull())
+      m_ReconstructionFilter->SetInput(i + 2, otherInputs[i]);
+
+  this->GraftOutput(estimate);
+}
+
+} // end namespace rtk
+
+#endif // rtkMultiResolutionConeBeamReconstructionFilter_hxx
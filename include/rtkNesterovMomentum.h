@@ -0,0 +1,218 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef rtkNesterovMomentum_h
+#define rtkNesterovMomentum_h
+
+#include <itkCovariantVector.h>
+#include <itkDataObject.h>
+#include <itkImageRegionConstIterator.h>
+#include <itkImageRegionIterator.h>
+#include <itkMultiThreaderBase.h>
+#include <itkNumericTraits.h>
+
+#include <cmath>
+#include <limits>
+#include <mutex>
+
+namespace rtk
+{
+
+/** \class NesterovMomentum
+ * \brief FISTA momentum with adaptive restart for the updates of iterative
+ * algorithms.
+ *
+ * Given the iterate x_{k+1} computed by an update step, e.g., a subset of SART
+ * or OSEM, from the point y_k, Extrapolate returns the point of the next step
+ *
+ * y_{k+1} = x_{k+1} + (t_k - 1) / t_{k+1} (x_{k+1} - x_k),
+ * with t_1 = 1 and t_{k+1} = (1 + sqrt(1 + 4 t_k^2)) / 2,
+ *
+ * as in the FISTA algorithm [Beck and Teboulle, SIAM J Imaging Sci, 2009].
+ * The momentum is restarted, i.e., t is reset to 1 and y_{k+1} = x_{k+1}, as
+ * proposed by [O'Donoghue and Candes, Found Comput Math, 2015]:
+ * - with GRADIENT_RESTART, when the update y_k - x_{k+1} and the step
+ * x_{k+1} - x_k point in the same direction, i.e., their inner product is
+ * positive,
+ * - with FUNCTION_RESTART, when the objective passed to ReportObjective
+ * increases.
+ *
+ * With positivity enforced, the voxels where y_{k+1} is not positive keep the
+ * value of x_{k+1}. Extrapolate accepts images of scalars and of
+ * itk::CovariantVector, for which positivity is ignored.
+ *
+ * \ingroup RTK
+ */
+class NesterovMomentum
+{
+public:
+  typedef enum
+  {
+    NO_RESTART = 0,
+    GRADIENT_RESTART = 1,
+    FUNCTION_RESTART = 2
+  } RestartType;
+
+  NesterovMomentum(RestartType restart = GRADIENT_RESTART, bool enforcePositivity = false)
+    : m_Restart(restart)
+    , m_EnforcePositivity(enforcePositivity)
+  {}
+
+  /** Resets the momentum, the next extrapolation returns x. */
+  void
+  Restart()
+  {
+    m_T = 1.;
+    m_NumberOfRestarts++;
+  }
+
+  /** Objective, e.g., the residual norm of an iteration, restarts the
+   * momentum if it has increased with FUNCTION_RESTART. Returns true if the
+   * momentum has been restarted. */
+  bool
+  ReportObjective(double objective)
+  {
+    const bool restart = m_Restart == FUNCTION_RESTART && objective > m_PreviousObjective;
+    m_PreviousObjective = objective;
+    if (restart)
+      this->Restart();
+    return restart;
+  }
+
+  unsigned int
+  GetNumberOfRestarts() const
+  {
+    return m_NumberOfRestarts;
+  }
+
+  /** Returns y_{k+1} from the new iterate x = x_{k+1} and the point y = y_k
+   * from which it has been computed, with the work units of threader, e.g.,
+   * the multithreader of the calling filter. x is kept as x_k of the next call
+   * and must not be modified in the meantime. The returned image is x itself
+   * if there is no momentum, otherwise output if it is set, which must be
+   * distinct from x, y and x_k, or a new image. */
+  template <class TImage>
+  typename TImage::Pointer
+  Extrapolate(TImage * x, const TImage * y, itk::MultiThreaderBase * threader, TImage * output = nullptr)
+  {
+    using PixelType = typename TImage::PixelType;
+    using ValueType = typename itk::NumericTraits<PixelType>::ValueType;
+
+    // The previous iterate may only be referenced by the momentum
+    const itk::DataObject::ConstPointer previousObject = m_Previous;
+    const TImage *                      previous = dynamic_cast<const TImage *>(previousObject.GetPointer());
+    m_Previous = x;
+    if (previous == nullptr)
+    {
+      m_T = 1.;
+      return x;
+    }
+
+    const typename TImage::RegionType region = x->GetLargestPossibleRegion();
+    if (m_Restart == GRADIENT_RESTART)
+    {
+      // Inner product of the update and of the step
+      double     inner = 0.;
+      std::mutex accumulationLock;
+      threader->template ParallelizeImageRegion<TImage::ImageDimension>(
+        region,
+        [x, y, previous, &inner, &accumulationLock](const typename TImage::RegionType & outputRegionForThread) {
+          itk::ImageRegionConstIterator<TImage> itX(x, outputRegionForThread);
+          itk::ImageRegionConstIterator<TImage> itY(y, outputRegionForThread);
+          itk::ImageRegionConstIterator<TImage> itPrevious(previous, outputRegionForThread);
+          double                                currentThreadInner = 0.;
+          while (!itX.IsAtEnd())
+          {
+            const PixelType update = itY.Get() - itX.Get();
+            const PixelType step = itX.Get() - itPrevious.Get();
+            currentThreadInner += static_cast<double>(update * step);
+            ++itX;
+            ++itY;
+            ++itPrevious;
+          }
+
+          std::lock_guard<std::mutex> mutexHolder(accumulationLock);
+          inner += currentThreadInner;
+        },
+        nullptr);
+      if (inner > 0.)
+        this->Restart();
+    }
+
+    const double tNext = 0.5 * (1. + std::sqrt(1. + 4. * m_T * m_T));
+    const auto   beta = static_cast<ValueType>((m_T - 1.) / tNext);
+    m_T = tNext;
+    if (beta == itk::NumericTraits<ValueType>::ZeroValue())
+      return x;
+
+    typename TImage::Pointer extrapolated = output;
+    if (extrapolated.IsNull())
+    {
+      extrapolated = TImage::New();
+      extrapolated->CopyInformation(x);
+      extrapolated->SetRegions(region);
+      extrapolated->Allocate();
+    }
+    TImage *   out = extrapolated.GetPointer();
+    const bool positivity = m_EnforcePositivity;
+    threader->template ParallelizeImageRegion<TImage::ImageDimension>(
+      region,
+      [x, previous, out, beta, positivity](const typename TImage::RegionType & outputRegionForThread) {
+        itk::ImageRegionConstIterator<TImage> itX(x, outputRegionForThread);
+        itk::ImageRegionConstIterator<TImage> itPrevious(previous, outputRegionForThread);
+        itk::ImageRegionIterator<TImage>      itOut(out, outputRegionForThread);
+        while (!itX.IsAtEnd())
+        {
+          PixelType value = itX.Get() + (itX.Get() - itPrevious.Get()) * beta;
+          if (positivity && !IsPositive(value))
+            value = itX.Get();
+          itOut.Set(value);
+          ++itX;
+          ++itPrevious;
+          ++itOut;
+        }
+      },
+      nullptr);
+    return extrapolated;
+  }
+
+private:
+  template <class TPixel>
+  static bool
+  IsPositive(const TPixel & value)
+  {
+    return value > itk::NumericTraits<TPixel>::ZeroValue();
+  }
+  template <class TValue, unsigned int VDimension>
+  static bool
+  IsPositive(const itk::CovariantVector<TValue, VDimension> &)
+  {
+    return true;
+  }
+
+  RestartType                   m_Restart;
+  bool                          m_EnforcePositivity;
+  double                        m_T{ 1. };
+  itk::DataObject::ConstPointer m_Previous;
+  double                        m_PreviousObjective{ std::numeric_limits<double>::infinity() };
+  unsigned int                  m_NumberOfRestarts{ 0 };
+};
+
+} // end namespace rtk
+
+#endif
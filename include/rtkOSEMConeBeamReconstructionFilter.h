@@ -31,6 +31,7 @@
 
 #include "rtkConstantImageSource.h"
 #include "rtkIterativeConeBeamReconstructionFilter.h"
+#include "rtkNesterovMomentum.h"
 
 namespace rtk
 {
@@ -57,6 +58,24 @@ namespace rtk
  * using the SetBetaRegularization method. If the hyperparameter is set to 0 the
  * filter behaves like the classic MLEM/OSEM algorithm.
  *
+ * If FusedSubsets is on, the projections of a subset are copied in a
+ * preallocated stack which is forward projected and back projected with one
+ * call of each projector. The ratio of the measured and the forward projected
+ * projections is computed in place and the multiplicative update, including
+ * the De Pierro regularization, is applied to the volume in a single pass.
+ * The sensitivity (normalization) image of each subset is then computed once
+ * for all iterations if StoreNormalizationImages is on. The subsets are the
+ * same as without FusedSubsets.
+ *
+ * The updates can be accelerated with the FISTA momentum of
+ * rtk::NesterovMomentum, see SetMomentum, after each iteration or, with
+ * MomentumPerSubset, after each subset (OS-Nesterov). The voxels of the
+ * extrapolated volume which are not positive keep the value of the update
+ * since the multiplicative update cannot recover from them. The function
+ * restart monitors the Poisson negative log-likelihood of the projections of
+ * each iteration. The momentum of the subsets may not converge with many
+ * subsets and noisy projections, the restart then limits its effect.
+ *
  * \dot
  * digraph OSEMConeBeamReconstructionFilter {
  *
@@ -144,6 +163,7 @@ public:
 
   using ForwardProjectionType = typename Superclass::ForwardProjectionType;
   using BackProjectionType = typename Superclass::BackProjectionType;
+  using MomentumRestartType = NesterovMomentum::RestartType;
 
   /** Standard New method. */
   itkNewMacro(Self);
@@ -158,6 +178,11 @@ public:
   /** Get / Set the number of iterations. Default is 3. */
   itkGetMacro(NumberOfIterations, unsigned int);
   itkSetMacro(NumberOfIterations, unsigned int);
+  void
+  SetNumberOfOuterIterations(unsigned int n) override
+  {
+    this->SetNumberOfIterations(n);
+  }
 
   /** Get / Set the number of projections per subset. Default is 1. */
   itkGetMacro(NumberOfProjectionsPerSubset, unsigned int);
@@ -179,10 +204,48 @@ public:
    * are only computed once during the first iteration and stored to be reused
    * for the next iterations. This speed up the computation time but it is
    * more memory consuming than if the normalizations images were computed at
-   * each iteration (false). Default is true */
+   * each iteration (false). Default is true. The stored images are looked up
+   * in and added to the SensitivityCache if it is set. */
   itkGetMacro(StoreNormalizationImages, bool);
   itkSetMacro(StoreNormalizationImages, bool);
 
+  /** Get / Set FusedSubsets. If true, each subset is processed as a whole,
+   * see the class description. Default is false, i.e., the projections are
+   * forward and back projected one by one. */
+  itkGetMacro(FusedSubsets, bool);
+  itkSetMacro(FusedSubsets, bool);
+  itkBooleanMacro(FusedSubsets);
+
+  /** Get / Set the memory budget in bytes of the caches of the rotated
+   * attenuation factors shared by the Zeng projectors and of the attenuation
+   * weights of the rays shared by the Joseph attenuated projectors when an
+   * attenuation map is given. The attenuation of each projection is then only
+   * computed once for all subsets and iterations. Default is 0, i.e., no
+   * cache. */
+  itkGetMacro(AttenuationCacheMemoryBudget, itk::SizeValueType);
+  itkSetMacro(AttenuationCacheMemoryBudget, itk::SizeValueType);
+
+  /** Get / Set whether the updates are accelerated with a FISTA momentum.
+   * Default is false. */
+  itkGetMacro(Momentum, bool);
+  itkSetMacro(Momentum, bool);
+  itkBooleanMacro(Momentum);
+
+  /** Get / Set the adaptive restart of the momentum, see
+   * rtk::NesterovMomentum. Default is FUNCTION_RESTART since the gradient
+   * restart is designed for additive updates. */
+  itkGetMacro(MomentumRestart, MomentumRestartType);
+  itkSetMacro(MomentumRestart, MomentumRestartType);
+
+  /** Get / Set whether the momentum is applied after each subset (OS-Nesterov)
+   * instead of after each iteration. Default is false. */
+  itkGetMacro(MomentumPerSubset, bool);
+  itkSetMacro(MomentumPerSubset, bool);
+  itkBooleanMacro(MomentumPerSubset);
+
+  /** Number of restarts of the momentum during the last update. */
+  itkGetConstMacro(NumberOfMomentumRestarts, unsigned int);
+
 protected:
   OSEMConeBeamReconstructionFilter();
   ~OSEMConeBeamReconstructionFilter() override = default;
@@ -206,6 +269,39 @@ protected:
   VerifyInputInformation() const override
   {}
 
+  /** Appends the point spread function of the Zeng back projector to the key
+   * of the superclass. */
+  SensitivityImageCache::KeyType
+  GetBackProjectionOfOnesKey(const ThreeDCircularProjectionGeometry * geometry,
+                             const std::vector<unsigned int> &        projections) override;
+
+  /** Processes the subsets of projOrder with one forward and one back
+   * projection each, see FusedSubsets. */
+  void
+  GenerateDataFusedSubsets(const std::vector<unsigned int> & projOrder);
+
+  /** Geometry of the n projections of projOrder starting at first */
+  ThreeDCircularProjectionGeometry::Pointer
+  CreateSubsetGeometry(const std::vector<unsigned int> & projOrder, unsigned int first, unsigned int n) const;
+
+  /** Replaces the forward projections in ratio by the ratio of the measured
+   * projections and the forward projections. */
+  void
+  ComputeProjectionRatio(const ProjectionType * measured, ProjectionType * ratio);
+
+  /** Poisson negative log-likelihood of the measured projections given their
+   * estimate, up to a constant, for the function restart of the momentum. */
+  double
+  ComputeNegativeLogLikelihood(const ProjectionType * measured, const ProjectionType * estimate);
+
+  /** Multiplicative update of x with the De Pierro regularization, written in
+   * output. */
+  void
+  UpdateVolume(const VolumeType * x,
+               const VolumeType * backProjection,
+               const VolumeType * sensitivity,
+               VolumeType *       output);
+
   /** Pointers to each subfilter of this composite filter */
   typename ExtractFilterType::Pointer                m_ExtractFilter;
   typename ForwardProjectionFilterType::Pointer      m_ForwardProjectionFilter;
@@ -219,6 +315,9 @@ protected:
   typename ConstantVolumeSourceType::Pointer         m_ConstantVolumeSource;
   typename DePierroRegularizationFilterType::Pointer m_DePierroRegularizationFilter;
 
+  /** Negative log-likelihood of the current iteration */
+  double m_IterationNegativeLogLikelihood{ 0. };
+
 private:
   /** Number of projections processed before the volume is updated (several for OS-EM) */
   unsigned int m_NumberOfProjectionsPerSubset{ 1 };
@@ -237,6 +336,18 @@ private:
   double m_BetaRegularization{ 0.01 };
 
   bool m_StoreNormalizationImages{ true };
+  bool m_FusedSubsets{ false };
+
+  /** Caches of the attenuation of the Zeng and Joseph attenuated projectors */
+  itk::SizeValueType              m_AttenuationCacheMemoryBudget{ 0 };
+  ZengAttenuationCache::Pointer   m_AttenuationCache;
+  JosephAttenuationCache::Pointer m_JosephAttenuationCache;
+
+  /** Momentum of the updates */
+  bool                m_Momentum{ false };
+  MomentumRestartType m_MomentumRestart{ NesterovMomentum::FUNCTION_RESTART };
+  bool                m_MomentumPerSubset{ false };
+  unsigned int        m_NumberOfMomentumRestarts{ 0 };
 
 }; // end of class
 
@@ -22,8 +22,16 @@
 #include "rtkGeneralPurposeFunctions.h"
 
 #include <algorithm>
+#include <cmath>
+#include <initializer_list>
+#include <itkConstNeighborhoodIterator.h>
+#include <itkConstantBoundaryCondition.h>
+#include <itkImageAlgorithm.h>
+#include <itkImageRegionIterator.h>
 #include <itkTimeProbe.h>
 
+#include <mutex>
+
 #include <itkImageFileWriter.h>
 
 #include <itkIterationReporter.h>
@@ -42,6 +50,7 @@ OSEMConeBeamReconstructionFilter<TVolumeImage, TProjectionImage>::OSEMConeBeamRe
   m_ZeroConstantProjectionStackSource = ConstantProjectionSourceType::New();
   m_DivideProjectionFilter = DivideProjectionFilterType::New();
   m_DePierroRegularizationFilter = DePierroRegularizationFilterType::New();
+  this->WatchTelemetrySection(m_DePierroRegularizationFilter, IterationTelemetry::REGULARIZATION);
 
   // Create the filters required for the normalization of the
   // backprojection
@@ -50,6 +59,14 @@ OSEMConeBeamReconstructionFilter<TVolumeImage, TProjectionImage>::OSEMConeBeamRe
 
   // Permanent internal connections
   m_DivideProjectionFilter->SetInput1(m_ExtractFilter->GetOutput());
+
+  // Accumulate the negative log-likelihood for the function restart of the
+  // momentum before the ratio overwrites the projections
+  m_DivideProjectionFilter->AddObserver(itk::StartEvent(), [this](const itk::EventObject &) {
+    if (m_Momentum && m_MomentumRestart == NesterovMomentum::FUNCTION_RESTART)
+      m_IterationNegativeLogLikelihood +=
+        this->ComputeNegativeLogLikelihood(m_ExtractFilter->GetOutput(), m_ForwardProjectionFilter->GetOutput());
+  });
   m_DivideVolumeFilter->SetInput1(m_MultiplyFilter->GetOutput());
 
   // Default parameters
@@ -223,6 +240,48 @@ OSEMConeBeamReconstructionFilter<TVolumeImage, TProjectionImage>::GenerateOutput
   m_DivideProjectionFilter->SetInput2(m_ForwardProjectionFilter->GetOutput());
   m_DivideProjectionFilter->SetConstant(1);
 
+  // The rotated attenuation factors are shared by all Zeng projectors
+  if (m_AttenuationCacheMemoryBudget > 0 && this->GetInput(2))
+  {
+    if (m_AttenuationCache.IsNull())
+      m_AttenuationCache = ZengAttenuationCache::New();
+    m_AttenuationCache->SetMemoryBudget(m_AttenuationCacheMemoryBudget);
+    if (this->GetForwardProjectionFilter() == this->FP_ZENG)
+      dynamic_cast<ZengForwardProjectionImageFilter<TProjectionImage, TVolumeImage> *>(
+        m_ForwardProjectionFilter.GetPointer())
+        ->SetAttenuationCache(m_AttenuationCache);
+    if (this->GetBackProjectionFilter() == this->BP_ZENG)
+    {
+      dynamic_cast<ZengBackProjectionImageFilter<TVolumeImage, TProjectionImage> *>(
+        m_BackProjectionFilter.GetPointer())
+        ->SetAttenuationCache(m_AttenuationCache);
+      dynamic_cast<ZengBackProjectionImageFilter<TVolumeImage, TProjectionImage> *>(
+        m_BackProjectionNormalizationFilter.GetPointer())
+        ->SetAttenuationCache(m_AttenuationCache);
+    }
+  }
+
+  // Idem for the attenuation weights of the rays of the Joseph attenuated projectors
+  if (m_AttenuationCacheMemoryBudget > 0 && this->GetInput(2))
+  {
+    if (m_JosephAttenuationCache.IsNull())
+      m_JosephAttenuationCache = JosephAttenuationCache::New();
+    m_JosephAttenuationCache->SetMemoryBudget(m_AttenuationCacheMemoryBudget);
+    if (this->GetForwardProjectionFilter() == this->FP_JOSEPHATTENUATED)
+      dynamic_cast<JosephForwardAttenuatedProjectionImageFilter<TProjectionImage, TVolumeImage> *>(
+        m_ForwardProjectionFilter.GetPointer())
+        ->SetAttenuationCache(m_JosephAttenuationCache);
+    if (this->GetBackProjectionFilter() == this->BP_JOSEPHATTENUATED)
+    {
+      dynamic_cast<JosephBackAttenuatedProjectionImageFilter<TVolumeImage, TProjectionImage> *>(
+        m_BackProjectionFilter.GetPointer())
+        ->SetAttenuationCache(m_JosephAttenuationCache);
+      dynamic_cast<JosephBackAttenuatedProjectionImageFilter<TVolumeImage, TProjectionImage> *>(
+        m_BackProjectionNormalizationFilter.GetPointer())
+        ->SetAttenuationCache(m_JosephAttenuationCache);
+    }
+  }
+
   m_ForwardProjectionFilter->SetGeometry(this->m_Geometry);
   m_BackProjectionFilter->SetGeometry(this->m_Geometry);
   m_BackProjectionNormalizationFilter->SetGeometry(this->m_Geometry);
@@ -265,10 +324,30 @@ OSEMConeBeamReconstructionFilter<TVolumeImage, TProjectionImage>::GenerateData()
     projOrder[i] = i;
   std::shuffle(projOrder.begin(), projOrder.end(), Superclass::m_DefaultRandomEngine);
 
+  if (m_FusedSubsets)
+  {
+    this->GenerateDataFusedSubsets(projOrder);
+    return;
+  }
+
   // Declare the image used in the main loop
   typename TVolumeImage::Pointer pimg;
   typename TVolumeImage::Pointer norm;
 
+  // The stored normalization images may be found in the sensitivity cache
+  const bool                     useCache = m_StoreNormalizationImages && this->GetUseSensitivityCache();
+  SensitivityImageCache::KeyType normKey;
+  typename TVolumeImage::Pointer cachedNorm;
+  unsigned int                   nProjPerSubset = m_NumberOfProjectionsPerSubset;
+  if (nProjPerSubset == 0 || nProjPerSubset > nProj)
+    nProjPerSubset = nProj;
+
+  // Momentum of the updates and volume from which the current update is
+  // computed, i.e., the extrapolated volume
+  NesterovMomentum                    momentum(m_MomentumRestart, true);
+  typename TVolumeImage::ConstPointer start = this->GetInput(0);
+  this->GetMultiThreader()->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+
   itk::IterationReporter iterationReporter(this, 0, 1);
 
   // For each iteration, go over each projection
@@ -276,8 +355,17 @@ OSEMConeBeamReconstructionFilter<TVolumeImage, TProjectionImage>::GenerateData()
   {
     unsigned int projectionsProcessedInSubset = 0;
     unsigned int currentSubset = 0;
+    m_IterationNegativeLogLikelihood = 0.;
     for (unsigned int i = 0; i < nProj; i++)
     {
+      if (iter == 0 && useCache && projectionsProcessedInSubset == 0)
+      {
+        const std::vector<unsigned int> subset(projOrder.begin() + i,
+                                               projOrder.begin() + std::min(i + nProjPerSubset, nProj));
+        normKey = this->GetBackProjectionOfOnesKey(m_Geometry, subset);
+        cachedNorm = this->GetSensitivityCache()->template FindImage<TVolumeImage>(normKey);
+      }
+
       // Change projection subset
       subsetRegion.SetIndex(Dimension - 1, projOrder[i]);
       m_ExtractFilter->SetExtractionRegion(subsetRegion);
@@ -291,7 +379,7 @@ OSEMConeBeamReconstructionFilter<TVolumeImage, TProjectionImage>::GenerateData()
       m_BackProjectionFilter->GetOutput()->PropagateRequestedRegion();
 
       m_BackProjectionFilter->Update();
-      if (iter == 0 || !m_StoreNormalizationImages)
+      if ((iter == 0 && cachedNorm.IsNull()) || !m_StoreNormalizationImages)
       {
         m_OneConstantProjectionStackSource->SetInformationFromImage(
           const_cast<TProjectionImage *>(m_ExtractFilter->GetOutput()));
@@ -303,10 +391,14 @@ OSEMConeBeamReconstructionFilter<TVolumeImage, TProjectionImage>::GenerateData()
       projectionsProcessedInSubset++;
       if ((projectionsProcessedInSubset == m_NumberOfProjectionsPerSubset) || (i == nProj - 1))
       {
-        if (iter == 0 && m_StoreNormalizationImages)
+        if (iter == 0 && m_StoreNormalizationImages && cachedNorm.IsNotNull())
+          vectorNorm.push_back(cachedNorm);
+        else if (iter == 0 && m_StoreNormalizationImages)
         {
           vectorNorm.push_back(m_BackProjectionNormalizationFilter->GetOutput());
           vectorNorm.back()->DisconnectPipeline();
+          if (useCache)
+            this->GetSensitivityCache()->InsertImage(normKey, vectorNorm.back().GetPointer());
         }
         m_MultiplyFilter->SetInput1(m_BackProjectionFilter->GetOutput());
 
@@ -327,13 +419,19 @@ OSEMConeBeamReconstructionFilter<TVolumeImage, TProjectionImage>::GenerateData()
         pimg = m_DivideVolumeFilter->GetOutput();
         pimg->DisconnectPipeline();
 
-        m_ForwardProjectionFilter->SetInput(1, pimg);
-        m_DePierroRegularizationFilter->SetInput(0, pimg);
-        m_MultiplyFilter->SetInput2(pimg);
+        typename TVolumeImage::Pointer next = pimg;
+        if (m_Momentum && m_MomentumPerSubset)
+        {
+          next = momentum.Extrapolate(pimg.GetPointer(), start.GetPointer(), this->GetMultiThreader());
+          start = next;
+        }
+        m_ForwardProjectionFilter->SetInput(1, next);
+        m_DePierroRegularizationFilter->SetInput(0, next);
+        m_MultiplyFilter->SetInput2(next);
         m_BackProjectionFilter->SetInput(0, m_ConstantVolumeSource->GetOutput());
         m_BackProjectionNormalizationFilter->SetInput(0, m_ConstantVolumeSource->GetOutput());
 
-        currentSubset++;
+        this->ReportTelemetrySubset(currentSubset++);
         projectionsProcessedInSubset = 0;
       }
       // Backproject in the same image otherwise.
@@ -342,7 +440,7 @@ OSEMConeBeamReconstructionFilter<TVolumeImage, TProjectionImage>::GenerateData()
         pimg = m_BackProjectionFilter->GetOutput();
         pimg->DisconnectPipeline();
         m_BackProjectionFilter->SetInput(0, pimg);
-        if (iter == 0 || !m_StoreNormalizationImages)
+        if ((iter == 0 && cachedNorm.IsNull()) || !m_StoreNormalizationImages)
         {
           norm = m_BackProjectionNormalizationFilter->GetOutput();
           norm->DisconnectPipeline();
@@ -350,12 +448,382 @@ OSEMConeBeamReconstructionFilter<TVolumeImage, TProjectionImage>::GenerateData()
         }
       }
     }
+
+    // Momentum of the iteration or restart of the momentum of the subsets
+    if (m_Momentum)
+    {
+      const bool                     restart = momentum.ReportObjective(m_IterationNegativeLogLikelihood);
+      typename TVolumeImage::Pointer next = pimg;
+      if (!m_MomentumPerSubset)
+        next = momentum.Extrapolate(pimg.GetPointer(), start.GetPointer(), this->GetMultiThreader());
+      if (restart || !m_MomentumPerSubset)
+      {
+        m_ForwardProjectionFilter->SetInput(1, next);
+        m_DePierroRegularizationFilter->SetInput(0, next);
+        m_MultiplyFilter->SetInput2(next);
+        start = next;
+      }
+    }
+
     this->GraftOutput(pimg);
     iterationReporter.CompletedStep();
+    if (this->GetTelemetryStopRequested())
+      break;
   }
+  m_NumberOfMomentumRestarts = momentum.GetNumberOfRestarts();
   vectorNorm.clear();
 }
 
+template <class TVolumeImage, class TProjectionImage>
+void
+OSEMConeBeamReconstructionFilter<TVolumeImage, TProjectionImage>::GenerateDataFusedSubsets(
+  const std::vector<unsigned int> & projOrder)
+{
+  const unsigned int Dimension = this->InputImageDimension;
+  const unsigned int nProj = projOrder.size();
+  unsigned int       nProjPerSubset = m_NumberOfProjectionsPerSubset;
+  if (nProjPerSubset == 0 || nProjPerSubset > nProj)
+    nProjPerSubset = nProj;
+  const unsigned int nSubsets = (nProj + nProjPerSubset - 1) / nProjPerSubset;
+
+  // The geometry of each subset does not change with the iterations
+  std::vector<ThreeDCircularProjectionGeometry::Pointer> subsetGeometries;
+  for (unsigned int s = 0; s < nSubsets; s++)
+  {
+    const unsigned int first = s * nProjPerSubset;
+    subsetGeometries.push_back(this->CreateSubsetGeometry(projOrder, first, std::min(nProjPerSubset, nProj - first)));
+  }
+
+  // Allocation of the buffers reused for all subsets
+  auto newVolume = [this]() {
+    typename VolumeType::Pointer volume = VolumeType::New();
+    volume->CopyInformation(this->GetInput(0));
+    volume->SetRegions(this->GetInput(0)->GetLargestPossibleRegion());
+    volume->Allocate();
+    return volume;
+  };
+  auto newProjections = [this, Dimension](unsigned int n) {
+    typename ProjectionType::RegionType region = this->GetInput(1)->GetLargestPossibleRegion();
+    region.SetIndex(Dimension - 1, 0);
+    region.SetSize(Dimension - 1, n);
+    typename ProjectionType::Pointer projections = ProjectionType::New();
+    projections->CopyInformation(this->GetInput(1));
+    projections->SetRegions(region);
+    projections->Allocate();
+    return projections;
+  };
+
+  // The projection buffers have the size of the largest subset, a smaller
+  // subset uses their first n projections
+  auto subsetProjections = [Dimension](ProjectionType * buffer, unsigned int n) {
+    typename ProjectionType::RegionType region = buffer->GetLargestPossibleRegion();
+    region.SetSize(Dimension - 1, n);
+    typename ProjectionType::Pointer projections = ProjectionType::New();
+    projections->CopyInformation(buffer);
+    projections->SetRegions(region);
+    projections->SetPixelContainer(buffer->GetPixelContainer());
+    return projections;
+  };
+  typename ProjectionType::Pointer measuredBuffer = newProjections(nProjPerSubset);
+  typename ProjectionType::Pointer ratioBuffer = newProjections(nProjPerSubset);
+  typename ProjectionType::Pointer onesBuffer;
+
+  // Volumes of the iterates, allocated when none of them is free. At most two
+  // are used without momentum and four with momentum: the previous estimate
+  // kept by the momentum, the volume from which the update is computed, the
+  // new estimate and the extrapolated volume.
+  std::vector<typename VolumeType::Pointer> iterates(1, newVolume());
+  auto                                      freeIterate = [&](std::initializer_list<const VolumeType *> used) {
+    for (auto & iterate : iterates)
+      if (std::find(used.begin(), used.end(), iterate.GetPointer()) == used.end())
+        return iterate;
+    iterates.push_back(newVolume());
+    return iterates.back();
+  };
+  typename VolumeType::Pointer x = iterates[0];
+  typename VolumeType::Pointer backProjection = newVolume();
+  itk::ImageAlgorithm::Copy(this->GetInput(0), x.GetPointer(), x->GetBufferedRegion(), x->GetBufferedRegion());
+
+  std::vector<typename VolumeType::Pointer> sensitivities(m_StoreNormalizationImages ? nSubsets : 1);
+  const bool useCache = m_StoreNormalizationImages && this->GetUseSensitivityCache();
+
+  // Momentum of the updates, x is then the extrapolated volume from which the
+  // update is computed, estimate the update and previous the estimate kept by
+  // the momentum
+  NesterovMomentum             momentum(m_MomentumRestart, true);
+  typename VolumeType::Pointer estimate = x;
+  typename VolumeType::Pointer start;
+  typename VolumeType::Pointer previous;
+  if (m_Momentum)
+    start = x;
+  this->GetMultiThreader()->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+
+  itk::IterationReporter iterationReporter(this, 0, 1);
+
+  for (unsigned int iter = 0; iter < m_NumberOfIterations; iter++)
+  {
+    m_IterationNegativeLogLikelihood = 0.;
+    for (unsigned int s = 0; s < nSubsets; s++)
+    {
+      const unsigned int               first = s * nProjPerSubset;
+      const unsigned int               n = std::min(nProjPerSubset, nProj - first);
+      typename ProjectionType::Pointer measured = subsetProjections(measuredBuffer, n);
+      typename ProjectionType::Pointer ratio = subsetProjections(ratioBuffer, n);
+
+      // Gather the measured projections of the subset
+      typename ProjectionType::RegionType sourceRegion = this->GetInput(1)->GetLargestPossibleRegion();
+      typename ProjectionType::RegionType destinationRegion = measured->GetLargestPossibleRegion();
+      sourceRegion.SetSize(Dimension - 1, 1);
+      destinationRegion.SetSize(Dimension - 1, 1);
+      for (unsigned int i = 0; i < n; i++)
+      {
+        sourceRegion.SetIndex(Dimension - 1, projOrder[first + i]);
+        destinationRegion.SetIndex(Dimension - 1, i);
+        itk::ImageAlgorithm::Copy(this->GetInput(1), measured.GetPointer(), sourceRegion, destinationRegion);
+      }
+
+      // Forward projection of the subset and ratio with the measurements
+      ratio->FillBuffer(itk::NumericTraits<typename ProjectionType::PixelType>::ZeroValue());
+      m_ForwardProjectionFilter->SetInput(0, ratio);
+      m_ForwardProjectionFilter->SetInput(1, x);
+      m_ForwardProjectionFilter->SetGeometry(subsetGeometries[s]);
+      m_ForwardProjectionFilter->Update();
+      ratio = m_ForwardProjectionFilter->GetOutput();
+      ratio->DisconnectPipeline();
+      ratio->ReleaseDataFlagOff();
+      if (m_Momentum && m_MomentumRestart == NesterovMomentum::FUNCTION_RESTART)
+        m_IterationNegativeLogLikelihood += this->ComputeNegativeLogLikelihood(measured, ratio);
+      this->ComputeProjectionRatio(measured, ratio);
+
+      // Sensitivity of the subset, i.e., back projection of ones
+      typename VolumeType::Pointer & sensitivity = sensitivities[m_StoreNormalizationImages ? s : 0];
+      SensitivityImageCache::KeyType key;
+      if (iter == 0 && useCache)
+      {
+        key = this->GetBackProjectionOfOnesKey(
+          m_Geometry, std::vector<unsigned int>(projOrder.begin() + first, projOrder.begin() + first + n));
+        sensitivity = this->GetSensitivityCache()->template FindImage<VolumeType>(key);
+      }
+      if ((iter == 0 && sensitivity.IsNull()) || !m_StoreNormalizationImages)
+      {
+        if (onesBuffer.IsNull())
+        {
+          onesBuffer = newProjections(nProjPerSubset);
+          onesBuffer->FillBuffer(itk::NumericTraits<typename ProjectionType::PixelType>::OneValue());
+        }
+        if (sensitivity.IsNull())
+          sensitivity = newVolume();
+        sensitivity->FillBuffer(itk::NumericTraits<typename VolumeType::PixelType>::ZeroValue());
+        m_BackProjectionNormalizationFilter->SetInput(0, sensitivity);
+        m_BackProjectionNormalizationFilter->SetInput(1, subsetProjections(onesBuffer, n));
+        m_BackProjectionNormalizationFilter->SetGeometry(subsetGeometries[s]);
+        m_BackProjectionNormalizationFilter->Update();
+        sensitivity = m_BackProjectionNormalizationFilter->GetOutput();
+        sensitivity->DisconnectPipeline();
+        if (useCache)
+        {
+          sensitivity->ReleaseDataFlagOff();
+          this->GetSensitivityCache()->InsertImage(key, sensitivity.GetPointer());
+        }
+      }
+
+      // Back projection of the ratio
+      backProjection->FillBuffer(itk::NumericTraits<typename VolumeType::PixelType>::ZeroValue());
+      m_BackProjectionFilter->SetInput(0, backProjection);
+      m_BackProjectionFilter->SetInput(1, ratio);
+      m_BackProjectionFilter->SetGeometry(subsetGeometries[s]);
+      m_BackProjectionFilter->Update();
+      backProjection = m_BackProjectionFilter->GetOutput();
+      backProjection->DisconnectPipeline();
+
+      // The new estimate is written in a volume which is neither read by the
+      // update nor kept for the momentum
+      estimate = freeIterate({ x, start, previous });
+      this->UpdateVolume(x, backProjection, sensitivity, estimate);
+      x = estimate;
+      if (m_Momentum && m_MomentumPerSubset)
+      {
+        x = momentum.Extrapolate(estimate.GetPointer(),
+                                 start.GetPointer(),
+                                 this->GetMultiThreader(),
+                                 freeIterate({ estimate, start, previous }).GetPointer());
+        previous = estimate;
+        start = x;
+      }
+      this->ReportTelemetrySubset(s);
+    }
+
+    // Momentum of the iteration or restart of the momentum of the subsets
+    if (m_Momentum)
+    {
+      const bool restart = momentum.ReportObjective(m_IterationNegativeLogLikelihood);
+      if (!m_MomentumPerSubset)
+      {
+        x = momentum.Extrapolate(estimate.GetPointer(),
+                                 start.GetPointer(),
+                                 this->GetMultiThreader(),
+                                 freeIterate({ estimate, start, previous }).GetPointer());
+        previous = estimate;
+      }
+      else if (restart)
+        x = estimate;
+      start = x;
+    }
+
+    this->GraftOutput(estimate);
+    iterationReporter.CompletedStep();
+    if (this->GetTelemetryStopRequested())
+      break;
+  }
+  m_NumberOfMomentumRestarts = momentum.GetNumberOfRestarts();
+}
+
+template <class TVolumeImage, class TProjectionImage>
+SensitivityImageCache::KeyType
+OSEMConeBeamReconstructionFilter<TVolumeImage, TProjectionImage>::GetBackProjectionOfOnesKey(
+  const ThreeDCircularProjectionGeometry * geometry,
+  const std::vector<unsigned int> &        projections)
+{
+  SensitivityImageCache::KeyType key = Superclass::GetBackProjectionOfOnesKey(geometry, projections);
+  key.push_back(m_SigmaZero);
+  key.push_back(m_Alpha);
+  return key;
+}
+
+template <class TVolumeImage, class TProjectionImage>
+ThreeDCircularProjectionGeometry::Pointer
+OSEMConeBeamReconstructionFilter<TVolumeImage, TProjectionImage>::CreateSubsetGeometry(
+  const std::vector<unsigned int> & projOrder,
+  unsigned int                      first,
+  unsigned int                      n) const
+{
+  ThreeDCircularProjectionGeometry::Pointer geometry = ThreeDCircularProjectionGeometry::New();
+  geometry->SetRadiusCylindricalDetector(m_Geometry->GetRadiusCylindricalDetector());
+  for (unsigned int i = first; i < first + n; i++)
+  {
+    const unsigned int p = projOrder[i];
+    geometry->AddProjectionInRadians(m_Geometry->GetSourceToIsocenterDistances()[p],
+                                     m_Geometry->GetSourceToDetectorDistances()[p],
+                                     m_Geometry->GetGantryAngles()[p],
+                                     m_Geometry->GetProjectionOffsetsX()[p],
+                                     m_Geometry->GetProjectionOffsetsY()[p],
+                                     m_Geometry->GetOutOfPlaneAngles()[p],
+                                     m_Geometry->GetInPlaneAngles()[p],
+                                     m_Geometry->GetSourceOffsetsX()[p],
+                                     m_Geometry->GetSourceOffsetsY()[p]);
+    geometry->SetCollimationOfLastProjection(m_Geometry->GetCollimationUInf()[p],
+                                             m_Geometry->GetCollimationUSup()[p],
+                                             m_Geometry->GetCollimationVInf()[p],
+                                             m_Geometry->GetCollimationVSup()[p]);
+  }
+  return geometry;
+}
+
+template <class TVolumeImage, class TProjectionImage>
+void
+OSEMConeBeamReconstructionFilter<TVolumeImage, TProjectionImage>::ComputeProjectionRatio(
+  const ProjectionType * measured,
+  ProjectionType *       ratio)
+{
+  // Same as m_DivideProjectionFilter
+  const double threshold = m_DivideProjectionFilter->GetThreshold();
+  const double constant = m_DivideProjectionFilter->GetConstant();
+
+  this->GetMultiThreader()->template ParallelizeImageRegion<ProjectionType::ImageDimension>(
+    ratio->GetBufferedRegion(),
+    [measured, ratio, threshold, constant](const typename ProjectionType::RegionType & region) {
+      itk::ImageRegionConstIterator<ProjectionType> itM(measured, region);
+      itk::ImageRegionIterator<ProjectionType>      itR(ratio, region);
+      for (; !itR.IsAtEnd(); ++itM, ++itR)
+      {
+        const double estimate = itR.Get();
+        itR.Set(static_cast<typename ProjectionType::PixelType>((estimate < threshold) ? constant
+                                                                                         : itM.Get() / estimate));
+      }
+    },
+    nullptr);
+}
+
+template <class TVolumeImage, class TProjectionImage>
+double
+OSEMConeBeamReconstructionFilter<TVolumeImage, TProjectionImage>::ComputeNegativeLogLikelihood(
+  const ProjectionType * measured,
+  const ProjectionType * estimate)
+{
+  // The estimates below the threshold of m_DivideProjectionFilter are ignored
+  // as in the ratio
+  const double threshold = m_DivideProjectionFilter->GetThreshold();
+
+  double     negativeLogLikelihood = 0.;
+  std::mutex accumulationLock;
+  this->GetMultiThreader()->template ParallelizeImageRegion<ProjectionType::ImageDimension>(
+    estimate->GetBufferedRegion(),
+    [measured, estimate, threshold, &negativeLogLikelihood, &accumulationLock](
+      const typename ProjectionType::RegionType & region) {
+      itk::ImageRegionConstIterator<ProjectionType> itM(measured, region);
+      itk::ImageRegionConstIterator<ProjectionType> itE(estimate, region);
+      double                                        currentThreadSum = 0.;
+      for (; !itE.IsAtEnd(); ++itM, ++itE)
+      {
+        const double e = itE.Get();
+        if (e >= threshold && e > 0.)
+          currentThreadSum += e - itM.Get() * std::log(e);
+      }
+
+      std::lock_guard<std::mutex> mutexHolder(accumulationLock);
+      negativeLogLikelihood += currentThreadSum;
+    },
+    nullptr);
+  return negativeLogLikelihood;
+}
+
+template <class TVolumeImage, class TProjectionImage>
+void
+OSEMConeBeamReconstructionFilter<TVolumeImage, TProjectionImage>::UpdateVolume(const VolumeType * x,
+                                                                               const VolumeType * backProjection,
+                                                                               const VolumeType * sensitivity,
+                                                                               VolumeType *       output)
+{
+  // Same as m_DePierroRegularizationFilter followed by m_DivideVolumeFilter.
+  // The De Pierro kernel weighs the center of a 3x3x3 neighborhood with 26
+  // and its neighbors with 1.
+  const double beta = m_BetaRegularization;
+  const double threshold = m_DivideVolumeFilter->GetThreshold();
+  const double constant = m_DivideVolumeFilter->GetConstant();
+  const double centerWeight = std::pow(3., static_cast<double>(VolumeType::ImageDimension)) - 1.;
+
+  using BoundaryConditionType = itk::ConstantBoundaryCondition<VolumeType>;
+  using NeighborhoodIteratorType = itk::ConstNeighborhoodIterator<VolumeType, BoundaryConditionType>;
+
+  this->GetMultiThreader()->template ParallelizeImageRegion<VolumeType::ImageDimension>(
+    output->GetBufferedRegion(),
+    [=](const typename VolumeType::RegionType & region) {
+      typename NeighborhoodIteratorType::RadiusType radius;
+      radius.Fill((beta != 0.) ? 1 : 0);
+      NeighborhoodIteratorType                  itX(radius, x, region);
+      itk::ImageRegionConstIterator<VolumeType> itBP(backProjection, region);
+      itk::ImageRegionConstIterator<VolumeType> itS(sensitivity, region);
+      itk::ImageRegionIterator<VolumeType>      itOut(output, region);
+      for (; !itOut.IsAtEnd(); ++itX, ++itBP, ++itS, ++itOut)
+      {
+        const double xj = itX.GetCenterPixel();
+        const double update = xj * itBP.Get();
+        double       denominator = itS.Get();
+        if (beta != 0.)
+        {
+          double convolution = (centerWeight - 1.) * xj;
+          for (unsigned int i = 0; i < itX.Size(); i++)
+            convolution += itX.GetPixel(i);
+          const double a = denominator - beta * convolution;
+          denominator = 0.5 * (a + std::sqrt(a * a + 8. * beta * centerWeight * update));
+        }
+        itOut.Set(static_cast<typename VolumeType::PixelType>((denominator < threshold) ? constant
+                                                                                          : update / denominator));
+      }
+    },
+    nullptr);
+}
+
 } // end namespace rtk
 
 #endif // rtkOSEMConeBeamReconstructionFilter_hxx
@@ -0,0 +1,143 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef rtkOnlineFDKConeBeamReconstruction_h
+#define rtkOnlineFDKConeBeamReconstruction_h
+
+#include "rtkFDKWeightProjectionFilter.h"
+#include "rtkFFTRampImageFilter.h"
+#include "rtkFDKBackProjectionImageFilter.h"
+#include "rtkConfiguration.h"
+
+#include <mutex>
+
+namespace rtk
+{
+
+/** \class OnlineFDKConeBeamReconstruction
+ * \brief FDK reconstruction updated as the projections are acquired
+ *
+ * OnlineFDKConeBeamReconstruction runs the steps of
+ * FDKConeBeamReconstructionFilter, i.e., rtk::FDKWeightProjectionFilter,
+ * rtk::FFTRampImageFilter and rtk::FDKBackProjectionImageFilter, on each
+ * projection passed to AddProjections and accumulates the backprojections in
+ * a live volume. The reconstruction is therefore complete as soon as the last
+ * projection has been added, and GetSnapshot can be called at any time, e.g.,
+ * from another thread, to get a copy of the partial reconstruction.
+ *
+ * The geometry must describe the complete acquisition before the first
+ * projection is added because the angular weights of FDK depend on the
+ * neighboring projections. The displaced detector and short scan weights can
+ * be set with GetWeightFilter, see rtk::FDKWeightProjectionFilter.
+ *
+ * \test rtkfdktest.cxx
+ *
+ * \ingroup RTK ReconstructionAlgorithm
+ */
+template <class TImage, class TFFTPrecision = double>
+class ITK_TEMPLATE_EXPORT OnlineFDKConeBeamReconstruction : public itk::Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(OnlineFDKConeBeamReconstruction);
+
+  /** Standard class type alias. */
+  using Self = OnlineFDKConeBeamReconstruction;
+  using Superclass = itk::Object;
+  using Pointer = itk::SmartPointer<Self>;
+  using ConstPointer = itk::SmartPointer<const Self>;
+
+  /** Some convenient type alias. */
+  using ImageType = TImage;
+  using ImagePointer = typename ImageType::Pointer;
+  using WeightFilterType = rtk::FDKWeightProjectionFilter<ImageType, ImageType>;
+  using RampFilterType = rtk::FFTRampImageFilter<ImageType, ImageType, TFFTPrecision>;
+  using BackProjectionFilterType = rtk::FDKBackProjectionImageFilter<ImageType, ImageType>;
+
+  /** Standard New method. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(OnlineFDKConeBeamReconstruction, itk::Object);
+
+  /** Get / Set the object pointer to the geometry of the complete acquisition */
+  itkGetModifiableObjectMacro(Geometry, ThreeDCircularProjectionGeometry);
+  itkSetObjectMacro(Geometry, ThreeDCircularProjectionGeometry);
+
+  /** Get pointer to the weighting filter */
+  typename WeightFilterType::Pointer
+  GetWeightFilter()
+  {
+    return m_WeightFilter;
+  }
+
+  /** Get pointer to the ramp filter */
+  typename RampFilterType::Pointer
+  GetRampFilter()
+  {
+    return m_RampFilter;
+  }
+
+  /** Starts a new reconstruction in a copy of volume, which gives the grid of
+   * the reconstruction and the values to which the backprojections are
+   * added. */
+  void
+  SetVolume(const ImageType * volume);
+
+  /** Weights, filters and backprojects a stack of projections into the live
+   * volume. The projections are the projections firstProjection to
+   * firstProjection+n-1 of the geometry, whatever their index in projections. */
+  void
+  AddProjections(const ImageType * projections, unsigned int firstProjection);
+
+  /** Number of projections backprojected since the last SetVolume. */
+  unsigned int
+  GetNumberOfProjections() const;
+
+  /** Copy of the live volume. */
+  ImagePointer
+  GetSnapshot() const;
+
+protected:
+  OnlineFDKConeBeamReconstruction();
+  ~OnlineFDKConeBeamReconstruction() override = default;
+
+  void
+  PrintSelf(std::ostream & os, itk::Indent indent) const override;
+
+private:
+  /** Filters of the mini-pipeline applied to each stack of projections */
+  typename WeightFilterType::Pointer         m_WeightFilter;
+  typename RampFilterType::Pointer           m_RampFilter;
+  typename BackProjectionFilterType::Pointer m_BackProjectionFilter;
+
+  /** Geometry of the complete acquisition. */
+  ThreeDCircularProjectionGeometry::Pointer m_Geometry;
+
+  /** Live volume, protected by m_Mutex */
+  ImagePointer       m_Volume;
+  unsigned int       m_NumberOfProjections{ 0 };
+  mutable std::mutex m_Mutex;
+}; // end of class
+
+} // end namespace rtk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "rtkOnlineFDKConeBeamReconstruction.hxx"
+#endif
+
+#endif
@@ -0,0 +1,127 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef rtkOnlineFDKConeBeamReconstruction_hxx
+#define rtkOnlineFDKConeBeamReconstruction_hxx
+
+
+#include <itkImageDuplicator.h>
+
+namespace rtk
+{
+
+template <class TImage, class TFFTPrecision>
+OnlineFDKConeBeamReconstruction<TImage, TFFTPrecision>::OnlineFDKConeBeamReconstruction()
+{
+  // Create each filter of the mini-pipeline
+  m_WeightFilter = WeightFilterType::New();
+  m_RampFilter = RampFilterType::New();
+  m_BackProjectionFilter = BackProjectionFilterType::New();
+
+  // Permanent internal connections
+  m_RampFilter->SetInput(m_WeightFilter->GetOutput());
+  m_BackProjectionFilter->SetInput(1, m_RampFilter->GetOutput());
+
+  // Default parameters, the projections belong to the caller
+  m_WeightFilter->InPlaceOff();
+  m_BackProjectionFilter->InPlaceOn();
+}
+
+template <class TImage, class TFFTPrecision>
+void
+OnlineFDKConeBeamReconstruction<TImage, TFFTPrecision>::SetVolume(const ImageType * volume)
+{
+  using DuplicatorType = itk::ImageDuplicator<ImageType>;
+  auto duplicator = DuplicatorType::New();
+  duplicator->SetInputImage(volume);
+  duplicator->Update();
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_Volume = duplicator->GetOutput();
+  m_NumberOfProjections = 0;
+  this->Modified();
+}
+
+template <class TImage, class TFFTPrecision>
+void
+OnlineFDKConeBeamReconstruction<TImage, TFFTPrecision>::AddProjections(const ImageType * projections,
+                                                                      unsigned int      firstProjection)
+{
+  if (m_Geometry.IsNull())
+    itkExceptionMacro(<< "Geometry has not been set.");
+  if (m_Volume.IsNull())
+    itkExceptionMacro(<< "Volume has not been set.");
+
+  // Place the projections at their index in the geometry without copy
+  typename ImageType::RegionType region = projections->GetBufferedRegion();
+  if (firstProjection + region.GetSize(2) > m_Geometry->GetGantryAngles().size())
+    itkExceptionMacro(<< "Projections " << firstProjection << " to " << firstProjection + region.GetSize(2) - 1
+                      << " are not in the geometry.");
+  region.SetIndex(2, firstProjection);
+  ImagePointer stack = ImageType::New();
+  stack->Graft(projections);
+  stack->SetRegions(region);
+
+  // Weighting and ramp filtering do not need the live volume
+  m_WeightFilter->SetInput(stack);
+  m_WeightFilter->SetGeometry(m_Geometry);
+  m_BackProjectionFilter->SetGeometry(m_Geometry);
+  m_RampFilter->UpdateLargestPossibleRegion();
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_BackProjectionFilter->SetInput(0, m_Volume);
+  m_BackProjectionFilter->UpdateLargestPossibleRegion();
+  m_Volume = m_BackProjectionFilter->GetOutput();
+  m_Volume->DisconnectPipeline();
+  m_NumberOfProjections += region.GetSize(2);
+}
+
+template <class TImage, class TFFTPrecision>
+unsigned int
+OnlineFDKConeBeamReconstruction<TImage, TFFTPrecision>::GetNumberOfProjections() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_NumberOfProjections;
+}
+
+template <class TImage, class TFFTPrecision>
+typename OnlineFDKConeBeamReconstruction<TImage, TFFTPrecision>::ImagePointer
+OnlineFDKConeBeamReconstruction<TImage, TFFTPrecision>::GetSnapshot() const
+{
+  using DuplicatorType = itk::ImageDuplicator<ImageType>;
+  auto duplicator = DuplicatorType::New();
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  if (m_Volume.IsNull())
+    itkExceptionMacro(<< "Volume has not been set.");
+  duplicator->SetInputImage(m_Volume);
+  duplicator->Update();
+  return duplicator->GetOutput();
+}
+
+template <class TImage, class TFFTPrecision>
+void
+OnlineFDKConeBeamReconstruction<TImage, TFFTPrecision>::PrintSelf(std::ostream & os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfProjections: " << this->GetNumberOfProjections() << std::endl;
+}
+
+} // end namespace rtk
+
+#endif // rtkOnlineFDKConeBeamReconstruction_hxx
@@ -76,6 +76,22 @@ public:
   itkGetMacro(AngularGapThreshold, double);
   itkSetMacro(AngularGapThreshold, double);
 
+  /** Detects whether the geometry is a short scan and computes its first
+   * angle and its overlap with the corners of projections. It is called by
+   * GenerateInputRequestedRegion but it can also be called directly to use
+   * ComputeWeights outside the pipeline, e.g., by FDKWeightProjectionFilter. */
+  void
+  ComputeShortScanParameters(const itk::ImageBase<3> * projections);
+
+  /** Whether the geometry is a short scan, computed by ComputeShortScanParameters. */
+  itkGetConstMacro(IsShortScan, bool);
+
+  /** Computes the weights of n consecutive columns of projection iProj, the
+   * first one at coordinate x along the detector rows and the next ones
+   * separated by spacing. Requires a short scan. */
+  void
+  ComputeWeights(unsigned int iProj, double x, double spacing, unsigned int n, double * weights) const;
+
 protected:
   ParkerShortScanImageFilter();
   ~ParkerShortScanImageFilter() override = default;
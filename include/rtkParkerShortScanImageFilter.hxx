@@ -21,7 +21,6 @@
 
 
 #include <itkImageRegionIterator.h>
-#include <itkImageRegionIteratorWithIndex.h>
 #include <itkMacro.h>
 
 namespace rtk
@@ -49,7 +48,13 @@ void
 ParkerShortScanImageFilter<TInputImage, TOutputImage>::GenerateInputRequestedRegion()
 {
   Superclass::GenerateInputRequestedRegion();
+  this->ComputeShortScanParameters(this->GetInput());
+}
 
+template <class TInputImage, class TOutputImage>
+void
+ParkerShortScanImageFilter<TInputImage, TOutputImage>::ComputeShortScanParameters(const itk::ImageBase<3> * projections)
+{
   // Get angular gaps and max gap
   std::vector<double> angularGaps = m_Geometry->GetAngularGapsWithNext(m_Geometry->GetGantryAngles());
   int                 nProj = angularGaps.size();
@@ -86,16 +91,16 @@ ParkerShortScanImageFilter<TInputImage, TOutputImage>::GenerateInputRequestedReg
   m_Delta = m_Delta - 2 * itk::Math::pi * floor(m_Delta / (2 * itk::Math::pi)); // between -2*PI and 2*PI
 
   // Pre-compute the two corners of the projection images
-  typename TInputImage::IndexType id = this->GetInput()->GetLargestPossibleRegion().GetIndex();
-  typename TInputImage::SizeType  sz = this->GetInput()->GetLargestPossibleRegion().GetSize();
-  typename TInputImage::SizeType  ones;
+  itk::ImageBase<3>::IndexType id = projections->GetLargestPossibleRegion().GetIndex();
+  itk::ImageBase<3>::SizeType  sz = projections->GetLargestPossibleRegion().GetSize();
+  itk::ImageBase<3>::SizeType  ones;
   ones.Fill(1);
-  typename TInputImage::PointType corner1, corner2;
-  this->GetInput()->TransformIndexToPhysicalPoint(id, corner1);
-  this->GetInput()->TransformIndexToPhysicalPoint(id - ones + sz, corner2);
+  itk::ImageBase<3>::PointType corner1, corner2;
+  projections->TransformIndexToPhysicalPoint(id, corner1);
+  projections->TransformIndexToPhysicalPoint(id - ones + sz, corner2);
 
   // Go over projection images
-  auto lpr = this->GetOutput()->GetLargestPossibleRegion();
+  auto lpr = projections->GetLargestPossibleRegion();
   for (unsigned int k = 0; k < lpr.GetSize(2); k++)
   {
     double sox = m_Geometry->GetSourceOffsetsX()[k];
@@ -117,6 +122,42 @@ ParkerShortScanImageFilter<TInputImage, TOutputImage>::GenerateInputRequestedReg
   }
 }
 
+template <class TInputImage, class TOutputImage>
+void
+ParkerShortScanImageFilter<TInputImage, TOutputImage>::ComputeWeights(unsigned int iProj,
+                                                                      double       x,
+                                                                      double       spacing,
+                                                                      unsigned int n,
+                                                                      double *     weights) const
+{
+  double sox = m_Geometry->GetSourceOffsetsX()[iProj];
+  double sid = m_Geometry->GetSourceToIsocenterDistances()[iProj];
+  double invsid = 1. / sqrt(sid * sid + sox * sox);
+
+  // Parker's article assumes that the scan starts at 0, convert projection
+  // angle accordingly
+  double beta = m_Geometry->GetGantryAngles()[iProj];
+  beta = beta - m_FirstAngle;
+  if (beta < 0)
+    beta += 2 * itk::Math::pi;
+
+  for (unsigned int i = 0; i < n; i++, x += spacing)
+  {
+    const double l = m_Geometry->ToUntiltedCoordinateAtIsocenter(iProj, x);
+    double       alpha = atan(-1 * l * invsid);
+    const double pi = itk::Math::pi;
+    if (beta <= 2 * m_Delta - 2 * alpha)
+      weights[i] = 2. * pow(sin((pi * beta) / (4 * (m_Delta - alpha))), 2.);
+    else if (beta <= pi - 2 * alpha)
+      weights[i] = 2.;
+    else if (beta <= pi + 2 * m_Delta)
+      // Denominator fix to a typo in equation (12) of Parker's article.
+      weights[i] = 2. * pow(sin((pi * (pi + 2 * m_Delta - beta)) / (4 * (m_Delta + alpha))), 2.);
+    else
+      weights[i] = 0.;
+  }
+}
+
 template <class TInputImage, class TOutputImage>
 void
 ParkerShortScanImageFilter<TInputImage, TOutputImage>::DynamicThreadedGenerateData(
@@ -145,71 +186,23 @@ ParkerShortScanImageFilter<TInputImage, TOutputImage>::DynamicThreadedGenerateDa
     return;
   }
 
-  // Weight image parameters
-  typename WeightImageType::RegionType  region;
-  typename WeightImageType::SpacingType spacing;
-  typename WeightImageType::PointType   origin;
-  region.SetSize(0, outputRegionForThread.GetSize(0));
-  region.SetIndex(0, outputRegionForThread.GetIndex(0));
-  spacing[0] = this->GetInput()->GetSpacing()[0];
-  origin[0] = this->GetInput()->GetOrigin()[0];
-
-  // Create one line of weights
-  typename WeightImageType::Pointer weights = WeightImageType::New();
-  weights->SetSpacing(spacing);
-  weights->SetOrigin(origin);
-  weights->SetRegions(region);
-  weights->Allocate();
-  typename itk::ImageRegionIteratorWithIndex<WeightImageType> itWeights(weights, weights->GetLargestPossibleRegion());
-
-  const std::vector<double> rotationAngles = m_Geometry->GetGantryAngles();
+  // One line of weights
+  std::vector<double> weights(outputRegionForThread.GetSize(0));
+  const double        spacing = this->GetInput()->GetSpacing()[0];
+  const double        x = this->GetInput()->GetOrigin()[0] + spacing * outputRegionForThread.GetIndex(0);
 
   // Go over projection images
   for (unsigned int k = 0; k < outputRegionForThread.GetSize(2); k++)
   {
-    double sox = m_Geometry->GetSourceOffsetsX()[itIn.GetIndex()[2]];
-    double sid = m_Geometry->GetSourceToIsocenterDistances()[itIn.GetIndex()[2]];
-    double invsid = 1. / sqrt(sid * sid + sox * sox);
-
     // Prepare weights for current slice (depends on ProjectionOffsetsX)
-    typename WeightImageType::PointType point;
-    weights->TransformIndexToPhysicalPoint(itWeights.GetIndex(), point);
-
-    // Parker's article assumes that the scan starts at 0, convert projection
-    // angle accordingly
-    double beta = rotationAngles[itIn.GetIndex()[2]];
-    beta = beta - m_FirstAngle;
-    if (beta < 0)
-      beta += 2 * itk::Math::pi;
-
-    itWeights.GoToBegin();
-    while (!itWeights.IsAtEnd())
-    {
-      const double l = m_Geometry->ToUntiltedCoordinateAtIsocenter(itIn.GetIndex()[2], point[0]);
-      double       alpha = atan(-1 * l * invsid);
-      const double pi = itk::Math::pi;
-      if (beta <= 2 * m_Delta - 2 * alpha)
-        itWeights.Set(2. * pow(sin((pi * beta) / (4 * (m_Delta - alpha))), 2.));
-      else if (beta <= pi - 2 * alpha)
-        itWeights.Set(2.);
-      else if (beta <= pi + 2 * m_Delta)
-        // Denominator fix to a typo in equation (12) of Parker's article.
-        itWeights.Set(2. * pow(sin((pi * (pi + 2 * m_Delta - beta)) / (4 * (m_Delta + alpha))), 2.));
-      else
-        itWeights.Set(0.);
-
-      ++itWeights;
-      point[0] += spacing[0];
-    }
+    this->ComputeWeights(itIn.GetIndex()[2], x, spacing, weights.size(), weights.data());
 
     // Multiply each line of the current slice
     for (unsigned int j = 0; j < outputRegionForThread.GetSize(1); j++)
     {
-      itWeights.GoToBegin();
-      while (!itWeights.IsAtEnd())
+      for (const double w : weights)
       {
-        itOut.Set(itIn.Get() * itWeights.Get());
-        ++itWeights;
+        itOut.Set(itIn.Get() * w);
         ++itIn;
         ++itOut;
       }
@@ -30,6 +30,12 @@ namespace rtk
 /** \class ProjectGeometricPhantomImageFilter
  * \brief Analytical projection a GeometricPhantom
  *
+ * All shapes are projected in a single pass. A bounding volume hierarchy is
+ * built once over the bounding boxes of the transformed shapes (see
+ * ConvexShape::ComputeBoundingBox) and each ray only computes its intersection
+ * with the shapes whose box it crosses. Shapes with an unbounded box are
+ * intersected with every ray.
+ *
  * \test rtkprojectgeometricphantomtest.cxx, rtkforbildtest.cxx
  *
  * \author Marc Vila, Simon Rit
@@ -56,6 +62,8 @@ public:
   using VectorType = ConvexShape::VectorType;
   using RotationMatrixType = ConvexShape::RotationMatrixType;
   using ScalarType = ConvexShape::ScalarType;
+  using PointType = ConvexShape::PointType;
+  using OutputImageRegionType = typename TOutputImage::RegionType;
 
   /** Method for creation through the object factory. */
   itkNewMacro(Self);
@@ -116,9 +124,38 @@ protected:
   void
   VerifyPreconditions() ITKv5_CONST override;
 
+  /** Reads the phantom, transforms its shapes and builds the bounding volume
+   * hierarchy before projecting them. */
   void
   GenerateData() override;
 
+  void
+  DynamicThreadedGenerateData(const OutputImageRegionType & outputRegionForThread) override;
+
+  /** Node of the bounding volume hierarchy. Leaves have no child and point
+   * to Count shapes starting at First in m_Shapes. */
+  struct BVHNode
+  {
+    PointType    BoxMin;
+    PointType    BoxMax;
+    unsigned int First;
+    unsigned int Count;
+    unsigned int Left;
+    unsigned int Right;
+  };
+
+  /** Recursively builds the node of the shapes [first, last) of m_Shapes and
+   * returns its index in m_BVH. */
+  unsigned int
+  BuildBVH(unsigned int first, unsigned int last);
+
+  /** Returns true if the line (origin, direction) crosses the box. */
+  static bool
+  IsBoxIntersectedByLine(const PointType &  origin,
+                         const VectorType & direction,
+                         const PointType &  boxMin,
+                         const PointType &  boxMax);
+
 private:
   GeometricPhantomConstPointer m_GeometricPhantom;
   GeometryConstPointer         m_Geometry;
@@ -129,6 +166,13 @@ private:
   RotationMatrixType           m_RotationMatrix;
   std::vector<VectorType>      m_PlaneDirections;
   std::vector<ScalarType>      m_PlanePositions;
+
+  /** Transformed shapes, ordered by BVH leaves, and their bounding boxes */
+  std::vector<ConvexShape::Pointer> m_Shapes;
+  std::vector<PointType>            m_ShapesBoxMin;
+  std::vector<PointType>            m_ShapesBoxMax;
+  std::vector<BVHNode>              m_BVH;
+  std::vector<ConvexShape::Pointer> m_UnboundedShapes;
 };
 
 } // end namespace rtk
@@ -21,13 +21,12 @@
 
 #include "rtkGeometricPhantomFileReader.h"
 #include "rtkForbildPhantomFileReader.h"
-#include "rtkRayConvexIntersectionImageFilter.h"
+#include "rtkProjectionsRegionConstIteratorRayBased.h"
 
-#include <iostream>
-#include <fstream>
-#include <sstream>
-#include <cstdio>
-#include <cstdlib>
+#include <itkImageRegionIteratorWithIndex.h>
+
+#include <algorithm>
+#include <numeric>
 
 namespace rtk
 {
@@ -77,8 +76,12 @@ ProjectGeometricPhantomImageFilter<TInputImage, TOutputImage>::GenerateData()
   if (cov.empty())
     itkExceptionMacro(<< "Empty phantom");
 
-  // Create one add filter per convex object
-  std::vector<typename itk::ImageSource<TOutputImage>::Pointer> projectors;
+  // Transform each convex object and sort them according to their bounding box
+  m_Shapes.clear();
+  m_ShapesBoxMin.clear();
+  m_ShapesBoxMax.clear();
+  m_UnboundedShapes.clear();
+  m_BVH.clear();
   for (const auto & convexShape : cov)
   {
     ConvexShape::Pointer co = convexShape->Clone();
@@ -88,29 +91,171 @@ ProjectGeometricPhantomImageFilter<TInputImage, TOutputImage>::GenerateData()
     for (size_t i = 0; i < m_PlaneDirections.size(); i++)
       co->AddClipPlane(m_PlaneDirections[i], m_PlanePositions[i]);
 
-    if (!projectors.empty())
+    PointType bbMin, bbMax;
+    co->ComputeBoundingBox(bbMin, bbMax);
+    bool bounded = true;
+    bool empty = false;
+    for (unsigned int i = 0; i < ConvexShape::Dimension; i++)
+    {
+      bounded = bounded && bbMin[i] > -itk::NumericTraits<ScalarType>::max() &&
+                bbMax[i] < itk::NumericTraits<ScalarType>::max();
+      empty = empty || bbMin[i] > bbMax[i];
+    }
+    if (empty)
+      continue;
+    if (bounded)
     {
-      using RCOIType = RayConvexIntersectionImageFilter<TOutputImage, TOutputImage>;
-      typename RCOIType::Pointer rcoi = RCOIType::New();
-      rcoi->SetInput(projectors.back()->GetOutput());
-      rcoi->SetGeometry(this->GetGeometry());
-      rcoi->SetConvexShape(co);
-      projectors.push_back(rcoi.GetPointer());
+      m_Shapes.push_back(co);
+      m_ShapesBoxMin.push_back(bbMin);
+      m_ShapesBoxMax.push_back(bbMax);
     }
     else
+      m_UnboundedShapes.push_back(co);
+  }
+  if (!m_Shapes.empty())
+    this->BuildBVH(0, m_Shapes.size());
+
+  // Allocate the output and project all shapes in one pass
+  Superclass::GenerateData();
+
+  m_Shapes.clear();
+  m_ShapesBoxMin.clear();
+  m_ShapesBoxMax.clear();
+  m_UnboundedShapes.clear();
+  m_BVH.clear();
+}
+
+template <class TInputImage, class TOutputImage>
+unsigned int
+ProjectGeometricPhantomImageFilter<TInputImage, TOutputImage>::BuildBVH(unsigned int first, unsigned int last)
+{
+  const unsigned int nodeIndex = m_BVH.size();
+  m_BVH.emplace_back();
+  BVHNode node;
+  node.BoxMin = m_ShapesBoxMin[first];
+  node.BoxMax = m_ShapesBoxMax[first];
+  for (unsigned int n = first + 1; n < last; n++)
+    for (unsigned int i = 0; i < ConvexShape::Dimension; i++)
+    {
+      node.BoxMin[i] = std::min(node.BoxMin[i], m_ShapesBoxMin[n][i]);
+      node.BoxMax[i] = std::max(node.BoxMax[i], m_ShapesBoxMax[n][i]);
+    }
+  node.First = first;
+  node.Count = last - first;
+  node.Left = 0;
+  node.Right = 0;
+
+  if (last - first > 2)
+  {
+    // Split at the median of the box centers along the largest dimension
+    unsigned int axis = 0;
+    for (unsigned int i = 1; i < ConvexShape::Dimension; i++)
+      if (node.BoxMax[i] - node.BoxMin[i] > node.BoxMax[axis] - node.BoxMin[axis])
+        axis = i;
+    std::vector<unsigned int> order(last - first);
+    std::iota(order.begin(), order.end(), first);
+    const unsigned int middle = (last - first) / 2;
+    std::nth_element(order.begin(), order.begin() + middle, order.end(), [this, axis](unsigned int a, unsigned int b) {
+      return m_ShapesBoxMin[a][axis] + m_ShapesBoxMax[a][axis] < m_ShapesBoxMin[b][axis] + m_ShapesBoxMax[b][axis];
+    });
+
+    // Reorder the shapes and their boxes accordingly
+    std::vector<ConvexShape::Pointer> shapes;
+    std::vector<PointType>            boxMin, boxMax;
+    for (unsigned int n : order)
+    {
+      shapes.push_back(m_Shapes[n]);
+      boxMin.push_back(m_ShapesBoxMin[n]);
+      boxMax.push_back(m_ShapesBoxMax[n]);
+    }
+    std::copy(shapes.begin(), shapes.end(), m_Shapes.begin() + first);
+    std::copy(boxMin.begin(), boxMin.end(), m_ShapesBoxMin.begin() + first);
+    std::copy(boxMax.begin(), boxMax.end(), m_ShapesBoxMax.begin() + first);
+
+    node.Count = 0;
+    node.Left = this->BuildBVH(first, first + middle);
+    node.Right = this->BuildBVH(first + middle, last);
+  }
+  m_BVH[nodeIndex] = node;
+  return nodeIndex;
+}
+
+template <class TInputImage, class TOutputImage>
+bool
+ProjectGeometricPhantomImageFilter<TInputImage, TOutputImage>::IsBoxIntersectedByLine(const PointType &  origin,
+                                                                                      const VectorType & direction,
+                                                                                      const PointType &  boxMin,
+                                                                                      const PointType &  boxMax)
+{
+  // Slab method on the whole line since shapes are intersected on both sides
+  // of the source
+  ScalarType nearDist = -itk::NumericTraits<ScalarType>::max();
+  ScalarType farDist = itk::NumericTraits<ScalarType>::max();
+  for (unsigned int i = 0; i < ConvexShape::Dimension; i++)
+  {
+    if (direction[i] == 0.)
+    {
+      if (origin[i] < boxMin[i] || origin[i] > boxMax[i])
+        return false;
+      continue;
+    }
+    const ScalarType t1 = (boxMin[i] - origin[i]) / direction[i];
+    const ScalarType t2 = (boxMax[i] - origin[i]) / direction[i];
+    nearDist = std::max(nearDist, std::min(t1, t2));
+    farDist = std::min(farDist, std::max(t1, t2));
+    if (nearDist > farDist)
+      return false;
+  }
+  return true;
+}
+
+template <class TInputImage, class TOutputImage>
+void
+ProjectGeometricPhantomImageFilter<TInputImage, TOutputImage>::DynamicThreadedGenerateData(
+  const OutputImageRegionType & outputRegionForThread)
+{
+  // Iterators on input and output
+  using InputRegionIterator = ProjectionsRegionConstIteratorRayBased<TInputImage>;
+  InputRegionIterator * itIn = nullptr;
+  itIn = InputRegionIterator::New(this->GetInput(), outputRegionForThread, m_Geometry);
+  using OutputRegionIterator = itk::ImageRegionIteratorWithIndex<TOutputImage>;
+  OutputRegionIterator itOut(this->GetOutput(), outputRegionForThread);
+
+  std::vector<unsigned int> stack;
+  for (unsigned int pix = 0; pix < outputRegionForThread.GetNumberOfPixels(); pix++, itIn->Next(), ++itOut)
+  {
+    const PointType  source = itIn->GetSourcePosition();
+    const VectorType direction = itIn->GetDirection();
+
+    // Accumulate the intersection lengths of all shapes crossed by the ray
+    double                  sum = 0.;
+    ConvexShape::ScalarType nearDist = NAN, farDist = NAN;
+    for (const auto & shape : m_UnboundedShapes)
+      if (shape->IsIntersectedByRay(source, direction, nearDist, farDist))
+        sum += shape->GetDensity() * (farDist - nearDist);
+
+    if (!m_BVH.empty())
+      stack.push_back(0);
+    while (!stack.empty())
     {
-      using RCOIType = RayConvexIntersectionImageFilter<TInputImage, TOutputImage>;
-      typename RCOIType::Pointer rcoi = RCOIType::New();
-      rcoi->SetInput(this->GetInput());
-      rcoi->SetGeometry(this->GetGeometry());
-      rcoi->SetConvexShape(co);
-      projectors.push_back(rcoi.GetPointer());
+      const BVHNode & node = m_BVH[stack.back()];
+      stack.pop_back();
+      if (!IsBoxIntersectedByLine(source, direction, node.BoxMin, node.BoxMax))
+        continue;
+      if (node.Count == 0)
+      {
+        stack.push_back(node.Left);
+        stack.push_back(node.Right);
+        continue;
+      }
+      for (unsigned int n = node.First; n < node.First + node.Count; n++)
+        if (m_Shapes[n]->IsIntersectedByRay(source, direction, nearDist, farDist))
+          sum += m_Shapes[n]->GetDensity() * (farDist - nearDist);
     }
+    itOut.Set(itIn->Get() + sum);
   }
 
-  projectors.back()->GetOutput()->SetRequestedRegion(this->GetOutput()->GetRequestedRegion());
-  projectors.back()->Update();
-  this->GraftOutput(projectors.back()->GetOutput());
+  delete itIn;
 }
 
 template <class TInputImage, class TOutputImage>
@@ -79,6 +79,13 @@ public:
                      double &           nearDist,
                      double &           farDist) const override;
 
+  /** See rtk::ConvexShape::ComputeBoundingBox. The quadric bounds are computed
+   * along the axes in which the quadric is an ellipse or an ellipsoid, e.g.,
+   * all axes for an ellipsoid and the two radial axes of a cylinder aligned
+   * with an axis. */
+  void
+  ComputeBoundingBox(PointType & bbMin, PointType & bbMax) const override;
+
   /** Rescale object along each direction by a 3D vector. */
   void
   Rescale(const VectorType & r) override;
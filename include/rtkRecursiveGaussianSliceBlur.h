@@ -0,0 +1,163 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef rtkRecursiveGaussianSliceBlur_h
+#define rtkRecursiveGaussianSliceBlur_h
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace rtk
+{
+
+/** \class RecursiveGaussianCoefficients
+ * \brief Coefficients of the third order recursive Gaussian filter of
+ * [Young and van Vliet, Signal Processing, 1995] for a standard deviation
+ * sigma in pixels.
+ *
+ * Below RecursiveMinimumSigma, the recursive approximation is not accurate
+ * and a direct convolution with a sampled and normalized Gaussian kernel is
+ * used instead. Its cost is bounded by the same threshold.
+ *
+ * \ingroup RTK
+ */
+struct RecursiveGaussianCoefficients
+{
+  explicit RecursiveGaussianCoefficients(double s)
+    : sigma(s)
+  {
+    if (sigma <= 0.)
+      return;
+
+    if (sigma < RecursiveMinimumSigma)
+    {
+      const int radius = std::max(1, static_cast<int>(std::ceil(4. * sigma)));
+      kernel.resize(2 * radius + 1);
+      double sum = 0.;
+      for (int k = -radius; k <= radius; k++)
+      {
+        kernel[k + radius] = std::exp(-0.5 * k * k / (sigma * sigma));
+        sum += kernel[k + radius];
+      }
+      for (double & k : kernel)
+        k /= sum;
+      return;
+    }
+
+    // Eqs. (11b) and (8c) of the paper, the coefficients are normalized by b0
+    const double q = 0.98711 * sigma - 0.96330;
+    const double q2 = q * q;
+    const double q3 = q2 * q;
+    const double b0 = 1.57825 + 2.44413 * q + 1.4281 * q2 + 0.422205 * q3;
+    b1 = (2.44413 * q + 2.85619 * q2 + 1.26661 * q3) / b0;
+    b2 = -(1.4281 * q2 + 1.26661 * q3) / b0;
+    b3 = 0.422205 * q3 / b0;
+    B = 1. - (b1 + b2 + b3);
+  }
+
+  static constexpr double RecursiveMinimumSigma = 2.5;
+
+  double              sigma;
+  double              b1{ 0. }, b2{ 0. }, b3{ 0. }, B{ 1. };
+  std::vector<double> kernel;
+};
+
+/** \brief Blurs in place a line of n values separated by stride with the
+ * Gaussian described by coefficients c. Values outside the line are assumed
+ * to be 0. buffer is a work array which can be reused between calls to avoid
+ * allocations.
+ *
+ * \ingroup RTK
+ */
+template <class TValue>
+void
+RecursiveGaussianBlurLine(TValue *                              line,
+                          unsigned int                          n,
+                          unsigned int                          stride,
+                          const RecursiveGaussianCoefficients & c,
+                          std::vector<double> &                 buffer)
+{
+  if (c.sigma <= 0. || n == 0)
+    return;
+
+  if (!c.kernel.empty())
+  {
+    const int radius = static_cast<int>(c.kernel.size() / 2);
+    buffer.assign(n, 0.);
+    for (int i = 0; i < static_cast<int>(n); i++)
+      for (int k = std::max(-radius, -i); k <= std::min(radius, static_cast<int>(n) - 1 - i); k++)
+        buffer[i] += c.kernel[k + radius] * line[(i + k) * stride];
+    for (unsigned int i = 0; i < n; i++)
+      line[i * stride] = static_cast<TValue>(buffer[i]);
+    return;
+  }
+
+  // The line is padded with zeros so that the anticausal pass starts where the
+  // causal response has vanished
+  const int m = static_cast<int>(n + std::ceil(5. * c.sigma)) + 3;
+  buffer.assign(m + 3, 0.);
+  double * w = buffer.data() + 3;
+
+  // Causal pass
+  for (int i = 0; i < m; i++)
+  {
+    const double x = (i < static_cast<int>(n)) ? static_cast<double>(line[i * stride]) : 0.;
+    w[i] = c.B * x + c.b1 * w[i - 1] + c.b2 * w[i - 2] + c.b3 * w[i - 3];
+  }
+
+  // Anticausal pass
+  double y1 = 0., y2 = 0., y3 = 0.;
+  for (int i = m - 1; i >= 0; i--)
+  {
+    const double y = c.B * w[i] + c.b1 * y1 + c.b2 * y2 + c.b3 * y3;
+    y3 = y2;
+    y2 = y1;
+    y1 = y;
+    if (i < static_cast<int>(n))
+      line[i * stride] = static_cast<TValue>(y);
+  }
+}
+
+/** \brief Blurs in place a 2D slice of sizeX x sizeY values, x being the
+ * fastest index, with a Gaussian of standard deviations sigmaX and sigmaY (in
+ * pixels). The cost does not depend on the standard deviations. See
+ * RecursiveGaussianCoefficients and RecursiveGaussianBlurLine.
+ *
+ * \ingroup RTK
+ */
+template <class TValue>
+void
+RecursiveGaussianBlurSlice(TValue *              slice,
+                           unsigned int          sizeX,
+                           unsigned int          sizeY,
+                           double                sigmaX,
+                           double                sigmaY,
+                           std::vector<double> & buffer)
+{
+  const RecursiveGaussianCoefficients cx(sigmaX);
+  for (unsigned int j = 0; j < sizeY; j++)
+    RecursiveGaussianBlurLine(slice + j * sizeX, sizeX, 1, cx, buffer);
+  const RecursiveGaussianCoefficients cy(sigmaY);
+  for (unsigned int i = 0; i < sizeX; i++)
+    RecursiveGaussianBlurLine(slice + i, sizeY, sizeX, cy, buffer);
+}
+
+} // end namespace rtk
+
+#endif
@@ -0,0 +1,273 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef rtkReducedPrecisionConverter_h
+#define rtkReducedPrecisionConverter_h
+
+#include <itkVector.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace rtk
+{
+
+/** Converts a float to the nearest IEEE 754 half precision value (float16),
+ * ties to even. Values beyond the float16 range become infinite. */
+inline std::uint16_t
+FloatToHalf(float value)
+{
+  std::uint32_t bits = 0;
+  std::memcpy(&bits, &value, sizeof(float));
+  const std::uint32_t sign = (bits >> 16) & 0x8000;
+  const std::uint32_t absBits = bits & 0x7fffffff;
+
+  // Infinity and NaN, which stays a (quiet) NaN
+  if (absBits >= 0x7f800000)
+    return sign | 0x7c00 | (absBits > 0x7f800000 ? 0x200 : 0);
+
+  // Rounds above 65504, the largest float16
+  if (absBits >= 0x477ff000)
+    return sign | 0x7c00;
+
+  // Subnormal float16, in units of 2^-24
+  if (absBits < 0x38800000)
+  {
+    if (absBits <= 0x33000000)
+      return sign;
+    const std::uint32_t shift = 126 - (absBits >> 23);
+    const std::uint32_t mantissa = (absBits & 0x7fffff) | 0x800000;
+    std::uint32_t       half = mantissa >> shift;
+    const std::uint32_t remainder = mantissa & ((1u << shift) - 1);
+    const std::uint32_t halfway = 1u << (shift - 1);
+    if (remainder > halfway || (remainder == halfway && (half & 1)))
+      half++;
+    return sign | half;
+  }
+
+  // Normal float16: rebias the exponent and round the mantissa
+  std::uint32_t       half = (absBits - 0x38000000) >> 13;
+  const std::uint32_t remainder = absBits & 0x1fff;
+  if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))
+    half++;
+  return sign | half;
+}
+
+/** Converts a half precision value (float16) to float, exactly. */
+inline float
+HalfToFloat(std::uint16_t value)
+{
+  const std::uint32_t sign = static_cast<std::uint32_t>(value & 0x8000) << 16;
+  const std::uint32_t exponent = (value >> 10) & 0x1f;
+  const std::uint32_t mantissa = value & 0x3ff;
+
+  std::uint32_t bits = 0;
+  if (exponent == 0x1f)
+    bits = sign | 0x7f800000 | (mantissa << 13);
+  else if (exponent != 0)
+    bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+  else
+  {
+    // Zero and subnormals, mantissa * 2^-24
+    const float subnormal = static_cast<float>(mantissa) * 5.9604644775390625e-8f;
+    return sign ? -subnormal : subnormal;
+  }
+
+  float result = 0.f;
+  std::memcpy(&result, &bits, sizeof(float));
+  return result;
+}
+
+/** Converts a float to the nearest bfloat16 value, i.e., the 16 most
+ * significant bits of a float, ties to even. */
+inline std::uint16_t
+FloatToBFloat16(float value)
+{
+  std::uint32_t bits = 0;
+  std::memcpy(&bits, &value, sizeof(float));
+  if ((bits & 0x7fffffff) > 0x7f800000)
+    return static_cast<std::uint16_t>((bits >> 16) | 0x40);
+  bits += 0x7fff + ((bits >> 16) & 1);
+  return static_cast<std::uint16_t>(bits >> 16);
+}
+
+/** Converts a bfloat16 value to float, exactly. */
+inline float
+BFloat16ToFloat(std::uint16_t value)
+{
+  const std::uint32_t bits = static_cast<std::uint32_t>(value) << 16;
+  float               result = 0.f;
+  std::memcpy(&result, &bits, sizeof(float));
+  return result;
+}
+
+/** \class ReducedPrecisionConverter
+ * \brief Stores floating point values in 16 bits and widens them back to
+ * float.
+ *
+ * The values are divided by a scale and converted to float16, which has a
+ * relative precision of 2^-11 and a range of [-65504, 65504], or to bfloat16,
+ * which has a relative precision of 2^-8 and the range of float. Float16
+ * values are saturated instead of overflowing. ComputeScale chooses a scale
+ * which maps the largest value to store well inside the float16 range.
+ *
+ * Encode and Decode accept scalars and itk::Vector so that images of both can
+ * be stored in images of ReducedPrecisionPixelTraits<TPixel>::StorageType.
+ *
+ * \ingroup RTK
+ */
+class ReducedPrecisionConverter
+{
+public:
+  typedef enum
+  {
+    FLOAT32 = 0,
+    FLOAT16 = 1,
+    BFLOAT16 = 2
+  } PrecisionType;
+
+  ReducedPrecisionConverter(PrecisionType precision = FLOAT16, float scale = 1.f)
+    : m_Precision(precision)
+    , m_Scale(scale)
+    , m_InverseScale(1.f / scale)
+  {}
+
+  PrecisionType
+  GetPrecision() const
+  {
+    return m_Precision;
+  }
+
+  float
+  GetScale() const
+  {
+    return m_Scale;
+  }
+
+  /** Scale mapping maximum, the largest absolute value to store, to 1024 in
+   * float16. This leaves room for values 64 times larger and keeps values
+   * 2^24 times smaller normalized. bfloat16 needs no scale. */
+  static float
+  ComputeScale(PrecisionType precision, double maximum)
+  {
+    if (precision != FLOAT16 || !(maximum > 0.) || !std::isfinite(maximum))
+      return 1.f;
+    return static_cast<float>(std::max(maximum / 1024., static_cast<double>(std::numeric_limits<float>::min())));
+  }
+
+  template <class TValue>
+  static double
+  GetMaximumAbsoluteValue(const TValue & value)
+  {
+    return std::abs(static_cast<double>(value));
+  }
+  template <class TValue, unsigned int VDimension>
+  static double
+  GetMaximumAbsoluteValue(const itk::Vector<TValue, VDimension> & value)
+  {
+    double maximum = 0.;
+    for (unsigned int i = 0; i < VDimension; i++)
+      maximum = std::max(maximum, std::abs(static_cast<double>(value[i])));
+    return maximum;
+  }
+
+  template <class TValue>
+  std::uint16_t
+  Encode(const TValue & value) const
+  {
+    const float scaled = static_cast<float>(value) * m_InverseScale;
+    if (m_Precision == BFLOAT16)
+      return FloatToBFloat16(scaled);
+    return FloatToHalf(std::min(std::max(scaled, -65504.f), 65504.f));
+  }
+  template <class TValue, unsigned int VDimension>
+  itk::Vector<std::uint16_t, VDimension>
+  Encode(const itk::Vector<TValue, VDimension> & value) const
+  {
+    itk::Vector<std::uint16_t, VDimension> encoded;
+    for (unsigned int i = 0; i < VDimension; i++)
+      encoded[i] = this->Encode(value[i]);
+    return encoded;
+  }
+
+  float
+  Decode(std::uint16_t value) const
+  {
+    return m_Scale * (m_Precision == BFLOAT16 ? BFloat16ToFloat(value) : HalfToFloat(value));
+  }
+  template <unsigned int VDimension>
+  itk::Vector<float, VDimension>
+  Decode(const itk::Vector<std::uint16_t, VDimension> & value) const
+  {
+    itk::Vector<float, VDimension> decoded;
+    for (unsigned int i = 0; i < VDimension; i++)
+      decoded[i] = this->Decode(value[i]);
+    return decoded;
+  }
+
+private:
+  PrecisionType m_Precision;
+  float         m_Scale;
+  float         m_InverseScale;
+};
+
+/** \class FullPrecisionConverter
+ * \brief Identity counterpart of ReducedPrecisionConverter for the code
+ * written for both.
+ *
+ * \ingroup RTK
+ */
+class FullPrecisionConverter
+{
+public:
+  template <class TPixel>
+  const TPixel &
+  Encode(const TPixel & value) const
+  {
+    return value;
+  }
+  template <class TPixel>
+  const TPixel &
+  Decode(const TPixel & value) const
+  {
+    return value;
+  }
+};
+
+/** \class ReducedPrecisionPixelTraits
+ * \brief Pixel type storing a TPixel with ReducedPrecisionConverter.
+ *
+ * \ingroup RTK
+ */
+template <class TPixel>
+struct ReducedPrecisionPixelTraits
+{
+  using StorageType = std::uint16_t;
+};
+template <class TValue, unsigned int VDimension>
+struct ReducedPrecisionPixelTraits<itk::Vector<TValue, VDimension>>
+{
+  using StorageType = itk::Vector<std::uint16_t, VDimension>;
+};
+
+} // end namespace rtk
+
+#endif
@@ -39,6 +39,10 @@ namespace rtk
  * - Applies wavelets denoising in space
  * and starting over as many times as the number of main loop iterations desired.
  *
+ * The gradient projection iterations of the total variation denoising can be
+ * accelerated with a FISTA momentum, see SetTVMomentum and
+ * rtk::DenoisingBPDQImageFilter.
+ *
  * \dot
  * digraph RegularizedConjugateGradientConeBeamReconstructionFilter {
  *
@@ -199,6 +203,11 @@ public:
   itkSetMacro(TV_iterations, int);
   itkGetMacro(TV_iterations, int);
 
+  /** Accelerate the total variation denoising with a FISTA momentum (CPU
+   * only). Default is false. */
+  itkSetMacro(TVMomentum, bool);
+  itkGetMacro(TVMomentum, bool);
+
   // Geometry
   itkSetObjectMacro(Geometry, ThreeDCircularProjectionGeometry);
   itkGetModifiableObjectMacro(Geometry, ThreeDCircularProjectionGeometry);
@@ -279,9 +288,10 @@ protected:
   bool m_DisableDisplacedDetectorFilter;
 
   // Iterations
-  int m_MainLoop_iterations;
-  int m_CG_iterations;
-  int m_TV_iterations;
+  int  m_MainLoop_iterations;
+  int  m_CG_iterations;
+  int  m_TV_iterations;
+  bool m_TVMomentum{ false };
 
   // Geometry
   typename rtk::ThreeDCircularProjectionGeometry::Pointer m_Geometry;
@@ -64,6 +64,9 @@ RegularizedConjugateGradientConeBeamReconstructionFilter<
   m_TVDenoising = TVDenoisingFilterType::New();
   m_WaveletsDenoising = WaveletsDenoisingFilterType::New();
   m_SoftThresholdFilter = SoftThresholdFilterType::New();
+  this->WatchTelemetrySection(m_TVDenoising, IterationTelemetry::REGULARIZATION);
+  this->WatchTelemetrySection(m_WaveletsDenoising, IterationTelemetry::REGULARIZATION);
+  this->WatchTelemetrySection(m_SoftThresholdFilter, IterationTelemetry::REGULARIZATION);
 }
 
 template <typename TImage>
@@ -155,6 +158,7 @@ RegularizedConjugateGradientConeBeamReconstructionFilter<TImage>::GenerateOutput
   // Set projection filters
   m_CGFilter->SetForwardProjectionFilter(this->m_CurrentForwardProjectionConfiguration);
   m_CGFilter->SetBackProjectionFilter(this->m_CurrentBackProjectionConfiguration);
+  m_CGFilter->SetTelemetry(this->GetTelemetry());
 
   // The conjugate gradient filter is the only part that must be in the pipeline
   // whatever was the user wants
@@ -190,6 +194,7 @@ RegularizedConjugateGradientConeBeamReconstructionFilter<TImage>::GenerateOutput
 
     m_TVDenoising->SetInput(currentDownstreamFilter->GetOutput());
     m_TVDenoising->SetNumberOfIterations(this->m_TV_iterations);
+    m_TVDenoising->SetMomentum(this->m_TVMomentum);
     m_TVDenoising->SetGamma(this->m_GammaTV);
     m_TVDenoising->SetDimensionsProcessed(this->m_DimensionsProcessedForTV);
 
@@ -269,6 +274,8 @@ RegularizedConjugateGradientConeBeamReconstructionFilter<TImage>::GenerateData()
     currentDownstreamFilter->Update();
     this->GraftOutput(currentDownstreamFilter->GetOutput());
     iterationReporter.CompletedStep();
+    if (this->GetTelemetryStopRequested())
+      break;
   }
 }
 
@@ -30,10 +30,13 @@
 #include <itkDivideOrZeroOutImageFilter.h>
 #include <itkThresholdImageFilter.h>
 
+#include <cmath>
+
 #include "rtkRayBoxIntersectionImageFilter.h"
 #include "rtkConstantImageSource.h"
 #include "rtkIterativeConeBeamReconstructionFilter.h"
 #include "rtkDisplacedDetectorImageFilter.h"
+#include "rtkNesterovMomentum.h"
 
 namespace rtk
 {
@@ -62,6 +65,13 @@ namespace rtk
  * It is implemented in NormalizedJosephBackProjectionImageFilter, which
  * is used in the SART pipeline.
  *
+ * The updates can be accelerated with the FISTA momentum of
+ * rtk::NesterovMomentum, see SetMomentum. The volume is then extrapolated
+ * after each iteration or, with MomentumPerSubset, after each subset
+ * (OS-Nesterov) before the next forward projection. The extrapolated volume is
+ * an additional volume in memory. The output is the last update, not its
+ * extrapolation.
+ *
  * \dot
  * digraph SARTConeBeamReconstructionFilter {
  *
@@ -167,6 +177,7 @@ public:
 
   using ForwardProjectionType = typename Superclass::ForwardProjectionType;
   using BackProjectionType = typename Superclass::BackProjectionType;
+  using MomentumRestartType = NesterovMomentum::RestartType;
 
   /** Standard New method. */
   itkNewMacro(Self);
@@ -181,6 +192,11 @@ public:
   /** Get / Set the number of iterations. Default is 3. */
   itkGetMacro(NumberOfIterations, unsigned int);
   itkSetMacro(NumberOfIterations, unsigned int);
+  void
+  SetNumberOfOuterIterations(unsigned int n) override
+  {
+    this->SetNumberOfIterations(n);
+  }
 
   /** Get / Set the number of projections per subset. Default is 1. */
   itkGetMacro(NumberOfProjectionsPerSubset, unsigned int);
@@ -209,6 +225,28 @@ public:
   itkSetMacro(DivisionThreshold, ProjectionPixelType);
   itkGetMacro(DivisionThreshold, ProjectionPixelType);
 
+  /** Get / Set whether the updates are accelerated with a FISTA momentum.
+   * Default is false. */
+  itkGetMacro(Momentum, bool);
+  itkSetMacro(Momentum, bool);
+  itkBooleanMacro(Momentum);
+
+  /** Get / Set the adaptive restart of the momentum, see
+   * rtk::NesterovMomentum. FUNCTION_RESTART restarts the momentum when the
+   * norm of the projection residuals of an iteration increases. Default is
+   * GRADIENT_RESTART. */
+  itkGetMacro(MomentumRestart, MomentumRestartType);
+  itkSetMacro(MomentumRestart, MomentumRestartType);
+
+  /** Get / Set whether the momentum is applied after each subset (OS-Nesterov)
+   * instead of after each iteration. Default is false. */
+  itkGetMacro(MomentumPerSubset, bool);
+  itkSetMacro(MomentumPerSubset, bool);
+  itkBooleanMacro(MomentumPerSubset);
+
+  /** Number of restarts of the momentum during the last update. */
+  itkGetConstMacro(NumberOfMomentumRestarts, unsigned int);
+
 protected:
   SARTConeBeamReconstructionFilter();
   ~SARTConeBeamReconstructionFilter() override = default;
@@ -232,6 +270,14 @@ protected:
   VerifyInputInformation() const override
   {}
 
+  /** Norm of the difference between the measured and the forward projected
+   * projections of the last iteration. */
+  double
+  GetTelemetryResidualNorm() override
+  {
+    return std::sqrt(m_TelemetryIterationResidual);
+  }
+
   /** Pointers to each subfilter of this composite filter */
   typename ExtractFilterType::Pointer            m_ExtractFilter;
   typename ExtractFilterType::Pointer            m_ExtractFilterRayBox;
@@ -257,6 +303,11 @@ protected:
   bool m_EnforcePositivity;
   bool m_DisableDisplacedDetectorFilter;
 
+  /** Squared norms of the projection residuals of the current subset and
+   * iteration */
+  double m_TelemetrySubsetResidual{ 0. };
+  double m_TelemetryIterationResidual{ 0. };
+
 private:
   /** Number of projections processed before the volume is updated (1 for SART,
    * several for OS-SART, all for SIRT) */
@@ -276,6 +327,12 @@ private:
    * the gating weights filter */
   bool               m_IsGated;
   std::vector<float> m_GatingWeights;
+
+  /** Momentum of the updates */
+  bool                m_Momentum{ false };
+  MomentumRestartType m_MomentumRestart{ NesterovMomentum::GRADIENT_RESTART };
+  bool                m_MomentumPerSubset{ false };
+  unsigned int        m_NumberOfMomentumRestarts{ 0 };
 }; // end of class
 
 } // end namespace rtk
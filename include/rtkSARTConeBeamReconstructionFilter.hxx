@@ -21,6 +21,8 @@
 
 
 #include <algorithm>
+#include <cmath>
+#include <itkImageRegionConstIterator.h>
 #include <itkIterationReporter.h>
 
 namespace rtk
@@ -68,6 +70,21 @@ SARTConeBeamReconstructionFilter<TVolumeImage, TProjectionImage>::SARTConeBeamRe
 
   m_SubtractFilter->SetInput(0, m_ExtractFilter->GetOutput());
 
+  // Accumulate the squared norm of the projection residuals for the telemetry
+  // and for the function restart of the momentum
+  m_SubtractFilter->AddObserver(itk::EndEvent(), [this](const itk::EventObject &) {
+    if (this->GetTelemetry() == nullptr &&
+        !(m_Momentum && m_MomentumRestart == NesterovMomentum::FUNCTION_RESTART))
+      return;
+    const ProjectionType *                         residual = m_SubtractFilter->GetOutput();
+    itk::ImageRegionConstIterator<ProjectionType> it(residual, residual->GetBufferedRegion());
+    double                                         sum = 0.;
+    for (; !it.IsAtEnd(); ++it)
+      sum += static_cast<double>(it.Get()) * static_cast<double>(it.Get());
+    m_TelemetrySubsetResidual += sum;
+    m_TelemetryIterationResidual += sum;
+  });
+
   m_MultiplyFilter->SetInput1(itk::NumericTraits<typename ProjectionType::PixelType>::ZeroValue());
   m_MultiplyFilter->SetInput2(m_SubtractFilter->GetOutput());
 
@@ -201,6 +218,21 @@ SARTConeBeamReconstructionFilter<TVolumeImage, TProjectionImage>::GenerateOutput
 
   m_RayBoxFilter->SetBoxFromImage(this->GetInput(0), false);
 
+  // With a sensitivity cache, the ray lengths of all projections are computed
+  // at once and the projections are extracted from the cached stack
+  if (this->GetUseSensitivityCache())
+  {
+    m_RayBoxFilter->SetInput(m_ConstantProjectionStackSource->GetOutput());
+    m_ExtractFilterRayBox->SetInput(m_RayBoxFilter->GetOutput());
+    m_DivideProjectionFilter->SetInput2(m_ExtractFilterRayBox->GetOutput());
+  }
+  else
+  {
+    m_ExtractFilterRayBox->SetInput(m_ConstantProjectionStackSource->GetOutput());
+    m_RayBoxFilter->SetInput(m_ExtractFilterRayBox->GetOutput());
+    m_DivideProjectionFilter->SetInput2(m_RayBoxFilter->GetOutput());
+  }
+
   if (m_EnforcePositivity)
   {
     m_ThresholdFilter->SetOutsideValue(0);
@@ -263,18 +295,66 @@ SARTConeBeamReconstructionFilter<TVolumeImage, TProjectionImage>::GenerateData()
   // Create the zero projection stack used as input by RayBoxIntersectionFilter
   m_ConstantProjectionStackSource->Update();
 
+  // Ray lengths and normalization images from the sensitivity cache
+  const bool                     useCache = this->GetUseSensitivityCache();
+  SensitivityImageCache::KeyType normKey;
+  typename TVolumeImage::Pointer cachedNorm;
+  unsigned int                   nProjPerSubset = m_NumberOfProjectionsPerSubset;
+  if (nProjPerSubset == 0 || nProjPerSubset > nProj)
+    nProjPerSubset = nProj;
+  if (useCache)
+  {
+    std::vector<unsigned int> allProjections(nProj);
+    for (unsigned int i = 0; i < nProj; i++)
+      allProjections[i] = i;
+    SensitivityImageCache::KeyType rayBoxKey;
+    rayBoxKey.push_back(SensitivityImageCache::RAY_BOX_INTERSECTION);
+    SensitivityImageCache::AppendImageInformation(rayBoxKey, this->GetInput(0));
+    SensitivityImageCache::AppendImageInformation(rayBoxKey, this->GetInput(1));
+    SensitivityImageCache::AppendGeometry(rayBoxKey, this->m_Geometry, allProjections);
+
+    typename TProjectionImage::Pointer rayBox =
+      this->GetSensitivityCache()->template FindImage<TProjectionImage>(rayBoxKey);
+    if (rayBox.IsNull())
+    {
+      m_RayBoxFilter->Update();
+      rayBox = m_RayBoxFilter->GetOutput();
+      rayBox->DisconnectPipeline();
+      rayBox->ReleaseDataFlagOff();
+      this->GetSensitivityCache()->InsertImage(rayBoxKey, rayBox.GetPointer());
+    }
+    m_ExtractFilterRayBox->SetInput(rayBox);
+  }
+
   // Declare the image used in the main loop
   typename TVolumeImage::Pointer pimg;
   typename TVolumeImage::Pointer norm;
 
+  // Momentum of the updates and volume from which the current update is
+  // computed, i.e., the extrapolated volume
+  NesterovMomentum                    momentum(m_MomentumRestart, m_EnforcePositivity);
+  typename TVolumeImage::ConstPointer start = this->GetInput(0);
+  this->GetMultiThreader()->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+
   itk::IterationReporter iterationReporter(this, 0, 1); // report every iteration
 
   // For each iteration, go over each projection
   for (unsigned int iter = 0; iter < m_NumberOfIterations; iter++)
   {
     unsigned int projectionsProcessedInSubset = 0;
+    unsigned int subset = 0;
+    m_TelemetryIterationResidual = 0.;
+    m_TelemetrySubsetResidual = 0.;
     for (unsigned int i = 0; i < nProj; i++)
     {
+      if (useCache && projectionsProcessedInSubset == 0)
+      {
+        const std::vector<unsigned int> subsetProjections(projOrder.begin() + i,
+                                                          projOrder.begin() + std::min(i + nProjPerSubset, nProj));
+        normKey = this->GetBackProjectionOfOnesKey(this->m_Geometry, subsetProjections);
+        cachedNorm = this->GetSensitivityCache()->template FindImage<TVolumeImage>(normKey);
+      }
+
       // Change projection subset
       subsetRegion.SetIndex(Dimension - 1, projOrder[i]);
       m_ExtractFilter->SetExtractionRegion(subsetRegion);
@@ -299,10 +379,19 @@ SARTConeBeamReconstructionFilter<TVolumeImage, TProjectionImage>::GenerateData()
       projectionsProcessedInSubset++;
       if ((projectionsProcessedInSubset == m_NumberOfProjectionsPerSubset) || (i == nProj - 1))
       {
-        m_DivideVolumeFilter->SetInput2(m_BackProjectionNormalizationFilter->GetOutput());
+        if (cachedNorm.IsNotNull())
+          m_DivideVolumeFilter->SetInput2(cachedNorm);
+        else
+          m_DivideVolumeFilter->SetInput2(m_BackProjectionNormalizationFilter->GetOutput());
         m_DivideVolumeFilter->SetInput1(m_BackProjectionFilter->GetOutput());
         m_AddFilter->SetInput1(m_DivideVolumeFilter->GetOutput());
         m_DivideVolumeFilter->Update();
+        if (useCache && cachedNorm.IsNull())
+        {
+          norm = m_BackProjectionNormalizationFilter->GetOutput();
+          norm->DisconnectPipeline();
+          this->GetSensitivityCache()->InsertImage(normKey, norm.GetPointer());
+        }
 
         // To start a new subset:
         // - plug the output of the pipeline back into the Forward projection filter
@@ -314,29 +403,59 @@ SARTConeBeamReconstructionFilter<TVolumeImage, TProjectionImage>::GenerateData()
         pimg->Update();
         pimg->DisconnectPipeline();
 
-        m_ForwardProjectionFilter->SetInput(1, pimg);
-        m_AddFilter->SetInput2(pimg);
+        typename TVolumeImage::Pointer next = pimg;
+        if (m_Momentum && m_MomentumPerSubset)
+        {
+          next = momentum.Extrapolate(pimg.GetPointer(), start.GetPointer(), this->GetMultiThreader());
+          start = next;
+        }
+        m_ForwardProjectionFilter->SetInput(1, next);
+        m_AddFilter->SetInput2(next);
         m_BackProjectionFilter->SetInput(0, m_ConstantVolumeSource->GetOutput());
         m_BackProjectionNormalizationFilter->SetInput(0, m_ConstantVolumeSource->GetOutput());
 
         projectionsProcessedInSubset = 0;
+        this->ReportTelemetrySubset(subset++, std::sqrt(m_TelemetrySubsetResidual));
+        m_TelemetrySubsetResidual = 0.;
       }
       // Backproject in the same image otherwise.
       else
       {
         m_BackProjectionFilter->Update();
-        m_BackProjectionNormalizationFilter->Update();
         pimg = m_BackProjectionFilter->GetOutput();
         pimg->DisconnectPipeline();
         m_BackProjectionFilter->SetInput(0, pimg);
-        norm = m_BackProjectionNormalizationFilter->GetOutput();
-        norm->DisconnectPipeline();
-        m_BackProjectionNormalizationFilter->SetInput(0, norm);
+        if (cachedNorm.IsNull())
+        {
+          m_BackProjectionNormalizationFilter->Update();
+          norm = m_BackProjectionNormalizationFilter->GetOutput();
+          norm->DisconnectPipeline();
+          m_BackProjectionNormalizationFilter->SetInput(0, norm);
+        }
       }
     }
+
+    // Momentum of the iteration or restart of the momentum of the subsets
+    if (m_Momentum)
+    {
+      const bool                     restart = momentum.ReportObjective(m_TelemetryIterationResidual);
+      typename TVolumeImage::Pointer next = pimg;
+      if (!m_MomentumPerSubset)
+        next = momentum.Extrapolate(pimg.GetPointer(), start.GetPointer(), this->GetMultiThreader());
+      if (restart || !m_MomentumPerSubset)
+      {
+        m_ForwardProjectionFilter->SetInput(1, next);
+        m_AddFilter->SetInput2(next);
+        start = next;
+      }
+    }
+
     this->GraftOutput(pimg);
     iterationReporter.CompletedStep();
+    if (this->GetTelemetryStopRequested())
+      break;
   }
+  m_NumberOfMomentumRestarts = momentum.GetNumberOfRestarts();
 }
 
 } // end namespace rtk
@@ -21,6 +21,7 @@
 
 #include "rtkConfiguration.h"
 #include "rtkFFTProjectionsConvolutionImageFilter.h"
+#include "rtkScatterGlareKernelCache.h"
 
 namespace rtk
 {
@@ -31,6 +32,12 @@ namespace rtk
  * The filter code is based on FFTConvolutionImageFilter by Gaetan Lehmann
  * (see http://hdl.handle.net/10380/3154)
  *
+ * The spectrum of the deconvolution kernel is stored in KernelCache for each
+ * padded size. The projections are distributed over the threads, each thread
+ * reusing its padded image, its FFT filters and their buffers from one
+ * projection to the next. Only the threads which are left, e.g., for a single
+ * projection, are given to the FFTs.
+ *
  * \test rtkscatterglaretest.cxx
  *
  * \author Sebastien Brousmiche
@@ -64,6 +71,7 @@ public:
   using FFTOutputImagePointer = typename FFTOutputImageType::Pointer;
 
   using CoefficientVectorType = typename std::vector<float>;
+  using RegionType = typename InputImageType::RegionType;
 
   /** Standard New method. */
   itkNewMacro(Self);
@@ -82,6 +90,11 @@ public:
     }
   }
 
+  /** Get / Set the cache of the deconvolution kernel spectra. A cache is
+   * created by the constructor and can be shared by several filters. */
+  itkGetModifiableObjectMacro(KernelCache, ScatterGlareKernelCache);
+  itkSetObjectMacro(KernelCache, ScatterGlareKernelCache);
+
 protected:
   ScatterGlareCorrectionImageFilter();
   ~ScatterGlareCorrectionImageFilter() override = default;
@@ -91,9 +104,19 @@ protected:
   void
   UpdateFFTProjectionsConvolutionKernel(const SizeType size) override;
 
+  void
+  BeforeThreadedGenerateData() override;
+
+  void
+  ThreadedGenerateData(const RegionType & outputRegionForThread, ThreadIdType threadId) override;
+
 private:
-  CoefficientVectorType m_Coefficients;
-  CoefficientVectorType m_PreviousCoefficients;
+  CoefficientVectorType            m_Coefficients;
+  ScatterGlareKernelCache::KeyType m_KernelKey;
+  ScatterGlareKernelCache::Pointer m_KernelCache;
+
+  /** Number of threads of each FFT */
+  unsigned int m_FFTNumberOfWorkUnits{ 1 };
 }; // end of class
 
 } // end namespace rtk
@@ -25,8 +25,6 @@
 #include <itkRealToHalfHermitianForwardFFTImageFilter.h>
 #include <itkHalfHermitianToRealInverseFFTImageFilter.h>
 #include <itkImageRegionIterator.h>
-#include <itkImageRegionIteratorWithIndex.h>
-#include <itkDivideImageFilter.h>
 
 namespace rtk
 {
@@ -35,6 +33,7 @@ template <class TInputImage, class TOutputImage, class TFFTPrecision>
 ScatterGlareCorrectionImageFilter<TInputImage, TOutputImage, TFFTPrecision>::ScatterGlareCorrectionImageFilter()
 {
   this->m_KernelDimension = 2;
+  m_KernelCache = ScatterGlareKernelCache::New();
 }
 
 template <class TInputImage, class TOutputImage, class TFFTPrecision>
@@ -46,47 +45,60 @@ ScatterGlareCorrectionImageFilter<TInputImage, TOutputImage, TFFTPrecision>::Upd
   {
     itkGenericExceptionMacro(<< "Expecting 2 coefficients in m_Coefficients)");
   }
-  double                dx = this->GetInput()->GetSpacing()[0];
-  double                dy = this->GetInput()->GetSpacing()[1];
-  CoefficientVectorType coeffs = m_Coefficients;
-  coeffs.push_back(dx);
-  coeffs.push_back(dy);
-  coeffs.push_back(size[0]);
-  coeffs.push_back(size[1]);
-  if (coeffs == m_PreviousCoefficients)
+  double                           dx = this->GetInput()->GetSpacing()[0];
+  double                           dy = this->GetInput()->GetSpacing()[1];
+  ScatterGlareKernelCache::KeyType key(m_Coefficients.begin(), m_Coefficients.end());
+  key.push_back(dx);
+  key.push_back(dy);
+  key.push_back(size[0]);
+  key.push_back(size[1]);
+  key.push_back(sizeof(TFFTPrecision));
+  if (key == m_KernelKey && this->m_KernelFFT.IsNotNull())
     return; // Up-to-date
-  m_PreviousCoefficients = coeffs;
+  m_KernelKey = key;
 
+  if (m_KernelCache.IsNotNull())
+  {
+    this->m_KernelFFT = dynamic_cast<FFTOutputImageType *>(m_KernelCache->Find(key).GetPointer());
+    if (this->m_KernelFFT.IsNotNull())
+    {
+      // The cached kernel may be older than the copies of the previous kernel, e.g., on the GPU
+      this->m_KernelFFT->Modified();
+      return;
+    }
+  }
+
+  // The kernel is the same for all projections, i.e., 2D
+  SizeType kernelSize;
+  kernelSize.Fill(1);
+  kernelSize[0] = size[0];
+  kernelSize[1] = size[1];
   FFTInputImagePointer kernel = FFTInputImageType::New();
-  kernel->SetRegions(size);
+  kernel->SetRegions(kernelSize);
   kernel->Allocate();
 
   double a3 = m_Coefficients[0];
   double b3 = m_Coefficients[1];
   double b3sq = b3 * b3;
-  double halfXSz = size[0] / 2.;
-  double halfYSz = size[1] / 2.;
-
-  itk::ImageRegionIteratorWithIndex<FFTInputImageType> itK(kernel, kernel->GetLargestPossibleRegion());
-  itK.GoToBegin();
+  double halfXSz = kernelSize[0] / 2.;
+  double halfYSz = kernelSize[1] / 2.;
+  double scale = a3 * dx * dy / (2. * itk::Math::pi * b3sq);
 
-  // Central value
-  double g = (1 - a3) + a3 * dx * dy / (2. * itk::Math::pi * b3sq);
-  itK.Set(g);
-  ++itK;
-
-  typename FFTInputImageType::IndexType idx;
-  while (!itK.IsAtEnd())
+  TFFTPrecision * k = kernel->GetBufferPointer();
+  for (unsigned int j = 0; j < kernelSize[1]; j++)
   {
-    idx = itK.GetIndex();
-    double xx = halfXSz - itk::Math::abs(halfXSz - idx[0]); // Distance to nearest x border
-    double yy = halfYSz - itk::Math::abs(halfYSz - idx[1]); // Distance to nearest y border
-    double rr2 = (xx * xx + yy * yy);
-    g = (a3 * dx * dy / (2. * itk::Math::pi * b3sq)) / std::pow((1. + rr2 / b3sq), 1.5);
-    itK.Set(g);
-    ++itK;
+    double yy = halfYSz - itk::Math::abs(halfYSz - j); // Distance to nearest y border
+    for (unsigned int i = 0; i < kernelSize[0]; i++, k++)
+    {
+      double xx = halfXSz - itk::Math::abs(halfXSz - i); // Distance to nearest x border
+      double rr2 = (xx * xx + yy * yy);
+      *k = scale / std::pow((1. + rr2 / b3sq), 1.5);
+    }
   }
 
+  // Central value
+  kernel->GetBufferPointer()[0] += 1 - a3;
+
   // FFT kernel
   using ForwardFFTType = itk::RealToHalfHermitianForwardFFTImageFilter<FFTInputImageType, FFTOutputImageType>;
   typename ForwardFFTType::Pointer fftK = ForwardFFTType::New();
@@ -95,15 +107,100 @@ ScatterGlareCorrectionImageFilter<TInputImage, TOutputImage, TFFTPrecision>::Upd
   fftK->Update();
 
   // Inverse
-  using DivideType = itk::DivideImageFilter<FFTOutputImageType, FFTOutputImageType, FFTOutputImageType>;
-  typename DivideType::Pointer div = DivideType::New();
-  div->SetConstant1(1.);
-  div->SetInput(1, fftK->GetOutput());
-  div->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
-  div->Update();
-
-  this->m_KernelFFT = div->GetOutput();
-  this->m_KernelFFT->DisconnectPipeline();
+  FFTOutputImagePointer kernelFFT = fftK->GetOutput();
+  kernelFFT->DisconnectPipeline();
+  typename FFTOutputImageType::PixelType * kf = kernelFFT->GetBufferPointer();
+  const itk::SizeValueType                 npix = kernelFFT->GetBufferedRegion().GetNumberOfPixels();
+  for (itk::SizeValueType i = 0; i < npix; i++)
+    kf[i] = TFFTPrecision(1.) / kf[i];
+
+  this->m_KernelFFT = kernelFFT;
+  if (m_KernelCache.IsNotNull())
+    m_KernelCache->Insert(key, kernelFFT, npix * sizeof(typename FFTOutputImageType::PixelType));
+}
+
+template <class TInputImage, class TOutputImage, class TFFTPrecision>
+void
+ScatterGlareCorrectionImageFilter<TInputImage, TOutputImage, TFFTPrecision>::BeforeThreadedGenerateData()
+{
+  // The projections are distributed over the threads, the FFTs of each
+  // projection get the threads which are left
+  RegionType   reqRegion = this->GetOutput()->GetRequestedRegion();
+  unsigned int nproj = reqRegion.GetNumberOfPixels() / (reqRegion.GetSize()[0] * reqRegion.GetSize()[1]);
+  unsigned int workUnits = this->GetNumberOfWorkUnits();
+  m_FFTNumberOfWorkUnits = std::max(1u, workUnits / std::max(1u, std::min(nproj, workUnits)));
+
+  Superclass::BeforeThreadedGenerateData();
+}
+
+template <class TInputImage, class TOutputImage, class TFFTPrecision>
+void
+ScatterGlareCorrectionImageFilter<TInputImage, TOutputImage, TFFTPrecision>::ThreadedGenerateData(
+  const RegionType & outputRegionForThread,
+  ThreadIdType       threadId)
+{
+  using FFTType = itk::RealToHalfHermitianForwardFFTImageFilter<FFTInputImageType, FFTOutputImageType>;
+  using IFFTType = itk::HalfHermitianToRealInverseFFTImageFilter<FFTOutputImageType, FFTInputImageType>;
+
+  auto nproj = outputRegionForThread.GetNumberOfPixels() /
+               (outputRegionForThread.GetSize()[0] * outputRegionForThread.GetSize()[1]);
+
+  itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels(), 100);
+
+  // All projections of the thread have the same padded size so the padded
+  // image, the FFT filters and their outputs are allocated once
+  FFTInputImagePointer      paddedImage = FFTInputImageType::New();
+  typename FFTType::Pointer fft = FFTType::New();
+  fft->SetInput(paddedImage);
+  fft->SetNumberOfWorkUnits(m_FFTNumberOfWorkUnits);
+  typename IFFTType::Pointer ifft = IFFTType::New();
+  ifft->SetInput(fft->GetOutput());
+  ifft->SetNumberOfWorkUnits(m_FFTNumberOfWorkUnits);
+
+  const RegionType inputRegion = this->GetInput()->GetRequestedRegion();
+  for (unsigned int i = 0; i < nproj; i++)
+  {
+    RegionType         outputRegion = outputRegionForThread;
+    itk::SizeValueType n = i;
+    for (unsigned int d = 2; d < OutputImageType::ImageDimension; d++)
+    {
+      outputRegion.SetIndex(d, outputRegionForThread.GetIndex(d) + n % outputRegionForThread.GetSize(d));
+      outputRegion.SetSize(d, 1);
+      n /= outputRegionForThread.GetSize(d);
+    }
+
+    // Pad image region enlarged along X and Y
+    RegionType enlargedRegion = outputRegion;
+    for (unsigned int d = 0; d < 2; d++)
+    {
+      enlargedRegion.SetIndex(d, inputRegion.GetIndex(d));
+      enlargedRegion.SetSize(d, inputRegion.GetSize(d));
+    }
+    this->PadInputImageRegionInto(enlargedRegion, paddedImage);
+    fft->Update();
+
+    // Deconvolution of the spectrum, which the inverse FFT reads
+    typename FFTOutputImageType::PixelType *       p = fft->GetOutput()->GetBufferPointer();
+    const typename FFTOutputImageType::PixelType * k = this->m_KernelFFT->GetBufferPointer();
+    const itk::SizeValueType                       npix = fft->GetOutput()->GetBufferedRegion().GetNumberOfPixels();
+    for (itk::SizeValueType j = 0; j < npix; j++)
+      p[j] *= k[j];
+
+    // Inverse FFT image
+    ifft->SetActualXDimensionIsOdd(paddedImage->GetLargestPossibleRegion().GetSize(0) % 2);
+    ifft->Update();
+
+    // Crop and paste result
+    itk::ImageRegionConstIterator<FFTInputImageType> itS(ifft->GetOutput(), outputRegion);
+    itk::ImageRegionIterator<OutputImageType>        itD(this->GetOutput(), outputRegion);
+    while (!itS.IsAtEnd())
+    {
+      itD.Set(itS.Get());
+      ++itS;
+      ++itD;
+      progress.CompletedPixel();
+    }
+  }
 }
 
 } // end namespace rtk
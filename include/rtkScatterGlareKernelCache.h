@@ -0,0 +1,117 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef rtkScatterGlareKernelCache_h
+#define rtkScatterGlareKernelCache_h
+
+#include "RTKExport.h"
+
+#include <itkDataObject.h>
+#include <itkObject.h>
+#include <itkObjectFactory.h>
+
+#include <list>
+#include <mutex>
+#include <vector>
+
+namespace rtk
+{
+
+/** \class ScatterGlareKernelCache
+ * \brief Cache of the deconvolution kernel spectra of
+ * ScatterGlareCorrectionImageFilter.
+ *
+ * The spectrum of the deconvolution kernel only depends on the coefficients
+ * of the point spread function, on the pixel spacing and on the padded size of
+ * the projections. It is stored for each of these keys so that runs on
+ * projections of another size, e.g., with another requested region, do not
+ * recompute the spectra of the previous sizes. A cache can be shared by
+ * several filters. The least recently used spectra are discarded when the
+ * cache exceeds MemoryBudget.
+ *
+ * \ingroup RTK
+ */
+class RTK_EXPORT ScatterGlareKernelCache : public itk::Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(ScatterGlareKernelCache);
+
+  /** Standard class type alias. */
+  using Self = ScatterGlareKernelCache;
+  using Superclass = itk::Object;
+  using Pointer = itk::SmartPointer<Self>;
+  using ConstPointer = itk::SmartPointer<const Self>;
+  using KeyType = std::vector<double>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ScatterGlareKernelCache, itk::Object);
+
+  /** Get / Set the memory budget of the cache in bytes. Default is 512 MB. */
+  itkGetConstMacro(MemoryBudget, itk::SizeValueType);
+  virtual void
+  SetMemoryBudget(itk::SizeValueType budget);
+
+  /** Returns the cached spectrum of key, nullptr if it is not cached. */
+  itk::DataObject::Pointer
+  Find(const KeyType & key);
+
+  /** Stores the spectrum of key which occupies size bytes and discards the
+   * least recently used spectra if needed. */
+  void
+  Insert(const KeyType & key, itk::DataObject * spectrum, itk::SizeValueType size);
+
+  /** Number of cached spectra and memory used by the cache in bytes. */
+  unsigned int
+  GetNumberOfEntries() const;
+  itk::SizeValueType
+  GetMemoryUsage() const;
+
+  /** Release all cached spectra. */
+  void
+  Clear();
+
+protected:
+  ScatterGlareKernelCache() = default;
+  ~ScatterGlareKernelCache() override = default;
+
+  void
+  PrintSelf(std::ostream & os, itk::Indent indent) const override;
+
+private:
+  struct Entry
+  {
+    KeyType                  Key;
+    itk::DataObject::Pointer Spectrum;
+    itk::SizeValueType       Size;
+  };
+
+  void
+  Evict(itk::SizeValueType budget);
+
+  itk::SizeValueType m_MemoryBudget{ 512 * 1024 * 1024 };
+  itk::SizeValueType m_MemoryUsage{ 0 };
+  std::list<Entry>   m_Entries;
+  mutable std::mutex m_Mutex;
+};
+
+} // end namespace rtk
+
+#endif
@@ -0,0 +1,274 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef rtkSensitivityImageCache_h
+#define rtkSensitivityImageCache_h
+
+#include "RTKExport.h"
+#include "rtkThreeDCircularProjectionGeometry.h"
+
+#include <itkDataObject.h>
+#include <itkImageFileReader.h>
+#include <itkImageFileWriter.h>
+#include <itkObject.h>
+#include <itkObjectFactory.h>
+#include <itksys/SystemTools.hxx>
+
+#include <cstdio>
+#include <list>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace rtk
+{
+
+/** \class SensitivityImageCache
+ * \brief Cache of the data-independent normalization images of the iterative
+ * reconstruction filters.
+ *
+ * Some iterative reconstruction filters normalize their updates with images
+ * which only depend on the geometry, on the volume and projection grids and
+ * on the partition of the projections in subsets, e.g., the back projection
+ * of ones of each subset in rtk::OSEMConeBeamReconstructionFilter and
+ * rtk::SARTConeBeamReconstructionFilter, or the lengths of the rays in the
+ * volume in the latter. A cache can be set to these filters and shared by
+ * several filters and several runs so that these images are only computed
+ * once. The filters describe each image with a key of doubles built with
+ * AppendGeometry and AppendImageInformation.
+ *
+ * The least recently used images are discarded when the memory used by the
+ * cache exceeds MemoryBudget. If Directory is set, the images are also written
+ * to that directory in a file named after a hash of their key and read from it
+ * when they are not in memory, e.g., by another process. The full key is
+ * written in the header of the file and a file is only used if its key is
+ * equal to the requested one, which excludes collisions of the hash and files
+ * written with another version of the key.
+ *
+ * \ingroup RTK
+ */
+class RTK_EXPORT SensitivityImageCache : public itk::Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(SensitivityImageCache);
+
+  /** Standard class type alias. */
+  using Self = SensitivityImageCache;
+  using Superclass = itk::Object;
+  using Pointer = itk::SmartPointer<Self>;
+  using ConstPointer = itk::SmartPointer<const Self>;
+  using KeyType = std::vector<double>;
+
+  /** Kinds of cached images, the first value of their key. */
+  typedef enum
+  {
+    BACK_PROJECTION_OF_ONES = 0,
+    RAY_BOX_INTERSECTION = 1
+  } SensitivityType;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(SensitivityImageCache, itk::Object);
+
+  /** Get / Set the memory budget of the cache in bytes. Default is 1 GB. */
+  itkGetConstMacro(MemoryBudget, itk::SizeValueType);
+  virtual void
+  SetMemoryBudget(itk::SizeValueType budget);
+
+  /** Get / Set the directory where the images are stored on disk, none (empty)
+   * by default. */
+  itkGetStringMacro(Directory);
+  itkSetStringMacro(Directory);
+
+  /** Returns the image of key in memory, nullptr if it is not cached. */
+  itk::DataObject::Pointer
+  Find(const KeyType & key);
+
+  /** Stores in memory the image of key which occupies size bytes and
+   * discards the least recently used images if needed. */
+  void
+  Insert(const KeyType & key, itk::DataObject * image, itk::SizeValueType size);
+
+  /** Returns the image of key, from memory or from Directory, nullptr if it is
+   * not cached. The image must not be modified. */
+  template <class TImage>
+  typename TImage::Pointer
+  FindImage(const KeyType & key);
+
+  /** Stores the image of key in memory and in Directory. The image must not be
+   * modified afterwards. */
+  template <class TImage>
+  void
+  InsertImage(const KeyType & key, TImage * image);
+
+  /** File name of the image of key in Directory, empty if Directory is not
+   * set. */
+  std::string
+  GetFileName(const KeyType & key) const;
+
+  /** Appends to key the description of the projections of geometry, in this
+   * order. */
+  static void
+  AppendGeometry(KeyType &                                key,
+                 const ThreeDCircularProjectionGeometry * geometry,
+                 const std::vector<unsigned int> &        projections);
+
+  /** Appends to key the grid of image. */
+  template <class TImage>
+  static void
+  AppendImageInformation(KeyType & key, const TImage * image);
+
+  /** Number of cached images and memory used by the cache in bytes. */
+  unsigned int
+  GetNumberOfEntries() const;
+  itk::SizeValueType
+  GetMemoryUsage() const;
+
+  /** Release all images cached in memory. The files are not removed. */
+  void
+  Clear();
+
+protected:
+  SensitivityImageCache() = default;
+  ~SensitivityImageCache() override = default;
+
+  void
+  PrintSelf(std::ostream & os, itk::Indent indent) const override;
+
+private:
+  struct Entry
+  {
+    KeyType                  Key;
+    itk::DataObject::Pointer Image;
+    itk::SizeValueType       Size;
+  };
+
+  void
+  Evict(itk::SizeValueType budget);
+
+  /** Writes key in / compares key with the meta data of a file of the
+   * directory. */
+  static void
+  EncapsulateKey(itk::MetaDataDictionary & dictionary, const KeyType & key);
+  static bool
+  IsKeyOfDictionary(const itk::MetaDataDictionary & dictionary, const KeyType & key);
+
+  /** Name of a temporary file next to fileName, unique to the process and to
+   * the call. */
+  static std::string
+  GetTemporaryFileName(const std::string & fileName);
+
+  itk::SizeValueType m_MemoryBudget{ 1024 * 1024 * 1024 };
+  itk::SizeValueType m_MemoryUsage{ 0 };
+  std::string        m_Directory;
+  std::list<Entry>   m_Entries;
+  mutable std::mutex m_Mutex;
+};
+
+template <class TImage>
+typename TImage::Pointer
+SensitivityImageCache::FindImage(const KeyType & key)
+{
+  typename TImage::Pointer image = dynamic_cast<TImage *>(this->Find(key).GetPointer());
+  const std::string        fileName = this->GetFileName(key);
+  if (image.IsNotNull() || fileName.empty() || !itksys::SystemTools::FileExists(fileName))
+    return image;
+
+  // A file which cannot be read is ignored, the image is then recomputed
+  using ReaderType = itk::ImageFileReader<TImage>;
+  typename ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(fileName);
+  try
+  {
+    reader->Update();
+  }
+  catch (itk::ExceptionObject & err)
+  {
+    itkWarningMacro(<< "Could not read " << fileName << ": " << err.GetDescription());
+    return nullptr;
+  }
+  image = reader->GetOutput();
+  if (!IsKeyOfDictionary(image->GetMetaDataDictionary(), key))
+  {
+    itkWarningMacro(<< fileName << " is not the image of the requested key and is ignored");
+    return nullptr;
+  }
+  image->DisconnectPipeline();
+  this->Insert(key, image, image->GetPixelContainer()->Size() * sizeof(typename TImage::PixelType));
+  return image;
+}
+
+template <class TImage>
+void
+SensitivityImageCache::InsertImage(const KeyType & key, TImage * image)
+{
+  this->Insert(key, image, image->GetPixelContainer()->Size() * sizeof(typename TImage::PixelType));
+
+  const std::string fileName = this->GetFileName(key);
+  if (fileName.empty() || itksys::SystemTools::FileExists(fileName))
+    return;
+
+  // Write to a temporary file first so that concurrent runs never read a
+  // partially written image, with a name unique to this process and write
+  const std::string tmpFileName = GetTemporaryFileName(fileName);
+
+  // The key is written with a shallow copy to leave the cached image as is
+  typename TImage::Pointer fileImage = TImage::New();
+  fileImage->Graft(image);
+  itk::MetaDataDictionary dictionary = image->GetMetaDataDictionary();
+  EncapsulateKey(dictionary, key);
+  fileImage->SetMetaDataDictionary(dictionary);
+
+  using WriterType = itk::ImageFileWriter<TImage>;
+  typename WriterType::Pointer writer = WriterType::New();
+  writer->SetFileName(tmpFileName);
+  writer->SetInput(fileImage);
+  try
+  {
+    writer->Update();
+  }
+  catch (itk::ExceptionObject & err)
+  {
+    itkWarningMacro(<< "Could not write " << tmpFileName << ": " << err.GetDescription());
+    return;
+  }
+  if (std::rename(tmpFileName.c_str(), fileName.c_str()) != 0)
+    std::remove(tmpFileName.c_str());
+}
+
+template <class TImage>
+void
+SensitivityImageCache::AppendImageInformation(KeyType & key, const TImage * image)
+{
+  const typename TImage::RegionType region = image->GetLargestPossibleRegion();
+  for (unsigned int i = 0; i < TImage::ImageDimension; i++)
+  {
+    key.push_back(region.GetIndex(i));
+    key.push_back(region.GetSize(i));
+    key.push_back(image->GetOrigin()[i]);
+    key.push_back(image->GetSpacing()[i]);
+    for (unsigned int j = 0; j < TImage::ImageDimension; j++)
+      key.push_back(image->GetDirection()[i][j]);
+  }
+}
+
+} // end namespace rtk
+
+#endif
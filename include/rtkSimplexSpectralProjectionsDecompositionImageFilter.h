@@ -23,6 +23,7 @@
 #include <itkAmoebaOptimizer.h>
 #include "rtkSchlomka2008NegativeLogLikelihood.h"
 #include "rtkDualEnergyNegativeLogLikelihood.h"
+#include "rtkSpectralDecompositionLookupTable.h"
 
 namespace rtk
 {
@@ -32,6 +33,17 @@ namespace rtk
  * See the reference paper: "Experimental feasibility of multi-energy photon-counting
  * K-edge imaging in pre-clinical computed tomography", Schlomka et al, PMB 2008
  *
+ * With UseLookupTable on, the simplex optimization is run once per node of a
+ * SpectralDecompositionLookupTable, i.e., a grid of binwise log-transformed
+ * measurements, and each pixel is then decomposed by interpolation in this
+ * table. This is only tractable for few bins (dual energy or a handful of
+ * spectral bins). For spectral CT, the interpolated decomposition can be refined
+ * with a few Fisher scoring (Newton-type) iterations on the negative
+ * log-likelihood. The table is computed for the incident spectrum of the first
+ * pixel of the requested region; pixels with a different incident spectrum fall
+ * back to the simplex. If LookupTableFileName is set, the table is read from this
+ * file when it matches the current forward model, and written to it otherwise.
+ *
  * \author Cyril Mory
  *
  * \ingroup RTK ReconstructionAlgorithm
@@ -64,6 +76,7 @@ public:
   using DetectorResponseType = vnl_matrix<double>;
   using MaterialAttenuationsType = vnl_matrix<double>;
   using CostFunctionType = ProjectionsDecompositionNegativeLogLikelihood;
+  using LookupTableType = SpectralDecompositionLookupTable;
 
   /** Standard New method. */
   itkNewMacro(Self);
@@ -139,6 +152,33 @@ public:
   itkSetMacro(IsSpectralCT, bool);
   itkGetMacro(IsSpectralCT, bool);
 
+  /** Get / Set whether the decomposition is interpolated in a precomputed
+   * lookup table instead of being optimized for each pixel. Default is off. */
+  itkSetMacro(UseLookupTable, bool);
+  itkGetMacro(UseLookupTable, bool);
+
+  /** Get / Set the number of nodes of the lookup table along each bin. Default is 64. */
+  itkSetMacro(LookupTableNumberOfNodes, unsigned int);
+  itkGetMacro(LookupTableNumberOfNodes, unsigned int);
+
+  /** Get / Set the largest binwise log-transformed measurement covered by the
+   * lookup table. Default is 8. */
+  itkSetMacro(LookupTableMaximumLogTransform, double);
+  itkGetMacro(LookupTableMaximumLogTransform, double);
+
+  /** Get / Set the file used to store and reuse the lookup table. Default is
+   * empty, i.e., the table is computed at each update and not stored. */
+  itkSetStringMacro(LookupTableFileName);
+  itkGetStringMacro(LookupTableFileName);
+
+  /** Get / Set the number of Fisher scoring iterations refining the interpolated
+   * decomposition (spectral CT only). Default is 2. */
+  itkSetMacro(NumberOfNewtonIterations, unsigned int);
+  itkGetMacro(NumberOfNewtonIterations, unsigned int);
+
+  /** Get the lookup table used in the last update. */
+  itkGetModifiableObjectMacro(LookupTable, LookupTableType);
+
 protected:
   SimplexSpectralProjectionsDecompositionImageFilter();
   ~SimplexSpectralProjectionsDecompositionImageFilter() override = default;
@@ -154,6 +194,14 @@ protected:
   void
   DynamicThreadedGenerateData(const typename DecomposedProjectionsType::RegionType & outputRegionForThread) override;
 
+  /** Create and set a cost function for the current parameters */
+  CostFunctionType::Pointer
+  CreateCostFunction();
+
+  /** Read or compute the lookup table */
+  void
+  UpdateLookupTable();
+
   /**  Create the Output */
   using DataObjectPointerArraySizeType = itk::ProcessObject::DataObjectPointerArraySizeType;
   using Superclass::MakeOutput;
@@ -182,6 +230,16 @@ protected:
   unsigned int             m_NumberOfEnergies;
   unsigned int             m_NumberOfSpectralBins;
 
+  /** Lookup table parameters */
+  bool                     m_UseLookupTable;
+  unsigned int             m_LookupTableNumberOfNodes;
+  double                   m_LookupTableMaximumLogTransform;
+  std::string              m_LookupTableFileName;
+  unsigned int             m_NumberOfNewtonIterations;
+  LookupTableType::Pointer m_LookupTable;
+  vnl_matrix<float>        m_LookupTableSpectra;
+  vnl_vector<double>       m_LookupTableUnattenuatedCounts;
+
 }; // end of class
 
 } // end namespace rtk
@@ -22,6 +22,7 @@
 #include "rtkSpectralForwardModelImageFilter.h"
 #include <itkImageRegionIterator.h>
 #include <itkImageRegionConstIterator.h>
+#include <vnl/algo/vnl_svd.h>
 
 namespace rtk
 {
@@ -66,6 +67,13 @@ SimplexSpectralProjectionsDecompositionImageFilter<
   m_LogTransformEachBin = false;
   m_GuessInitialization = false;
   m_IsSpectralCT = true;
+
+  // Lookup table, off by default
+  m_UseLookupTable = false;
+  m_LookupTableNumberOfNodes = 64;
+  m_LookupTableMaximumLogTransform = 8.;
+  m_NumberOfNewtonIterations = 2;
+  m_LookupTable = LookupTableType::New();
 }
 
 template <typename DecomposedProjectionsType,
@@ -424,6 +432,9 @@ SimplexSpectralProjectionsDecompositionImageFilter<DecomposedProjectionsType,
     this->m_DetectorResponse = SpectralBinDetectorResponse<DetectorResponseType::element_type>(
       this->GetDetectorResponse().GetPointer(), m_Thresholds, m_NumberOfEnergies);
   }
+
+  if (m_UseLookupTable)
+    this->UpdateLookupTable();
 }
 
 template <typename DecomposedProjectionsType,
@@ -431,18 +442,14 @@ template <typename DecomposedProjectionsType,
           typename IncidentSpectrumImageType,
           typename DetectorResponseImageType,
           typename MaterialAttenuationsImageType>
-void
+ProjectionsDecompositionNegativeLogLikelihood::Pointer
 SimplexSpectralProjectionsDecompositionImageFilter<DecomposedProjectionsType,
                                                    MeasuredProjectionsType,
                                                    IncidentSpectrumImageType,
                                                    DetectorResponseImageType,
-                                                   MaterialAttenuationsImageType>::
-  DynamicThreadedGenerateData(const typename DecomposedProjectionsType::RegionType & outputRegionForThread)
+                                                   MaterialAttenuationsImageType>::CreateCostFunction()
 {
-  ////////////////////////////////////////////////////////////////////
-  // Create a Nelder-Mead simplex optimizer and its cost function
-  itk::AmoebaOptimizer::Pointer                               optimizer = itk::AmoebaOptimizer::New();
-  rtk::ProjectionsDecompositionNegativeLogLikelihood::Pointer cost;
+  CostFunctionType::Pointer cost;
   if (m_IsSpectralCT)
     cost = rtk::Schlomka2008NegativeLogLikelihood::New();
   else
@@ -459,6 +466,140 @@ SimplexSpectralProjectionsDecompositionImageFilter<DecomposedProjectionsType,
 
   // Pass the binned detector response to the cost function
   cost->SetDetectorResponse(this->m_DetectorResponse);
+  return cost;
+}
+
+template <typename DecomposedProjectionsType,
+          typename MeasuredProjectionsType,
+          typename IncidentSpectrumImageType,
+          typename DetectorResponseImageType,
+          typename MaterialAttenuationsImageType>
+void
+SimplexSpectralProjectionsDecompositionImageFilter<DecomposedProjectionsType,
+                                                   MeasuredProjectionsType,
+                                                   IncidentSpectrumImageType,
+                                                   DetectorResponseImageType,
+                                                   MaterialAttenuationsImageType>::UpdateLookupTable()
+{
+  // The table is computed for the incident spectrum (or spectra) of the first buffered pixel
+  typename IncidentSpectrumImageType::IndexType spectrumIndex =
+    this->GetInputIncidentSpectrum()->GetBufferedRegion().GetIndex();
+  if (this->GetInputSecondIncidentSpectrum())
+  {
+    m_LookupTableSpectra.set_size(2, this->m_NumberOfEnergies);
+    m_LookupTableSpectra.set_row(0, this->GetInputIncidentSpectrum()->GetPixel(spectrumIndex).GetDataPointer());
+    m_LookupTableSpectra.set_row(1, this->GetInputSecondIncidentSpectrum()->GetPixel(spectrumIndex).GetDataPointer());
+  }
+  else
+  {
+    m_LookupTableSpectra.set_size(1, this->m_NumberOfEnergies);
+    m_LookupTableSpectra.set_row(0, this->GetInputIncidentSpectrum()->GetPixel(spectrumIndex).GetDataPointer());
+  }
+
+  CostFunctionType::Pointer cost = this->CreateCostFunction();
+  cost->SetIncidentSpectrum(m_LookupTableSpectra);
+  cost->Initialize();
+
+  // Counts without any material and linearized forward model, i.e., the mean
+  // attenuation of each material in each bin, by finite differences
+  CostFunctionType::ParametersType lineIntegrals(this->m_NumberOfMaterials);
+  lineIntegrals.Fill(0.);
+  m_LookupTableUnattenuatedCounts = cost->ForwardModel(lineIntegrals);
+  vnl_matrix<double> linearized(this->m_NumberOfSpectralBins, this->m_NumberOfMaterials);
+  const double       delta = 1e-3;
+  for (unsigned int m = 0; m < this->m_NumberOfMaterials; m++)
+  {
+    lineIntegrals.Fill(0.);
+    lineIntegrals[m] = delta;
+    vnl_vector<double> attenuated = cost->ForwardModel(lineIntegrals);
+    for (unsigned int b = 0; b < this->m_NumberOfSpectralBins; b++)
+      linearized[b][m] = std::log(m_LookupTableUnattenuatedCounts[b] / attenuated[b]) / delta;
+  }
+  const vnl_matrix<double> linearizedInverse = vnl_svd<double>(linearized).pinverse();
+
+  // Key of the forward model and of the grid
+  LookupTableType::KeyType key = LookupTableType::HashValues(
+    m_DetectorResponse.data_block(), m_DetectorResponse.size(), m_IsSpectralCT ? 1 : 2);
+  key = LookupTableType::HashValues(m_MaterialAttenuations.data_block(), m_MaterialAttenuations.size(), key);
+  key = LookupTableType::HashValues(
+    m_LookupTableUnattenuatedCounts.data_block(), m_LookupTableUnattenuatedCounts.size(), key);
+  vnl_matrix<double> spectra(m_LookupTableSpectra.rows(), m_LookupTableSpectra.cols());
+  for (unsigned int i = 0; i < spectra.rows(); i++)
+    for (unsigned int j = 0; j < spectra.cols(); j++)
+      spectra[i][j] = m_LookupTableSpectra[i][j];
+  key = LookupTableType::HashValues(spectra.data_block(), spectra.size(), key);
+  const double iterations = m_NumberOfIterations;
+  key = LookupTableType::HashValues(&iterations, 1, key);
+
+  m_LookupTable->SetNumberOfSpectralBins(this->m_NumberOfSpectralBins);
+  m_LookupTable->SetNumberOfMaterials(this->m_NumberOfMaterials);
+  m_LookupTable->SetNumberOfNodes(m_LookupTableNumberOfNodes);
+  m_LookupTable->SetMaximumLogTransform(m_LookupTableMaximumLogTransform);
+  m_LookupTable->SetKey(key);
+  if (!m_LookupTableFileName.empty() && m_LookupTable->Read(m_LookupTableFileName))
+    return;
+
+  // Optimize the decomposition of each node, starting from the linearized solution
+  m_LookupTable->Allocate();
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    m_LookupTable->GetNumberOfGridNodes(),
+    [this, &linearizedInverse](itk::SizeValueType node) {
+      CostFunctionType::Pointer nodeCost = this->CreateCostFunction();
+      nodeCost->SetIncidentSpectrum(m_LookupTableSpectra);
+      nodeCost->Initialize();
+
+      LookupTableType::MeasurementType logTransforms;
+      m_LookupTable->GetNodeMeasurement(node, logTransforms);
+      CostFunctionType::MeasuredDataType measured(this->m_NumberOfSpectralBins);
+      vnl_vector<double>                 vnlLogTransforms(this->m_NumberOfSpectralBins);
+      for (unsigned int b = 0; b < this->m_NumberOfSpectralBins; b++)
+      {
+        measured[b] = m_LookupTableUnattenuatedCounts[b] * std::exp(-logTransforms[b]);
+        vnlLogTransforms[b] = logTransforms[b];
+      }
+      nodeCost->SetMeasuredData(measured);
+
+      vnl_vector<double>               guess = linearizedInverse * vnlLogTransforms;
+      CostFunctionType::ParametersType startingPosition(this->m_NumberOfMaterials);
+      for (unsigned int m = 0; m < this->m_NumberOfMaterials; m++)
+        startingPosition[m] = guess[m];
+
+      itk::AmoebaOptimizer::Pointer optimizer = itk::AmoebaOptimizer::New();
+      optimizer->SetCostFunction(nodeCost);
+      optimizer->SetMaximumNumberOfIterations(this->m_NumberOfIterations);
+      optimizer->SetInitialPosition(startingPosition);
+      optimizer->SetAutomaticInitialSimplex(true);
+      optimizer->StartOptimization();
+
+      LookupTableType::DecompositionType decomposition(this->m_NumberOfMaterials);
+      for (unsigned int m = 0; m < this->m_NumberOfMaterials; m++)
+        decomposition[m] = optimizer->GetCurrentPosition()[m];
+      m_LookupTable->SetNodeDecomposition(node, decomposition);
+    },
+    nullptr);
+
+  if (!m_LookupTableFileName.empty())
+    m_LookupTable->Write(m_LookupTableFileName);
+}
+
+template <typename DecomposedProjectionsType,
+          typename MeasuredProjectionsType,
+          typename IncidentSpectrumImageType,
+          typename DetectorResponseImageType,
+          typename MaterialAttenuationsImageType>
+void
+SimplexSpectralProjectionsDecompositionImageFilter<DecomposedProjectionsType,
+                                                   MeasuredProjectionsType,
+                                                   IncidentSpectrumImageType,
+                                                   DetectorResponseImageType,
+                                                   MaterialAttenuationsImageType>::
+  DynamicThreadedGenerateData(const typename DecomposedProjectionsType::RegionType & outputRegionForThread)
+{
+  ////////////////////////////////////////////////////////////////////
+  // Create a Nelder-Mead simplex optimizer and its cost function
+  itk::AmoebaOptimizer::Pointer optimizer = itk::AmoebaOptimizer::New();
+  CostFunctionType::Pointer     cost = this->CreateCostFunction();
 
   // Set the optimizer
   optimizer->SetCostFunction(cost);
@@ -522,26 +663,69 @@ SimplexSpectralProjectionsDecompositionImageFilter<DecomposedProjectionsType,
     // Pass the detector counts vector to cost function
     cost->SetMeasuredData(spectralProjIt.Get());
 
-    // Run the optimizer
-    typename rtk::ProjectionsDecompositionNegativeLogLikelihood::ParametersType startingPosition(
-      this->m_NumberOfMaterials);
-    if (m_GuessInitialization)
+    typename rtk::ProjectionsDecompositionNegativeLogLikelihood::ParametersType solution(this->m_NumberOfMaterials);
+    if (m_UseLookupTable && spectra == m_LookupTableSpectra)
     {
-      itk::VariableLengthVector<double> guess = cost->GuessInitialization();
+      // Interpolate in the lookup table
+      LookupTableType::MeasurementType logTransforms(this->m_NumberOfSpectralBins);
+      for (unsigned int b = 0; b < this->m_NumberOfSpectralBins; b++)
+      {
+        if (spectralProjIt.Get()[b] > 0)
+          logTransforms[b] = std::log(m_LookupTableUnattenuatedCounts[b] / spectralProjIt.Get()[b]);
+        else
+          logTransforms[b] = m_LookupTableMaximumLogTransform;
+      }
+      LookupTableType::DecompositionType decomposition;
+      m_LookupTable->Interpolate(logTransforms, decomposition);
       for (unsigned int m = 0; m < this->m_NumberOfMaterials; m++)
-        startingPosition[m] = guess[m];
+        solution[m] = decomposition[m];
+
+      // Refine with Fisher scoring iterations, only available with the
+      // derivatives of the spectral CT cost function
+      for (unsigned int k = 0; m_IsSpectralCT && k < m_NumberOfNewtonIterations; k++)
+      {
+        CostFunctionType::DerivativeType gradient;
+        cost->GetDerivative(solution, gradient);
+        cost->ComputeFischerMatrix(solution);
+        itk::VariableLengthVector<float> fischer = cost->GetFischerMatrix();
+        vnl_matrix<double>               fischerMatrix(this->m_NumberOfMaterials, this->m_NumberOfMaterials);
+        for (unsigned int i = 0; i < this->m_NumberOfMaterials; i++)
+          for (unsigned int j = 0; j < this->m_NumberOfMaterials; j++)
+            fischerMatrix[i][j] = fischer[i * this->m_NumberOfMaterials + j];
+        vnl_vector<double> step = vnl_svd<double>(fischerMatrix).solve(gradient);
+
+        typename rtk::ProjectionsDecompositionNegativeLogLikelihood::ParametersType candidate(solution);
+        for (unsigned int m = 0; m < this->m_NumberOfMaterials; m++)
+          candidate[m] -= step[m];
+        if (!(cost->GetValue(candidate) < cost->GetValue(solution)))
+          break;
+        solution = candidate;
+      }
     }
     else
     {
-      for (unsigned int m = 0; m < this->m_NumberOfMaterials; m++)
-        startingPosition[m] = inputIt.Get()[m];
+      // Run the optimizer
+      typename rtk::ProjectionsDecompositionNegativeLogLikelihood::ParametersType startingPosition(
+        this->m_NumberOfMaterials);
+      if (m_GuessInitialization)
+      {
+        itk::VariableLengthVector<double> guess = cost->GuessInitialization();
+        for (unsigned int m = 0; m < this->m_NumberOfMaterials; m++)
+          startingPosition[m] = guess[m];
+      }
+      else
+      {
+        for (unsigned int m = 0; m < this->m_NumberOfMaterials; m++)
+          startingPosition[m] = inputIt.Get()[m];
+      }
+
+      optimizer->SetInitialPosition(startingPosition);
+      optimizer->SetAutomaticInitialSimplex(true);
+      optimizer->SetOptimizeWithRestarts(this->m_OptimizeWithRestarts);
+      optimizer->StartOptimization();
+      solution = optimizer->GetCurrentPosition();
     }
 
-    optimizer->SetInitialPosition(startingPosition);
-    optimizer->SetAutomaticInitialSimplex(true);
-    optimizer->SetOptimizeWithRestarts(this->m_OptimizeWithRestarts);
-    optimizer->StartOptimization();
-
     typename DecomposedProjectionsType::PixelType outputPixel;
     if (m_LogTransformEachBin)
     {
@@ -553,13 +737,13 @@ SimplexSpectralProjectionsDecompositionImageFilter<DecomposedProjectionsType,
       outputPixel.SetSize(this->m_NumberOfMaterials);
 
     for (unsigned int m = 0; m < this->m_NumberOfMaterials; m++)
-      outputPixel[m] = optimizer->GetCurrentPosition()[m];
+      outputPixel[m] = solution[m];
 
     output0It.Set(outputPixel);
 
     // If required, compute the Fischer matrix
     if (m_OutputInverseCramerRaoLowerBound || m_OutputFischerMatrix)
-      cost->ComputeFischerMatrix(optimizer->GetCurrentPosition());
+      cost->ComputeFischerMatrix(solution);
 
     // If requested, compute the inverse variance of decomposition noise, and store it into output(1)
     if (m_OutputInverseCramerRaoLowerBound)
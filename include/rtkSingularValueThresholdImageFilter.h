@@ -20,6 +20,7 @@
 #define rtkSingularValueThresholdImageFilter_h
 
 #include <itkInPlaceImageFilter.h>
+#include <itkMatrix.h>
 #include <itkVector.h>
 
 #include <itkImageRegionSplitterDirection.h>
@@ -41,6 +42,14 @@ namespace rtk
  * then reconstructed. The resulting matrix is then cut back into L gradient vectors,
  * which are written in output.
  *
+ * Since N is small, the SVD is not computed explicitly. The N x N Gram matrix
+ * J^T J of the L x N matrix J is diagonalized with cyclic Jacobi rotations,
+ * which gives the right singular vectors V and the squared singular values.
+ * The thresholded matrix is then J V F V^T, where F is the diagonal matrix of
+ * the ratios between the thresholded and the original singular values. All
+ * voxels of a row are processed together, channel after channel, so that
+ * memory is traversed sequentially.
+ *
  * \author Cyril Mory
  *
  * \ingroup RTK
@@ -86,6 +95,9 @@ public:
   using RealVectorType = itk::Vector<TRealType, InputPixelType::Dimension>;
   using RealVectorImageType = itk::Image<RealVectorType, TInputImage::ImageDimension>;
 
+  /** Small symmetric matrix of size N x N used for the SVD of each voxel. */
+  using GramMatrixType = itk::Matrix<double, TInputImage::ImageDimension - 1, TInputImage::ImageDimension - 1>;
+
   /** Superclass type alias. */
   using OutputImageRegionType = typename Superclass::OutputImageRegionType;
 
@@ -111,6 +123,11 @@ protected:
                                              GetImageRegionSplitter() const override;
   itk::ImageRegionSplitterDirection::Pointer m_Splitter;
 
+  /** Replaces the Gram matrix J^T J of a voxel by the matrix M such that J M
+   * has the singular values of J thresholded. */
+  void
+  ComputeThresholdingMatrix(GramMatrixType & matrix) const;
+
 private:
   TRealType m_Threshold;
 };
@@ -20,11 +20,11 @@
 #define rtkSingularValueThresholdImageFilter_hxx
 
 
-#include <itkImageRegionIterator.h>
-#include <itkImageRegionConstIterator.h>
 #include <itkImageRegionIteratorWithIndex.h>
 
-#include <itkProgressReporter.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
 
 namespace rtk
 {
@@ -49,76 +49,152 @@ SingularValueThresholdImageFilter<TInputImage, TRealType, TOutputImage>::GetImag
 
 template <typename TInputImage, typename TRealType, typename TOutputImage>
 void
-SingularValueThresholdImageFilter<TInputImage, TRealType, TOutputImage>::ThreadedGenerateData(
-  const OutputImageRegionType & outputRegionForThread,
-  itk::ThreadIdType /*threadId*/)
+SingularValueThresholdImageFilter<TInputImage, TRealType, TOutputImage>::ComputeThresholdingMatrix(
+  GramMatrixType & matrix) const
 {
-  // Walks the first frame of the outputRegionForThread
-  // For each voxel, creates an input iterator that walks
-  // the last dimension and computes the average, and
-  // a similar output iterator that replaces the output
-  // by their average along last dimension if ROI=1
-
-  // Create a region containing only the first frame of outputRegionForThread
-  typename TInputImage::RegionType FirstFrameRegion = outputRegionForThread;
-  FirstFrameRegion.SetSize(TInputImage::ImageDimension - 1, 1);
-
-  // Iterate on these regions
-  itk::ImageRegionIteratorWithIndex<TInputImage> FakeIterator(this->GetOutput(), FirstFrameRegion);
-
-  // Create a single-voxel region traversing last dimension
-  typename TInputImage::RegionType SingleVoxelRegion = outputRegionForThread;
-  for (unsigned int dim = 0; dim < TInputImage::ImageDimension - 1; dim++)
-    SingleVoxelRegion.SetSize(dim, 1);
-
-  // Create a variable to store the jacobian matrix
-  vnl_matrix<double> jacobian(outputRegionForThread.GetSize()[TInputImage::ImageDimension - 1],
-                              TInputImage::ImageDimension - 1);
+  constexpr unsigned int N = TInputImage::ImageDimension - 1;
 
-  while (!FakeIterator.IsAtEnd())
+  // Cyclic Jacobi rotations: matrix converges to diag(eigenvalues) = V^T (J^T J) V
+  GramMatrixType eigenVectors;
+  eigenVectors.SetIdentity();
+  for (unsigned int sweep = 0; sweep < 20; sweep++)
   {
-    // Configure the SingleVoxelRegion correctly to follow the FakeIterator
-    // It is the only purpose of this FakeIterator
-    SingleVoxelRegion.SetIndex(FakeIterator.GetIndex());
-
-    // Walk the input along last dimension for this voxel, filling in the jacobian along the way
-    itk::ImageRegionConstIterator<TInputImage> inputIterator(this->GetInput(), SingleVoxelRegion);
-    unsigned int                               row = 0;
-    for (inputIterator.GoToBegin(); !inputIterator.IsAtEnd(); ++inputIterator, row++)
+    double offDiagonal = 0.;
+    double diagonal = 0.;
+    for (unsigned int p = 0; p < N; p++)
     {
-      typename TInputImage::PixelType gradient = inputIterator.Get();
-      for (unsigned int column = 0; column < TInputImage::ImageDimension - 1; column++)
+      diagonal += matrix[p][p] * matrix[p][p];
+      for (unsigned int q = p + 1; q < N; q++)
+        offDiagonal += matrix[p][q] * matrix[p][q];
+    }
+    if (offDiagonal <= 1e-24 * diagonal)
+      break;
+
+    for (unsigned int p = 0; p < N; p++)
+      for (unsigned int q = p + 1; q < N; q++)
       {
-        jacobian[row][column] = gradient[column];
+        if (matrix[p][q] == 0.)
+          continue;
+        const double theta = (matrix[q][q] - matrix[p][p]) / (2. * matrix[p][q]);
+        const double t = (theta >= 0. ? 1. : -1.) / (std::abs(theta) + std::sqrt(theta * theta + 1.));
+        const double c = 1. / std::sqrt(t * t + 1.);
+        const double s = t * c;
+        for (unsigned int k = 0; k < N; k++)
+        {
+          const double akp = matrix[k][p];
+          const double akq = matrix[k][q];
+          matrix[k][p] = c * akp - s * akq;
+          matrix[k][q] = s * akp + c * akq;
+        }
+        for (unsigned int k = 0; k < N; k++)
+        {
+          const double apk = matrix[p][k];
+          const double aqk = matrix[q][k];
+          matrix[p][k] = c * apk - s * aqk;
+          matrix[q][k] = s * apk + c * aqk;
+        }
+        for (unsigned int k = 0; k < N; k++)
+        {
+          const double vkp = eigenVectors[k][p];
+          const double vkq = eigenVectors[k][q];
+          eigenVectors[k][p] = c * vkp - s * vkq;
+          eigenVectors[k][q] = s * vkp + c * vkq;
+        }
       }
-    }
+  }
 
-    // Perform the singular value decomposition of the jacobian matrix
-    vnl_svd<double> svd(jacobian);
+  // Ratio between the thresholded and the original singular values
+  double ratios[N];
+  for (unsigned int i = 0; i < N; i++)
+  {
+    const double singularValue = std::sqrt(std::max(matrix[i][i], 0.));
+    ratios[i] = (singularValue > m_Threshold) ? m_Threshold / singularValue : 1.;
+  }
 
-    // Threshold the singular values. Since they are sorted in descending order, we
-    // can stop as soon as we reach one that is below threshold
-    for (unsigned int i = 0; (i < TInputImage::ImageDimension && svd.W(i) > m_Threshold); i++)
+  // M = V diag(ratios) V^T
+  for (unsigned int i = 0; i < N; i++)
+    for (unsigned int j = 0; j < N; j++)
     {
-      svd.W(i) = m_Threshold;
+      matrix[i][j] = 0.;
+      for (unsigned int k = 0; k < N; k++)
+        matrix[i][j] += eigenVectors[i][k] * ratios[k] * eigenVectors[j][k];
     }
+}
 
-    // Reconstruct the jacobian
-    jacobian = svd.recompose();
-
-    // Walk the output along last dimension for this voxel,
-    // replacing gradient vectors with their newly computed value
-    itk::ImageRegionIterator<TInputImage> outputIterator(this->GetOutput(), SingleVoxelRegion);
-    row = 0;
-    for (outputIterator.GoToBegin(); !outputIterator.IsAtEnd(); ++outputIterator, row++)
+template <typename TInputImage, typename TRealType, typename TOutputImage>
+void
+SingularValueThresholdImageFilter<TInputImage, TRealType, TOutputImage>::ThreadedGenerateData(
+  const OutputImageRegionType & outputRegionForThread,
+  itk::ThreadIdType /*threadId*/)
+{
+  // Walks the rows of the first frame of the outputRegionForThread.
+  // For each row, the Gram matrices of the jacobians of all its voxels are
+  // accumulated by walking the channels, then each one is turned into a
+  // thresholding matrix, and the channels are walked again to apply them.
+  constexpr unsigned int Dimension = TInputImage::ImageDimension;
+  constexpr unsigned int N = Dimension - 1;
+  const unsigned int     nChannels = outputRegionForThread.GetSize(Dimension - 1);
+  const unsigned int     rowLength = outputRegionForThread.GetSize(0);
+
+  const TInputImage *        input = this->GetInput();
+  TOutputImage *             output = this->GetOutput();
+  const itk::OffsetValueType inputChannelStride = input->GetOffsetTable()[Dimension - 1];
+  const itk::OffsetValueType outputChannelStride = output->GetOffsetTable()[Dimension - 1];
+
+  // One small matrix per voxel of the row
+  std::vector<GramMatrixType> matrices(rowLength);
+
+  // Region containing the first voxel of each row of the first frame
+  typename TInputImage::RegionType rowStartsRegion = outputRegionForThread;
+  rowStartsRegion.SetSize(0, 1);
+  rowStartsRegion.SetSize(Dimension - 1, 1);
+
+  // Iterate on this region, only to get the indices of the rows
+  itk::ImageRegionIteratorWithIndex<TOutputImage> FakeIterator(output, rowStartsRegion);
+  while (!FakeIterator.IsAtEnd())
+  {
+    const typename TInputImage::IndexType rowStart = FakeIterator.GetIndex();
+    const InputPixelType * const          inRow = input->GetBufferPointer() + input->ComputeOffset(rowStart);
+    OutputPixelType * const               outRow = output->GetBufferPointer() + output->ComputeOffset(rowStart);
+
+    // Accumulate the Gram matrices J^T J
+    for (unsigned int x = 0; x < rowLength; x++)
+      matrices[x].Fill(0.);
+    const InputPixelType * in = inRow;
+    for (unsigned int c = 0; c < nChannels; c++, in += inputChannelStride)
+      for (unsigned int x = 0; x < rowLength; x++)
+        for (unsigned int i = 0; i < N; i++)
+          for (unsigned int j = i; j < N; j++)
+            matrices[x][i][j] += in[x][i] * in[x][j];
+
+    for (unsigned int x = 0; x < rowLength; x++)
     {
-      typename TInputImage::PixelType vector;
-      for (unsigned int column = 0; column < jacobian.cols(); column++)
-        vector[column] = jacobian[row][column];
-
-      outputIterator.Set(vector);
+      for (unsigned int i = 0; i < N; i++)
+        for (unsigned int j = 0; j < i; j++)
+          matrices[x][i][j] = matrices[x][j][i];
+      ComputeThresholdingMatrix(matrices[x]);
     }
 
+    // Replace each gradient vector, i.e., each row of J, by its product with the
+    // thresholding matrix. The filter may run in place, so the input pixel is read
+    // before the output pixel is written.
+    in = inRow;
+    OutputPixelType * out = outRow;
+    for (unsigned int c = 0; c < nChannels; c++, in += inputChannelStride, out += outputChannelStride)
+      for (unsigned int x = 0; x < rowLength; x++)
+      {
+        const InputPixelType gradient = in[x];
+        OutputPixelType      vector;
+        for (unsigned int i = 0; i < N; i++)
+        {
+          double value = 0.;
+          for (unsigned int j = 0; j < N; j++)
+            value += gradient[j] * matrices[x][j][i];
+          vector[i] = value;
+        }
+        out[x] = vector;
+      }
+
     ++FakeIterator;
   }
 }
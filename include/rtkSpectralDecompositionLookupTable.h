@@ -0,0 +1,147 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef rtkSpectralDecompositionLookupTable_h
+#define rtkSpectralDecompositionLookupTable_h
+
+#include "RTKExport.h"
+
+#include <itkObject.h>
+#include <itkObjectFactory.h>
+#include <itkVariableLengthVector.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace rtk
+{
+/** \class SpectralDecompositionLookupTable
+ * \brief Precomputed inverse of the spectral forward model.
+ *
+ * The table samples a regular grid in the space of binwise log-transformed
+ * measurements, i.e., log(unattenuated counts / measured counts) in each bin,
+ * between 0 and MaximumLogTransform with NumberOfNodes nodes per bin. Each node
+ * stores the material line integrals that best explain the corresponding
+ * measurement. The decomposition of a pixel is then obtained by multilinear
+ * interpolation in the table.
+ *
+ * The table is only valid for the forward model (incident spectrum, detector
+ * response and material attenuations) it has been computed with. A key
+ * summarizing this model is stored with the table and checked when reading it
+ * from disk, so that a file can safely be reused across scans.
+ *
+ * \ingroup RTK
+ */
+class RTK_EXPORT SpectralDecompositionLookupTable : public itk::Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(SpectralDecompositionLookupTable);
+
+  /** Standard class type alias. */
+  using Self = SpectralDecompositionLookupTable;
+  using Superclass = itk::Object;
+  using Pointer = itk::SmartPointer<Self>;
+  using ConstPointer = itk::SmartPointer<const Self>;
+
+  /** Convenient type alias. */
+  using MeasurementType = itk::VariableLengthVector<double>;
+  using DecompositionType = itk::VariableLengthVector<double>;
+  using KeyType = std::uint64_t;
+  using NodeIndexType = itk::SizeValueType;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(SpectralDecompositionLookupTable, itk::Object);
+
+  /** Get / Set the number of spectral bins, i.e., the dimension of the grid. */
+  itkGetConstMacro(NumberOfSpectralBins, unsigned int);
+  itkSetMacro(NumberOfSpectralBins, unsigned int);
+
+  /** Get / Set the number of materials stored at each node. */
+  itkGetConstMacro(NumberOfMaterials, unsigned int);
+  itkSetMacro(NumberOfMaterials, unsigned int);
+
+  /** Get / Set the number of grid nodes along each bin. Default is 64. */
+  itkGetConstMacro(NumberOfNodes, unsigned int);
+  itkSetMacro(NumberOfNodes, unsigned int);
+
+  /** Get / Set the largest log-transformed measurement covered by the grid.
+   * Measurements beyond are clamped. Default is 8. */
+  itkGetConstMacro(MaximumLogTransform, double);
+  itkSetMacro(MaximumLogTransform, double);
+
+  /** Get / Set the key of the forward model the table is computed for. */
+  itkGetConstMacro(Key, KeyType);
+  itkSetMacro(Key, KeyType);
+
+  /** Hash a set of values (forward model and grid parameters) into a key. The
+   * hash is chained with the input key so that it can be called several times. */
+  static KeyType
+  HashValues(const double * values, size_t n, KeyType key = 14695981039346656037ULL);
+
+  /** Allocate the table according to the current parameters. */
+  void
+  Allocate();
+
+  /** Total number of nodes of the grid. */
+  NodeIndexType
+  GetNumberOfGridNodes() const;
+
+  /** Log-transformed measurements at a given node of the grid. */
+  void
+  GetNodeMeasurement(NodeIndexType node, MeasurementType & logTransforms) const;
+
+  /** Store the decomposition of a given node. Thread safe for different nodes. */
+  void
+  SetNodeDecomposition(NodeIndexType node, const DecompositionType & decomposition);
+
+  /** Multilinear interpolation of the table at the given log-transformed measurements. */
+  void
+  Interpolate(const MeasurementType & logTransforms, DecompositionType & decomposition) const;
+
+  /** Read the table from a file. Returns false, leaving the table unchanged,
+   * if the file cannot be read or has been computed for other parameters. */
+  bool
+  Read(const std::string & fileName);
+
+  /** Write the table to a file. */
+  void
+  Write(const std::string & fileName) const;
+
+protected:
+  SpectralDecompositionLookupTable() = default;
+  ~SpectralDecompositionLookupTable() override = default;
+
+  void
+  PrintSelf(std::ostream & os, itk::Indent indent) const override;
+
+private:
+  unsigned int       m_NumberOfSpectralBins{ 2 };
+  unsigned int       m_NumberOfMaterials{ 2 };
+  unsigned int       m_NumberOfNodes{ 64 };
+  double             m_MaximumLogTransform{ 8. };
+  KeyType            m_Key{ 0 };
+  std::vector<float> m_Table;
+};
+
+} // namespace rtk
+
+#endif // rtkSpectralDecompositionLookupTable_h
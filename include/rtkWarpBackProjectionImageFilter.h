@@ -0,0 +1,122 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef rtkWarpBackProjectionImageFilter_h
+#define rtkWarpBackProjectionImageFilter_h
+
+#include "rtkBackProjectionImageFilter.h"
+
+#include <itkCovariantVector.h>
+#include <itkLinearInterpolateImageFunction.h>
+
+#include <vector>
+
+namespace rtk
+{
+
+/** \class WarpBackProjectionImageFilter
+ * \brief Voxel-based backprojection into a warped volume
+ *
+ * WarpBackProjectionImageFilter is the CPU counterpart of
+ * CudaWarpBackProjectionImageFilter. Each voxel center is displaced by the
+ * trilinearly interpolated displacement vector field (DVF) before being
+ * projected onto the projection images, where the value to backproject is
+ * bilinearly interpolated. The DVF is interpolated once per voxel and reused
+ * for all the projections of the input stack, which avoids warping the whole
+ * volume for each projection.
+ *
+ * \test rtkwarpprojectionstacktofourdtest.cxx
+ *
+ * \ingroup RTK Projector
+ */
+template <class TInputImage,
+          class TOutputImage = TInputImage,
+          class TDVFImage =
+            itk::Image<itk::CovariantVector<typename TInputImage::PixelType, TInputImage::ImageDimension>,
+                       TInputImage::ImageDimension>>
+class ITK_TEMPLATE_EXPORT WarpBackProjectionImageFilter : public BackProjectionImageFilter<TInputImage, TOutputImage>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(WarpBackProjectionImageFilter);
+
+  /** Standard class type alias. */
+  using Self = WarpBackProjectionImageFilter;
+  using Superclass = BackProjectionImageFilter<TInputImage, TOutputImage>;
+  using Pointer = itk::SmartPointer<Self>;
+  using ConstPointer = itk::SmartPointer<const Self>;
+  using OutputImageRegionType = typename TOutputImage::RegionType;
+  using ProjectionMatrixType = typename Superclass::ProjectionMatrixType;
+  using ProjectionImageType = typename Superclass::ProjectionImageType;
+  using ProjectionImagePointer = typename Superclass::ProjectionImagePointer;
+  using ProjectionPPToIndexMatrixType = itk::Matrix<double, TInputImage::ImageDimension, TInputImage::ImageDimension>;
+  using DVFImageType = TDVFImage;
+  using ProjectionInterpolatorType = itk::LinearInterpolateImageFunction<ProjectionImageType, double>;
+  using DVFInterpolatorType = itk::LinearInterpolateImageFunction<TDVFImage, double>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(WarpBackProjectionImageFilter, BackProjectionImageFilter);
+
+  /** Input projection stack */
+  void
+  SetInputProjectionStack(const TInputImage * ProjectionStack);
+
+  /** Input volume */
+  void
+  SetInputVolume(const TInputImage * Volume);
+
+  /** Input displacement vector field */
+  void
+  SetDisplacementField(const DVFImageType * DVF);
+  const DVFImageType *
+  GetDisplacementField();
+
+protected:
+  WarpBackProjectionImageFilter() = default;
+  ~WarpBackProjectionImageFilter() override = default;
+
+  /** Warped voxels may project anywhere, the whole projections and DVF are
+   * requested. */
+  void
+  GenerateInputRequestedRegion() override;
+
+  /** Extracts the projections and computes their matrices once for all threads. */
+  void
+  BeforeThreadedGenerateData() override;
+
+  void
+  DynamicThreadedGenerateData(const OutputImageRegionType & outputRegionForThread) override;
+
+  void
+  AfterThreadedGenerateData() override;
+
+private:
+  std::vector<ProjectionMatrixType>                         m_ProjectionMatrices;
+  std::vector<ProjectionPPToIndexMatrixType>                m_ProjPPToProjIndex;
+  std::vector<typename ProjectionInterpolatorType::Pointer> m_ProjectionInterpolators;
+};
+
+} // end namespace rtk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "rtkWarpBackProjectionImageFilter.hxx"
+#endif
+
+#endif
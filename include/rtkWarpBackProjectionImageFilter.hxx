@@ -0,0 +1,240 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef rtkWarpBackProjectionImageFilter_hxx
+#define rtkWarpBackProjectionImageFilter_hxx
+
+
+#include "rtkHomogeneousMatrix.h"
+
+#include <itkImageRegionConstIterator.h>
+#include <itkImageRegionIteratorWithIndex.h>
+
+#include <cmath>
+
+namespace rtk
+{
+
+template <class TInputImage, class TOutputImage, class TDVFImage>
+void
+WarpBackProjectionImageFilter<TInputImage, TOutputImage, TDVFImage>::SetInputProjectionStack(
+  const TInputImage * ProjectionStack)
+{
+  this->SetInput(1, const_cast<TInputImage *>(ProjectionStack));
+}
+
+template <class TInputImage, class TOutputImage, class TDVFImage>
+void
+WarpBackProjectionImageFilter<TInputImage, TOutputImage, TDVFImage>::SetInputVolume(const TInputImage * Volume)
+{
+  this->SetInput(0, const_cast<TInputImage *>(Volume));
+}
+
+template <class TInputImage, class TOutputImage, class TDVFImage>
+void
+WarpBackProjectionImageFilter<TInputImage, TOutputImage, TDVFImage>::SetDisplacementField(const DVFImageType * DVF)
+{
+  this->SetInput("DisplacementField", const_cast<DVFImageType *>(DVF));
+}
+
+template <class TInputImage, class TOutputImage, class TDVFImage>
+const typename WarpBackProjectionImageFilter<TInputImage, TOutputImage, TDVFImage>::DVFImageType *
+WarpBackProjectionImageFilter<TInputImage, TOutputImage, TDVFImage>::GetDisplacementField()
+{
+  return static_cast<const DVFImageType *>(this->itk::ProcessObject::GetInput("DisplacementField"));
+}
+
+template <class TInputImage, class TOutputImage, class TDVFImage>
+void
+WarpBackProjectionImageFilter<TInputImage, TOutputImage, TDVFImage>::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+
+  // The region of the projections computed by the superclass assumes that
+  // voxels do not move, so request the largest possible region instead
+  auto * projPtr = const_cast<TInputImage *>(this->GetInput(1));
+  if (projPtr)
+    projPtr->SetRequestedRegionToLargestPossibleRegion();
+
+  auto * dvfPtr = const_cast<DVFImageType *>(this->GetDisplacementField());
+  if (dvfPtr)
+    dvfPtr->SetRequestedRegionToLargestPossibleRegion();
+}
+
+template <class TInputImage, class TOutputImage, class TDVFImage>
+void
+WarpBackProjectionImageFilter<TInputImage, TOutputImage, TDVFImage>::BeforeThreadedGenerateData()
+{
+  Superclass::BeforeThreadedGenerateData();
+
+  const unsigned int Dimension = TInputImage::ImageDimension;
+  const unsigned int nProj = this->GetInput(1)->GetLargestPossibleRegion().GetSize(Dimension - 1);
+  const unsigned int iFirstProj = this->GetInput(1)->GetLargestPossibleRegion().GetIndex(Dimension - 1);
+  const bool         cylindrical = (this->m_Geometry->GetRadiusCylindricalDetector() != 0);
+
+  m_ProjectionMatrices.clear();
+  m_ProjPPToProjIndex.clear();
+  m_ProjectionInterpolators.clear();
+  for (unsigned int iProj = iFirstProj; iProj < iFirstProj + nProj; iProj++)
+  {
+    // With a cylindrical detector, the projection matrix only goes to the
+    // physical coordinates of the flat detector and the correction is done
+    // for each voxel
+    if (cylindrical)
+    {
+      m_ProjectionMatrices.push_back(this->GetVolumeIndexToProjectionPhysicalPointMatrix(iProj));
+      m_ProjPPToProjIndex.push_back(this->GetProjectionPhysicalPointToProjectionIndexMatrix(iProj));
+    }
+    else
+      m_ProjectionMatrices.push_back(this->GetIndexToIndexProjectionMatrix(iProj));
+
+    typename ProjectionInterpolatorType::Pointer interpolator = ProjectionInterpolatorType::New();
+    interpolator->SetInputImage(this->template GetProjection<ProjectionImageType>(iProj));
+    m_ProjectionInterpolators.push_back(interpolator);
+  }
+}
+
+template <class TInputImage, class TOutputImage, class TDVFImage>
+void
+WarpBackProjectionImageFilter<TInputImage, TOutputImage, TDVFImage>::DynamicThreadedGenerateData(
+  const OutputImageRegionType & outputRegionForThread)
+{
+  const unsigned int Dimension = TInputImage::ImageDimension;
+  const double       radius = this->m_Geometry->GetRadiusCylindricalDetector();
+
+  // Conversions between the volume indices and physical coordinates (in mm)
+  itk::Matrix<double, Dimension + 1, Dimension + 1> volIndexToPP =
+    GetIndexToPhysicalPointMatrix<TOutputImage>(this->GetOutput());
+  itk::Matrix<double, Dimension + 1, Dimension + 1> volPPToIndex =
+    GetPhysicalPointToIndexMatrix<TOutputImage>(this->GetOutput());
+
+  typename DVFInterpolatorType::Pointer dvfInterpolator;
+  if (this->GetDisplacementField())
+  {
+    dvfInterpolator = DVFInterpolatorType::New();
+    dvfInterpolator->SetInputImage(this->GetDisplacementField());
+  }
+
+  // Iterators on volume input and output
+  using InputRegionIterator = itk::ImageRegionConstIterator<TInputImage>;
+  InputRegionIterator itIn(this->GetInput(), outputRegionForThread);
+  using OutputRegionIterator = itk::ImageRegionIteratorWithIndex<TOutputImage>;
+  OutputRegionIterator itOut(this->GetOutput(), outputRegionForThread);
+
+  // Initialize output region with input region in case the filter is not in
+  // place
+  if (this->GetInput() != this->GetOutput())
+  {
+    itIn.GoToBegin();
+    while (!itIn.IsAtEnd())
+    {
+      itOut.Set(itIn.Get());
+      ++itIn;
+      ++itOut;
+    }
+  }
+
+  typename DVFInterpolatorType::PointType     point;
+  itk::ContinuousIndex<double, Dimension>     warpedIndex;
+  itk::ContinuousIndex<double, Dimension - 1> pointProj, pointProjIdx;
+
+  // Go over each voxel
+  itOut.GoToBegin();
+  while (!itOut.IsAtEnd())
+  {
+    // Warp the voxel center, once for all projections
+    for (unsigned int i = 0; i < Dimension; i++)
+    {
+      point[i] = volIndexToPP[i][Dimension];
+      for (unsigned int j = 0; j < Dimension; j++)
+        point[i] += volIndexToPP[i][j] * itOut.GetIndex()[j];
+    }
+    if (dvfInterpolator.IsNotNull() && dvfInterpolator->IsInsideBuffer(point))
+    {
+      const typename DVFInterpolatorType::OutputType displacement = dvfInterpolator->Evaluate(point);
+      for (unsigned int i = 0; i < Dimension; i++)
+        point[i] += displacement[i];
+    }
+    for (unsigned int i = 0; i < Dimension; i++)
+    {
+      warpedIndex[i] = volPPToIndex[i][Dimension];
+      for (unsigned int j = 0; j < Dimension; j++)
+        warpedIndex[i] += volPPToIndex[i][j] * point[j];
+    }
+
+    typename TOutputImage::PixelType sum = itk::NumericTraits<typename TOutputImage::PixelType>::ZeroValue();
+    for (unsigned int p = 0; p < m_ProjectionMatrices.size(); p++)
+    {
+      const ProjectionMatrixType & matrix = m_ProjectionMatrices[p];
+
+      // Compute projection index
+      for (unsigned int i = 0; i < Dimension - 1; i++)
+      {
+        pointProj[i] = matrix[i][Dimension];
+        for (unsigned int j = 0; j < Dimension; j++)
+          pointProj[i] += matrix[i][j] * warpedIndex[j];
+      }
+
+      // Apply perspective
+      double perspFactor = matrix[Dimension - 1][Dimension];
+      for (unsigned int j = 0; j < Dimension; j++)
+        perspFactor += matrix[Dimension - 1][j] * warpedIndex[j];
+      perspFactor = 1 / perspFactor;
+      for (unsigned int i = 0; i < Dimension - 1; i++)
+        pointProj[i] = pointProj[i] * perspFactor;
+
+      // Apply correction for cylindrical detector centered on source and
+      // convert to projection index
+      if (radius != 0)
+      {
+        const double u = pointProj[0];
+        pointProj[0] = radius * std::atan2(u, radius);
+        pointProj[1] = pointProj[1] * radius / std::sqrt(radius * radius + u * u);
+
+        const ProjectionPPToIndexMatrixType & projPPToProjIndex = m_ProjPPToProjIndex[p];
+        for (unsigned int i = 0; i < Dimension - 1; i++)
+        {
+          pointProjIdx[i] = projPPToProjIndex[i][Dimension - 1];
+          for (unsigned int j = 0; j < Dimension - 1; j++)
+            pointProjIdx[i] += projPPToProjIndex[i][j] * pointProj[j];
+        }
+        pointProj = pointProjIdx;
+      }
+
+      // Interpolate if in projection
+      if (m_ProjectionInterpolators[p]->IsInsideBuffer(pointProj))
+        sum += m_ProjectionInterpolators[p]->EvaluateAtContinuousIndex(pointProj);
+    }
+    itOut.Set(itOut.Get() + sum);
+    ++itOut;
+  }
+}
+
+template <class TInputImage, class TOutputImage, class TDVFImage>
+void
+WarpBackProjectionImageFilter<TInputImage, TOutputImage, TDVFImage>::AfterThreadedGenerateData()
+{
+  // Release the extracted projections
+  m_ProjectionMatrices.clear();
+  m_ProjPPToProjIndex.clear();
+  m_ProjectionInterpolators.clear();
+}
+
+} // end namespace rtk
+
+#endif
@@ -0,0 +1,114 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef rtkWarpForwardProjectionImageFilter_h
+#define rtkWarpForwardProjectionImageFilter_h
+
+#include "rtkForwardProjectionImageFilter.h"
+
+#include <itkCovariantVector.h>
+#include <itkLinearInterpolateImageFunction.h>
+
+namespace rtk
+{
+
+/** \class WarpForwardProjectionImageFilter
+ * \brief Trilinear interpolation forward projection in warped volume
+ *
+ * WarpForwardProjectionImageFilter is the CPU counterpart of
+ * CudaWarpForwardProjectionImageFilter. It assumes the object has undergone
+ * a known deformation, described by the displacement vector field (DVF), and
+ * compensates for it during the forward projection. Each ray is sampled
+ * regularly with StepSize (in mm) in the undeformed volume, each sample is
+ * displaced by the trilinearly interpolated DVF and the volume is trilinearly
+ * interpolated at the displaced position. It amounts to bending the
+ * trajectories of the rays and avoids warping the whole volume for each
+ * projection.
+ *
+ * \test rtkwarpfourdtoprojectionstacktest.cxx
+ *
+ * \ingroup RTK Projector
+ */
+template <class TInputImage,
+          class TOutputImage = TInputImage,
+          class TDVFImage =
+            itk::Image<itk::CovariantVector<typename TInputImage::PixelType, TInputImage::ImageDimension>,
+                       TInputImage::ImageDimension>>
+class ITK_TEMPLATE_EXPORT WarpForwardProjectionImageFilter
+  : public ForwardProjectionImageFilter<TInputImage, TOutputImage>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(WarpForwardProjectionImageFilter);
+
+  /** Standard class type alias. */
+  using Self = WarpForwardProjectionImageFilter;
+  using Superclass = ForwardProjectionImageFilter<TInputImage, TOutputImage>;
+  using Pointer = itk::SmartPointer<Self>;
+  using ConstPointer = itk::SmartPointer<const Self>;
+  using OutputImageRegionType = typename TOutputImage::RegionType;
+  using GeometryType = typename Superclass::GeometryType;
+  using DVFImageType = TDVFImage;
+  using VolumeInterpolatorType = itk::LinearInterpolateImageFunction<TInputImage, double>;
+  using DVFInterpolatorType = itk::LinearInterpolateImageFunction<TDVFImage, double>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(WarpForwardProjectionImageFilter, ForwardProjectionImageFilter);
+
+  /** Input projection stack */
+  void
+  SetInputProjectionStack(const TInputImage * ProjectionStack);
+
+  /** Input volume */
+  void
+  SetInputVolume(const TInputImage * Volume);
+
+  /** Input displacement vector field */
+  void
+  SetDisplacementField(const DVFImageType * DVF);
+  const DVFImageType *
+  GetDisplacementField();
+
+  /** Set step size along ray (in mm). Default is 1 mm. */
+  itkGetConstMacro(StepSize, double);
+  itkSetMacro(StepSize, double);
+
+protected:
+  WarpForwardProjectionImageFilter() = default;
+  ~WarpForwardProjectionImageFilter() override = default;
+
+  /** The DVF is interpolated wherever the rays go. */
+  void
+  GenerateInputRequestedRegion() override;
+
+  void
+  DynamicThreadedGenerateData(const OutputImageRegionType & outputRegionForThread) override;
+
+private:
+  double m_StepSize{ 1. };
+};
+
+} // end namespace rtk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "rtkWarpForwardProjectionImageFilter.hxx"
+#endif
+
+#endif
@@ -0,0 +1,180 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef rtkWarpForwardProjectionImageFilter_hxx
+#define rtkWarpForwardProjectionImageFilter_hxx
+
+
+#include "rtkHomogeneousMatrix.h"
+#include "rtkBoxShape.h"
+#include "rtkProjectionsRegionConstIteratorRayBased.h"
+
+#include <itkImageRegionIteratorWithIndex.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace rtk
+{
+
+template <class TInputImage, class TOutputImage, class TDVFImage>
+void
+WarpForwardProjectionImageFilter<TInputImage, TOutputImage, TDVFImage>::SetInputProjectionStack(
+  const TInputImage * ProjectionStack)
+{
+  this->SetInput(0, const_cast<TInputImage *>(ProjectionStack));
+}
+
+template <class TInputImage, class TOutputImage, class TDVFImage>
+void
+WarpForwardProjectionImageFilter<TInputImage, TOutputImage, TDVFImage>::SetInputVolume(const TInputImage * Volume)
+{
+  this->SetInput(1, const_cast<TInputImage *>(Volume));
+}
+
+template <class TInputImage, class TOutputImage, class TDVFImage>
+void
+WarpForwardProjectionImageFilter<TInputImage, TOutputImage, TDVFImage>::SetDisplacementField(const DVFImageType * DVF)
+{
+  this->SetInput("DisplacementField", const_cast<DVFImageType *>(DVF));
+}
+
+template <class TInputImage, class TOutputImage, class TDVFImage>
+const typename WarpForwardProjectionImageFilter<TInputImage, TOutputImage, TDVFImage>::DVFImageType *
+WarpForwardProjectionImageFilter<TInputImage, TOutputImage, TDVFImage>::GetDisplacementField()
+{
+  return static_cast<const DVFImageType *>(this->itk::ProcessObject::GetInput("DisplacementField"));
+}
+
+template <class TInputImage, class TOutputImage, class TDVFImage>
+void
+WarpForwardProjectionImageFilter<TInputImage, TOutputImage, TDVFImage>::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+
+  // Since we do not know where the rays go after deformation, the whole
+  // displacement field is requested
+  auto * dvfPtr = const_cast<DVFImageType *>(this->GetDisplacementField());
+  if (dvfPtr)
+    dvfPtr->SetRequestedRegionToLargestPossibleRegion();
+}
+
+template <class TInputImage, class TOutputImage, class TDVFImage>
+void
+WarpForwardProjectionImageFilter<TInputImage, TOutputImage, TDVFImage>::DynamicThreadedGenerateData(
+  const OutputImageRegionType & outputRegionForThread)
+{
+  const unsigned int                                    Dimension = TInputImage::ImageDimension;
+  const TInputImage *                                   volume = this->GetInput(1);
+  const typename Superclass::GeometryType::ConstPointer geometry = this->GetGeometry();
+
+  // Conversions between the 3D volume indices and physical coordinates (in mm)
+  typename GeometryType::ThreeDHomogeneousMatrixType volPPToIndex = GetPhysicalPointToIndexMatrix(volume);
+  typename GeometryType::ThreeDHomogeneousMatrixType volIndexToPP = GetIndexToPhysicalPointMatrix(volume);
+
+  // Trilinear interpolators of the volume and of the displacement field
+  typename VolumeInterpolatorType::Pointer volumeInterpolator = VolumeInterpolatorType::New();
+  volumeInterpolator->SetInputImage(volume);
+  typename DVFInterpolatorType::Pointer dvfInterpolator;
+  if (this->GetDisplacementField())
+  {
+    dvfInterpolator = DVFInterpolatorType::New();
+    dvfInterpolator->SetInputImage(this->GetDisplacementField());
+  }
+
+  // Iterators on input and output projections
+  using InputRegionIterator = ProjectionsRegionConstIteratorRayBased<TInputImage>;
+  InputRegionIterator * itIn = nullptr;
+  itIn = InputRegionIterator::New(this->GetInput(), outputRegionForThread, geometry, volPPToIndex);
+  using OutputRegionIterator = itk::ImageRegionIteratorWithIndex<TOutputImage>;
+  OutputRegionIterator itOut(this->GetOutput(), outputRegionForThread);
+
+  // Rays are sampled in the box of the undeformed volume, in voxel coordinates
+  typename BoxShape::Pointer    box = BoxShape::New();
+  typename BoxShape::VectorType boxMin, boxMax;
+  for (unsigned int i = 0; i < Dimension; i++)
+  {
+    boxMin[i] = volume->GetBufferedRegion().GetIndex()[i];
+    boxMax[i] = volume->GetBufferedRegion().GetIndex()[i] + volume->GetBufferedRegion().GetSize()[i] - 1;
+  }
+  box->SetBoxMin(boxMin);
+  box->SetBoxMax(boxMax);
+
+  // Go over each pixel of the projection
+  itk::ContinuousIndex<double, Dimension> warpedIndex;
+  typename DVFInterpolatorType::PointType samplePoint;
+  for (unsigned int pix = 0; pix < outputRegionForThread.GetNumberOfPixels(); pix++, itIn->Next(), ++itOut)
+  {
+    typename InputRegionIterator::PointType pixelPosition = itIn->GetPixelPosition();
+    typename InputRegionIterator::PointType dirVox = -itIn->GetSourceToPixel();
+
+    BoxShape::ScalarType nearDist = NAN, farDist = NAN;
+    if (!box->IsIntersectedByRay(pixelPosition, dirVox, nearDist, farDist) || farDist < 0. || nearDist > 1.)
+    {
+      itOut.Set(itIn->Get());
+      continue;
+    }
+    nearDist = std::max(nearDist, 0.);
+    farDist = std::min(farDist, 1.);
+
+    // Length of the intersection in mm and regular sampling with at most StepSize
+    double rayLengthMM = 0.;
+    for (unsigned int i = 0; i < Dimension; i++)
+      rayLengthMM += itk::Math::sqr(dirVox[i] * volume->GetSpacing()[i]);
+    rayLengthMM = (farDist - nearDist) * std::sqrt(rayLengthMM);
+    const auto   nSteps = static_cast<unsigned int>(std::max(1., std::ceil(rayLengthMM / m_StepSize)));
+    const double tStep = (farDist - nearDist) / nSteps;
+
+    double sum = 0.;
+    for (unsigned int s = 0; s < nSteps; s++)
+    {
+      const typename InputRegionIterator::PointType sampleIndex =
+        pixelPosition + (nearDist + (s + 0.5) * tStep) * dirVox;
+
+      // Physical position of the sample, displaced by the DVF
+      for (unsigned int i = 0; i < Dimension; i++)
+      {
+        samplePoint[i] = volIndexToPP[i][Dimension];
+        for (unsigned int j = 0; j < Dimension; j++)
+          samplePoint[i] += volIndexToPP[i][j] * sampleIndex[j];
+      }
+      if (dvfInterpolator.IsNotNull() && dvfInterpolator->IsInsideBuffer(samplePoint))
+      {
+        const typename DVFInterpolatorType::OutputType displacement = dvfInterpolator->Evaluate(samplePoint);
+        for (unsigned int i = 0; i < Dimension; i++)
+          samplePoint[i] += displacement[i];
+      }
+
+      // Back to the volume indices for the interpolation of the volume
+      for (unsigned int i = 0; i < Dimension; i++)
+      {
+        warpedIndex[i] = volPPToIndex[i][Dimension];
+        for (unsigned int j = 0; j < Dimension; j++)
+          warpedIndex[i] += volPPToIndex[i][j] * samplePoint[j];
+      }
+      if (volumeInterpolator->IsInsideBuffer(warpedIndex))
+        sum += volumeInterpolator->EvaluateAtContinuousIndex(warpedIndex);
+    }
+    itOut.Set(itIn->Get() + sum * rayLengthMM / nSteps);
+  }
+  delete itIn;
+}
+
+} // end namespace rtk
+
+#endif
@@ -20,7 +20,7 @@
 
 #include "rtkFourDToProjectionStackImageFilter.h"
 #include "rtkCyclicDeformationImageFilter.h"
-#include "rtkJosephForwardProjectionImageFilter.h"
+#include "rtkWarpForwardProjectionImageFilter.h"
 #include <vector>
 
 #ifdef RTK_USE_CUDA
@@ -117,16 +117,17 @@ public:
   using DVFImageType = typename itk::Image<VectorForDVF, VolumeSeriesType::ImageDimension - 1>;
 #endif
   using CPUDVFInterpolatorType = CyclicDeformationImageFilter<DVFSequenceImageType, DVFImageType>;
+  using CPUWarpForwardProjectionImageFilterType =
+    WarpForwardProjectionImageFilter<ProjectionStackType, ProjectionStackType, DVFImageType>;
 #ifdef RTK_USE_CUDA
   typedef typename std::conditional<std::is_same<VolumeSeriesType, CPUVolumeSeriesType>::value,
-                                    JosephForwardProjectionImageFilter<ProjectionStackType, ProjectionStackType>,
+                                    CPUWarpForwardProjectionImageFilterType,
                                     CudaWarpForwardProjectionImageFilter>::type WarpForwardProjectionImageFilterType;
   typedef typename std::conditional<std::is_same<VolumeSeriesType, CPUVolumeSeriesType>::value,
                                     CPUDVFInterpolatorType,
                                     CudaCyclicDeformationImageFilter>::type     CudaCyclicDeformationImageFilterType;
 #else
-  using WarpForwardProjectionImageFilterType =
-    JosephForwardProjectionImageFilter<ProjectionStackType, ProjectionStackType>;
+  using WarpForwardProjectionImageFilterType = CPUWarpForwardProjectionImageFilterType;
   using CudaCyclicDeformationImageFilterType = CPUDVFInterpolatorType;
 #endif
 
@@ -28,9 +28,6 @@ WarpFourDToProjectionStackImageFilter<VolumeSeriesType, ProjectionStackType>::Wa
   this->SetNumberOfRequiredInputs(3);
 
   this->m_ForwardProjectionFilter = WarpForwardProjectionImageFilterType::New();
-  if (std::is_same<VolumeSeriesType, CPUVolumeSeriesType>::value)
-    itkWarningMacro("The warp Forward project image filter exists only in CUDA. Ignoring the displacement vector field "
-                    "and using CPU Joseph forward projection");
 }
 
 template <typename VolumeSeriesType, typename ProjectionStackType>
@@ -80,6 +77,9 @@ WarpFourDToProjectionStackImageFilter<VolumeSeriesType, ProjectionStackType>::Ge
     wfp->SetDisplacementField(cudvf);
   }
 #endif
+  auto * cpuwfp = dynamic_cast<CPUWarpForwardProjectionImageFilterType *>(this->m_ForwardProjectionFilter.GetPointer());
+  if (cpuwfp)
+    cpuwfp->SetDisplacementField(m_DVFInterpolatorFilter->GetOutput());
   m_DVFInterpolatorFilter->SetSignalVector(m_Signal);
   m_DVFInterpolatorFilter->SetInput(this->GetDisplacementField());
   m_DVFInterpolatorFilter->SetFrame(0);
@@ -20,6 +20,7 @@
 
 #include "rtkCyclicDeformationImageFilter.h"
 #include "rtkProjectionStackToFourDImageFilter.h"
+#include "rtkWarpBackProjectionImageFilter.h"
 
 #ifdef RTK_USE_CUDA
 #  include "rtkCudaWarpBackProjectionImageFilter.h"
@@ -109,8 +110,9 @@ public:
     typename std::conditional<std::is_same<VolumeSeriesType, CPUVolumeSeriesType>::value,
                               itk::Image<VectorForDVF, VolumeSeriesType::ImageDimension - 1>,
                               itk::CudaImage<VectorForDVF, VolumeSeriesType::ImageDimension - 1>>::type DVFImageType;
+  using CPUWarpBackProjectionImageFilterType = rtk::WarpBackProjectionImageFilter<VolumeType, VolumeType, DVFImageType>;
   typedef typename std::conditional<std::is_same<VolumeSeriesType, CPUVolumeSeriesType>::value,
-                                    BackProjectionImageFilter<VolumeType, VolumeType>,
+                                    CPUWarpBackProjectionImageFilterType,
                                     CudaWarpBackProjectionImageFilter>::type WarpBackProjectionImageFilter;
   using CPUDVFInterpolatorType = CyclicDeformationImageFilter<DVFSequenceImageType, DVFImageType>;
   typedef typename std::conditional<std::is_same<VolumeSeriesType, CPUVolumeSeriesType>::value,
@@ -119,7 +121,8 @@ public:
 #else
   using DVFSequenceImageType = itk::Image<VectorForDVF, VolumeSeriesType::ImageDimension>;
   using DVFImageType = itk::Image<VectorForDVF, VolumeSeriesType::ImageDimension - 1>;
-  using WarpBackProjectionImageFilter = BackProjectionImageFilter<VolumeType, VolumeType>;
+  using CPUWarpBackProjectionImageFilterType = rtk::WarpBackProjectionImageFilter<VolumeType, VolumeType, DVFImageType>;
+  using WarpBackProjectionImageFilter = CPUWarpBackProjectionImageFilterType;
   using CPUDVFInterpolatorType = CyclicDeformationImageFilter<DVFSequenceImageType, DVFImageType>;
   using CudaCyclicDeformationImageFilterType = CPUDVFInterpolatorType;
 #endif
@@ -36,9 +36,6 @@ WarpProjectionStackToFourDImageFilter<VolumeSeriesType, ProjectionStackType>::Wa
   m_UseCudaCyclicDeformation = false;
 
   this->m_BackProjectionFilter = WarpBackProjectionImageFilter::New();
-  if (std::is_same<VolumeSeriesType, CPUVolumeSeriesType>::value)
-    itkWarningMacro("The warp back project image filter exists only in CUDA. Ignoring the displacement vector field "
-                    "and using CPU voxel-based back projection");
 }
 
 template <typename VolumeSeriesType, typename ProjectionStackType>
@@ -88,6 +85,9 @@ WarpProjectionStackToFourDImageFilter<VolumeSeriesType, ProjectionStackType>::Ge
     wbp->SetDisplacementField(cudvf);
   }
 #endif
+  auto * cpuwbp = dynamic_cast<CPUWarpBackProjectionImageFilterType *>(this->m_BackProjectionFilter.GetPointer());
+  if (cpuwbp)
+    cpuwbp->SetDisplacementField(m_DVFInterpolatorFilter->GetOutput());
   m_DVFInterpolatorFilter->SetSignalVector(m_Signal);
   m_DVFInterpolatorFilter->SetInput(this->GetDisplacementField());
   m_DVFInterpolatorFilter->SetFrame(0);
@@ -81,6 +81,10 @@ protected:
   virtual void
   DeleteFilter();
 
+  /** Callback method to show the IterationEvent */
+  virtual void
+  IterationFilter();
+
 
 private:
   itk::ProcessObject * m_Process;
@@ -89,10 +93,15 @@ private:
   CommandType::Pointer m_StartFilterCommand;
   CommandType::Pointer m_EndFilterCommand;
   CommandType::Pointer m_DeleteFilterCommand;
+  CommandType::Pointer m_IterationFilterCommand;
 
   unsigned long m_StartTag;
   unsigned long m_EndTag;
   unsigned long m_DeleteTag;
+  unsigned long m_IterationTag;
+
+  /** Identifier of the watched filter in the trace of GlobalResourceProbe */
+  itk::SizeValueType m_Instance;
 };
 
 
@@ -0,0 +1,168 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef rtkZengAttenuationCache_h
+#define rtkZengAttenuationCache_h
+
+#include "RTKExport.h"
+
+#include <itkContinuousIndex.h>
+#include <itkImageRegion.h>
+#include <itkMatrix.h>
+#include <itkObject.h>
+#include <itkObjectFactory.h>
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace rtk
+{
+
+/** \class ZengAttenuationCache
+ * \brief Cache of the rotated attenuation factors of the Zeng projectors.
+ *
+ * ZengForwardProjectionImageFilter and ZengBackProjectionImageFilter
+ * interpolate, for each angle, the attenuation factors exp(-thickness*mu) of
+ * the attenuation map in the grid of the rotated volume. The attenuation map
+ * does not change during an iterative reconstruction, so the factors of each
+ * angle can be computed once and shared by all the forward and back
+ * projections of all iterations by setting the same cache to all projectors.
+ *
+ * The factors are stored in float. An entry is identified by the attenuation
+ * map (pointer and modification time), the region of the rotated grid and the
+ * homogeneous matrix from the rotated grid indices to the attenuation map
+ * indices, which accounts for the angle and for the geometries of the volume
+ * and of the projections. The least recently used entries are discarded when
+ * the cache exceeds MemoryBudget.
+ *
+ * \ingroup RTK
+ */
+class RTK_EXPORT ZengAttenuationCache : public itk::Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(ZengAttenuationCache);
+
+  /** Standard class type alias. */
+  using Self = ZengAttenuationCache;
+  using Superclass = itk::Object;
+  using Pointer = itk::SmartPointer<Self>;
+  using ConstPointer = itk::SmartPointer<const Self>;
+  using FactorsType = std::vector<float>;
+  using FactorsPointer = std::shared_ptr<const FactorsType>;
+  using MatrixType = itk::Matrix<double, 4, 4>;
+  using RegionType = itk::ImageRegion<3>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ZengAttenuationCache, itk::Object);
+
+  /** Get / Set the memory budget of the cache in bytes. Default is 512 MB. */
+  itkGetConstMacro(MemoryBudget, itk::SizeValueType);
+  virtual void
+  SetMemoryBudget(itk::SizeValueType budget);
+
+  /** Returns the cached factors of an angle, nullptr if they are not cached. */
+  FactorsPointer
+  Find(const itk::Object * attenuationMap, const RegionType & region, const MatrixType & matrix);
+
+  /** Stores the factors of an angle and discards the least recently used
+   * entries, or the entries of another attenuation map, if needed. */
+  void
+  Insert(const itk::Object * attenuationMap,
+         const RegionType &  region,
+         const MatrixType &  matrix,
+         FactorsPointer      factors);
+
+  /** Number of cached angles and memory used by the cache in bytes. */
+  unsigned int
+  GetNumberOfEntries() const;
+  itk::SizeValueType
+  GetMemoryUsage() const;
+
+  /** Release all cached factors. */
+  void
+  Clear();
+
+  /** Interpolates the factors of all slices of the rotated grid region, x
+   * being the fastest index. matrix maps the rotated grid indices to the
+   * continuous indices of the image of factors interpolated by interpolator.
+   * Outside that image, the factors are 1. */
+  template <class TInterpolator>
+  static FactorsPointer
+  ComputeFactors(const TInterpolator * interpolator, const RegionType & region, const MatrixType & matrix)
+  {
+    auto                            factors = std::make_shared<FactorsType>(region.GetNumberOfPixels());
+    auto                            it = factors->begin();
+    itk::ContinuousIndex<double, 3> idx;
+    for (unsigned int k = 0; k < region.GetSize(2); k++)
+      for (unsigned int j = 0; j < region.GetSize(1); j++)
+      {
+        for (unsigned int d = 0; d < 3; d++)
+          idx[d] = matrix[d][3] + matrix[d][0] * region.GetIndex(0) + matrix[d][1] * (region.GetIndex(1) + j) +
+                   matrix[d][2] * (region.GetIndex(2) + k);
+        for (unsigned int i = 0; i < region.GetSize(0); i++, ++it)
+        {
+          *it = 1.f;
+          if (interpolator->IsInsideBuffer(idx))
+            *it = static_cast<float>(interpolator->EvaluateAtContinuousIndex(idx));
+          for (unsigned int d = 0; d < 3; d++)
+            idx[d] += matrix[d][0];
+        }
+      }
+    return factors;
+  }
+
+protected:
+  ZengAttenuationCache() = default;
+  ~ZengAttenuationCache() override = default;
+
+  void
+  PrintSelf(std::ostream & os, itk::Indent indent) const override;
+
+private:
+  struct Entry
+  {
+    const itk::Object *   AttenuationMap;
+    itk::ModifiedTimeType AttenuationMapTime;
+    RegionType            Region;
+    MatrixType            Matrix;
+    FactorsPointer        Factors;
+  };
+
+  bool
+  Matches(const Entry &       entry,
+          const itk::Object * attenuationMap,
+          const RegionType &  region,
+          const MatrixType &  matrix) const;
+
+  void
+  Evict(itk::SizeValueType budget);
+
+  itk::SizeValueType m_MemoryBudget{ 512 * 1024 * 1024 };
+  itk::SizeValueType m_MemoryUsage{ 0 };
+  std::list<Entry>   m_Entries;
+  mutable std::mutex m_Mutex;
+};
+
+} // end namespace rtk
+
+#endif
@@ -22,24 +22,12 @@
 #include "rtkConfiguration.h"
 #include "rtkBackProjectionImageFilter.h"
 #include "rtkMacro.h"
-#include <itkPixelTraits.h>
+#include "rtkZengAttenuationCache.h"
 
-#include <itkMultiplyImageFilter.h>
-#include <itkAddImageFilter.h>
-#include <itkDiscreteGaussianImageFilter.h>
-#include <itkPasteImageFilter.h>
-#include <itkResampleImageFilter.h>
 #include <itkVector.h>
 #include <itkCenteredEuler3DTransform.h>
-#include <itkChangeInformationImageFilter.h>
-#include <itkExtractImageFilter.h>
-#include <itkRegionOfInterestImageFilter.h>
-#include <itkConstantBoundaryCondition.h>
-#include <itkUnaryGeneratorImageFilter.h>
+#include <itkLinearInterpolateImageFunction.h>
 
-#include "rtkConstantImageSource.h"
-
-#include <itkVectorImage.h>
 namespace rtk
 {
 
@@ -53,6 +41,14 @@ namespace rtk
  * has been placed after the source and the volume. If the detector is in the volume
  * the sum is performed only until that point.
  *
+ * The angles are processed by batches of one angle per work unit. The blurred
+ * rotated volumes of a batch are computed in parallel with a recursive
+ * Gaussian (see RecursiveGaussianBlurSlice), then accumulated in parallel over
+ * the slices of the output volume with trilinear interpolation. The batches
+ * are reduced so that their rotated volumes, and their rotated attenuation
+ * factors with an attenuation map, fit in MaximumRotatedVolumesMemory and
+ * these volumes are reused from one batch to the next.
+ *
  * \test rtkZengBackprojectiontest.cxx
  *
  * \author Antoine Robert
@@ -77,35 +73,14 @@ public:
   using Superclass = BackProjectionImageFilter<TInputImage, TOutputImage>;
   using Pointer = itk::SmartPointer<Self>;
   using ConstPointer = itk::SmartPointer<const Self>;
-  using AddImageFilterType = itk::AddImageFilter<InputCPUImageType, InputCPUImageType>;
-  using AddImageFilterPointerType = typename AddImageFilterType::Pointer;
-  using PasteImageFilterType = itk::PasteImageFilter<InputCPUImageType, OuputCPUImageType>;
-  using PasteImageFilterPointerType = typename PasteImageFilterType::Pointer;
-  using DiscreteGaussianFilterType = itk::DiscreteGaussianImageFilter<OuputCPUImageType, OuputCPUImageType>;
-  using DiscreteGaussianFilterPointeurType = typename DiscreteGaussianFilterType::Pointer;
-  using ResampleImageFilterType = itk::ResampleImageFilter<InputCPUImageType, InputCPUImageType>;
-  using ResampleImageFilterPointerType = typename ResampleImageFilterType::Pointer;
   using TransformType = itk::CenteredEuler3DTransform<double>;
   using TransformPointerType = typename TransformType::Pointer;
-  using ChangeInformationFilterType = itk::ChangeInformationImageFilter<OuputCPUImageType>;
-  using ChangeInformationPointerType = typename ChangeInformationFilterType::Pointer;
-  using MultiplyImageFilterType = itk::MultiplyImageFilter<InputCPUImageType, InputCPUImageType>;
-  using MultpiplyImageFilterPointerType = typename MultiplyImageFilterType::Pointer;
-  using ConstantVolumeSourceType = rtk::ConstantImageSource<InputCPUImageType>;
-  using ConstantVolumeSourcePointerType = typename ConstantVolumeSourceType::Pointer;
-  using ExtractImageFilterType = itk::ExtractImageFilter<OuputCPUImageType, OuputCPUImageType>;
-  using ExtractImageFilterPointerType = typename ExtractImageFilterType::Pointer;
-  using RegionOfInterestFilterType = itk::RegionOfInterestImageFilter<OuputCPUImageType, OuputCPUImageType>;
-  using RegionOfInterestPointerType = typename RegionOfInterestFilterType::Pointer;
-  using CustomUnaryFilterType = itk::UnaryGeneratorImageFilter<OuputCPUImageType, OuputCPUImageType>;
-  using CustomUnaryFilterPointerType = typename CustomUnaryFilterType::Pointer;
+  using AttenuationFactorsPointer = ZengAttenuationCache::FactorsPointer;
+  using RotatedVolumeInterpolatorType = itk::LinearInterpolateImageFunction<OuputCPUImageType, double>;
 
   /** ImageDimension constants */
   static constexpr unsigned int InputImageDimension = TInputImage::ImageDimension;
 
-  /** Typedef for the boundary condition */
-  using BoundaryCondition = itk::ConstantBoundaryCondition<OuputCPUImageType>;
-
   /** Method for creation through the object factory. */
   itkNewMacro(Self);
 
@@ -120,17 +95,30 @@ public:
   itkGetMacro(Alpha, double);
   itkSetMacro(Alpha, double);
 
+  /** Get / Set the cache of the rotated attenuation factors. If set, the
+   * factors of each angle are computed once and reused by all projectors
+   * sharing the cache, e.g., across the subsets and iterations of OSEM.
+   * Default is nullptr, i.e., the factors are recomputed at each update. */
+  itkSetObjectMacro(AttenuationCache, ZengAttenuationCache);
+  itkGetModifiableObjectMacro(AttenuationCache, ZengAttenuationCache);
+
+  /** Get / Set the memory in bytes of the rotated volumes and attenuation
+   * factors of a batch of angles, at least one angle is used. Default is
+   * 1 GiB. */
+  itkGetMacro(MaximumRotatedVolumesMemory, itk::SizeValueType);
+  itkSetMacro(MaximumRotatedVolumesMemory, itk::SizeValueType);
 
 protected:
-  ZengBackProjectionImageFilter();
+  ZengBackProjectionImageFilter() = default;
   ~ZengBackProjectionImageFilter() override = default;
 
   /** Apply changes to the input image requested region. */
   void
   GenerateInputRequestedRegion() override;
 
+  /** The whole volume is computed at once. */
   void
-  GenerateOutputInformation() override;
+  EnlargeOutputRequestedRegion(itk::DataObject * output) override;
 
   void
   GenerateData() override;
@@ -140,32 +128,16 @@ protected:
   void
   VerifyInputInformation() const override;
 
-  AddImageFilterPointerType          m_AddImageFilter;
-  PasteImageFilterPointerType        m_PasteImageFilter;
-  DiscreteGaussianFilterPointeurType m_DiscreteGaussianFilter;
-  ResampleImageFilterPointerType     m_ResampleImageFilter;
-  TransformPointerType               m_Transform;
-  MultpiplyImageFilterPointerType    m_MultiplyImageFilter;
-  ConstantVolumeSourcePointerType    m_ConstantVolumeSource;
-  ExtractImageFilterPointerType      m_ExtractImageFilter;
-  ChangeInformationPointerType       m_ChangeInformation;
-  MultpiplyImageFilterPointerType    m_AttenuationMapMultiplyImageFilter;
-  RegionOfInterestPointerType        m_AttenuationMapRegionOfInterest;
-  ResampleImageFilterPointerType     m_AttenuationMapResampleImageFilter;
-  ChangeInformationPointerType       m_AttenuationMapChangeInformation;
-  TransformPointerType               m_AttenuationMapTransform;
-  BoundaryCondition                  m_BoundsCondition;
-  CustomUnaryFilterPointerType       m_CustomUnaryFilter;
-
 private:
   ZengBackProjectionImageFilter(const Self &) = delete; // purposely not implemented
   void
   operator=(const Self &) = delete; // purposely not implemented
 
-  double     m_SigmaZero{ 1.5417233052142099 };
-  double     m_Alpha{ 0.016241189545787734 };
-  VectorType m_VectorOrthogonalDetector{ 0. };
-  PointType  m_centerVolume{ 0 };
+  double             m_SigmaZero{ 1.5417233052142099 };
+  double             m_Alpha{ 0.016241189545787734 };
+  itk::SizeValueType m_MaximumRotatedVolumesMemory{ itk::SizeValueType(1) << 30 };
+
+  ZengAttenuationCache::Pointer m_AttenuationCache;
 };
 
 } // end namespace rtk
@@ -19,67 +19,44 @@
 #ifndef rtkZengBackProjectionImageFilter_hxx
 #define rtkZengBackProjectionImageFilter_hxx
 
-#include <math.h>
-
-#include "math.h"
-
-
 #include "rtkHomogeneousMatrix.h"
-#include "rtkBoxShape.h"
-#include "rtkProjectionsRegionConstIteratorRayBased.h"
-#include <itkImageFileWriter.h>
+#include "rtkRecursiveGaussianSliceBlur.h"
 
-#include <itkImageRegionIteratorWithIndex.h>
+#include <itkImageRegionConstIterator.h>
+#include <itkImageRegionIterator.h>
 #include <itkInputDataObjectConstIterator.h>
 
-namespace rtk
-{
+#include <algorithm>
+#include <cmath>
+#include <mutex>
 
-template <class TInputImage, class TOutputImage>
-ZengBackProjectionImageFilter<TInputImage, TOutputImage>::ZengBackProjectionImageFilter()
+namespace rtk
 {
-  // Set default parameters
-  m_VectorOrthogonalDetector[2] = 1;
-
-  // Create each filter of the composite filter
-  m_AddImageFilter = AddImageFilterType::New();
-  m_PasteImageFilter = PasteImageFilterType::New();
-  m_DiscreteGaussianFilter = DiscreteGaussianFilterType::New();
-  m_ResampleImageFilter = ResampleImageFilterType::New();
-  m_Transform = TransformType::New();
-  m_MultiplyImageFilter = MultiplyImageFilterType::New();
-  m_ExtractImageFilter = ExtractImageFilterType::New();
-  m_ConstantVolumeSource = ConstantVolumeSourceType::New();
-  m_ChangeInformation = ChangeInformationFilterType::New();
-  m_AttenuationMapMultiplyImageFilter = nullptr;
-  m_AttenuationMapRegionOfInterest = nullptr;
-  m_AttenuationMapResampleImageFilter = nullptr;
-  m_AttenuationMapChangeInformation = nullptr;
-  m_AttenuationMapTransform = nullptr;
-  m_CustomUnaryFilter = nullptr;
-
-  // Permanent internal connections
-  m_AddImageFilter->SetInput2(m_MultiplyImageFilter->GetOutput());
-  m_MultiplyImageFilter->SetInput(m_ResampleImageFilter->GetOutput());
-  m_ChangeInformation->SetInput(m_ExtractImageFilter->GetOutput());
-  m_ChangeInformation->ChangeSpacingOn();
-
-  // Default parameters
-  m_DiscreteGaussianFilter->SetMaximumError(0.00001);
-  m_DiscreteGaussianFilter->SetFilterDimensionality(2);
-  m_DiscreteGaussianFilter->SetInputBoundaryCondition(&m_BoundsCondition);
-  m_DiscreteGaussianFilter->SetRealBoundaryCondition(&m_BoundsCondition);
-}
 
 template <class TInputImage, class TOutputImage>
 void
 ZengBackProjectionImageFilter<TInputImage, TOutputImage>::GenerateInputRequestedRegion()
 {
   Superclass::GenerateInputRequestedRegion();
+
+  // Each rotated volume covers the whole stack of projections
+  typename Superclass::InputImagePointer inputPtr1 = const_cast<TInputImage *>(this->GetInput(1));
+  if (!inputPtr1)
+    return;
+  inputPtr1->SetRequestedRegionToLargestPossibleRegion();
+
   // Input 2 is the attenuation map relative to the volume
   typename Superclass::InputImagePointer inputPtr2 = const_cast<TInputImage *>(this->GetInput(2));
   if (!inputPtr2)
     return;
+  inputPtr2->SetRequestedRegionToLargestPossibleRegion();
+}
+
+template <class TInputImage, class TOutputImage>
+void
+ZengBackProjectionImageFilter<TInputImage, TOutputImage>::EnlargeOutputRequestedRegion(itk::DataObject * output)
+{
+  output->SetRequestedRegionToLargestPossibleRegion();
 }
 
 template <class TInputImage, class TOutputImage>
@@ -164,157 +141,17 @@ ZengBackProjectionImageFilter<TInputImage, TOutputImage>::VerifyInputInformation
   }
 }
 
-template <class TInputImage, class TOutputImage>
-void
-ZengBackProjectionImageFilter<TInputImage, TOutputImage>::GenerateOutputInformation()
-{
-
-  // Info of the input volume
-  const typename InputCPUImageType::SpacingType spacingVolume = this->GetInput(0)->GetSpacing();
-  const typename InputCPUImageType::SizeType    sizeVolume = this->GetInput(0)->GetLargestPossibleRegion().GetSize();
-  const typename InputCPUImageType::IndexType   indexVolume = this->GetInput(0)->GetLargestPossibleRegion().GetIndex();
-
-  // Info of the input stack of projections
-  const typename OuputCPUImageType::SpacingType spacingProjections = this->GetInput(1)->GetSpacing();
-  const typename OuputCPUImageType::SizeType  sizeProjection = this->GetInput(1)->GetLargestPossibleRegion().GetSize();
-  const typename OuputCPUImageType::PointType originProjection = this->GetInput(1)->GetOrigin();
-
-  // Find the center of the volume
-  using CoordRepType = typename PointType ::ValueType;
-  using ContinuousIndexType = itk::ContinuousIndex<CoordRepType, InputImageDimension>;
-  using ContinuousIndexValueType = typename ContinuousIndexType::ValueType;
-  ContinuousIndexType centerIndex;
-
-  for (unsigned int k = 0; k < InputImageDimension; k++)
-  {
-    centerIndex[k] = static_cast<ContinuousIndexValueType>(indexVolume[k]) +
-                     static_cast<ContinuousIndexValueType>(sizeVolume[k] - 1) / 2.0;
-  }
-
-  this->GetInput(0)->TransformContinuousIndexToPhysicalPoint(centerIndex, m_centerVolume);
-
-  PointType centerRotation;
-  centerRotation.Fill(0);
-  m_Transform->SetCenter(centerRotation);
-  m_ResampleImageFilter->SetTransform(m_Transform);
-  m_ResampleImageFilter->SetOutputParametersFromImage(this->GetInput(0));
-
-  // Set the output size of volume
-  typename InputCPUImageType::SizeType outputSize;
-  outputSize[0] = sizeProjection[0];
-  outputSize[1] = sizeProjection[1];
-  outputSize[2] = sizeVolume[2] * std::sqrt(2);
-
-  // Set the new origin of the volume
-  typename InputCPUImageType::PointType outputOrigin;
-  outputOrigin[0] = originProjection[0];
-  outputOrigin[1] = originProjection[1];
-  outputOrigin[2] = m_centerVolume[2] - spacingVolume[2] * (double)(outputSize[2] - 1) / 2.0;
-
-  // Set the output spacing of the volume
-  typename InputCPUImageType::SpacingType outputSpacing;
-  outputSpacing[0] = spacingProjections[0];
-  outputSpacing[1] = spacingProjections[1];
-  outputSpacing[2] = spacingVolume[2];
-
-  // We only set the first sub-stack at that point, the rest will be
-  // requested in the GenerateData function
-  typename ExtractImageFilterType::InputImageRegionType projRegion;
-  const unsigned int                                    Dimension = this->InputImageDimension;
-  projRegion = this->GetInput(1)->GetLargestPossibleRegion();
-  m_ExtractImageFilter->SetExtractionRegion(projRegion);
-  m_ExtractImageFilter->SetInput(this->GetInput(1));
-  m_ExtractImageFilter->UpdateOutputInformation();
-  m_ChangeInformation->SetOutputSpacing(outputSpacing);
-  m_ChangeInformation->UpdateOutputInformation();
-
-  m_DiscreteGaussianFilter->SetVariance(pow(m_SigmaZero, 2.0));
-
-  if (!(this->GetInput(2)))
-  {
-    m_DiscreteGaussianFilter->SetInput(m_ChangeInformation->GetOutput());
-  }
-  else
-  {
-    m_AttenuationMapMultiplyImageFilter = MultiplyImageFilterType::New();
-    m_AttenuationMapRegionOfInterest = RegionOfInterestFilterType::New();
-    m_AttenuationMapResampleImageFilter = ResampleImageFilterType::New();
-    m_AttenuationMapChangeInformation = ChangeInformationFilterType::New();
-    m_CustomUnaryFilter = CustomUnaryFilterType::New();
-    m_AttenuationMapTransform = TransformType::New();
-    m_AttenuationMapChangeInformation->ChangeOriginOn();
-    m_AttenuationMapChangeInformation->ChangeRegionOn();
-    m_AttenuationMapChangeInformation->SetReferenceImage(m_ChangeInformation->GetOutput());
-    m_AttenuationMapChangeInformation->SetUseReferenceImage(true);
-
-    // Set Lambda function
-    auto customLambda = [spacingVolume](const typename OuputCPUImageType::PixelType & input1) ->
-      typename OuputCPUImageType::PixelType
-    {
-      return static_cast<typename OuputCPUImageType::PixelType>(std::exp(-spacingVolume[2] * input1));
-    };
-    m_CustomUnaryFilter->SetFunctor(customLambda);
-    m_CustomUnaryFilter->SetInput(this->GetInput(2));
-
-    m_AttenuationMapTransform->SetCenter(centerRotation);
-    m_AttenuationMapResampleImageFilter->SetTransform(m_AttenuationMapTransform);
-    m_AttenuationMapResampleImageFilter->SetOutputParametersFromImage(this->GetInput(0));
-    m_AttenuationMapResampleImageFilter->SetSize(outputSize);
-    m_AttenuationMapResampleImageFilter->SetOutputOrigin(outputOrigin);
-    m_AttenuationMapResampleImageFilter->SetOutputSpacing(outputSpacing);
-    m_AttenuationMapResampleImageFilter->SetOutputDirection(this->GetInput(1)->GetDirection());
-    m_AttenuationMapResampleImageFilter->SetInput(m_CustomUnaryFilter->GetOutput());
-    m_AttenuationMapResampleImageFilter->SetDefaultPixelValue(1.);
-    m_AttenuationMapResampleImageFilter->UpdateOutputInformation();
-
-    typename RegionOfInterestFilterType::InputImageRegionType attRegion;
-    attRegion = m_AttenuationMapResampleImageFilter->GetOutput()->GetLargestPossibleRegion();
-    attRegion.SetSize(Dimension - 1, 1);
-    m_AttenuationMapRegionOfInterest->SetRegionOfInterest(attRegion);
-    m_AttenuationMapRegionOfInterest->SetInput(m_AttenuationMapResampleImageFilter->GetOutput());
-    m_AttenuationMapRegionOfInterest->UpdateOutputInformation();
-
-    m_AttenuationMapChangeInformation->SetInput(m_AttenuationMapRegionOfInterest->GetOutput());
-    m_AttenuationMapMultiplyImageFilter->SetInput1(m_ChangeInformation->GetOutput());
-    m_AttenuationMapMultiplyImageFilter->SetInput2(m_AttenuationMapChangeInformation->GetOutput());
-    m_DiscreteGaussianFilter->SetInput(m_AttenuationMapMultiplyImageFilter->GetOutput());
-  }
-
-  m_MultiplyImageFilter->SetConstant(spacingVolume[2]);
-
-  m_ConstantVolumeSource->SetInformationFromImage(const_cast<TInputImage *>(this->GetInput(0)));
-  m_ConstantVolumeSource->SetSpacing(outputSpacing);
-  m_ConstantVolumeSource->SetOrigin(outputOrigin);
-  m_ConstantVolumeSource->SetSize(outputSize);
-  m_ConstantVolumeSource->SetDirection(this->GetInput(1)->GetDirection());
-  m_ConstantVolumeSource->SetConstant(0);
-
-  m_PasteImageFilter->SetSourceImage(m_DiscreteGaussianFilter->GetOutput());
-  m_PasteImageFilter->SetDestinationImage(m_ConstantVolumeSource->GetOutput());
-  m_PasteImageFilter->SetSourceRegion(m_DiscreteGaussianFilter->GetOutput()->GetLargestPossibleRegion());
-
-  m_ResampleImageFilter->SetInput(m_PasteImageFilter->GetOutput());
-  m_AddImageFilter->SetInput1(this->GetInput(0));
-
-  // Update output information
-  m_AddImageFilter->UpdateOutputInformation();
-  this->GetOutput()->SetOrigin(m_AddImageFilter->GetOutput()->GetOrigin());
-  this->GetOutput()->SetSpacing(m_AddImageFilter->GetOutput()->GetSpacing());
-  this->GetOutput()->SetDirection(m_AddImageFilter->GetOutput()->GetDirection());
-  this->GetOutput()->SetLargestPossibleRegion(m_AddImageFilter->GetOutput()->GetLargestPossibleRegion());
-}
-
 template <class TInputImage, class TOutputImage>
 void
 ZengBackProjectionImageFilter<TInputImage, TOutputImage>::GenerateData()
 {
   const typename Superclass::GeometryType::ConstPointer geometry = this->GetGeometry();
   const unsigned int                                    Dimension = this->InputImageDimension;
+  const TInputImage *                                   projections = this->GetInput(1);
 
-  typename ExtractImageFilterType::InputImageRegionType projRegion;
-  projRegion = this->GetInput(1)->GetLargestPossibleRegion();
-  int                 indexProj = 0;
-  std::vector<double> list_angle;
+  const typename TInputImage::RegionType projRegion = projections->GetLargestPossibleRegion();
+  int                                    indexProj = 0;
+  std::vector<double>                    list_angle;
   if (geometry->GetGantryAngles().size() != projRegion.GetSize(Dimension - 1))
   {
     indexProj = projRegion.GetIndex(Dimension - 1);
@@ -325,142 +162,232 @@ ZengBackProjectionImageFilter<TInputImage, TOutputImage>::GenerateData()
     list_angle = geometry->GetGantryAngles();
   }
 
-  projRegion.SetSize(Dimension - 1, 1);
-
-  typename OuputCPUImageType::Pointer                       currentSlice;
-  typename OuputCPUImageType::Pointer                       pimg;
-  typename OuputCPUImageType::Pointer                       currentVolume;
-  typename OuputCPUImageType::PointType                     pointSlice;
-  typename OuputCPUImageType::IndexType                     indexSlice;
-  typename OuputCPUImageType::Pointer                       rotatedAttenuation;
-  typename RegionOfInterestFilterType::InputImageRegionType desiredRegion;
-  PointType                                                 centerRotatedVolume;
-  PointType                                                 originRotatedVolume;
-
-  indexSlice.Fill(0);
-  double dist = NAN, sigmaSlice = NAN;
-  double thicknessSlice = this->GetInput(0)->GetSpacing()[2];
-  int    nbProjections = 0;
-  int    startSlice = -1;
-  for (auto & angle : list_angle)
+  // Initialize the output with the input volume
+  this->AllocateOutputs();
+  TOutputImage *              output = this->GetOutput();
+  const OutputImageRegionType volRegion = output->GetLargestPossibleRegion();
+  if (this->GetInput(0) != output)
   {
-    // Get the center of the rotated volume
-    m_Transform->SetRotation(0., angle, 0.);
-    centerRotatedVolume = m_Transform->GetMatrix() * m_centerVolume;
-
-    // Set the new origin of the rotate volume according to the center
-    originRotatedVolume = m_ConstantVolumeSource->GetOrigin();
-    originRotatedVolume[2] = centerRotatedVolume[2] - m_ConstantVolumeSource->GetSpacing()[2] *
-                                                        (double)(m_ConstantVolumeSource->GetSize()[2] - 1) / 2.0;
-    m_ConstantVolumeSource->SetOrigin(originRotatedVolume);
-
-    // Set the rotation angle.
-    m_Transform->SetRotation(0., -angle, 0.);
-
-    // Extract the projection corresponding to the current angle from the projection stack
-    projRegion.SetIndex(Dimension - 1, nbProjections + indexProj);
-    m_ExtractImageFilter->SetExtractionRegion(projRegion);
-    m_ExtractImageFilter->UpdateOutputInformation();
-
-    // Find the first positive distance between the volume and the detector
-    m_ConstantVolumeSource->Update();
-    int nbSlice = m_ConstantVolumeSource->GetOutput()->GetLargestPossibleRegion().GetSize()[2];
-    dist = -1;
-    startSlice = -1;
-    while (dist < 0)
-    {
-      startSlice += 1;
-      indexSlice[Dimension - 1] = startSlice;
-      m_ConstantVolumeSource->GetOutput()->TransformIndexToPhysicalPoint(indexSlice, pointSlice);
-      dist = geometry->GetSourceToIsocenterDistances()[nbProjections + indexProj] +
-             pointSlice.GetVectorFromOrigin() * m_VectorOrthogonalDetector;
-    }
-    if (this->GetInput(2))
-    {
-      m_AttenuationMapTransform->SetRotation(0., angle, 0.);
-      m_AttenuationMapResampleImageFilter->SetOutputOrigin(originRotatedVolume);
-      m_AttenuationMapResampleImageFilter->Update();
-      rotatedAttenuation = m_AttenuationMapResampleImageFilter->GetOutput();
-      rotatedAttenuation->DisconnectPipeline();
-      desiredRegion = rotatedAttenuation->GetLargestPossibleRegion();
-      desiredRegion.SetSize(Dimension - 1, 1);
-      desiredRegion.SetIndex(Dimension - 1, startSlice);
-      m_AttenuationMapRegionOfInterest->SetInput(rotatedAttenuation);
-      m_AttenuationMapRegionOfInterest->SetRegionOfInterest(desiredRegion);
-      m_AttenuationMapRegionOfInterest->UpdateOutputInformation();
-    }
-    // Compute the variance of the PSF for the first slice
-    sigmaSlice = pow(m_Alpha * dist + m_SigmaZero, 2.0);
-    m_DiscreteGaussianFilter->SetVariance(sigmaSlice);
-    m_DiscreteGaussianFilter->UpdateLargestPossibleRegion();
-    currentSlice = m_DiscreteGaussianFilter->GetOutput();
-    currentSlice->DisconnectPipeline();
-
-    // Paste the blur slice into the output volume
-    m_PasteImageFilter->SetDestinationImage(m_ConstantVolumeSource->GetOutput());
-    m_PasteImageFilter->SetSourceImage(currentSlice);
-    m_PasteImageFilter->SetSourceRegion(currentSlice->GetLargestPossibleRegion());
-    m_PasteImageFilter->SetDestinationIndex(indexSlice);
-    m_PasteImageFilter->Update();
-    currentVolume = m_PasteImageFilter->GetOutput();
-    currentVolume->DisconnectPipeline();
-    m_PasteImageFilter->SetDestinationImage(currentVolume);
-    int index = 0;
-    for (index = startSlice; index < nbSlice - 1; index++)
-    {
-      if (!this->GetInput(2))
-      {
-        m_DiscreteGaussianFilter->SetInput(currentSlice);
-      }
-      else
+    itk::ImageRegionConstIterator<TInputImage> itIn(this->GetInput(0), volRegion);
+    itk::ImageRegionIterator<TOutputImage>     itOut(output, volRegion);
+    for (; !itOut.IsAtEnd(); ++itIn, ++itOut)
+      itOut.Set(itIn.Get());
+  }
+
+  // Center of the volume, around which the rotated volumes are centered
+  itk::ContinuousIndex<double, 3> centerIndex;
+  for (unsigned int k = 0; k < Dimension; k++)
+    centerIndex[k] = volRegion.GetIndex(k) + (volRegion.GetSize(k) - 1) / 2.0;
+  PointType centerVolume;
+  output->TransformContinuousIndexToPhysicalPoint(centerIndex, centerVolume);
+
+  // Grid of the rotated volume, parallel to the detector. Its origin along the
+  // third axis depends on the angle and is set in the homogeneous matrix.
+  const double       thicknessSlice = output->GetSpacing()[2];
+  const auto         nbSlice = static_cast<unsigned int>(volRegion.GetSize(2) * std::sqrt(2.));
+  const unsigned int sizeX = projRegion.GetSize(0);
+  const unsigned int sizeY = projRegion.GetSize(1);
+
+  typename OuputCPUImageType::Pointer    rotatedGrid = OuputCPUImageType::New();
+  typename OuputCPUImageType::RegionType gridRegion = projRegion;
+  gridRegion.SetIndex(2, 0);
+  gridRegion.SetSize(2, nbSlice);
+  typename OuputCPUImageType::SpacingType gridSpacing = projections->GetSpacing();
+  gridSpacing[2] = thicknessSlice;
+  PointType gridOrigin = projections->GetOrigin();
+  gridOrigin[2] = 0.;
+  rotatedGrid->SetRegions(gridRegion);
+  rotatedGrid->SetSpacing(gridSpacing);
+  rotatedGrid->SetOrigin(gridOrigin);
+  rotatedGrid->SetDirection(projections->GetDirection());
+  using HomogeneousMatrixType = itk::Matrix<double, 4, 4>;
+  const HomogeneousMatrixType gridIndexToPP = GetIndexToPhysicalPointMatrix<OuputCPUImageType>(rotatedGrid);
+  const HomogeneousMatrixType volIndexToPP = GetIndexToPhysicalPointMatrix<TOutputImage>(output);
+  const HomogeneousMatrixType volPPToIndex = GetPhysicalPointToIndexMatrix<TOutputImage>(output);
+
+  // Matrices between the indices of the rotated volume of each angle, the
+  // physical points and the volume indices
+  const unsigned int                 nbAngles = list_angle.size();
+  std::vector<HomogeneousMatrixType> rotatedIndexToPP(nbAngles, gridIndexToPP);
+  std::vector<HomogeneousMatrixType> rotatedIndexToVolIndex(nbAngles);
+  std::vector<HomogeneousMatrixType> volIndexToRotatedIndex(nbAngles);
+  for (unsigned int iAngle = 0; iAngle < nbAngles; iAngle++)
+  {
+    TransformPointerType transform = TransformType::New();
+    transform->SetRotation(0., list_angle[iAngle], 0.);
+    const PointType       centerRotatedVolume = transform->GetMatrix() * centerVolume;
+    HomogeneousMatrixType rotation, inverseRotation;
+    rotation.SetIdentity();
+    inverseRotation.SetIdentity();
+    for (unsigned int i = 0; i < Dimension; i++)
+      for (unsigned int j = 0; j < Dimension; j++)
       {
-        desiredRegion.SetIndex(Dimension - 1, index + 1);
-        m_AttenuationMapRegionOfInterest->SetRegionOfInterest(desiredRegion);
-        m_AttenuationMapRegionOfInterest->UpdateOutputInformation();
-        m_AttenuationMapMultiplyImageFilter->SetInput1(currentSlice);
-        m_DiscreteGaussianFilter->SetInput(m_AttenuationMapMultiplyImageFilter->GetOutput());
+        rotation[i][j] = transform->GetMatrix()[i][j];
+        inverseRotation[i][j] = transform->GetMatrix()[j][i];
       }
-      // Compute the distance between the current slice and the detector
-      indexSlice[Dimension - 1] = index + 1;
-      dist += m_ConstantVolumeSource->GetSpacing()[2];
-      // Compute the variance of the PSF for the current slice
-      sigmaSlice = dist * 2. * thicknessSlice * pow(m_Alpha, 2.0) + 2. * thicknessSlice * m_Alpha * m_SigmaZero -
-                   pow(m_Alpha, 2.0) * pow(thicknessSlice, 2.0);
-      m_DiscreteGaussianFilter->SetVariance(sigmaSlice);
-      m_DiscreteGaussianFilter->Update();
-      currentSlice = m_DiscreteGaussianFilter->GetOutput();
-      currentSlice->DisconnectPipeline();
-
-      // Paste the blur slice into the output volume
-      m_PasteImageFilter->SetSourceImage(currentSlice);
-      m_PasteImageFilter->SetSourceRegion(currentSlice->GetLargestPossibleRegion());
-      m_PasteImageFilter->SetDestinationIndex(indexSlice);
-      m_PasteImageFilter->Update();
-      currentVolume = m_PasteImageFilter->GetOutput();
-      currentVolume->DisconnectPipeline();
-      m_PasteImageFilter->SetDestinationImage(currentVolume);
-    }
-    // Rotate the volume
-    m_ResampleImageFilter->SetInput(currentVolume);
-    m_AddImageFilter->Update();
-    pimg = m_AddImageFilter->GetOutput();
-    pimg->DisconnectPipeline();
-    m_AddImageFilter->SetInput1(pimg);
-    if (!this->GetInput(2))
-    {
-      m_DiscreteGaussianFilter->SetInput(m_ChangeInformation->GetOutput());
-    }
-    else
-    {
-      m_AttenuationMapMultiplyImageFilter->SetInput1(m_ChangeInformation->GetOutput());
-      m_DiscreteGaussianFilter->SetInput(m_AttenuationMapMultiplyImageFilter->GetOutput());
-    }
-    nbProjections++;
+    rotatedIndexToPP[iAngle][2][3] = centerRotatedVolume[2] - thicknessSlice * (nbSlice - 1) / 2.0;
+    rotatedIndexToVolIndex[iAngle] = volPPToIndex * rotation * rotatedIndexToPP[iAngle];
+    volIndexToRotatedIndex[iAngle] =
+      HomogeneousMatrixType(rotatedIndexToPP[iAngle].GetInverse()) * inverseRotation * volIndexToPP;
+  }
+
+  // Trilinear interpolation of the attenuation factor of each voxel, which is
+  // 1 outside the attenuation map, only built when the factors of an angle are
+  // not cached
+  typename RotatedVolumeInterpolatorType::Pointer attenuationInterpolator;
+  std::once_flag                                  attenuationInterpolatorFlag;
+  auto                                            getAttenuationInterpolator = [&]() {
+    std::call_once(attenuationInterpolatorFlag, [&]() {
+      typename OuputCPUImageType::Pointer attenuationFactor = OuputCPUImageType::New();
+      attenuationFactor->CopyInformation(this->GetInput(2));
+      attenuationFactor->SetRegions(this->GetInput(2)->GetLargestPossibleRegion());
+      attenuationFactor->Allocate();
+      itk::ImageRegionConstIterator<TInputImage>  itMu(this->GetInput(2), attenuationFactor->GetBufferedRegion());
+      itk::ImageRegionIterator<OuputCPUImageType> itFactor(attenuationFactor, attenuationFactor->GetBufferedRegion());
+      for (; !itFactor.IsAtEnd(); ++itMu, ++itFactor)
+        itFactor.Set(static_cast<OutputPixelType>(std::exp(-thicknessSlice * itMu.Get())));
+      attenuationInterpolator = RotatedVolumeInterpolatorType::New();
+      attenuationInterpolator->SetInputImage(attenuationFactor);
+    });
+    return attenuationInterpolator.GetPointer();
+  };
+
+  // The angles are processed by batches of at most one angle per work unit and
+  // of rotated volumes fitting in MaximumRotatedVolumesMemory, with the
+  // attenuation factors of each angle of a batch if any. The rotated volumes
+  // are allocated once and reused by the successive batches.
+  const double       alpha = m_Alpha;
+  const double       sigmaZero = m_SigmaZero;
+  itk::SizeValueType rotatedVolumeMemory = gridRegion.GetNumberOfPixels() * sizeof(OutputPixelType);
+  if (this->GetInput(2))
+    rotatedVolumeMemory += gridRegion.GetNumberOfPixels() * sizeof(ZengAttenuationCache::FactorsType::value_type);
+  const itk::SizeValueType memoryBatchSize = m_MaximumRotatedVolumesMemory / rotatedVolumeMemory;
+  const unsigned int       batchSize = static_cast<unsigned int>(std::max<itk::SizeValueType>(
+    1, std::min<itk::SizeValueType>({ nbAngles, this->GetNumberOfWorkUnits(), memoryBatchSize })));
+
+  std::vector<typename OuputCPUImageType::Pointer>             rotatedVolumes(batchSize);
+  std::vector<typename RotatedVolumeInterpolatorType::Pointer> interpolators(batchSize);
+  for (unsigned int b = 0; b < batchSize; b++)
+  {
+    rotatedVolumes[b] = OuputCPUImageType::New();
+    rotatedVolumes[b]->SetRegions(gridRegion);
+    rotatedVolumes[b]->Allocate();
+    interpolators[b] = RotatedVolumeInterpolatorType::New();
+    interpolators[b]->SetInputImage(rotatedVolumes[b]);
+  }
+  this->GetMultiThreader()->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+  for (unsigned int firstAngle = 0; firstAngle < nbAngles; firstAngle += batchSize)
+  {
+    const unsigned int nbBatchAngles = std::min(batchSize, nbAngles - firstAngle);
+
+    // Blurred rotated volume of each angle of the batch
+    this->GetMultiThreader()->ParallelizeArray(
+      0,
+      nbBatchAngles,
+      [&](itk::SizeValueType b) {
+        const unsigned int            iAngle = firstAngle + b;
+        const unsigned int            iProj = iAngle + indexProj;
+        const HomogeneousMatrixType & indexToPP = rotatedIndexToPP[iAngle];
+
+        // Rotated attenuation factors of the angle, exp(-thickness*mu), which
+        // are taken from the cache when possible
+        AttenuationFactorsPointer attenuationFactors;
+        if (this->GetInput(2))
+        {
+          const HomogeneousMatrixType & matrix = rotatedIndexToVolIndex[iAngle];
+          if (m_AttenuationCache.IsNotNull())
+            attenuationFactors = m_AttenuationCache->Find(this->GetInput(2), gridRegion, matrix);
+          if (!attenuationFactors)
+          {
+            attenuationFactors =
+              ZengAttenuationCache::ComputeFactors(getAttenuationInterpolator(), gridRegion, matrix);
+            if (m_AttenuationCache.IsNotNull())
+              m_AttenuationCache->Insert(this->GetInput(2), gridRegion, matrix, attenuationFactors);
+          }
+        }
+
+        rotatedVolumes[b]->FillBuffer(0.);
+        OutputPixelType * rotatedBuffer = rotatedVolumes[b]->GetBufferPointer();
+
+        // Find the first positive distance between the volume and the detector
+        const double sid = geometry->GetSourceToIsocenterDistances()[iProj];
+        auto         distanceToSlice = [&](unsigned int k) {
+          return sid + indexToPP[2][3] + indexToPP[2][0] * gridRegion.GetIndex(0) +
+                 indexToPP[2][1] * gridRegion.GetIndex(1) + indexToPP[2][2] * k;
+        };
+        unsigned int startSlice = 0;
+        while (startSlice < nbSlice && distanceToSlice(startSlice) < 0)
+          startSlice++;
+        double dist = (startSlice < nbSlice) ? distanceToSlice(startSlice) : 0.;
+
+        // Multiplies the current slice by the attenuation factors of slice k
+        std::vector<double> current(sizeX * sizeY), buffer;
+        auto                attenuate = [&](unsigned int k) {
+          if (!attenuationFactors)
+            return;
+          const float * attenuation = attenuationFactors->data() + k * current.size();
+          for (unsigned int p = 0; p < current.size(); p++)
+            current[p] *= attenuation[p];
+        };
+        auto blurAndStore = [&](double variance, unsigned int k) {
+          const double sigma = std::sqrt(std::max(0., variance));
+          RecursiveGaussianBlurSlice(
+            current.data(), sizeX, sizeY, sigma / gridSpacing[0], sigma / gridSpacing[1], buffer);
+          std::copy(current.begin(), current.end(), rotatedBuffer + k * current.size());
+        };
+
+        if (startSlice < nbSlice)
+        {
+          typename TInputImage::IndexType indexProjection = projRegion.GetIndex();
+          indexProjection[Dimension - 1] = iProj;
+          const InputPixelType * proj = projections->GetBufferPointer() + projections->ComputeOffset(indexProjection);
+          std::copy(proj, proj + current.size(), current.begin());
+
+          // Variance of the PSF for the first slice
+          attenuate(startSlice);
+          blurAndStore(std::pow(alpha * dist + sigmaZero, 2.0), startSlice);
+          for (unsigned int index = startSlice; index < nbSlice - 1; index++)
+          {
+            attenuate(index + 1);
+            dist += thicknessSlice;
+            // Variance of the PSF for the current slice
+            blurAndStore(dist * 2. * thicknessSlice * alpha * alpha + 2. * thicknessSlice * alpha * sigmaZero -
+                           alpha * alpha * thicknessSlice * thicknessSlice,
+                         index + 1);
+          }
+        }
+        // Only the cache, if any, keeps the factors of the angle
+        attenuationFactors.reset();
+      },
+      nullptr);
+
+    // Accumulate the rotated volumes of the batch, one output slice per work item
+    this->GetMultiThreader()->ParallelizeArray(
+      0,
+      volRegion.GetSize(2),
+      [&](itk::SizeValueType k) {
+        typename TOutputImage::IndexType index = volRegion.GetIndex();
+        index[2] += k;
+        OutputPixelType *               out = output->GetBufferPointer() + output->ComputeOffset(index);
+        itk::ContinuousIndex<double, 3> idx;
+        for (unsigned int j = 0; j < volRegion.GetSize(1); j++)
+          for (unsigned int i = 0; i < volRegion.GetSize(0); i++, out++)
+          {
+            double sum = 0.;
+            for (unsigned int b = 0; b < nbBatchAngles; b++)
+            {
+              const HomogeneousMatrixType & matrix = volIndexToRotatedIndex[firstAngle + b];
+              for (unsigned int d = 0; d < Dimension; d++)
+                idx[d] = matrix[d][3] + matrix[d][0] * (index[0] + i) + matrix[d][1] * (index[1] + j) +
+                         matrix[d][2] * index[2];
+              if (interpolators[b]->IsInsideBuffer(idx))
+                sum += interpolators[b]->EvaluateAtContinuousIndex(idx);
+            }
+            *out += static_cast<OutputPixelType>(thicknessSlice * sum);
+          }
+      },
+      nullptr);
   }
-  this->GetOutput()->SetPixelContainer(pimg->GetPixelContainer());
-  this->GetOutput()->CopyInformation(pimg);
-  this->GetOutput()->SetBufferedRegion(pimg->GetBufferedRegion());
-  this->GetOutput()->SetRequestedRegion(pimg->GetRequestedRegion());
 }
 
 } // end namespace rtk
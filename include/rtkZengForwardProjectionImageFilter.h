@@ -22,21 +22,12 @@
 #include "rtkConfiguration.h"
 #include "rtkForwardProjectionImageFilter.h"
 #include "rtkMacro.h"
-#include <itkPixelTraits.h>
+#include "rtkZengAttenuationCache.h"
 
-#include <itkMultiplyImageFilter.h>
-#include <itkAddImageFilter.h>
-#include <itkDiscreteGaussianImageFilter.h>
-#include <itkPasteImageFilter.h>
-#include <itkResampleImageFilter.h>
 #include <itkVector.h>
 #include <itkCenteredEuler3DTransform.h>
-#include <itkChangeInformationImageFilter.h>
-#include <itkRegionOfInterestImageFilter.h>
-#include <itkConstantBoundaryCondition.h>
-#include <itkUnaryGeneratorImageFilter.h>
+#include <itkLinearInterpolateImageFunction.h>
 
-#include <itkVectorImage.h>
 namespace rtk
 {
 
@@ -50,6 +41,12 @@ namespace rtk
  * has been placed after the source and the volume. If the detector is in the volume
  * the sum is performed only until that point.
  *
+ * The projections are computed in parallel, one angle per work unit. For each
+ * angle, the slices of the rotated volume are trilinearly interpolated on the
+ * fly with incremental continuous indices and the depth-dependent PSF is
+ * applied with a recursive Gaussian (see RecursiveGaussianBlurSlice) whose
+ * cost does not depend on the variance.
+ *
  * \test rtkZengforwardprojectiontest.cxx
  *
  * \author Antoine Robert
@@ -75,31 +72,15 @@ public:
   using Superclass = ForwardProjectionImageFilter<TInputImage, TOutputImage>;
   using Pointer = itk::SmartPointer<Self>;
   using ConstPointer = itk::SmartPointer<const Self>;
-  using AddImageFilterType = itk::AddImageFilter<OuputCPUImageType, OuputCPUImageType>;
-  using AddImageFilterPointerType = typename AddImageFilterType::Pointer;
-  using PasteImageFilterType = itk::PasteImageFilter<OuputCPUImageType, InputCPUImageType>;
-  using PasteImageFilterPointerType = typename PasteImageFilterType::Pointer;
-  using DiscreteGaussianFilterType = itk::DiscreteGaussianImageFilter<OuputCPUImageType, OuputCPUImageType>;
-  using DiscreteGaussianFilterPointeurType = typename DiscreteGaussianFilterType::Pointer;
-  using ResampleImageFilterType = itk::ResampleImageFilter<OuputCPUImageType, OuputCPUImageType>;
-  using ResampleImageFilterPointerType = typename ResampleImageFilterType::Pointer;
   using TransformType = itk::CenteredEuler3DTransform<double>;
   using TransformPointerType = typename TransformType::Pointer;
-  using ChangeInformationFilterType = itk::ChangeInformationImageFilter<OuputCPUImageType>;
-  using ChangeInformationPointerType = typename ChangeInformationFilterType::Pointer;
-  using RegionOfInterestFilterType = itk::RegionOfInterestImageFilter<OuputCPUImageType, OuputCPUImageType>;
-  using RegionOfInterestPointerType = typename RegionOfInterestFilterType::Pointer;
-  using MultiplyImageFilterType = itk::MultiplyImageFilter<OuputCPUImageType, OuputCPUImageType>;
-  using MultpiplyImageFilterPointerType = typename MultiplyImageFilterType::Pointer;
-  using CustomUnaryFilterType = itk::UnaryGeneratorImageFilter<OuputCPUImageType, OuputCPUImageType>;
-  using CustomUnaryFilterPointerType = typename CustomUnaryFilterType::Pointer;
+  using VolumeInterpolatorType = itk::LinearInterpolateImageFunction<TInputImage, double>;
+  using AttenuationFactorsPointer = ZengAttenuationCache::FactorsPointer;
+  using AttenuationInterpolatorType = itk::LinearInterpolateImageFunction<OuputCPUImageType, double>;
 
   /** ImageDimension constants */
   static constexpr unsigned int InputImageDimension = TOutputImage::ImageDimension;
 
-  /** Typedef for the boundary condition */
-  using BoundaryCondition = itk::ConstantBoundaryCondition<OuputCPUImageType>;
-
   /** Method for creation through the object factory. */
   itkNewMacro(Self);
 
@@ -114,15 +95,24 @@ public:
   itkGetMacro(Alpha, double);
   itkSetMacro(Alpha, double);
 
+  /** Get / Set the cache of the rotated attenuation factors. If set, the
+   * factors of each angle are computed once and reused by all projectors
+   * sharing the cache, e.g., across the subsets and iterations of OSEM.
+   * Default is nullptr, i.e., the factors are recomputed at each update. */
+  itkSetObjectMacro(AttenuationCache, ZengAttenuationCache);
+  itkGetModifiableObjectMacro(AttenuationCache, ZengAttenuationCache);
+
 protected:
-  ZengForwardProjectionImageFilter();
+  ZengForwardProjectionImageFilter() = default;
   ~ZengForwardProjectionImageFilter() override = default;
 
+  /** All inputs are entirely used by each projection. */
   void
   GenerateInputRequestedRegion() override;
 
+  /** The whole stack of projections is computed at once. */
   void
-  GenerateOutputInformation() override;
+  EnlargeOutputRequestedRegion(itk::DataObject * output) override;
 
   void
   GenerateData() override;
@@ -132,31 +122,15 @@ protected:
   void
   VerifyInputInformation() const override;
 
-  RegionOfInterestPointerType        m_RegionOfInterest;
-  AddImageFilterPointerType          m_AddImageFilter;
-  PasteImageFilterPointerType        m_PasteImageFilter;
-  DiscreteGaussianFilterPointeurType m_DiscreteGaussianFilter;
-  ResampleImageFilterPointerType     m_ResampleImageFilter;
-  TransformPointerType               m_Transform;
-  ChangeInformationPointerType       m_ChangeInformation;
-  MultpiplyImageFilterPointerType    m_MultiplyImageFilter;
-  MultpiplyImageFilterPointerType    m_AttenuationMapMultiplyImageFilter;
-  RegionOfInterestPointerType        m_AttenuationMapRegionOfInterest;
-  ResampleImageFilterPointerType     m_AttenuationMapResampleImageFilter;
-  ChangeInformationPointerType       m_AttenuationMapChangeInformation;
-  BoundaryCondition                  m_BoundsCondition;
-  CustomUnaryFilterPointerType       m_CustomUnaryFilter;
-
-
 private:
   ZengForwardProjectionImageFilter(const Self &) = delete; // purposely not implemented
   void
   operator=(const Self &) = delete; // purposely not implemented
 
-  double     m_SigmaZero{ 1.5417233052142099 };
-  double     m_Alpha{ 0.016241189545787734 };
-  VectorType m_VectorOrthogonalDetector{ 0. };
-  PointType  m_centerVolume{ 0 };
+  double m_SigmaZero{ 1.5417233052142099 };
+  double m_Alpha{ 0.016241189545787734 };
+
+  ZengAttenuationCache::Pointer m_AttenuationCache;
 };
 
 } // end namespace rtk
@@ -19,58 +19,20 @@
 #ifndef rtkZengForwardProjectionImageFilter_hxx
 #define rtkZengForwardProjectionImageFilter_hxx
 
-#include <math.h>
-
-#include "math.h"
-
-
 #include "rtkHomogeneousMatrix.h"
-#include "rtkBoxShape.h"
-#include "rtkProjectionsRegionConstIteratorRayBased.h"
-#include "itkImageFileWriter.h"
+#include "rtkRecursiveGaussianSliceBlur.h"
 
-#include <itkImageRegionIteratorWithIndex.h>
+#include <itkImageRegionConstIterator.h>
+#include <itkImageRegionIterator.h>
 #include <itkInputDataObjectConstIterator.h>
 
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
 namespace rtk
 {
 
-template <class TInputImage, class TOutputImage>
-ZengForwardProjectionImageFilter<TInputImage, TOutputImage>::ZengForwardProjectionImageFilter()
-{
-  // Set default parameters
-  m_VectorOrthogonalDetector[2] = 1;
-
-  // Create each filter of the composite filter
-  m_RegionOfInterest = RegionOfInterestFilterType::New();
-  m_AddImageFilter = AddImageFilterType::New();
-  m_PasteImageFilter = PasteImageFilterType::New();
-  m_DiscreteGaussianFilter = DiscreteGaussianFilterType::New();
-  m_ResampleImageFilter = ResampleImageFilterType::New();
-  m_Transform = TransformType::New();
-  m_ChangeInformation = ChangeInformationFilterType::New();
-  m_MultiplyImageFilter = MultiplyImageFilterType::New();
-  m_AttenuationMapMultiplyImageFilter = nullptr;
-  m_AttenuationMapRegionOfInterest = nullptr;
-  m_AttenuationMapResampleImageFilter = nullptr;
-  m_AttenuationMapChangeInformation = nullptr;
-  m_CustomUnaryFilter = nullptr;
-
-  // Permanent internal connections
-  m_AddImageFilter->SetInput1(m_DiscreteGaussianFilter->GetOutput());
-  m_AddImageFilter->SetInput2(m_ChangeInformation->GetOutput());
-  m_MultiplyImageFilter->SetInput(m_PasteImageFilter->GetOutput());
-
-  // Default parameters
-  m_DiscreteGaussianFilter->SetMaximumError(0.00001);
-  m_DiscreteGaussianFilter->SetFilterDimensionality(2);
-  m_DiscreteGaussianFilter->SetInputBoundaryCondition(&m_BoundsCondition);
-  m_DiscreteGaussianFilter->SetRealBoundaryCondition(&m_BoundsCondition);
-  m_ChangeInformation->ChangeOriginOn();
-  m_ChangeInformation->SetReferenceImage(m_DiscreteGaussianFilter->GetOutput());
-  m_ChangeInformation->SetUseReferenceImage(true);
-}
-
 template <class TInputImage, class TOutputImage>
 void
 ZengForwardProjectionImageFilter<TInputImage, TOutputImage>::GenerateInputRequestedRegion()
@@ -80,6 +42,14 @@ ZengForwardProjectionImageFilter<TInputImage, TOutputImage>::GenerateInputReques
   typename Superclass::InputImagePointer inputPtr2 = const_cast<TInputImage *>(this->GetInput(2));
   if (!inputPtr2)
     return;
+  inputPtr2->SetRequestedRegionToLargestPossibleRegion();
+}
+
+template <class TInputImage, class TOutputImage>
+void
+ZengForwardProjectionImageFilter<TInputImage, TOutputImage>::EnlargeOutputRequestedRegion(itk::DataObject * output)
+{
+  output->SetRequestedRegionToLargestPossibleRegion();
 }
 
 template <class TInputImage, class TOutputImage>
@@ -164,145 +134,18 @@ ZengForwardProjectionImageFilter<TInputImage, TOutputImage>::VerifyInputInformat
   }
 }
 
-template <class TInputImage, class TOutputImage>
-void
-ZengForwardProjectionImageFilter<TInputImage, TOutputImage>::GenerateOutputInformation()
-{
-
-  // Info of the input volume
-  const typename OuputCPUImageType::SpacingType spacingVolume = this->GetInput(1)->GetSpacing();
-  const typename OuputCPUImageType::SizeType    sizeVolume = this->GetInput(1)->GetLargestPossibleRegion().GetSize();
-  const typename OuputCPUImageType::IndexType   indexVolume = this->GetInput(1)->GetLargestPossibleRegion().GetIndex();
-
-  // Info of the input stack of projections
-  const typename InputCPUImageType::SpacingType spacingProjections = this->GetInput(0)->GetSpacing();
-  const typename InputCPUImageType::SizeType  sizeProjection = this->GetInput(0)->GetLargestPossibleRegion().GetSize();
-  const typename OuputCPUImageType::PointType originProjection = this->GetInput(0)->GetOrigin();
-
-  // Find the center of the volume
-
-  using CoordRepType = typename PointType ::ValueType;
-  using ContinuousIndexType = itk::ContinuousIndex<CoordRepType, InputImageDimension>;
-  using ContinuousIndexValueType = typename ContinuousIndexType::ValueType;
-  ContinuousIndexType centerIndex;
-
-  for (unsigned int k = 0; k < InputImageDimension; k++)
-  {
-    centerIndex[k] = static_cast<ContinuousIndexValueType>(indexVolume[k]) +
-                     static_cast<ContinuousIndexValueType>(sizeVolume[k] - 1) / 2.0;
-  }
-
-  this->GetInput(1)->TransformContinuousIndexToPhysicalPoint(centerIndex, m_centerVolume);
-
-  PointType centerRotation;
-  centerRotation.Fill(0);
-  m_Transform->SetCenter(centerRotation);
-  m_ResampleImageFilter->SetTransform(m_Transform);
-  m_ResampleImageFilter->SetOutputParametersFromImage(this->GetInput(1));
-
-  // Set the output size of the rotated volume
-  typename OuputCPUImageType::SizeType outputSize;
-  outputSize[0] = sizeProjection[0];
-  outputSize[1] = sizeProjection[1];
-  outputSize[2] = sizeVolume[2] * std::sqrt(2);
-  m_ResampleImageFilter->SetSize(outputSize);
-
-  // Set the new origin of the rotated volume
-  typename OuputCPUImageType::PointType outputOrigin;
-  outputOrigin[0] = originProjection[0];
-  outputOrigin[1] = originProjection[1];
-  outputOrigin[2] = m_centerVolume[2] - spacingVolume[2] * (double)(outputSize[2] - 1) / 2.0;
-  m_ResampleImageFilter->SetOutputOrigin(outputOrigin);
-
-  // Set the output spacing of the rotated volume
-  typename OuputCPUImageType::SpacingType outputSpacing;
-  outputSpacing[0] = spacingProjections[0];
-  outputSpacing[1] = spacingProjections[1];
-  outputSpacing[2] = spacingVolume[2];
-  m_ResampleImageFilter->SetOutputSpacing(outputSpacing);
-  m_ResampleImageFilter->SetOutputDirection(this->GetInput(0)->GetDirection());
-  m_ResampleImageFilter->SetInput(this->GetInput(1));
-  m_ResampleImageFilter->UpdateOutputInformation();
-
-  // We only set the first sub-stack at that point, the rest will be
-  // requested in the GenerateData function
-  typename RegionOfInterestFilterType::InputImageRegionType projRegion;
-  const unsigned int                                        Dimension = this->InputImageDimension;
-  projRegion = m_ResampleImageFilter->GetOutput()->GetLargestPossibleRegion();
-  projRegion.SetSize(Dimension - 1, 1);
-  m_RegionOfInterest->SetRegionOfInterest(projRegion);
-  m_RegionOfInterest->SetInput(m_ResampleImageFilter->GetOutput());
-  m_RegionOfInterest->UpdateOutputInformation();
-
-  m_DiscreteGaussianFilter->SetVariance(pow(m_SigmaZero, 2.0));
-
-  if (!(this->GetInput(2)))
-  {
-    m_DiscreteGaussianFilter->SetInput(m_RegionOfInterest->GetOutput());
-  }
-  else
-  {
-    m_AttenuationMapMultiplyImageFilter = MultiplyImageFilterType::New();
-    m_AttenuationMapRegionOfInterest = RegionOfInterestFilterType::New();
-    m_AttenuationMapResampleImageFilter = ResampleImageFilterType::New();
-    m_AttenuationMapChangeInformation = ChangeInformationFilterType::New();
-    m_AttenuationMapChangeInformation->ChangeOriginOn();
-    m_AttenuationMapChangeInformation->SetReferenceImage(m_DiscreteGaussianFilter->GetOutput());
-    m_AttenuationMapChangeInformation->SetUseReferenceImage(true);
-    m_CustomUnaryFilter = CustomUnaryFilterType::New();
-
-    // Set Lambda function
-    auto customLambda = [spacingVolume](const typename OuputCPUImageType::PixelType & input1) ->
-      typename OuputCPUImageType::PixelType
-    {
-      return static_cast<typename OuputCPUImageType::PixelType>(std::exp(-spacingVolume[2] * input1));
-    };
-    m_CustomUnaryFilter->SetFunctor(customLambda);
-    m_CustomUnaryFilter->SetInput(this->GetInput(2));
-
-    m_AttenuationMapResampleImageFilter->SetTransform(m_Transform);
-    m_AttenuationMapResampleImageFilter->SetOutputParametersFromImage(this->GetInput(1));
-    m_AttenuationMapResampleImageFilter->SetSize(outputSize);
-    m_AttenuationMapResampleImageFilter->SetOutputOrigin(outputOrigin);
-    m_AttenuationMapResampleImageFilter->SetOutputSpacing(outputSpacing);
-    m_AttenuationMapResampleImageFilter->SetOutputDirection(this->GetInput(0)->GetDirection());
-    m_AttenuationMapResampleImageFilter->SetInput(m_CustomUnaryFilter->GetOutput());
-    m_AttenuationMapResampleImageFilter->SetDefaultPixelValue(1.);
-    m_AttenuationMapResampleImageFilter->UpdateOutputInformation();
-
-    m_AttenuationMapRegionOfInterest->SetRegionOfInterest(projRegion);
-    m_AttenuationMapRegionOfInterest->SetInput(m_AttenuationMapResampleImageFilter->GetOutput());
-    m_AttenuationMapRegionOfInterest->UpdateOutputInformation();
-
-    m_AttenuationMapMultiplyImageFilter->SetInput1(m_RegionOfInterest->GetOutput());
-    m_AttenuationMapMultiplyImageFilter->SetInput2(m_AttenuationMapRegionOfInterest->GetOutput());
-    m_DiscreteGaussianFilter->SetInput(m_AttenuationMapMultiplyImageFilter->GetOutput());
-  }
-
-  m_MultiplyImageFilter->SetConstant(spacingVolume[2]);
-
-  m_PasteImageFilter->SetSourceImage(m_DiscreteGaussianFilter->GetOutput());
-  m_PasteImageFilter->SetDestinationImage(this->GetInput(0));
-  m_PasteImageFilter->SetSourceRegion(m_DiscreteGaussianFilter->GetOutput()->GetLargestPossibleRegion());
-
-  // Update output information
-  m_PasteImageFilter->UpdateOutputInformation();
-  this->GetOutput()->SetOrigin(m_PasteImageFilter->GetOutput()->GetOrigin());
-  this->GetOutput()->SetSpacing(m_PasteImageFilter->GetOutput()->GetSpacing());
-  this->GetOutput()->SetDirection(m_PasteImageFilter->GetOutput()->GetDirection());
-  this->GetOutput()->SetLargestPossibleRegion(m_PasteImageFilter->GetOutput()->GetLargestPossibleRegion());
-
-  //  m_ResampleImageFilter->ReleaseDataFlagOn();
-}
-
 template <class TInputImage, class TOutputImage>
 void
 ZengForwardProjectionImageFilter<TInputImage, TOutputImage>::GenerateData()
 {
   const unsigned int                                    Dimension = this->InputImageDimension;
   const typename Superclass::GeometryType::ConstPointer geometry = this->GetGeometry();
-  typename OuputCPUImageType::RegionType                projRegion = this->GetInput(0)->GetLargestPossibleRegion();
-  std::vector<double>                                   list_angle;
+  const TInputImage *                                   volume = this->GetInput(1);
+
+  this->AllocateOutputs();
+  TOutputImage *              output = this->GetOutput();
+  const OutputImageRegionType projRegion = output->GetLargestPossibleRegion();
+  std::vector<double>         list_angle;
   if (geometry->GetGantryAngles().size() != projRegion.GetSize(Dimension - 1))
   {
     list_angle.push_back(geometry->GetGantryAngles()[projRegion.GetIndex(Dimension - 1)]);
@@ -312,135 +155,189 @@ ZengForwardProjectionImageFilter<TInputImage, TOutputImage>::GenerateData()
     list_angle = geometry->GetGantryAngles();
   }
 
-  typename OuputCPUImageType::Pointer   currentSlice;
-  typename OuputCPUImageType::Pointer   pimg;
-  typename OuputCPUImageType::Pointer   rotatedVolume;
-  typename OuputCPUImageType::IndexType indexSlice;
-  typename OuputCPUImageType::IndexType indexProjection;
-  PointType                             pointSlice;
-  PointType                             centerRotatedVolume;
-  PointType                             originRotatedVolume;
-
-  indexSlice.Fill(0);
-  indexProjection.Fill(0);
-  double dist = NAN, sigmaSlice = NAN;
-  double thicknessSlice = NAN;
-  int    nbProjections = 0;
-  for (auto & angle : list_angle)
+  // Center of the volume, around which the rotated volumes are centered
+  const typename TInputImage::RegionType volRegion = volume->GetLargestPossibleRegion();
+  itk::ContinuousIndex<double, 3>        centerIndex;
+  for (unsigned int k = 0; k < Dimension; k++)
+    centerIndex[k] = volRegion.GetIndex(k) + (volRegion.GetSize(k) - 1) / 2.0;
+  PointType centerVolume;
+  volume->TransformContinuousIndexToPhysicalPoint(centerIndex, centerVolume);
+
+  // Grid of the rotated volume, parallel to the detector. Its origin along the
+  // third axis depends on the angle and is set in the homogeneous matrix.
+  const double       thicknessSlice = volume->GetSpacing()[2];
+  const auto         nbSlice = static_cast<unsigned int>(volRegion.GetSize(2) * std::sqrt(2.));
+  const unsigned int sizeX = projRegion.GetSize(0);
+  const unsigned int sizeY = projRegion.GetSize(1);
+
+  typename OuputCPUImageType::Pointer    rotatedGrid = OuputCPUImageType::New();
+  typename OuputCPUImageType::RegionType gridRegion = projRegion;
+  gridRegion.SetIndex(2, 0);
+  gridRegion.SetSize(2, nbSlice);
+  typename OuputCPUImageType::SpacingType gridSpacing = this->GetInput(0)->GetSpacing();
+  gridSpacing[2] = thicknessSlice;
+  PointType gridOrigin = this->GetInput(0)->GetOrigin();
+  gridOrigin[2] = 0.;
+  rotatedGrid->SetRegions(gridRegion);
+  rotatedGrid->SetSpacing(gridSpacing);
+  rotatedGrid->SetOrigin(gridOrigin);
+  rotatedGrid->SetDirection(this->GetInput(0)->GetDirection());
+  using HomogeneousMatrixType = itk::Matrix<double, 4, 4>;
+  const HomogeneousMatrixType gridIndexToPP = GetIndexToPhysicalPointMatrix<OuputCPUImageType>(rotatedGrid);
+  const HomogeneousMatrixType volPPToIndex = GetPhysicalPointToIndexMatrix<TInputImage>(volume);
+
+  // Matrices from the indices of the rotated volume to physical points and
+  // to the volume indices for each angle
+  const unsigned int                 nbAngles = list_angle.size();
+  std::vector<HomogeneousMatrixType> rotatedIndexToPP(nbAngles, gridIndexToPP);
+  std::vector<HomogeneousMatrixType> rotatedIndexToVolIndex(nbAngles);
+  for (unsigned int iAngle = 0; iAngle < nbAngles; iAngle++)
   {
-    // Set the rotation angle.
-    m_Transform->SetRotation(0., angle, 0.);
-    centerRotatedVolume = m_Transform->GetMatrix() * m_centerVolume;
-
-    // Rotate the input volume
-    this->GetInput(1)->GetBufferPointer();
-    originRotatedVolume = m_ResampleImageFilter->GetOutputOrigin();
-    originRotatedVolume[2] = centerRotatedVolume[2] - m_ResampleImageFilter->GetOutputSpacing()[2] *
-                                                        (double)(m_ResampleImageFilter->GetSize()[2] - 1) / 2.0;
-    m_ResampleImageFilter->SetOutputOrigin(originRotatedVolume);
-    m_ResampleImageFilter->Update();
-    rotatedVolume = m_ResampleImageFilter->GetOutput();
-    rotatedVolume->DisconnectPipeline();
-    thicknessSlice = rotatedVolume->GetSpacing()[2];
-
-    // Extract slice from the volume starting by the farthest from the detector.
-    typename RegionOfInterestFilterType::InputImageRegionType desiredRegion = rotatedVolume->GetLargestPossibleRegion();
-    unsigned int                                              nbSlice = desiredRegion.GetSize(Dimension - 1);
-    desiredRegion.SetSize(Dimension - 1, 1);
-    desiredRegion.SetIndex(Dimension - 1, nbSlice - 1);
-    indexSlice[2] = nbSlice - 1;
-    m_RegionOfInterest->SetInput(rotatedVolume);
-    m_RegionOfInterest->SetRegionOfInterest(desiredRegion);
-    m_RegionOfInterest->UpdateOutputInformation();
-    m_RegionOfInterest->Update();
-    if (!(this->GetInput(2)))
-    {
-      currentSlice = m_RegionOfInterest->GetOutput();
-    }
-    else
-    {
-      typename OuputCPUImageType::Pointer rotatedAttenuation;
-      m_AttenuationMapResampleImageFilter->SetOutputOrigin(originRotatedVolume);
-      m_AttenuationMapResampleImageFilter->Update();
-      rotatedAttenuation = m_AttenuationMapResampleImageFilter->GetOutput();
-      rotatedAttenuation->DisconnectPipeline();
-      m_AttenuationMapRegionOfInterest->SetInput(rotatedAttenuation);
-      m_AttenuationMapRegionOfInterest->SetRegionOfInterest(desiredRegion);
-      m_AttenuationMapRegionOfInterest->UpdateOutputInformation();
-      m_AttenuationMapMultiplyImageFilter->SetInput1(m_RegionOfInterest->GetOutput());
-      m_AttenuationMapMultiplyImageFilter->SetInput2(m_AttenuationMapRegionOfInterest->GetOutput());
-      m_AttenuationMapMultiplyImageFilter->Update();
-      m_AttenuationMapChangeInformation->SetInput(m_AttenuationMapRegionOfInterest->GetOutput());
-      currentSlice = m_AttenuationMapMultiplyImageFilter->GetOutput();
-    }
-    currentSlice->DisconnectPipeline();
-    m_DiscreteGaussianFilter->SetInput(currentSlice);
-    m_ChangeInformation->SetInput(m_RegionOfInterest->GetOutput());
+    TransformPointerType transform = TransformType::New();
+    transform->SetRotation(0., list_angle[iAngle], 0.);
+    const PointType       centerRotatedVolume = transform->GetMatrix() * centerVolume;
+    HomogeneousMatrixType rotation;
+    rotation.SetIdentity();
+    for (unsigned int i = 0; i < Dimension; i++)
+      for (unsigned int j = 0; j < Dimension; j++)
+        rotation[i][j] = transform->GetMatrix()[i][j];
+    rotatedIndexToPP[iAngle][2][3] = centerRotatedVolume[2] - thicknessSlice * (nbSlice - 1) / 2.0;
+    rotatedIndexToVolIndex[iAngle] = volPPToIndex * rotation * rotatedIndexToPP[iAngle];
+  }
 
-    // Compute the distance between the current slice and the detector
-    rotatedVolume->TransformIndexToPhysicalPoint(indexSlice, pointSlice);
-    dist = geometry->GetSourceToIsocenterDistances()[nbProjections + projRegion.GetIndex(Dimension - 1)] +
-           pointSlice.GetVectorFromOrigin() * m_VectorOrthogonalDetector;
-    int index = 0;
-    for (index = nbSlice - 2; index >= 0; index--)
-    {
-      if (dist - rotatedVolume->GetSpacing()[2] < 0)
+  // Trilinear interpolation of the volume and of the attenuation factor of
+  // each voxel, which is 1 outside the attenuation map. The latter is only
+  // built when the factors of an angle are not cached.
+  typename VolumeInterpolatorType::Pointer volumeInterpolator = VolumeInterpolatorType::New();
+  volumeInterpolator->SetInputImage(volume);
+  typename AttenuationInterpolatorType::Pointer attenuationInterpolator;
+  std::once_flag                                attenuationInterpolatorFlag;
+  auto                                          getAttenuationInterpolator = [&]() {
+    std::call_once(attenuationInterpolatorFlag, [&]() {
+      typename OuputCPUImageType::Pointer attenuationFactor = OuputCPUImageType::New();
+      attenuationFactor->CopyInformation(this->GetInput(2));
+      attenuationFactor->SetRegions(this->GetInput(2)->GetLargestPossibleRegion());
+      attenuationFactor->Allocate();
+      itk::ImageRegionConstIterator<TInputImage>  itMu(this->GetInput(2), attenuationFactor->GetBufferedRegion());
+      itk::ImageRegionIterator<OuputCPUImageType> itFactor(attenuationFactor, attenuationFactor->GetBufferedRegion());
+      for (; !itFactor.IsAtEnd(); ++itMu, ++itFactor)
+        itFactor.Set(static_cast<OutputPixelType>(std::exp(-thicknessSlice * itMu.Get())));
+      attenuationInterpolator = AttenuationInterpolatorType::New();
+      attenuationInterpolator->SetInputImage(attenuationFactor);
+    });
+    return attenuationInterpolator.GetPointer();
+  };
+
+  // Each work unit computes the projections of a subset of the angles
+  const double alpha = m_Alpha;
+  const double sigmaZero = m_SigmaZero;
+  this->GetMultiThreader()->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    nbAngles,
+    [&](itk::SizeValueType iAngle) {
+      const unsigned int            iProj = iAngle + projRegion.GetIndex(Dimension - 1);
+      const HomogeneousMatrixType & matrix = rotatedIndexToVolIndex[iAngle];
+      const HomogeneousMatrixType & indexToPP = rotatedIndexToPP[iAngle];
+
+      // Rotated attenuation factors of the angle, exp(-thickness*mu), which
+      // are taken from the cache when possible
+      AttenuationFactorsPointer attenuationFactors;
+      if (this->GetInput(2))
       {
-        break;
+        if (m_AttenuationCache.IsNotNull())
+          attenuationFactors = m_AttenuationCache->Find(this->GetInput(2), gridRegion, matrix);
+        if (!attenuationFactors)
+        {
+          attenuationFactors = ZengAttenuationCache::ComputeFactors(getAttenuationInterpolator(), gridRegion, matrix);
+          if (m_AttenuationCache.IsNotNull())
+            m_AttenuationCache->Insert(this->GetInput(2), gridRegion, matrix, attenuationFactors);
+        }
       }
-      // Compute the variance of the PSF for the current slice
-      sigmaSlice = dist * 2. * thicknessSlice * pow(m_Alpha, 2.0) + 2. * thicknessSlice * m_Alpha * m_SigmaZero -
-                   pow(m_Alpha, 2.0) * pow(thicknessSlice, 2.0);
-      m_DiscreteGaussianFilter->SetVariance(sigmaSlice);
-
-      // Extract the next slice
-      desiredRegion.SetIndex(Dimension - 1, index);
-      m_RegionOfInterest->SetRegionOfInterest(desiredRegion);
-      m_RegionOfInterest->UpdateOutputInformation();
 
-      // Add the current blur slice with the next
-      m_AddImageFilter->GetOutput()->UpdateOutputInformation();
-      m_AddImageFilter->GetOutput()->PropagateRequestedRegion();
-      m_AddImageFilter->Update();
-      if (!(this->GetInput(2)))
-      {
-        currentSlice = m_AddImageFilter->GetOutput();
-      }
-      else
+      // Interpolates one slice of the rotated volume with incremental
+      // continuous indices
+      std::vector<double> current(sizeX * sizeY), slice(sizeX * sizeY), buffer;
+      auto                interpolateSlice = [&](unsigned int k, std::vector<double> & values) {
+        itk::ContinuousIndex<double, 3> idx;
+        for (unsigned int j = 0; j < sizeY; j++)
+        {
+          for (unsigned int d = 0; d < Dimension; d++)
+            idx[d] = matrix[d][3] + matrix[d][0] * gridRegion.GetIndex(0) +
+                     matrix[d][1] * (gridRegion.GetIndex(1) + j) + matrix[d][2] * k;
+          for (unsigned int i = 0; i < sizeX; i++)
+          {
+            const unsigned int p = j * sizeX + i;
+            values[p] = 0.;
+            if (volumeInterpolator->IsInsideBuffer(idx))
+              values[p] = volumeInterpolator->EvaluateAtContinuousIndex(idx);
+            for (unsigned int d = 0; d < Dimension; d++)
+              idx[d] += matrix[d][0];
+          }
+        }
+      };
+      // Multiplies the current slice by the attenuation factors of slice k
+      auto attenuate = [&](unsigned int k) {
+        if (!attenuationFactors)
+          return;
+        const float * attenuation = attenuationFactors->data() + k * current.size();
+        for (unsigned int p = 0; p < current.size(); p++)
+          current[p] *= attenuation[p];
+      };
+      auto blurCurrent = [&](double variance) {
+        const double sigma = std::sqrt(std::max(0., variance));
+        RecursiveGaussianBlurSlice(
+          current.data(), sizeX, sizeY, sigma / gridSpacing[0], sigma / gridSpacing[1], buffer);
+      };
+
+      // Start with the farthest slice from the detector
+      interpolateSlice(nbSlice - 1, current);
+      attenuate(nbSlice - 1);
+
+      // Compute the distance between the current slice and the detector
+      double dist = geometry->GetSourceToIsocenterDistances()[iProj] + indexToPP[2][3] +
+                    indexToPP[2][0] * gridRegion.GetIndex(0) + indexToPP[2][1] * gridRegion.GetIndex(1) +
+                    indexToPP[2][2] * (nbSlice - 1);
+      for (int index = nbSlice - 2; index >= 0; index--)
       {
-        m_AttenuationMapRegionOfInterest->SetRegionOfInterest(desiredRegion);
-        m_AttenuationMapRegionOfInterest->UpdateOutputInformation();
-        m_AttenuationMapMultiplyImageFilter->SetInput1(m_AddImageFilter->GetOutput());
-        m_AttenuationMapMultiplyImageFilter->SetInput2(m_AttenuationMapChangeInformation->GetOutput());
-        m_AttenuationMapMultiplyImageFilter->Update();
-        currentSlice = m_AttenuationMapMultiplyImageFilter->GetOutput();
+        if (dist - thicknessSlice < 0)
+        {
+          break;
+        }
+        // Blur with the variance of the PSF for the current slice and add the next slice
+        blurCurrent(dist * 2. * thicknessSlice * alpha * alpha + 2. * thicknessSlice * alpha * sigmaZero -
+                    alpha * alpha * thicknessSlice * thicknessSlice);
+        interpolateSlice(index, slice);
+        for (unsigned int p = 0; p < current.size(); p++)
+          current[p] += slice[p];
+        attenuate(index);
+        dist -= thicknessSlice;
       }
-      currentSlice->DisconnectPipeline();
-      m_DiscreteGaussianFilter->SetInput(currentSlice);
-      dist -= rotatedVolume->GetSpacing()[2];
-    }
-    // Compute the variance of the PSF for the last slice
-    sigmaSlice = pow(m_Alpha * dist + m_SigmaZero, 2.0);
-    m_DiscreteGaussianFilter->SetVariance(sigmaSlice);
-    // Paste the projection in the output volume
-    indexProjection[Dimension - 1] = nbProjections + projRegion.GetIndex(Dimension - 1);
-    m_PasteImageFilter->SetSourceRegion(m_DiscreteGaussianFilter->GetOutput()->GetLargestPossibleRegion());
-    m_PasteImageFilter->SetDestinationIndex(indexProjection);
-    m_PasteImageFilter->UpdateLargestPossibleRegion();
-    pimg = m_PasteImageFilter->GetOutput();
-
-    pimg->DisconnectPipeline();
-    m_PasteImageFilter->SetDestinationImage(pimg);
-    nbProjections++;
+      // Variance of the PSF for the last slice
+      blurCurrent(std::pow(alpha * dist + sigmaZero, 2.0));
+      // Only the cache, if any, keeps the factors of the angle
+      attenuationFactors.reset();
+
+      // Write the projection in the output
+      typename TOutputImage::IndexType indexProjection = projRegion.GetIndex();
+      indexProjection[Dimension - 1] = iProj;
+      OutputPixelType * out = output->GetBufferPointer() + output->ComputeOffset(indexProjection);
+      for (unsigned int p = 0; p < current.size(); p++)
+        out[p] = static_cast<OutputPixelType>(thicknessSlice * current[p]);
+    },
+    nullptr);
+
+  // The projections of the stack which have not been computed are only scaled
+  OutputImageRegionType otherRegion = projRegion;
+  otherRegion.SetIndex(Dimension - 1, projRegion.GetIndex(Dimension - 1) + list_angle.size());
+  otherRegion.SetSize(Dimension - 1, projRegion.GetSize(Dimension - 1) - list_angle.size());
+  if (otherRegion.GetNumberOfPixels())
+  {
+    itk::ImageRegionConstIterator<TInputImage> itIn(this->GetInput(0), otherRegion);
+    itk::ImageRegionIterator<TOutputImage>     itOut(output, otherRegion);
+    for (; !itOut.IsAtEnd(); ++itIn, ++itOut)
+      itOut.Set(static_cast<OutputPixelType>(thicknessSlice * itIn.Get()));
   }
-  m_MultiplyImageFilter->SetInput(pimg);
-  m_MultiplyImageFilter->UpdateLargestPossibleRegion();
-  pimg = m_MultiplyImageFilter->GetOutput();
-  pimg->DisconnectPipeline();
-  this->GetOutput()->SetPixelContainer(pimg->GetPixelContainer());
-  this->GetOutput()->CopyInformation(pimg);
-  this->GetOutput()->SetBufferedRegion(pimg->GetBufferedRegion());
-  this->GetOutput()->SetRequestedRegion(pimg->GetRequestedRegion());
 }
 
 } // end namespace rtk
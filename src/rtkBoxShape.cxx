@@ -20,6 +20,8 @@
 
 #include "rtkBoxShape.h"
 
+#include <algorithm>
+
 namespace rtk
 {
 
@@ -97,6 +99,38 @@ BoxShape ::IsIntersectedByRay(const PointType &  rayOrigin,
   return ApplyClipPlanes(rayOrigin, rayDirection, nearDist, farDist);
 }
 
+void
+BoxShape ::ComputeBoundingBox(PointType & bbMin, PointType & bbMax) const
+{
+  Superclass::ComputeBoundingBox(bbMin, bbMax);
+
+  // Corners of the box in the rotated frame, brought back in the world frame
+  RotationMatrixType dirt;
+  dirt = m_Direction.GetTranspose();
+  PointType min = dirt * m_BoxMin;
+  PointType max = dirt * m_BoxMax;
+  PointType cornersMin, cornersMax;
+  cornersMin.Fill(itk::NumericTraits<ScalarType>::max());
+  cornersMax.Fill(-itk::NumericTraits<ScalarType>::max());
+  for (unsigned int c = 0; c < (1u << Dimension); c++)
+  {
+    PointType corner;
+    for (unsigned int i = 0; i < Dimension; i++)
+      corner[i] = (c & (1u << i)) ? max[i] : min[i];
+    corner = m_Direction * corner;
+    for (unsigned int i = 0; i < Dimension; i++)
+    {
+      cornersMin[i] = std::min(cornersMin[i], corner[i]);
+      cornersMax[i] = std::max(cornersMax[i], corner[i]);
+    }
+  }
+  for (unsigned int i = 0; i < Dimension; i++)
+  {
+    bbMin[i] = std::max(bbMin[i], cornersMin[i]);
+    bbMax[i] = std::min(bbMax[i], cornersMax[i]);
+  }
+}
+
 void
 BoxShape ::Rescale(const VectorType & r)
 {
@@ -18,6 +18,8 @@
 
 #include "rtkConvexShape.h"
 
+#include <algorithm>
+
 namespace rtk
 {
 
@@ -40,6 +42,35 @@ ConvexShape ::IsIntersectedByRay(const PointType & /*rayOrigin*/,
   return false;
 }
 
+void
+ConvexShape ::ComputeBoundingBox(PointType & bbMin, PointType & bbMax) const
+{
+  bbMin.Fill(-itk::NumericTraits<ScalarType>::max());
+  bbMax.Fill(itk::NumericTraits<ScalarType>::max());
+
+  // A point is inside if point * dir < pos for every plane
+  for (size_t i = 0; i < m_PlaneDirections.size(); i++)
+  {
+    unsigned int nNonZero = 0, axis = 0;
+    for (unsigned int j = 0; j < Dimension; j++)
+    {
+      if (m_PlaneDirections[i][j] != itk::NumericTraits<ScalarType>::ZeroValue())
+      {
+        nNonZero++;
+        axis = j;
+      }
+    }
+    if (nNonZero != 1)
+      continue;
+
+    const ScalarType bound = m_PlanePositions[i] / m_PlaneDirections[i][axis];
+    if (m_PlaneDirections[i][axis] > itk::NumericTraits<ScalarType>::ZeroValue())
+      bbMax[axis] = std::min(bbMax[axis], bound);
+    else
+      bbMin[axis] = std::max(bbMin[axis], bound);
+  }
+}
+
 void
 ConvexShape ::Rescale(const VectorType & r)
 {
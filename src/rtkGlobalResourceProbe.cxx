@@ -18,22 +18,147 @@
 #include "rtkGlobalResourceProbe.h"
 #include "itkObjectFactory.h"
 
+#include <itkImageBase.h>
+#include <itkMemoryUsageObserver.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <unordered_map>
+
 namespace rtk
 {
 GlobalResourceProbe::Pointer GlobalResourceProbe::m_Instance = nullptr;
 
+/** Run of a filter or, if IsIteration, end of an iteration of a filter */
+struct GlobalResourceProbe::TraceEvent
+{
+  const char *       Name;
+  itk::SizeValueType Instance;
+  itk::SizeValueType Id;
+  itk::SizeValueType Parent;
+  unsigned int       Thread;
+  double             Start;    // us
+  double             Duration; // us
+  unsigned int       WorkUnits;
+  itk::SizeValueType Pixels;
+  long long          Bytes;
+  itk::SizeValueType Iteration;
+  bool               IsIteration;
+};
+
+/** Events and stack of running filters of one thread */
+struct GlobalResourceProbe::TraceBuffer
+{
+  struct Frame
+  {
+    itk::ProcessObject *                     Process;
+    itk::SizeValueType                       Instance;
+    itk::SizeValueType                       Id;
+    itk::SizeValueType                       Parent;
+    itk::SizeValueType                       Iteration;
+    itk::SizeValueType                       NumberOfIterations;
+    itk::MemoryUsageObserver::MemoryLoadType Memory;
+    std::chrono::steady_clock::time_point    Start;
+  };
+
+  /** Memory used by the process, read at the runs which are not nested in
+   * another run and otherwise at most every MemorySamplingPeriod since the
+   * observer reads it from the system */
+  itk::MemoryUsageObserver::MemoryLoadType
+  GetMemoryUsage(std::chrono::steady_clock::time_point now, bool topLevel);
+
+  unsigned int                             Thread;
+  std::vector<TraceEvent>                  Events;
+  std::vector<Frame>                       Stack;
+  itk::MemoryUsageObserver                 MemoryObserver;
+  itk::MemoryUsageObserver::MemoryLoadType Memory{ 0 };
+  std::chrono::steady_clock::time_point    MemoryTime;
+  bool                                     MemorySampled{ false };
+};
+
+namespace
+{
+/** Generation of the trace buffers, incremented when the buffers of a
+ * probe are created or cleared so that the threads drop their old buffer */
+std::atomic<itk::SizeValueType> g_TraceGeneration{ 0 };
+
+/** Number of pixels of the requested region of the first output if it is an image */
+itk::SizeValueType
+GetNumberOfRequestedPixels(itk::ProcessObject * o)
+{
+  itk::ProcessObject::DataObjectPointerArray outputs = o->GetOutputs();
+  if (outputs.empty() || outputs[0].IsNull())
+    return 0;
+  if (auto * image2 = dynamic_cast<itk::ImageBase<2> *>(outputs[0].GetPointer()))
+    return image2->GetRequestedRegion().GetNumberOfPixels();
+  if (auto * image3 = dynamic_cast<itk::ImageBase<3> *>(outputs[0].GetPointer()))
+    return image3->GetRequestedRegion().GetNumberOfPixels();
+  if (auto * image4 = dynamic_cast<itk::ImageBase<4> *>(outputs[0].GetPointer()))
+    return image4->GetRequestedRegion().GetNumberOfPixels();
+  return 0;
+}
+
+/** Minimum delay between two readings of the memory within a top-level run */
+constexpr std::chrono::milliseconds MemorySamplingPeriod{ 10 };
+
+/** Nearest-rank percentile of sorted values */
+double
+GetPercentile(const std::vector<double> & sorted, double p)
+{
+  auto rank = static_cast<size_t>(std::ceil(p * sorted.size()));
+  return sorted[std::min(std::max<size_t>(rank, 1), sorted.size()) - 1];
+}
+} // namespace
+
+itk::MemoryUsageObserver::MemoryLoadType
+GlobalResourceProbe::TraceBuffer::GetMemoryUsage(std::chrono::steady_clock::time_point now, bool topLevel)
+{
+  if (topLevel || !MemorySampled || now - MemoryTime >= MemorySamplingPeriod)
+  {
+    Memory = MemoryObserver.GetMemoryUsage();
+    MemoryTime = now;
+    MemorySampled = true;
+  }
+  return Memory;
+}
+
 /**
  * Prompting off by default
  */
 GlobalResourceProbe ::GlobalResourceProbe()
 {
   m_Verbose = false;
+  m_TraceOrigin = std::chrono::steady_clock::now();
+  m_TraceGeneration = ++g_TraceGeneration;
+
+  // Tracing of production runs without recompiling the applications
+  const char * traceFileName = std::getenv("RTK_PROBE_TRACE");
+  const char * traceSummaryFileName = std::getenv("RTK_PROBE_TRACE_SUMMARY");
+  if (traceFileName)
+    m_TraceFileName = traceFileName;
+  if (traceSummaryFileName)
+    m_TraceSummaryFileName = traceSummaryFileName;
+  m_Tracing = !m_TraceFileName.empty() || !m_TraceSummaryFileName.empty();
 }
 
 GlobalResourceProbe ::~GlobalResourceProbe()
 {
   if (m_Verbose)
     this->Report(std::cout);
+  if (!m_TraceFileName.empty())
+  {
+    std::ofstream ofs(m_TraceFileName.c_str());
+    this->WriteChromeTrace(ofs);
+  }
+  if (!m_TraceSummaryFileName.empty())
+  {
+    std::ofstream ofs(m_TraceSummaryFileName.c_str());
+    this->WriteTraceSummary(ofs);
+  }
   this->Clear();
 }
 
@@ -128,6 +253,211 @@ GlobalResourceProbe ::Clear()
   m_Mutex.lock();
   m_ResourceProbesCollector.Clear();
   m_Watchers.clear();
+
+  // The threads get a new buffer at their next event
+  m_TraceBuffers.clear();
+  m_TraceGeneration = ++g_TraceGeneration;
+  m_TraceOrigin = std::chrono::steady_clock::now();
   m_Mutex.unlock();
 }
+
+itk::SizeValueType
+GlobalResourceProbe ::GetNewTraceInstance()
+{
+  return ++m_TraceCounter;
+}
+
+GlobalResourceProbe::TraceBuffer &
+GlobalResourceProbe ::GetTraceBuffer()
+{
+  // Buffer of the current thread and generation of the buffers it belongs to
+  thread_local TraceBuffer *      threadBuffer = nullptr;
+  thread_local itk::SizeValueType threadGeneration = 0;
+  const itk::SizeValueType        generation = m_TraceGeneration;
+  if (threadBuffer == nullptr || threadGeneration != generation)
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_TraceBuffers.push_back(std::make_unique<TraceBuffer>());
+    m_TraceBuffers.back()->Thread = m_TraceBuffers.size() - 1;
+    threadBuffer = m_TraceBuffers.back().get();
+    threadGeneration = generation;
+  }
+  return *threadBuffer;
+}
+
+void
+GlobalResourceProbe ::StartTrace(itk::ProcessObject * o, itk::SizeValueType instance)
+{
+  TraceBuffer & buffer = this->GetTraceBuffer();
+
+  TraceBuffer::Frame frame;
+  frame.Process = o;
+  frame.Instance = instance;
+  frame.Id = ++m_TraceCounter;
+  frame.Parent = buffer.Stack.empty() ? 0 : buffer.Stack.back().Id;
+  frame.NumberOfIterations = 0;
+
+  // Iteration of the innermost enclosing filter which has iterated
+  frame.Iteration = 0;
+  for (auto it = buffer.Stack.rbegin(); it != buffer.Stack.rend(); ++it)
+  {
+    if (it->NumberOfIterations)
+    {
+      frame.Iteration = it->NumberOfIterations;
+      break;
+    }
+  }
+  frame.Start = std::chrono::steady_clock::now();
+  frame.Memory = buffer.GetMemoryUsage(frame.Start, buffer.Stack.empty());
+  buffer.Stack.push_back(frame);
+}
+
+void
+GlobalResourceProbe ::StopTrace(itk::ProcessObject * o)
+{
+  const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+  TraceBuffer &                               buffer = this->GetTraceBuffer();
+
+  // Runs which have not stopped, e.g., after an exception, are discarded
+  auto it = std::find_if(buffer.Stack.rbegin(), buffer.Stack.rend(), [o](const TraceBuffer::Frame & f) {
+    return f.Process == o;
+  });
+  if (it == buffer.Stack.rend())
+    return;
+  const TraceBuffer::Frame & frame = *it;
+
+  TraceEvent event;
+  event.Name = o->GetNameOfClass();
+  event.Instance = frame.Instance;
+  event.Id = frame.Id;
+  event.Parent = frame.Parent;
+  event.Thread = buffer.Thread;
+  event.Start = std::chrono::duration<double, std::micro>(frame.Start - m_TraceOrigin).count();
+  event.Duration = std::chrono::duration<double, std::micro>(end - frame.Start).count();
+  event.WorkUnits = o->GetNumberOfWorkUnits();
+  event.Pixels = GetNumberOfRequestedPixels(o);
+  const bool topLevel = std::next(it) == buffer.Stack.rend();
+  event.Bytes = 1024 * ((long long)buffer.GetMemoryUsage(end, topLevel) - (long long)frame.Memory);
+  event.Iteration = frame.Iteration;
+  event.IsIteration = false;
+  buffer.Events.push_back(event);
+  buffer.Stack.erase(std::next(it).base(), buffer.Stack.end());
+}
+
+void
+GlobalResourceProbe ::IterationTrace(itk::ProcessObject * o)
+{
+  TraceBuffer & buffer = this->GetTraceBuffer();
+  auto          it = std::find_if(buffer.Stack.rbegin(), buffer.Stack.rend(), [o](const TraceBuffer::Frame & f) {
+    return f.Process == o;
+  });
+  if (it == buffer.Stack.rend())
+    return;
+  it->NumberOfIterations++;
+
+  TraceEvent event;
+  event.Name = o->GetNameOfClass();
+  event.Instance = it->Instance;
+  event.Id = ++m_TraceCounter;
+  event.Parent = it->Id;
+  event.Thread = buffer.Thread;
+  event.Start = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - m_TraceOrigin).count();
+  event.Duration = 0.;
+  event.WorkUnits = o->GetNumberOfWorkUnits();
+  event.Pixels = 0;
+  event.Bytes = 0;
+  event.Iteration = it->NumberOfIterations;
+  event.IsIteration = true;
+  buffer.Events.push_back(event);
+}
+
+std::vector<GlobalResourceProbe::TraceEvent>
+GlobalResourceProbe ::GetTraceEvents() const
+{
+  std::vector<TraceEvent> events;
+  for (const auto & buffer : m_TraceBuffers)
+    events.insert(events.end(), buffer->Events.begin(), buffer->Events.end());
+  std::sort(events.begin(), events.end(), [](const TraceEvent & a, const TraceEvent & b) {
+    return a.Start < b.Start;
+  });
+  return events;
+}
+
+void
+GlobalResourceProbe ::WriteChromeTrace(std::ostream & os) const
+{
+  const std::vector<TraceEvent> events = this->GetTraceEvents();
+
+  os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  os << std::fixed << std::setprecision(3);
+  for (size_t i = 0; i < events.size(); i++)
+  {
+    const TraceEvent & e = events[i];
+    os << (i ? ",\n" : "\n");
+    if (e.IsIteration)
+      os << "{\"name\":\"Iteration\",\"cat\":\"iteration\",\"ph\":\"i\",\"s\":\"t\"";
+    else
+      os << "{\"name\":\"" << e.Name << "\",\"cat\":\"filter\",\"ph\":\"X\",\"dur\":" << e.Duration;
+    os << ",\"ts\":" << e.Start << ",\"pid\":1,\"tid\":" << e.Thread << ",\"args\":{";
+    if (e.IsIteration)
+      os << "\"filter\":\"" << e.Name << "\",";
+    os << "\"instance\":" << e.Instance << ",\"id\":" << e.Id << ",\"parent\":" << e.Parent
+       << ",\"workUnits\":" << e.WorkUnits << ",\"pixels\":" << e.Pixels << ",\"bytes\":" << e.Bytes
+       << ",\"iteration\":" << e.Iteration << "}}";
+  }
+  os << "\n]}" << std::endl;
+}
+
+void
+GlobalResourceProbe ::WriteTraceSummary(std::ostream & os) const
+{
+  const std::vector<TraceEvent> events = this->GetTraceEvents();
+
+  // Self time of each run, i.e., without the runs nested in it
+  std::unordered_map<itk::SizeValueType, double> selfTimes;
+  for (const TraceEvent & e : events)
+    if (!e.IsIteration)
+      selfTimes[e.Id] += e.Duration;
+  for (const TraceEvent & e : events)
+    if (!e.IsIteration && selfTimes.count(e.Parent))
+      selfTimes[e.Parent] -= e.Duration;
+
+  struct Summary
+  {
+    std::vector<double> Durations;
+    double              SelfTime{ 0. };
+    double              WorkUnits{ 0. };
+    double              Pixels{ 0. };
+    double              Bytes{ 0. };
+  };
+  std::map<std::string, Summary> summaries;
+  for (const TraceEvent & e : events)
+  {
+    if (e.IsIteration)
+      continue;
+    Summary & summary = summaries[e.Name];
+    summary.Durations.push_back(e.Duration);
+    summary.SelfTime += selfTimes[e.Id];
+    summary.WorkUnits += e.WorkUnits;
+    summary.Pixels += e.Pixels;
+    summary.Bytes += e.Bytes;
+  }
+
+  os << "filter,runs,total_ms,self_ms,mean_ms,p50_ms,p90_ms,p99_ms,max_ms,mean_work_units,mean_pixels,mean_bytes"
+     << std::endl;
+  os << std::fixed << std::setprecision(3);
+  for (auto & s : summaries)
+  {
+    std::vector<double> & d = s.second.Durations;
+    std::sort(d.begin(), d.end());
+    double total = 0.;
+    for (double v : d)
+      total += v;
+    const double n = d.size();
+    os << s.first << ',' << d.size() << ',' << total * 1e-3 << ',' << s.second.SelfTime * 1e-3 << ','
+       << total * 1e-3 / n << ',' << GetPercentile(d, 0.5) * 1e-3 << ',' << GetPercentile(d, 0.9) * 1e-3 << ','
+       << GetPercentile(d, 0.99) * 1e-3 << ',' << d.back() * 1e-3 << ',' << s.second.WorkUnits / n << ','
+       << s.second.Pixels / n << ',' << s.second.Bytes / n << std::endl;
+  }
+}
 } // end namespace rtk
@@ -66,6 +66,23 @@ IntersectionOfConvexShapes ::IsIntersectedByRay(const PointType &  rayOrigin,
   return true;
 }
 
+void
+IntersectionOfConvexShapes ::ComputeBoundingBox(PointType & bbMin, PointType & bbMax) const
+{
+  bbMin.Fill(-itk::NumericTraits<ScalarType>::max());
+  bbMax.Fill(itk::NumericTraits<ScalarType>::max());
+  for (const auto & convexShape : m_ConvexShapes)
+  {
+    PointType shapeMin, shapeMax;
+    convexShape->ComputeBoundingBox(shapeMin, shapeMax);
+    for (unsigned int i = 0; i < Dimension; i++)
+    {
+      bbMin[i] = std::max(bbMin[i], shapeMin[i]);
+      bbMax[i] = std::min(bbMax[i], shapeMax[i]);
+    }
+  }
+}
+
 void
 IntersectionOfConvexShapes ::Rescale(const VectorType & r)
 {
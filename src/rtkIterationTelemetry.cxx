@@ -0,0 +1,244 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "rtkIterationTelemetry.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+namespace rtk
+{
+
+//--------------------------------------------------------------------
+// Sinks
+
+std::ostream &
+IterationTelemetrySink::GetStream()
+{
+  if (m_FileName.empty())
+    return std::cout;
+  if (!m_File.is_open() || m_OpenedFileName != m_FileName)
+  {
+    m_File.close();
+    m_File.open(m_FileName.c_str());
+    if (!m_File.is_open())
+      itkExceptionMacro(<< "Could not open " << m_FileName << " for writing.");
+    m_OpenedFileName = m_FileName;
+  }
+  return m_File;
+}
+
+void
+CSVIterationTelemetrySink::Write(const IterationTelemetryRecord & record)
+{
+  std::ostream & os = this->GetStream();
+  if (!m_HeaderWritten)
+  {
+    os << "filter,iteration,subset,time_s,forward_projection_s,back_projection_s,regularization_s,residual_norm,"
+          "memory_high_water_mark_bytes,forward_projections,back_projections"
+       << std::endl;
+    m_HeaderWritten = true;
+  }
+  os << record.Filter << ',' << record.Iteration << ',' << record.Subset << ',' << record.Time << ','
+     << record.ForwardProjectionTime << ',' << record.BackProjectionTime << ',' << record.RegularizationTime << ','
+     << record.ResidualNorm << ',' << record.MemoryHighWaterMark << ',' << record.ForwardProjections << ','
+     << record.BackProjections << std::endl;
+}
+
+void
+JSONIterationTelemetrySink::Write(const IterationTelemetryRecord & record)
+{
+  // JSON has no NaN, unknown residuals are null
+  std::ostringstream residual;
+  if (std::isnan(record.ResidualNorm))
+    residual << "null";
+  else
+    residual << record.ResidualNorm;
+
+  this->GetStream() << "{\"filter\": \"" << record.Filter << "\", \"iteration\": " << record.Iteration
+                    << ", \"subset\": " << record.Subset << ", \"time_s\": " << record.Time
+                    << ", \"forward_projection_s\": " << record.ForwardProjectionTime
+                    << ", \"back_projection_s\": " << record.BackProjectionTime
+                    << ", \"regularization_s\": " << record.RegularizationTime
+                    << ", \"residual_norm\": " << residual.str()
+                    << ", \"memory_high_water_mark_bytes\": " << record.MemoryHighWaterMark
+                    << ", \"forward_projections\": " << record.ForwardProjections
+                    << ", \"back_projections\": " << record.BackProjections << "}" << std::endl;
+}
+
+//--------------------------------------------------------------------
+// Telemetry
+
+void
+IterationTelemetry::StartReconstruction(const itk::Object * filter)
+{
+  // Nested reconstruction filter, only its sections are measured
+  if (m_Owner != nullptr && m_Owner != filter)
+    return;
+
+  m_Owner = filter;
+  m_ReconstructionStart = ClockType::now();
+  std::fill(m_SectionDepth, m_SectionDepth + NumberOfSections, 0);
+  std::fill(m_SectionCount, m_SectionCount + NumberOfSections, 0);
+  this->ResetAccumulator(m_Subset);
+  this->ResetAccumulator(m_Iteration);
+  m_MemoryHighWaterMark = 0.;
+  this->SampleMemory();
+  m_ResidualNorms.clear();
+  m_Records.clear();
+  m_StopRequested = false;
+  m_StopReason.clear();
+}
+
+void
+IterationTelemetry::EndReconstruction(const itk::Object * filter)
+{
+  if (m_Owner == filter)
+    m_Owner = nullptr;
+}
+
+void
+IterationTelemetry::StartSection(SectionType section)
+{
+  // Only the outermost section is timed if the same step is nested
+  if (m_SectionDepth[section]++ == 0)
+    m_SectionStart[section] = ClockType::now();
+}
+
+void
+IterationTelemetry::EndSection(SectionType section)
+{
+  if (m_SectionDepth[section] == 0 || --m_SectionDepth[section] > 0)
+    return;
+  m_SectionCount[section]++;
+  const double time = std::chrono::duration<double>(ClockType::now() - m_SectionStart[section]).count();
+  m_Subset.Sections[section] += time;
+  m_Iteration.Sections[section] += time;
+  this->SampleMemory();
+}
+
+void
+IterationTelemetry::CompleteSubset(const itk::Object * filter,
+                                   unsigned int        iteration,
+                                   unsigned int        subset,
+                                   double              residualNorm)
+{
+  if (filter != m_Owner)
+    return;
+
+  RecordType record;
+  record.Iteration = iteration;
+  record.Subset = subset;
+  record.ResidualNorm = residualNorm;
+  this->Complete(filter, record, m_Subset);
+}
+
+void
+IterationTelemetry::CompleteIteration(const itk::Object * filter, unsigned int iteration, double residualNorm)
+{
+  if (filter != m_Owner)
+    return;
+
+  RecordType record;
+  record.Iteration = iteration;
+  record.ResidualNorm = residualNorm;
+  this->Complete(filter, record, m_Iteration);
+
+  // The next subset starts with the next iteration
+  this->ResetAccumulator(m_Subset);
+
+  // Early stop criteria
+  const double elapsed = std::chrono::duration<double>(ClockType::now() - m_ReconstructionStart).count();
+  if (m_TimeBudget > 0. && elapsed >= m_TimeBudget)
+  {
+    std::ostringstream reason;
+    reason << "time budget of " << m_TimeBudget << " s exceeded after " << iteration + 1 << " iteration(s)";
+    m_StopReason = reason.str();
+    m_StopRequested = true;
+  }
+
+  if (!std::isnan(residualNorm))
+    m_ResidualNorms.push_back(residualNorm);
+  if (m_ResidualPlateauTolerance > 0. && m_ResidualPlateauWindow > 0 &&
+      m_ResidualNorms.size() > m_ResidualPlateauWindow)
+  {
+    const double previous = m_ResidualNorms[m_ResidualNorms.size() - 1 - m_ResidualPlateauWindow];
+    const double decrease = (previous - m_ResidualNorms.back()) / previous;
+    if (previous > 0. && decrease < m_ResidualPlateauTolerance)
+    {
+      std::ostringstream reason;
+      reason << "residual norm decreased by " << decrease << " over the last " << m_ResidualPlateauWindow
+             << " iterations";
+      m_StopReason = reason.str();
+      m_StopRequested = true;
+    }
+  }
+}
+
+void
+IterationTelemetry::Complete(const itk::Object * filter, RecordType & record, Accumulator & accumulator)
+{
+  this->SampleMemory();
+  const ClockType::time_point now = ClockType::now();
+  record.Filter = filter->GetNameOfClass();
+  record.Time = std::chrono::duration<double>(now - accumulator.Start).count();
+  record.ForwardProjectionTime = accumulator.Sections[FORWARD_PROJECTION];
+  record.BackProjectionTime = accumulator.Sections[BACK_PROJECTION];
+  record.RegularizationTime = accumulator.Sections[REGULARIZATION];
+  record.MemoryHighWaterMark = m_MemoryHighWaterMark;
+  record.ForwardProjections = m_SectionCount[FORWARD_PROJECTION];
+  record.BackProjections = m_SectionCount[BACK_PROJECTION];
+  this->ResetAccumulator(accumulator);
+  accumulator.Start = now;
+
+  m_Records.push_back(record);
+  if (m_Sink.IsNotNull())
+    m_Sink->Write(record);
+}
+
+void
+IterationTelemetry::ResetAccumulator(Accumulator & accumulator)
+{
+  accumulator.Start = ClockType::now();
+  std::fill(accumulator.Sections, accumulator.Sections + NumberOfSections, 0.);
+}
+
+void
+IterationTelemetry::SampleMemory()
+{
+  // The memory usage observer returns kB
+  m_MemoryHighWaterMark = std::max(m_MemoryHighWaterMark, 1024. * m_MemoryObserver.GetMemoryUsage());
+}
+
+void
+IterationTelemetry::PrintSelf(std::ostream & os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "TimeBudget: " << m_TimeBudget << std::endl;
+  os << indent << "ResidualPlateauTolerance: " << m_ResidualPlateauTolerance << std::endl;
+  os << indent << "ResidualPlateauWindow: " << m_ResidualPlateauWindow << std::endl;
+  os << indent << "NumberOfRecords: " << m_Records.size() << std::endl;
+  os << indent << "StopRequested: " << m_StopRequested << std::endl;
+  if (m_StopRequested)
+    os << indent << "StopReason: " << m_StopReason << std::endl;
+}
+
+} // end namespace rtk
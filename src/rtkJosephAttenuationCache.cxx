@@ -0,0 +1,300 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "rtkJosephAttenuationCache.h"
+
+#include <algorithm>
+
+namespace rtk
+{
+
+void
+JosephAttenuationCache::SetMemoryBudget(itk::SizeValueType budget)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  if (m_MemoryBudget == budget)
+    return;
+  m_MemoryBudget = budget;
+  this->Evict(m_MemoryBudget);
+  this->Modified();
+}
+
+itk::SizeValueType
+JosephAttenuationCache::GetTableSize(const TableType & table)
+{
+  return table.Offsets.size() * sizeof(itk::SizeValueType) + table.Weights.size() * sizeof(float);
+}
+
+JosephAttenuationCache::TablePointer
+JosephAttenuationCache::Find(const itk::Object * attenuationMap, const KeyType & key)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  for (auto it = m_Entries.begin(); it != m_Entries.end(); ++it)
+  {
+    if (it->AttenuationMap == attenuationMap && it->AttenuationMapTime == attenuationMap->GetMTime() &&
+        it->Key == key)
+    {
+      // Most recently used entries are kept at the front
+      m_Entries.splice(m_Entries.begin(), m_Entries, it);
+      return m_Entries.front().Table;
+    }
+  }
+  return nullptr;
+}
+
+void
+JosephAttenuationCache::Insert(const itk::Object * attenuationMap, const KeyType & key, TablePointer table)
+{
+  const itk::SizeValueType size = GetTableSize(*table);
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  if (size > m_MemoryBudget)
+    return;
+
+  // Entries of another attenuation map, or of a modified one, are obsolete
+  for (auto it = m_Entries.begin(); it != m_Entries.end();)
+  {
+    if (it->AttenuationMap != attenuationMap || it->AttenuationMapTime != attenuationMap->GetMTime())
+    {
+      m_MemoryUsage -= GetTableSize(*(it->Table));
+      it = m_Entries.erase(it);
+    }
+    else
+    {
+      if (it->Key == key)
+        return;
+      ++it;
+    }
+  }
+
+  this->Evict(m_MemoryBudget - size);
+  m_Entries.push_front({ attenuationMap, attenuationMap->GetMTime(), key, table });
+  m_MemoryUsage += size;
+}
+
+void
+JosephAttenuationCache::Evict(itk::SizeValueType budget)
+{
+  while (!m_Entries.empty() && m_MemoryUsage > budget)
+  {
+    m_MemoryUsage -= GetTableSize(*(m_Entries.back().Table));
+    m_Entries.pop_back();
+  }
+}
+
+unsigned int
+JosephAttenuationCache::GetNumberOfEntries() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_Entries.size();
+}
+
+itk::SizeValueType
+JosephAttenuationCache::GetMemoryUsage() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_MemoryUsage;
+}
+
+void
+JosephAttenuationCache::Clear()
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_Entries.clear();
+  m_MemoryUsage = 0;
+}
+
+JosephAttenuationCache::KeyType
+JosephAttenuationCache::ComputeKey(bool                                     backProjection,
+                                   const ThreeDCircularProjectionGeometry * geometry,
+                                   unsigned int                             iProj,
+                                   const itk::ImageBase<3> *                projections,
+                                   const RegionType &                       projectionRegion,
+                                   const itk::ImageBase<3> *                volume,
+                                   const RegionType &                       volumeRegion,
+                                   double                                   inferiorClip,
+                                   double                                   superiorClip)
+{
+  KeyType key;
+  key.push_back(backProjection);
+  key.push_back(inferiorClip);
+  key.push_back(superiorClip);
+
+  // Source and detector of the projection
+  const ThreeDCircularProjectionGeometry::ThreeDHomogeneousMatrixType detector =
+    geometry->GetProjectionCoordinatesToFixedSystemMatrix(iProj);
+  for (unsigned int i = 0; i < 4; i++)
+    for (unsigned int j = 0; j < 4; j++)
+      key.push_back(detector[i][j]);
+  const ThreeDCircularProjectionGeometry::HomogeneousVectorType source = geometry->GetSourcePosition(iProj);
+  for (unsigned int i = 0; i < 4; i++)
+    key.push_back(source[i]);
+  key.push_back(geometry->GetSourceToDetectorDistances()[iProj]);
+  key.push_back(geometry->GetRadiusCylindricalDetector());
+
+  // Sampling of the projection and of the volume
+  for (const itk::ImageBase<3> * image : { projections, volume })
+    for (unsigned int i = 0; i < 3; i++)
+    {
+      key.push_back(image->GetOrigin()[i]);
+      key.push_back(image->GetSpacing()[i]);
+      for (unsigned int j = 0; j < 3; j++)
+        key.push_back(image->GetDirection()[i][j]);
+    }
+  for (const RegionType & region : { projectionRegion, volumeRegion })
+    for (unsigned int i = 0; i < 3; i++)
+    {
+      key.push_back(region.GetIndex(i));
+      key.push_back(region.GetSize(i));
+    }
+  return key;
+}
+
+void
+JosephAttenuationCache::PrintSelf(std::ostream & os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "MemoryBudget: " << m_MemoryBudget << std::endl;
+  os << indent << "MemoryUsage: " << this->GetMemoryUsage() << std::endl;
+  os << indent << "NumberOfEntries: " << this->GetNumberOfEntries() << std::endl;
+}
+
+void
+JosephAttenuationTables::Initialize(unsigned int                      numberOfThreads,
+                                    itk::SizeValueType                pixelsPerProjection,
+                                    const std::vector<TablePointer> & cachedTables,
+                                    itk::SizeValueType                memoryBudget)
+{
+  this->Reset();
+  m_PixelsPerProjection = pixelsPerProjection;
+  m_Replaying = std::none_of(
+    cachedTables.begin(), cachedTables.end(), [](const TablePointer & table) { return table == nullptr; });
+  if (m_Replaying)
+    m_Tables = cachedTables;
+  else
+  {
+    // The offsets of the tables are known, the rest of the budget is left to
+    // the weights
+    const itk::SizeValueType offsetsSize = cachedTables.size() * (pixelsPerProjection + 1) * sizeof(itk::SizeValueType);
+    if (offsetsSize < memoryBudget)
+    {
+      m_Recording = true;
+      m_MaximumNumberOfWeights = (memoryBudget - offsetsSize) / sizeof(float);
+      m_RayOffsets.assign(pixelsPerProjection * cachedTables.size(), 0);
+      m_RayLengths.assign(pixelsPerProjection * cachedTables.size(), 0);
+    }
+  }
+  m_RayBuffers.assign(numberOfThreads, std::vector<double>());
+}
+
+void
+JosephAttenuationTables::Reset()
+{
+  m_Recording = false;
+  m_Replaying = false;
+  m_Tables.clear();
+  std::vector<float>().swap(m_RecordedWeights);
+  std::vector<itk::SizeValueType>().swap(m_RayOffsets);
+  std::vector<itk::SizeValueType>().swap(m_RayLengths);
+  m_RayBuffers.clear();
+}
+
+bool
+JosephAttenuationTables::ReserveWeights(itk::SizeValueType numberOfWeights)
+{
+  if (m_RecordedWeights.size() + numberOfWeights <= m_MaximumNumberOfWeights)
+    return true;
+
+  // The tables could not be replayed, release what has been recorded
+  m_Recording = false;
+  std::vector<float>().swap(m_RecordedWeights);
+  std::vector<itk::SizeValueType>().swap(m_RayOffsets);
+  std::vector<itk::SizeValueType>().swap(m_RayLengths);
+  return false;
+}
+
+void
+JosephAttenuationTables::RecordRay(itk::SizeValueType pixel, const std::vector<double> & weights)
+{
+  std::lock_guard<std::mutex> lock(m_RecordMutex);
+  if (!m_Recording || !this->ReserveWeights(weights.size()))
+    return;
+  m_RayOffsets[pixel] = m_RecordedWeights.size();
+  m_RayLengths[pixel] = weights.size();
+  m_RecordedWeights.insert(m_RecordedWeights.end(), weights.begin(), weights.end());
+}
+
+void
+JosephAttenuationTables::BeginRay(itk::SizeValueType pixel)
+{
+  if (!m_Recording)
+    return;
+  m_CurrentRay = pixel;
+  m_RayOffsets[pixel] = m_RecordedWeights.size();
+  m_RayLengths[pixel] = 0;
+}
+
+void
+JosephAttenuationTables::RecordWeight(double weight)
+{
+  if (!m_Recording || !this->ReserveWeights(1))
+    return;
+  m_RecordedWeights.push_back(weight);
+  m_RayLengths[m_CurrentRay]++;
+}
+
+JosephAttenuationTables::TablePointer
+JosephAttenuationTables::GetRecordedTable(unsigned int projection) const
+{
+  auto                     table = std::make_shared<JosephAttenuationCache::TableType>();
+  const itk::SizeValueType first = projection * m_PixelsPerProjection;
+  table->Offsets.resize(m_PixelsPerProjection + 1);
+  table->Offsets[0] = 0;
+  for (itk::SizeValueType p = 0; p < m_PixelsPerProjection; p++)
+    table->Offsets[p + 1] = table->Offsets[p] + m_RayLengths[first + p];
+  table->Weights.reserve(table->Offsets.back());
+  for (itk::SizeValueType p = 0; p < m_PixelsPerProjection; p++)
+  {
+    const auto begin = m_RecordedWeights.begin() + m_RayOffsets[first + p];
+    table->Weights.insert(table->Weights.end(), begin, begin + m_RayLengths[first + p]);
+  }
+  return table;
+}
+
+const float *
+JosephAttenuationTables::GetWeights(itk::SizeValueType pixel, itk::SizeValueType & numberOfWeights) const
+{
+  const JosephAttenuationCache::TableType & table = *(m_Tables[pixel / m_PixelsPerProjection]);
+  const itk::SizeValueType                  p = pixel % m_PixelsPerProjection;
+  numberOfWeights = table.Offsets[p + 1] - table.Offsets[p];
+  return table.Weights.data() + table.Offsets[p];
+}
+
+double
+JosephAttenuationTables::ReplayRay(itk::SizeValueType pixel, const std::vector<double> & values) const
+{
+  itk::SizeValueType numberOfWeights = 0;
+  const float *      weights = this->GetWeights(pixel, numberOfWeights);
+  const auto         n = std::min<itk::SizeValueType>(numberOfWeights, values.size());
+  double             sum = 0.;
+  for (itk::SizeValueType i = 0; i < n; i++)
+    sum += weights[i] * values[i];
+  return sum;
+}
+
+} // end namespace rtk
@@ -0,0 +1,306 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "rtkMemoryPlanner.h"
+
+#include <algorithm>
+
+namespace rtk
+{
+
+void
+MemoryPlanner::Initialize()
+{
+  m_Outputs.clear();
+  m_RetainedData.clear();
+  m_TransientMemory.clear();
+  this->Modified();
+}
+
+void
+MemoryPlanner::AddOutput(itk::DataObject * output)
+{
+  m_Outputs.push_back(output);
+  this->Modified();
+}
+
+void
+MemoryPlanner::AddRetainedData(itk::DataObject * data)
+{
+  m_RetainedData.insert(data);
+  this->Modified();
+}
+
+void
+MemoryPlanner::AddTransientMemory(const itk::ProcessObject * filter, itk::SizeValueType bytes)
+{
+  m_TransientMemory[filter] += bytes;
+  this->Modified();
+}
+
+itk::SizeValueType
+MemoryPlanner::GetBytes(const itk::DataObject * data) const
+{
+  itk::SizeValueType bytes = 0;
+  for (const SizeFunctionType & size : m_SizeFunctions)
+    if (size(data, bytes))
+      return bytes;
+  return 0;
+}
+
+void
+MemoryPlanner::Plan(itk::ProcessObject * owner)
+{
+  this->RestoreFlags();
+
+  // The inputs of the composite filter bound the internal pipeline
+  m_Boundary.clear();
+  for (const itk::DataObject::Pointer & input : owner->GetInputs())
+    m_Boundary.insert(input.GetPointer());
+  for (const itk::DataObject::Pointer & output : owner->GetOutputs())
+    m_Boundary.insert(output.GetPointer());
+
+  // Order the internal filters as the pipeline executes them, i.e., each
+  // filter after the filters producing its inputs
+  m_Steps.clear();
+  m_StepIndices.clear();
+  for (itk::DataObject * output : m_Outputs)
+  {
+    output->UpdateOutputInformation();
+    if (output->GetSource() != nullptr)
+      this->Visit(output->GetSource());
+  }
+
+  this->Analyze();
+  if (m_MemoryCap > 0 && m_PredictedPeak > m_MemoryCap)
+  {
+    this->ReduceMemory();
+    this->Analyze();
+    if (m_PredictedPeak > m_MemoryCap)
+      itkWarningMacro(<< "The predicted memory peak of " << owner->GetNameOfClass() << ", " << m_PredictedPeak
+                      << " bytes, exceeds the memory cap of " << m_MemoryCap << " bytes.");
+  }
+  this->AssignBuffers();
+}
+
+void
+MemoryPlanner::Visit(itk::ProcessObject * filter)
+{
+  if (m_StepIndices.count(filter))
+    return;
+
+  // Mark the filter to stop at cycles
+  m_StepIndices[filter] = 0;
+  for (const itk::DataObject::Pointer & input : filter->GetInputs())
+    if (this->IsInternal(input) && input->GetSource() != nullptr)
+      this->Visit(input->GetSource());
+  m_StepIndices[filter] = m_Steps.size();
+  m_Steps.push_back(filter);
+}
+
+bool
+MemoryPlanner::IsInternal(const itk::DataObject * data) const
+{
+  return data != nullptr && m_Boundary.count(data) == 0;
+}
+
+bool
+MemoryPlanner::RunsInPlace(itk::ProcessObject * filter, const itk::DataObject * input, bool enable) const
+{
+  bool inPlace = false;
+  for (const InPlaceFunctionType & function : m_InPlaceFunctions)
+    if (function(filter, input, enable, inPlace))
+      return inPlace;
+  return false;
+}
+
+bool
+MemoryPlanner::GetInPlaceFlag(itk::ProcessObject * filter, bool & inPlaceFlag, const bool * newInPlaceFlag) const
+{
+  for (const InPlaceFlagFunctionType & function : m_InPlaceFlagFunctions)
+    if (function(filter, inPlaceFlag, newInPlaceFlag))
+      return true;
+  return false;
+}
+
+void
+MemoryPlanner::Analyze()
+{
+  const unsigned int nSteps = m_Steps.size();
+
+  // Consumers of each image
+  m_Consumers.clear();
+  for (unsigned int s = 0; s < nSteps; s++)
+    for (const itk::DataObject::Pointer & input : m_Steps[s]->GetInputs())
+      if (this->IsInternal(input))
+        m_Consumers[input].push_back(s);
+
+  // Lifetime of each image
+  m_Intervals.clear();
+  for (unsigned int s = 0; s < nSteps; s++)
+  {
+    for (const itk::DataObject::Pointer & output : m_Steps[s]->GetOutputs())
+    {
+      if (output.IsNull())
+        continue;
+      Interval interval;
+      interval.Data = output;
+      interval.Producer = m_Steps[s]->GetNameOfClass();
+      interval.Bytes = this->GetBytes(output);
+      interval.Start = s;
+      interval.End = nSteps - 1;
+      interval.Buffer = -1;
+
+      const bool retained = m_RetainedData.count(output.GetPointer()) ||
+                            std::find(m_Outputs.begin(), m_Outputs.end(), output.GetPointer()) != m_Outputs.end();
+      const auto consumers = m_Consumers.find(output.GetPointer());
+      if (!retained && consumers != m_Consumers.end())
+      {
+        const unsigned int last = *std::max_element(consumers->second.begin(), consumers->second.end());
+        if (this->RunsInPlace(m_Steps[last], output, false))
+        {
+          // The consumer takes over the buffer
+          interval.End = last - 1;
+        }
+        else if (output->GetReleaseDataFlag())
+          interval.End = last;
+      }
+      m_Intervals.push_back(interval);
+    }
+  }
+
+  // Predicted peak
+  m_PredictedPeak = 0;
+  for (unsigned int s = 0; s < nSteps; s++)
+  {
+    itk::SizeValueType live = 0;
+    const auto         transient = m_TransientMemory.find(m_Steps[s]);
+    if (transient != m_TransientMemory.end())
+      live += transient->second;
+    for (const Interval & interval : m_Intervals)
+      if (interval.Start <= s && s <= interval.End)
+        live += interval.Bytes;
+    m_PredictedPeak = std::max(m_PredictedPeak, live);
+  }
+}
+
+void
+MemoryPlanner::ReduceMemory()
+{
+  for (const auto & consumers : m_Consumers)
+  {
+    auto * data = const_cast<itk::DataObject *>(consumers.first);
+    if (consumers.second.size() != 1 || m_RetainedData.count(data) ||
+        std::find(m_Outputs.begin(), m_Outputs.end(), data) != m_Outputs.end())
+      continue;
+    if (!data->GetReleaseDataFlag() && data->GetSource() != nullptr)
+    {
+      m_ReleasedData.emplace_back(data->GetSource(), data);
+      data->ReleaseDataFlagOn();
+    }
+    itk::ProcessObject * consumer = m_Steps[consumers.second[0]];
+    bool                 inPlaceFlag = true;
+    this->GetInPlaceFlag(consumer, inPlaceFlag);
+    this->RunsInPlace(consumer, data, true);
+    bool newInPlaceFlag = false;
+    if (!inPlaceFlag && this->GetInPlaceFlag(consumer, newInPlaceFlag) && newInPlaceFlag)
+      m_InPlaceFilters.push_back(consumer);
+  }
+}
+
+void
+MemoryPlanner::RestoreFlags()
+{
+  // The images replaced since, e.g., by DisconnectPipeline, have the default
+  // flag of the new outputs
+  for (const auto & released : m_ReleasedData)
+    for (const itk::DataObject::Pointer & output : released.first->GetOutputs())
+      if (output.GetPointer() == released.second)
+        output->ReleaseDataFlagOff();
+  const bool off = false;
+  bool       inPlaceFlag = false;
+  for (const itk::ProcessObject::Pointer & filter : m_InPlaceFilters)
+    this->GetInPlaceFlag(filter, inPlaceFlag, &off);
+  m_ReleasedData.clear();
+  m_InPlaceFilters.clear();
+}
+
+void
+MemoryPlanner::AssignBuffers()
+{
+  std::vector<Interval *> sorted;
+  for (Interval & interval : m_Intervals)
+    if (interval.Bytes > 0)
+      sorted.push_back(&interval);
+  std::stable_sort(sorted.begin(), sorted.end(), [](const Interval * a, const Interval * b) {
+    return a->Start < b->Start || (a->Start == b->Start && a->Bytes > b->Bytes);
+  });
+
+  // Linear scan: each image takes the smallest free buffer which fits, or the
+  // largest free buffer which then grows, or a new buffer
+  m_BufferSizes.clear();
+  std::vector<int> bufferEnds;
+  for (Interval * interval : sorted)
+  {
+    int best = -1;
+    for (unsigned int b = 0; b < m_BufferSizes.size(); b++)
+    {
+      if (bufferEnds[b] >= static_cast<int>(interval->Start))
+        continue;
+      const bool fits = m_BufferSizes[b] >= interval->Bytes;
+      if (best < 0)
+        best = b;
+      else if (fits && (m_BufferSizes[best] < interval->Bytes || m_BufferSizes[b] < m_BufferSizes[best]))
+        best = b;
+      else if (!fits && m_BufferSizes[best] < interval->Bytes && m_BufferSizes[b] > m_BufferSizes[best])
+        best = b;
+    }
+    if (best < 0)
+    {
+      best = m_BufferSizes.size();
+      m_BufferSizes.push_back(0);
+      bufferEnds.push_back(-1);
+    }
+    interval->Buffer = best;
+    m_BufferSizes[best] = std::max(m_BufferSizes[best], interval->Bytes);
+    bufferEnds[best] = interval->End;
+  }
+
+  m_PoolSize = 0;
+  for (itk::SizeValueType size : m_BufferSizes)
+    m_PoolSize += size;
+}
+
+void
+MemoryPlanner::PrintSelf(std::ostream & os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "MemoryCap: " << m_MemoryCap << std::endl;
+  os << indent << "PredictedPeak: " << m_PredictedPeak << std::endl;
+  os << indent << "NumberOfBuffers: " << m_BufferSizes.size() << std::endl;
+  os << indent << "PoolSize: " << m_PoolSize << std::endl;
+  for (const Interval & interval : m_Intervals)
+  {
+    if (interval.Bytes == 0)
+      continue;
+    os << indent.GetNextIndent() << interval.Producer << ": " << interval.Bytes << " bytes in buffer "
+       << interval.Buffer << " from step " << interval.Start << " to step " << interval.End << std::endl;
+  }
+}
+
+} // end namespace rtk
@@ -18,6 +18,9 @@
 
 #include "rtkQuadricShape.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace rtk
 {
 
@@ -134,6 +137,99 @@ QuadricShape ::IsIntersectedByRay(const PointType &  rayOrigin,
   return ApplyClipPlanes(rayOrigin, rayDirection, nearDist, farDist);
 }
 
+void
+QuadricShape ::ComputeBoundingBox(PointType & bbMin, PointType & bbMax) const
+{
+  Superclass::ComputeBoundingBox(bbMin, bbMax);
+
+  // Quadric equation x^T Q x + L^T x + J <= 0
+  const ScalarType Q[Dimension][Dimension] = { { m_A, 0.5 * m_D, 0.5 * m_E },
+                                               { 0.5 * m_D, m_B, 0.5 * m_F },
+                                               { 0.5 * m_E, 0.5 * m_F, m_C } };
+  const ScalarType L[Dimension] = { m_G, m_H, m_I };
+
+  // Restrict to the axes involved in the quadratic form. The quadric does not
+  // depend on the other axes only if it has no linear term along them.
+  unsigned int axes[Dimension];
+  unsigned int n = 0;
+  for (unsigned int i = 0; i < Dimension; i++)
+  {
+    if (Q[i][0] != 0. || Q[i][1] != 0. || Q[i][2] != 0.)
+      axes[n++] = i;
+    else if (L[i] != 0.)
+      return;
+  }
+  if (n == 0)
+    return;
+
+  // Cholesky decomposition S = C C^T of the restricted quadratic form, which
+  // fails if the quadric is not an ellipse or an ellipsoid along these axes
+  ScalarType C[Dimension][Dimension] = {};
+  for (unsigned int j = 0; j < n; j++)
+  {
+    ScalarType d = Q[axes[j]][axes[j]];
+    for (unsigned int k = 0; k < j; k++)
+      d -= C[j][k] * C[j][k];
+    if (d <= 0.)
+      return;
+    C[j][j] = std::sqrt(d);
+    for (unsigned int i = j + 1; i < n; i++)
+    {
+      ScalarType v = Q[axes[i]][axes[j]];
+      for (unsigned int k = 0; k < j; k++)
+        v -= C[i][k] * C[j][k];
+      C[i][j] = v / C[j][j];
+    }
+  }
+
+  // Center c = -S^-1 L / 2, by forward and backward substitutions
+  ScalarType center[Dimension];
+  for (unsigned int i = 0; i < n; i++)
+  {
+    center[i] = -0.5 * L[axes[i]];
+    for (unsigned int k = 0; k < i; k++)
+      center[i] -= C[i][k] * center[k];
+    center[i] /= C[i][i];
+  }
+  for (unsigned int ii = n; ii > 0; ii--)
+  {
+    const unsigned int i = ii - 1;
+    for (unsigned int k = i + 1; k < n; k++)
+      center[i] -= C[k][i] * center[k];
+    center[i] /= C[i][i];
+  }
+
+  // The quadric is (x-c)^T S (x-c) <= r with r = c^T S c - J = -L^T c / 2 - J
+  ScalarType r = -m_J;
+  for (unsigned int i = 0; i < n; i++)
+    r -= 0.5 * L[axes[i]] * center[i];
+  if (r < 0.)
+  {
+    // Empty quadric
+    bbMin.Fill(itk::NumericTraits<ScalarType>::max());
+    bbMax.Fill(-itk::NumericTraits<ScalarType>::max());
+    return;
+  }
+
+  // Half extent along axis i is sqrt(r (S^-1)_ii) with (S^-1)_ii = ||C^-1 e_i||^2
+  for (unsigned int i = 0; i < n; i++)
+  {
+    ScalarType y[Dimension] = {};
+    ScalarType norm2 = 0.;
+    for (unsigned int j = i; j < n; j++)
+    {
+      y[j] = (j == i) ? 1. : 0.;
+      for (unsigned int k = i; k < j; k++)
+        y[j] -= C[j][k] * y[k];
+      y[j] /= C[j][j];
+      norm2 += y[j] * y[j];
+    }
+    const ScalarType halfExtent = std::sqrt(r * norm2);
+    bbMin[axes[i]] = std::max(bbMin[axes[i]], center[i] - halfExtent);
+    bbMax[axes[i]] = std::min(bbMax[axes[i]], center[i] + halfExtent);
+  }
+}
+
 void
 QuadricShape ::Rescale(const VectorType & r)
 {
@@ -0,0 +1,107 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "rtkScatterGlareKernelCache.h"
+
+namespace rtk
+{
+
+void
+ScatterGlareKernelCache::SetMemoryBudget(itk::SizeValueType budget)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  if (m_MemoryBudget == budget)
+    return;
+  m_MemoryBudget = budget;
+  this->Evict(m_MemoryBudget);
+  this->Modified();
+}
+
+itk::DataObject::Pointer
+ScatterGlareKernelCache::Find(const KeyType & key)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  for (auto it = m_Entries.begin(); it != m_Entries.end(); ++it)
+  {
+    if (it->Key == key)
+    {
+      // Most recently used entries are kept at the front
+      m_Entries.splice(m_Entries.begin(), m_Entries, it);
+      return m_Entries.front().Spectrum;
+    }
+  }
+  return nullptr;
+}
+
+void
+ScatterGlareKernelCache::Insert(const KeyType & key, itk::DataObject * spectrum, itk::SizeValueType size)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  if (size > m_MemoryBudget)
+    return;
+  for (const Entry & entry : m_Entries)
+    if (entry.Key == key)
+      return;
+
+  this->Evict(m_MemoryBudget - size);
+  m_Entries.push_front({ key, spectrum, size });
+  m_MemoryUsage += size;
+}
+
+void
+ScatterGlareKernelCache::Evict(itk::SizeValueType budget)
+{
+  while (!m_Entries.empty() && m_MemoryUsage > budget)
+  {
+    m_MemoryUsage -= m_Entries.back().Size;
+    m_Entries.pop_back();
+  }
+}
+
+unsigned int
+ScatterGlareKernelCache::GetNumberOfEntries() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_Entries.size();
+}
+
+itk::SizeValueType
+ScatterGlareKernelCache::GetMemoryUsage() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_MemoryUsage;
+}
+
+void
+ScatterGlareKernelCache::Clear()
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_Entries.clear();
+  m_MemoryUsage = 0;
+}
+
+void
+ScatterGlareKernelCache::PrintSelf(std::ostream & os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "MemoryBudget: " << m_MemoryBudget << std::endl;
+  os << indent << "MemoryUsage: " << this->GetMemoryUsage() << std::endl;
+  os << indent << "NumberOfEntries: " << this->GetNumberOfEntries() << std::endl;
+}
+
+} // end namespace rtk
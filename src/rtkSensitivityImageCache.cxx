@@ -0,0 +1,228 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "rtkSensitivityImageCache.h"
+
+#include <itkMetaDataObject.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+#ifdef _WIN32
+#  include <process.h>
+#  define RTK_GETPID _getpid
+#else
+#  include <unistd.h>
+#  define RTK_GETPID getpid
+#endif
+
+namespace rtk
+{
+
+namespace
+{
+// Version of the key written in the files, to be increased when the key of an
+// image changes
+const std::string  KeyVersion = "1";
+const std::string  KeyPrefix = "RTKSensitivityKey";
+const unsigned int NumberOfKeyValuesPerField = 8;
+
+// Exact text of the values of key from first, in short fields since MetaIO
+// limits the length of the values of its header
+std::string
+GetKeyField(const SensitivityImageCache::KeyType & key, unsigned int first)
+{
+  std::ostringstream field;
+  field << std::hexfloat;
+  for (unsigned int i = first; i < key.size() && i < first + NumberOfKeyValuesPerField; i++)
+    field << (i == first ? "" : ",") << key[i];
+  return field.str();
+}
+} // namespace
+
+void
+SensitivityImageCache::SetMemoryBudget(itk::SizeValueType budget)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  if (m_MemoryBudget == budget)
+    return;
+  m_MemoryBudget = budget;
+  this->Evict(m_MemoryBudget);
+  this->Modified();
+}
+
+itk::DataObject::Pointer
+SensitivityImageCache::Find(const KeyType & key)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  for (auto it = m_Entries.begin(); it != m_Entries.end(); ++it)
+  {
+    if (it->Key == key)
+    {
+      // Most recently used entries are kept at the front
+      m_Entries.splice(m_Entries.begin(), m_Entries, it);
+      return m_Entries.front().Image;
+    }
+  }
+  return nullptr;
+}
+
+void
+SensitivityImageCache::Insert(const KeyType & key, itk::DataObject * image, itk::SizeValueType size)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  if (size > m_MemoryBudget)
+    return;
+  for (const Entry & entry : m_Entries)
+    if (entry.Key == key)
+      return;
+
+  this->Evict(m_MemoryBudget - size);
+  m_Entries.push_front({ key, image, size });
+  m_MemoryUsage += size;
+}
+
+std::string
+SensitivityImageCache::GetFileName(const KeyType & key) const
+{
+  if (m_Directory.empty())
+    return std::string();
+
+  // 64-bit FNV-1a hash of the key
+  std::uint64_t hash = 14695981039346656037ULL;
+  for (double value : key)
+  {
+    unsigned char bytes[sizeof(double)];
+    std::memcpy(bytes, &value, sizeof(double));
+    for (unsigned char byte : bytes)
+    {
+      hash ^= byte;
+      hash *= 1099511628211ULL;
+    }
+  }
+
+  std::ostringstream fileName;
+  fileName << m_Directory << "/rtksensitivity_" << std::hex << std::setw(16) << std::setfill('0') << hash << ".mha";
+  return fileName.str();
+}
+
+void
+SensitivityImageCache::AppendGeometry(KeyType &                                key,
+                                      const ThreeDCircularProjectionGeometry * geometry,
+                                      const std::vector<unsigned int> &        projections)
+{
+  key.push_back(geometry->GetRadiusCylindricalDetector());
+  for (unsigned int p : projections)
+  {
+    // The projection matrix and the source position describe the rays
+    const ThreeDCircularProjectionGeometry::HomogeneousProjectionMatrixType & matrix = geometry->GetMatrices()[p];
+    for (unsigned int i = 0; i < 3; i++)
+      for (unsigned int j = 0; j < 4; j++)
+        key.push_back(matrix[i][j]);
+    const ThreeDCircularProjectionGeometry::HomogeneousVectorType source = geometry->GetSourcePosition(p);
+    for (unsigned int i = 0; i < 3; i++)
+      key.push_back(source[i]);
+    key.push_back(geometry->GetCollimationUInf()[p]);
+    key.push_back(geometry->GetCollimationUSup()[p]);
+    key.push_back(geometry->GetCollimationVInf()[p]);
+    key.push_back(geometry->GetCollimationVSup()[p]);
+  }
+}
+
+void
+SensitivityImageCache::EncapsulateKey(itk::MetaDataDictionary & dictionary, const KeyType & key)
+{
+  itk::EncapsulateMetaData<std::string>(dictionary, KeyPrefix + "Version", KeyVersion);
+  itk::EncapsulateMetaData<std::string>(dictionary, KeyPrefix + "Size", std::to_string(key.size()));
+  for (unsigned int i = 0; i < key.size(); i += NumberOfKeyValuesPerField)
+    itk::EncapsulateMetaData<std::string>(
+      dictionary, KeyPrefix + std::to_string(i / NumberOfKeyValuesPerField), GetKeyField(key, i));
+}
+
+bool
+SensitivityImageCache::IsKeyOfDictionary(const itk::MetaDataDictionary & dictionary, const KeyType & key)
+{
+  std::string value;
+  if (!itk::ExposeMetaData<std::string>(dictionary, KeyPrefix + "Version", value) || value != KeyVersion)
+    return false;
+  if (!itk::ExposeMetaData<std::string>(dictionary, KeyPrefix + "Size", value) || value != std::to_string(key.size()))
+    return false;
+  for (unsigned int i = 0; i < key.size(); i += NumberOfKeyValuesPerField)
+  {
+    const std::string name = KeyPrefix + std::to_string(i / NumberOfKeyValuesPerField);
+    if (!itk::ExposeMetaData<std::string>(dictionary, name, value) || value != GetKeyField(key, i))
+      return false;
+  }
+  return true;
+}
+
+std::string
+SensitivityImageCache::GetTemporaryFileName(const std::string & fileName)
+{
+  static std::atomic<unsigned long> counter(0);
+  std::ostringstream                tmpFileName;
+  tmpFileName << fileName.substr(0, fileName.size() - 4) << "_tmp" << RTK_GETPID() << "_" << counter++ << ".mha";
+  return tmpFileName.str();
+}
+
+void
+SensitivityImageCache::Evict(itk::SizeValueType budget)
+{
+  while (!m_Entries.empty() && m_MemoryUsage > budget)
+  {
+    m_MemoryUsage -= m_Entries.back().Size;
+    m_Entries.pop_back();
+  }
+}
+
+unsigned int
+SensitivityImageCache::GetNumberOfEntries() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_Entries.size();
+}
+
+itk::SizeValueType
+SensitivityImageCache::GetMemoryUsage() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_MemoryUsage;
+}
+
+void
+SensitivityImageCache::Clear()
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_Entries.clear();
+  m_MemoryUsage = 0;
+}
+
+void
+SensitivityImageCache::PrintSelf(std::ostream & os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "MemoryBudget: " << m_MemoryBudget << std::endl;
+  os << indent << "MemoryUsage: " << this->GetMemoryUsage() << std::endl;
+  os << indent << "NumberOfEntries: " << this->GetNumberOfEntries() << std::endl;
+  os << indent << "Directory: " << m_Directory << std::endl;
+}
+
+} // end namespace rtk
@@ -0,0 +1,202 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "rtkSpectralDecompositionLookupTable.h"
+
+#include <itkMacro.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace rtk
+{
+
+namespace
+{
+const char         LookupTableMagic[8] = { 'R', 'T', 'K', 'S', 'D', 'L', 'U', 'T' };
+const unsigned int LookupTableVersion = 1;
+} // namespace
+
+SpectralDecompositionLookupTable::KeyType
+SpectralDecompositionLookupTable ::HashValues(const double * values, size_t n, KeyType key)
+{
+  // FNV-1a hash of the bytes of the values
+  const auto * bytes = reinterpret_cast<const unsigned char *>(values);
+  for (size_t i = 0; i < n * sizeof(double); i++)
+  {
+    key ^= bytes[i];
+    key *= 1099511628211ULL;
+  }
+  return key;
+}
+
+SpectralDecompositionLookupTable::NodeIndexType
+SpectralDecompositionLookupTable ::GetNumberOfGridNodes() const
+{
+  NodeIndexType n = 1;
+  for (unsigned int b = 0; b < m_NumberOfSpectralBins; b++)
+    n *= m_NumberOfNodes;
+  return n;
+}
+
+void
+SpectralDecompositionLookupTable ::Allocate()
+{
+  if (m_NumberOfNodes < 2)
+    itkExceptionMacro(<< "The lookup table requires at least 2 nodes per bin, got " << m_NumberOfNodes);
+
+  // Guard against the exponential growth of the grid with the number of bins
+  const double numberOfValues = std::pow(double(m_NumberOfNodes), double(m_NumberOfSpectralBins)) * m_NumberOfMaterials;
+  if (numberOfValues > double(1 << 30))
+    itkExceptionMacro(<< "Lookup table with " << m_NumberOfNodes << "^" << m_NumberOfSpectralBins
+                      << " nodes is too large, reduce the number of nodes or use the simplex optimization");
+
+  m_Table.assign(GetNumberOfGridNodes() * m_NumberOfMaterials, 0.f);
+}
+
+void
+SpectralDecompositionLookupTable ::GetNodeMeasurement(NodeIndexType node, MeasurementType & logTransforms) const
+{
+  const double step = m_MaximumLogTransform / (m_NumberOfNodes - 1);
+  logTransforms.SetSize(m_NumberOfSpectralBins);
+  for (unsigned int b = 0; b < m_NumberOfSpectralBins; b++)
+  {
+    logTransforms[b] = (node % m_NumberOfNodes) * step;
+    node /= m_NumberOfNodes;
+  }
+}
+
+void
+SpectralDecompositionLookupTable ::SetNodeDecomposition(NodeIndexType node, const DecompositionType & decomposition)
+{
+  for (unsigned int m = 0; m < m_NumberOfMaterials; m++)
+    m_Table[node * m_NumberOfMaterials + m] = decomposition[m];
+}
+
+void
+SpectralDecompositionLookupTable ::Interpolate(const MeasurementType & logTransforms,
+                                               DecompositionType &     decomposition) const
+{
+  // Lower corner of the grid cell and interpolation weights along each bin
+  std::vector<NodeIndexType> lower(m_NumberOfSpectralBins);
+  std::vector<double>        frac(m_NumberOfSpectralBins);
+  NodeIndexType              stride = 1;
+  NodeIndexType              base = 0;
+  std::vector<NodeIndexType> strides(m_NumberOfSpectralBins);
+  const double               invStep = (m_NumberOfNodes - 1) / m_MaximumLogTransform;
+  for (unsigned int b = 0; b < m_NumberOfSpectralBins; b++)
+  {
+    double c = std::min(std::max(logTransforms[b] * invStep, 0.), double(m_NumberOfNodes - 1));
+    lower[b] = std::min(NodeIndexType(c), NodeIndexType(m_NumberOfNodes - 2));
+    frac[b] = c - lower[b];
+    strides[b] = stride;
+    base += lower[b] * stride;
+    stride *= m_NumberOfNodes;
+  }
+
+  decomposition.SetSize(m_NumberOfMaterials);
+  decomposition.Fill(0.);
+  for (unsigned int corner = 0; corner < (1u << m_NumberOfSpectralBins); corner++)
+  {
+    double        w = 1.;
+    NodeIndexType node = base;
+    for (unsigned int b = 0; b < m_NumberOfSpectralBins; b++)
+    {
+      if (corner & (1u << b))
+      {
+        w *= frac[b];
+        node += strides[b];
+      }
+      else
+        w *= 1. - frac[b];
+    }
+    if (w == 0.)
+      continue;
+    const float * values = &(m_Table[node * m_NumberOfMaterials]);
+    for (unsigned int m = 0; m < m_NumberOfMaterials; m++)
+      decomposition[m] += w * values[m];
+  }
+}
+
+bool
+SpectralDecompositionLookupTable ::Read(const std::string & fileName)
+{
+  std::ifstream is(fileName.c_str(), std::ios::in | std::ios::binary);
+  if (!is.is_open())
+    return false;
+
+  char         magic[8];
+  unsigned int version = 0, nBins = 0, nMaterials = 0, nNodes = 0;
+  double       maximum = 0.;
+  KeyType      key = 0;
+  is.read(magic, sizeof(magic));
+  is.read(reinterpret_cast<char *>(&version), sizeof(version));
+  is.read(reinterpret_cast<char *>(&key), sizeof(key));
+  is.read(reinterpret_cast<char *>(&nBins), sizeof(nBins));
+  is.read(reinterpret_cast<char *>(&nMaterials), sizeof(nMaterials));
+  is.read(reinterpret_cast<char *>(&nNodes), sizeof(nNodes));
+  is.read(reinterpret_cast<char *>(&maximum), sizeof(maximum));
+  if (!is || std::memcmp(magic, LookupTableMagic, sizeof(magic)) || version != LookupTableVersion ||
+      key != m_Key || nBins != m_NumberOfSpectralBins || nMaterials != m_NumberOfMaterials ||
+      nNodes != m_NumberOfNodes || maximum != m_MaximumLogTransform)
+  {
+    itkDebugMacro(<< "Lookup table file " << fileName << " does not match the current parameters");
+    return false;
+  }
+
+  std::vector<float> table(GetNumberOfGridNodes() * m_NumberOfMaterials);
+  is.read(reinterpret_cast<char *>(table.data()), table.size() * sizeof(float));
+  if (!is)
+    return false;
+  m_Table.swap(table);
+  return true;
+}
+
+void
+SpectralDecompositionLookupTable ::Write(const std::string & fileName) const
+{
+  std::ofstream os(fileName.c_str(), std::ios::out | std::ios::binary);
+  if (!os.is_open())
+    itkExceptionMacro(<< "Could not open " << fileName << " for writing");
+
+  os.write(LookupTableMagic, sizeof(LookupTableMagic));
+  os.write(reinterpret_cast<const char *>(&LookupTableVersion), sizeof(LookupTableVersion));
+  os.write(reinterpret_cast<const char *>(&m_Key), sizeof(m_Key));
+  os.write(reinterpret_cast<const char *>(&m_NumberOfSpectralBins), sizeof(m_NumberOfSpectralBins));
+  os.write(reinterpret_cast<const char *>(&m_NumberOfMaterials), sizeof(m_NumberOfMaterials));
+  os.write(reinterpret_cast<const char *>(&m_NumberOfNodes), sizeof(m_NumberOfNodes));
+  os.write(reinterpret_cast<const char *>(&m_MaximumLogTransform), sizeof(m_MaximumLogTransform));
+  os.write(reinterpret_cast<const char *>(m_Table.data()), m_Table.size() * sizeof(float));
+  if (!os)
+    itkExceptionMacro(<< "Error while writing lookup table to " << fileName);
+}
+
+void
+SpectralDecompositionLookupTable ::PrintSelf(std::ostream & os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfSpectralBins: " << m_NumberOfSpectralBins << std::endl;
+  os << indent << "NumberOfMaterials: " << m_NumberOfMaterials << std::endl;
+  os << indent << "NumberOfNodes: " << m_NumberOfNodes << std::endl;
+  os << indent << "MaximumLogTransform: " << m_MaximumLogTransform << std::endl;
+  os << indent << "Key: " << m_Key << std::endl;
+}
+
+} // namespace rtk
@@ -24,35 +24,50 @@ WatcherForResourceProbe ::WatcherForResourceProbe(ProcessObject * o)
 {
   // Initialize state
   m_Process = o;
+  m_Instance = rtk::GlobalResourceProbe::GetInstance()->GetNewTraceInstance();
 
   // Create a series of commands
   m_StartFilterCommand = CommandType::New();
   m_EndFilterCommand = CommandType::New();
   m_DeleteFilterCommand = CommandType::New();
+  m_IterationFilterCommand = CommandType::New();
 
   // Assign the callbacks
   m_StartFilterCommand->SetCallbackFunction(this, &WatcherForResourceProbe::StartFilter);
   m_EndFilterCommand->SetCallbackFunction(this, &WatcherForResourceProbe::EndFilter);
   m_DeleteFilterCommand->SetCallbackFunction(this, &WatcherForResourceProbe::DeleteFilter);
+  m_IterationFilterCommand->SetCallbackFunction(this, &WatcherForResourceProbe::IterationFilter);
 
   // Add the commands as observers
   m_StartTag = m_Process->AddObserver(StartEvent(), m_StartFilterCommand);
   m_EndTag = m_Process->AddObserver(EndEvent(), m_EndFilterCommand);
   m_DeleteTag = m_Process->AddObserver(DeleteEvent(), m_DeleteFilterCommand);
+  m_IterationTag = m_Process->AddObserver(IterationEvent(), m_IterationFilterCommand);
 }
 
 void
 WatcherForResourceProbe ::StartFilter()
 {
   rtk::GlobalResourceProbe::GetInstance()->Start(m_Process->GetNameOfClass());
+  if (rtk::GlobalResourceProbe::GetInstance()->GetTracing())
+    rtk::GlobalResourceProbe::GetInstance()->StartTrace(m_Process, m_Instance);
 }
 
 void
 WatcherForResourceProbe ::EndFilter()
 {
+  if (rtk::GlobalResourceProbe::GetInstance()->GetTracing())
+    rtk::GlobalResourceProbe::GetInstance()->StopTrace(m_Process);
   rtk::GlobalResourceProbe::GetInstance()->Stop(m_Process->GetNameOfClass());
 }
 
+void
+WatcherForResourceProbe ::IterationFilter()
+{
+  if (rtk::GlobalResourceProbe::GetInstance()->GetTracing())
+    rtk::GlobalResourceProbe::GetInstance()->IterationTrace(m_Process);
+}
+
 void
 WatcherForResourceProbe ::DeleteFilter()
 {
@@ -68,6 +83,10 @@ WatcherForResourceProbe ::DeleteFilter()
   {
     m_Process->RemoveObserver(m_DeleteTag);
   }
+  if (m_IterationFilterCommand)
+  {
+    m_Process->RemoveObserver(m_IterationTag);
+  }
   rtk::GlobalResourceProbe::GetInstance()->Remove(this);
 }
 
@@ -88,6 +107,10 @@ WatcherForResourceProbe ::WatcherForResourceProbe(const WatcherForResourceProbe
     {
       m_Process->RemoveObserver(m_DeleteTag);
     }
+    if (m_IterationFilterCommand)
+    {
+      m_Process->RemoveObserver(m_IterationTag);
+    }
   }
 
   // Initialize state
@@ -95,6 +118,8 @@ WatcherForResourceProbe ::WatcherForResourceProbe(const WatcherForResourceProbe
   m_StartTag = 0;
   m_EndTag = 0;
   m_DeleteTag = 0;
+  m_IterationTag = 0;
+  m_Instance = watch.m_Instance;
 
   // Create a series of commands
   if (m_Process)
@@ -102,16 +127,19 @@ WatcherForResourceProbe ::WatcherForResourceProbe(const WatcherForResourceProbe
     m_StartFilterCommand = CommandType::New();
     m_EndFilterCommand = CommandType::New();
     m_DeleteFilterCommand = CommandType::New();
+    m_IterationFilterCommand = CommandType::New();
 
     // Assign the callbacks
     m_StartFilterCommand->SetCallbackFunction(this, &WatcherForResourceProbe::StartFilter);
     m_EndFilterCommand->SetCallbackFunction(this, &WatcherForResourceProbe::EndFilter);
     m_DeleteFilterCommand->SetCallbackFunction(this, &WatcherForResourceProbe::DeleteFilter);
+    m_IterationFilterCommand->SetCallbackFunction(this, &WatcherForResourceProbe::IterationFilter);
 
     // Add the commands as observers
     m_StartTag = m_Process->AddObserver(StartEvent(), m_StartFilterCommand);
     m_EndTag = m_Process->AddObserver(EndEvent(), m_EndFilterCommand);
     m_DeleteTag = m_Process->AddObserver(DeleteEvent(), m_DeleteFilterCommand);
+    m_IterationTag = m_Process->AddObserver(IterationEvent(), m_IterationFilterCommand);
   }
 }
 
@@ -135,6 +163,10 @@ WatcherForResourceProbe ::operator=(const WatcherForResourceProbe & watch)
       {
         m_Process->RemoveObserver(m_DeleteTag);
       }
+      if (m_IterationFilterCommand)
+      {
+        m_Process->RemoveObserver(m_IterationTag);
+      }
     }
 
     // Initialize state
@@ -143,6 +175,8 @@ WatcherForResourceProbe ::operator=(const WatcherForResourceProbe & watch)
     m_StartTag = 0;
     m_EndTag = 0;
     m_DeleteTag = 0;
+    m_IterationTag = 0;
+    m_Instance = watch.m_Instance;
 
     // Create a series of commands
     if (m_Process)
@@ -150,16 +184,19 @@ WatcherForResourceProbe ::operator=(const WatcherForResourceProbe & watch)
       m_StartFilterCommand = CommandType::New();
       m_EndFilterCommand = CommandType::New();
       m_DeleteFilterCommand = CommandType::New();
+      m_IterationFilterCommand = CommandType::New();
 
       // Assign the callbacks
       m_StartFilterCommand->SetCallbackFunction(this, &WatcherForResourceProbe::StartFilter);
       m_EndFilterCommand->SetCallbackFunction(this, &WatcherForResourceProbe::EndFilter);
       m_DeleteFilterCommand->SetCallbackFunction(this, &WatcherForResourceProbe::DeleteFilter);
+      m_IterationFilterCommand->SetCallbackFunction(this, &WatcherForResourceProbe::IterationFilter);
 
       // Add the commands as observers
       m_StartTag = m_Process->AddObserver(StartEvent(), m_StartFilterCommand);
       m_EndTag = m_Process->AddObserver(EndEvent(), m_EndFilterCommand);
       m_DeleteTag = m_Process->AddObserver(DeleteEvent(), m_DeleteFilterCommand);
+      m_IterationTag = m_Process->AddObserver(IterationEvent(), m_IterationFilterCommand);
     }
   }
   return *this;
@@ -0,0 +1,143 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "rtkZengAttenuationCache.h"
+
+#include <itkMath.h>
+
+namespace rtk
+{
+
+void
+ZengAttenuationCache::SetMemoryBudget(itk::SizeValueType budget)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  if (m_MemoryBudget == budget)
+    return;
+  m_MemoryBudget = budget;
+  this->Evict(m_MemoryBudget);
+  this->Modified();
+}
+
+bool
+ZengAttenuationCache::Matches(const Entry &       entry,
+                              const itk::Object * attenuationMap,
+                              const RegionType &  region,
+                              const MatrixType &  matrix) const
+{
+  if (entry.AttenuationMap != attenuationMap || entry.AttenuationMapTime != attenuationMap->GetMTime() ||
+      entry.Region != region)
+    return false;
+  for (unsigned int i = 0; i < 3; i++)
+    for (unsigned int j = 0; j < 4; j++)
+      if (itk::Math::abs(entry.Matrix[i][j] - matrix[i][j]) > 1e-9 * (1. + itk::Math::abs(matrix[i][j])))
+        return false;
+  return true;
+}
+
+ZengAttenuationCache::FactorsPointer
+ZengAttenuationCache::Find(const itk::Object * attenuationMap, const RegionType & region, const MatrixType & matrix)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  for (auto it = m_Entries.begin(); it != m_Entries.end(); ++it)
+  {
+    if (this->Matches(*it, attenuationMap, region, matrix))
+    {
+      // Most recently used entries are kept at the front
+      m_Entries.splice(m_Entries.begin(), m_Entries, it);
+      return m_Entries.front().Factors;
+    }
+  }
+  return nullptr;
+}
+
+void
+ZengAttenuationCache::Insert(const itk::Object * attenuationMap,
+                             const RegionType &  region,
+                             const MatrixType &  matrix,
+                             FactorsPointer      factors)
+{
+  const itk::SizeValueType size = factors->size() * sizeof(FactorsType::value_type);
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  if (size > m_MemoryBudget)
+    return;
+
+  // Entries of another attenuation map, or of a modified one, are obsolete
+  for (auto it = m_Entries.begin(); it != m_Entries.end();)
+  {
+    if (it->AttenuationMap != attenuationMap || it->AttenuationMapTime != attenuationMap->GetMTime())
+    {
+      m_MemoryUsage -= it->Factors->size() * sizeof(FactorsType::value_type);
+      it = m_Entries.erase(it);
+    }
+    else
+    {
+      if (this->Matches(*it, attenuationMap, region, matrix))
+        return;
+      ++it;
+    }
+  }
+
+  this->Evict(m_MemoryBudget - size);
+  m_Entries.push_front({ attenuationMap, attenuationMap->GetMTime(), region, matrix, factors });
+  m_MemoryUsage += size;
+}
+
+void
+ZengAttenuationCache::Evict(itk::SizeValueType budget)
+{
+  while (!m_Entries.empty() && m_MemoryUsage > budget)
+  {
+    m_MemoryUsage -= m_Entries.back().Factors->size() * sizeof(FactorsType::value_type);
+    m_Entries.pop_back();
+  }
+}
+
+unsigned int
+ZengAttenuationCache::GetNumberOfEntries() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_Entries.size();
+}
+
+itk::SizeValueType
+ZengAttenuationCache::GetMemoryUsage() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_MemoryUsage;
+}
+
+void
+ZengAttenuationCache::Clear()
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_Entries.clear();
+  m_MemoryUsage = 0;
+}
+
+void
+ZengAttenuationCache::PrintSelf(std::ostream & os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "MemoryBudget: " << m_MemoryBudget << std::endl;
+  os << indent << "MemoryUsage: " << this->GetMemoryUsage() << std::endl;
+  os << indent << "NumberOfEntries: " << this->GetNumberOfEntries() << std::endl;
+}
+
+} // end namespace rtk
@@ -299,6 +299,28 @@ main(int, char **)
       randomVolumeSource->GetOutput(), attbp->GetOutput(), randomProjectionsSource->GetOutput(), attfw->GetOutput());
     std::cout << "\n\nTest PASSED! " << std::endl;
 
+    std::cout << "\n\n****** Attenuated Joseph Back projector with cached weights ******" << std::endl;
+
+    // The first update records the weights, the second one replays them
+    rtk::JosephAttenuationCache::Pointer attenuationCache = rtk::JosephAttenuationCache::New();
+    attbp->SetAttenuationCache(attenuationCache);
+    for (unsigned int i = 0; i < 2; i++)
+    {
+      attbp->Modified();
+      TRY_AND_EXIT_ON_ITK_EXCEPTION(attbp->Update());
+
+      CheckScalarProducts<OutputImageType, OutputImageType>(
+        randomVolumeSource->GetOutput(), attbp->GetOutput(), randomProjectionsSource->GetOutput(), attfw->GetOutput());
+    }
+    if (attenuationCache->GetNumberOfEntries() != NumberOfProjectionImages)
+    {
+      std::cerr << "Test Failed, " << attenuationCache->GetNumberOfEntries() << " cached projections instead of "
+                << NumberOfProjectionImages << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    attbp->SetAttenuationCache(nullptr);
+    std::cout << "\n\nTest PASSED! " << std::endl;
+
 #ifdef USE_CUDA
     std::cout << "\n\n****** Cuda Ray Cast Forward projector ******" << std::endl;
 
@@ -356,6 +378,15 @@ main(int, char **)
     randomVolumeSource->GetOutput(), zbp->GetOutput(), randomProjectionsSource->GetOutput(), zfw->GetOutput());
   std::cout << "\n\nTest PASSED! " << std::endl;
 
+  std::cout << "\n\n****** Zeng Back projector, one rotated volume at a time ******" << std::endl;
+
+  zbp->SetMaximumRotatedVolumesMemory(1);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(zbp->Update());
+
+  CheckScalarProducts<OutputImageType, OutputImageType>(
+    randomVolumeSource->GetOutput(), zbp->GetOutput(), randomProjectionsSource->GetOutput(), zfw->GetOutput());
+  std::cout << "\n\nTest PASSED! " << std::endl;
+
   std::cout << "\n\n******  Attenuated Zeng Forward projector ******" << std::endl;
 
   using ZengForwardProjectorType = rtk::ZengForwardProjectionImageFilter<OutputImageType, OutputImageType>;
@@ -166,6 +166,45 @@ main(int argc, char * argv[])
   CheckImageQuality<OutputImageType>(admmtotalvariation->GetOutput(), dsl->GetOutput(), 0.05, 23, 2.0);
   std::cout << "\n\nTest PASSED! " << std::endl;
 
+  std::cout << "\n\n****** Case 2b: Joseph Backprojector with a memory cap ******" << std::endl;
+
+  // The intermediate images with a single consumer are released, which must
+  // lower the peak
+  const itk::SizeValueType peak = admmtotalvariation->GetMemoryPlanner()->GetPredictedPeak();
+  const itk::SizeValueType poolSize = admmtotalvariation->GetMemoryPlanner()->GetPoolSize();
+  const unsigned int       nBuffers = admmtotalvariation->GetMemoryPlanner()->GetNumberOfBuffers();
+  admmtotalvariation->SetMemoryCap(1);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(admmtotalvariation->Update());
+  const itk::SizeValueType cappedPeak = admmtotalvariation->GetMemoryPlanner()->GetPredictedPeak();
+  if (peak == 0 || cappedPeak >= peak)
+  {
+    std::cerr << "Test Failed, predicted memory peak of " << cappedPeak << " bytes with a memory cap and of " << peak
+              << " bytes without." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  CheckImageQuality<OutputImageType>(admmtotalvariation->GetOutput(), dsl->GetOutput(), 0.05, 23, 2.0);
+
+  // Without cap, the flags are restored and the plan is the initial one
+  admmtotalvariation->SetMemoryCap(0);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(admmtotalvariation->Update());
+  if (admmtotalvariation->GetMemoryPlanner()->GetPredictedPeak() != peak)
+  {
+    std::cerr << "Test Failed, predicted memory peak of " << admmtotalvariation->GetMemoryPlanner()->GetPredictedPeak()
+              << " bytes after the removal of the memory cap instead of " << peak << " bytes." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  if (admmtotalvariation->GetMemoryPlanner()->GetPoolSize() != poolSize ||
+      admmtotalvariation->GetMemoryPlanner()->GetNumberOfBuffers() != nBuffers)
+  {
+    std::cerr << "Test Failed, pool of " << admmtotalvariation->GetMemoryPlanner()->GetNumberOfBuffers()
+              << " buffers and " << admmtotalvariation->GetMemoryPlanner()->GetPoolSize()
+              << " bytes after the removal of the memory cap instead of " << nBuffers << " buffers and " << poolSize
+              << " bytes." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  CheckImageQuality<OutputImageType>(admmtotalvariation->GetOutput(), dsl->GetOutput(), 0.05, 23, 2.0);
+  std::cout << "\n\nTest PASSED! " << std::endl;
+
 #ifdef USE_CUDA
   std::cout << "\n\n****** Case 3: CUDA Voxel-Based Backprojector and CUDA Forward projector ******" << std::endl;
 
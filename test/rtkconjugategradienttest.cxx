@@ -8,6 +8,7 @@
 #include "rtkMacro.h"
 #include "rtkForwardDifferenceGradientImageFilter.h"
 #include "rtkBackwardDifferenceDivergenceImageFilter.h"
+#include "rtkReducedPrecisionConverter.h"
 
 
 template <class TImage1, class TImage2>
@@ -80,6 +81,64 @@ CheckImageQuality(typename TImage1::Pointer recon, typename TImage2::Pointer ref
 }
 #endif
 
+void
+CheckReducedPrecisionConversions()
+{
+  // Every finite float16 and bfloat16 value must be represented exactly
+  for (unsigned int i = 0; i < 65536; i++)
+  {
+    const auto  value = static_cast<std::uint16_t>(i);
+    const float half = rtk::HalfToFloat(value);
+    const float bfloat = rtk::BFloat16ToFloat(value);
+    if ((!std::isnan(half) && rtk::FloatToHalf(half) != value) ||
+        (!std::isnan(bfloat) && rtk::FloatToBFloat16(bfloat) != value))
+    {
+      std::cerr << "Test Failed, 16-bit value " << i << " does not round trip" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  // The relative rounding error is at most half a unit in the last place
+  rtk::ReducedPrecisionConverter half(rtk::ReducedPrecisionConverter::FLOAT16);
+  rtk::ReducedPrecisionConverter bfloat(rtk::ReducedPrecisionConverter::BFLOAT16);
+  for (float value = 6.1035156e-5f; value < 65504.f; value *= 1.0001f)
+  {
+    if (std::abs(half.Decode(half.Encode(value)) - value) > value * std::pow(2.f, -11.f) ||
+        std::abs(bfloat.Decode(bfloat.Encode(-value)) + value) > value * std::pow(2.f, -8.f))
+    {
+      std::cerr << "Test Failed, rounding error of " << value << " too large" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+  }
+  if (half.Encode(1e6f) != 0x7bff || !std::isinf(rtk::HalfToFloat(rtk::FloatToHalf(1e6f))))
+  {
+    std::cerr << "Test Failed, float16 overflow not handled" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+template <class TImage>
+void
+CheckReducedPrecisionAccuracy(typename TImage::Pointer recon, typename TImage::Pointer ref, double tolerance)
+{
+  itk::ImageRegionConstIterator<TImage> itTest(recon, recon->GetBufferedRegion());
+  itk::ImageRegionConstIterator<TImage> itRef(ref, ref->GetBufferedRegion());
+  double                                squaredError = 0.;
+  while (!itRef.IsAtEnd())
+  {
+    squaredError += std::pow(double(itTest.Get() - itRef.Get()), 2.);
+    ++itTest;
+    ++itRef;
+  }
+  const double rmse = std::sqrt(squaredError / ref->GetBufferedRegion().GetNumberOfPixels());
+  std::cout << "RMSE to the full precision result = " << rmse << std::endl;
+  if (rmse > tolerance)
+  {
+    std::cerr << "Test Failed, RMSE not valid! " << rmse << " instead of " << tolerance << std::endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
 /**
  * \file rtkconjugategradienttest.cxx
  *
@@ -98,6 +157,8 @@ CheckImageQuality(typename TImage1::Pointer recon, typename TImage2::Pointer ref
  * A = div(grad(.))
  * X = f
  * B = div(g)
+ * The same problem is then solved with the residual stored in float16 and
+ * bfloat16 and the results are compared to the full precision one.
  *
  *
  * \author Cyril Mory
@@ -193,5 +254,26 @@ main(int, char **)
 
   std::cout << "\n\nTest PASSED! " << std::endl;
 
+  std::cout << "\n\n****** Reduced precision conversions ******" << std::endl;
+  CheckReducedPrecisionConversions();
+  std::cout << "\n\nTest PASSED! " << std::endl;
+
+  OutputImageType::Pointer fullPrecision = cg->GetOutput();
+  fullPrecision->DisconnectPipeline();
+
+  std::cout << "\n\n****** Residual stored in float16 ******" << std::endl;
+  cg->SetStoragePrecision(rtk::ReducedPrecisionConverter::FLOAT16);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(cg->Update());
+  CheckImageQuality<OutputImageType, OutputImageType>(cg->GetOutput(), randomVolumeSource->GetOutput());
+  CheckReducedPrecisionAccuracy<OutputImageType>(cg->GetOutput(), fullPrecision, 0.02);
+  std::cout << "\n\nTest PASSED! " << std::endl;
+
+  std::cout << "\n\n****** Residual stored in bfloat16 ******" << std::endl;
+  cg->SetStoragePrecision(rtk::ReducedPrecisionConverter::BFLOAT16);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(cg->Update());
+  CheckImageQuality<OutputImageType, OutputImageType>(cg->GetOutput(), randomVolumeSource->GetOutput());
+  CheckReducedPrecisionAccuracy<OutputImageType>(cg->GetOutput(), fullPrecision, 0.1);
+  std::cout << "\n\nTest PASSED! " << std::endl;
+
   return EXIT_SUCCESS;
 }
@@ -146,8 +146,32 @@ main(int, char **)
   CheckVectorImageQuality<DVFImageType>(cyclic->GetOutput(), cyclic->GetOutput(), 0.4, 12, 2.0);
   std::cout << "\n\nTest PASSED! " << std::endl;
 
+  std::cout << "\n\n****** Case 2: cached DVF stored in float16 ******" << std::endl;
+
+  DVFImageType::Pointer fullPrecision = cyclic->GetOutput();
+  fullPrecision->DisconnectPipeline();
+
+  cyclic = CyclicDeformationType::New();
+  cyclic->SetInput(deformationField);
+  cyclic->SetSignalFilename(signalFileName);
+  cyclic->SetCacheMemoryBudget(1024 * 1024 * 1024);
+  cyclic->SetCachePrecision(rtk::ReducedPrecisionConverter::FLOAT16);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(cyclic->Update());
+
+  // The second update widens the cached DVF
+  cyclic->Modified();
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(cyclic->Update());
+  if (cyclic->GetNumberOfCachedFields() != 1)
+  {
+    std::cerr << "Test Failed, " << cyclic->GetNumberOfCachedFields() << " cached DVFs instead of 1" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  CheckVectorImageQuality<DVFImageType>(cyclic->GetOutput(), fullPrecision, 0.01, 40, 2.0);
+  std::cout << "\n\nTest PASSED! " << std::endl;
+
 #ifdef USE_CUDA
-  std::cout << "\n\n****** Case 2: GPU cyclic deformation field ******" << std::endl;
+  std::cout << "\n\n****** Case 3: GPU cyclic deformation field ******" << std::endl;
 
   cyclic = rtk::CudaCyclicDeformationImageFilter::New();
   cyclic->SetInput(deformationField);
@@ -6,6 +6,7 @@
 #include "rtkConstantImageSource.h"
 #include "rtkRayEllipsoidIntersectionImageFilter.h"
 #include <itkImageFileReader.h>
+#include <itksys/SystemTools.hxx>
 
 /**
  * \file rtkdecomposespectralprojectionstest.cxx
@@ -225,6 +226,99 @@ main(int argc, char * argv[])
   TRY_AND_EXIT_ON_ITK_EXCEPTION(simplex->Update())
   CheckVectorImageQuality<DecomposedProjectionType>(simplex->GetOutput(), decomposed, 0.0001, 15, 2.0);
 
+  // Largest absolute difference with the reference decomposition
+  auto maximumError = [&decomposed](DecomposedProjectionType * image) {
+    itk::ImageRegionConstIterator<DecomposedProjectionType> refIt(decomposed, decomposed->GetLargestPossibleRegion());
+    itk::ImageRegionConstIterator<DecomposedProjectionType> imgIt(image, image->GetLargestPossibleRegion());
+    double                                                  error = 0.;
+    for (; !refIt.IsAtEnd(); ++refIt, ++imgIt)
+      for (unsigned int m = 0; m < 3; m++)
+        error = std::max(error, itk::Math::abs(double(refIt.Get()[m]) - double(imgIt.Get()[m])));
+    return error;
+  };
+
+  std::cout << "\n\n****** Case 3: Lookup table with and without Newton refinement ******" << std::endl;
+
+  const std::string lutFileName("rtkdecomposespectralprojectionstest.lut");
+  itksys::SystemTools::RemoveFile(lutFileName);
+  simplex->SetUseLookupTable(true);
+  simplex->SetLookupTableNumberOfNodes(3);
+  simplex->SetLookupTableMaximumLogTransform(1.);
+  simplex->SetLookupTableFileName(lutFileName);
+  simplex->SetNumberOfNewtonIterations(0);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(simplex->Update())
+  const double interpolationError = maximumError(simplex->GetOutput());
+  simplex->SetNumberOfNewtonIterations(10);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(simplex->Update())
+  const double newtonError = maximumError(simplex->GetOutput());
+  std::cout << "Maximum error without Newton refinement: " << interpolationError
+            << ", with Newton refinement: " << newtonError << std::endl;
+#if !FAST_TESTS_NO_CHECKS
+  if (!(newtonError < interpolationError))
+  {
+    std::cerr << "Test Failed, the Newton refinement does not improve the interpolated decomposition" << std::endl;
+    return EXIT_FAILURE;
+  }
+#endif
+  CheckVectorImageQuality<DecomposedProjectionType>(simplex->GetOutput(), decomposed, 0.0001, 15, 2.0);
+
+  std::cout << "\n\n****** Case 4: Lookup table file round trip ******" << std::endl;
+
+  // The table written by case 3 is read with the key of the filter and
+  // rejected with another key
+  using LookupTableType = SimplexFilterType::LookupTableType;
+  const LookupTableType * written = simplex->GetLookupTable();
+  LookupTableType::Pointer read = LookupTableType::New();
+  read->SetNumberOfSpectralBins(written->GetNumberOfSpectralBins());
+  read->SetNumberOfMaterials(written->GetNumberOfMaterials());
+  read->SetNumberOfNodes(written->GetNumberOfNodes());
+  read->SetMaximumLogTransform(written->GetMaximumLogTransform());
+  read->SetKey(written->GetKey() + 1);
+  if (read->Read(lutFileName))
+  {
+    std::cerr << "Test Failed, lookup table read with a wrong key" << std::endl;
+    return EXIT_FAILURE;
+  }
+  read->SetKey(written->GetKey());
+  if (!read->Read(lutFileName))
+  {
+    std::cerr << "Test Failed, could not read the lookup table " << lutFileName << std::endl;
+    return EXIT_FAILURE;
+  }
+  LookupTableType::MeasurementType logTransforms(written->GetNumberOfSpectralBins());
+  for (unsigned int i = 0; i < 10; i++)
+  {
+    for (unsigned int b = 0; b < written->GetNumberOfSpectralBins(); b++)
+      logTransforms[b] = 0.1 * ((i + b) % 10);
+    LookupTableType::DecompositionType writtenDecomposition, readDecomposition;
+    written->Interpolate(logTransforms, writtenDecomposition);
+    read->Interpolate(logTransforms, readDecomposition);
+    if (writtenDecomposition != readDecomposition)
+    {
+      std::cerr << "Test Failed, the lookup table read differs from the one written" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // A new filter uses the table of the file
+  SimplexFilterType::Pointer simplexFromFile = SimplexFilterType::New();
+  simplexFromFile->SetInputDecomposedProjections(initialDecomposedProjections);
+  simplexFromFile->SetInputMeasuredProjections(forward->GetOutput());
+  simplexFromFile->SetInputIncidentSpectrum(incidentSpectrumReader->GetOutput());
+  simplexFromFile->SetDetectorResponse(detectorResponseReader->GetOutput());
+  simplexFromFile->SetMaterialAttenuations(materialAttenuationsReader->GetOutput());
+  simplexFromFile->SetThresholds(thresholds);
+  simplexFromFile->SetNumberOfIterations(10000);
+  simplexFromFile->SetGuessInitialization(true);
+  simplexFromFile->SetUseLookupTable(true);
+  simplexFromFile->SetLookupTableNumberOfNodes(3);
+  simplexFromFile->SetLookupTableMaximumLogTransform(1.);
+  simplexFromFile->SetLookupTableFileName(lutFileName);
+  simplexFromFile->SetNumberOfNewtonIterations(10);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(simplexFromFile->Update())
+  CheckVectorImageQuality<DecomposedProjectionType>(
+    simplexFromFile->GetOutput(), simplex->GetOutput(), 1e-6, 100, 2.0);
+  itksys::SystemTools::RemoveFile(lutFileName);
 
   std::cout << "\n\nTest PASSED! " << std::endl;
   return EXIT_SUCCESS;
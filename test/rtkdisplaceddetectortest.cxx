@@ -1,5 +1,8 @@
 #include <itkImageRegionConstIterator.h>
 
+#include <algorithm>
+#include <cmath>
+
 #include "rtkTest.h"
 #include "rtkSheppLoganPhantomFilter.h"
 #include "rtkDrawSheppLoganFilter.h"
@@ -173,6 +176,59 @@ main(int, char **)
   TRY_AND_EXIT_ON_ITK_EXCEPTION(feldkamp->Update());
   CheckImageQuality<OutputImageType>(feldkamp->GetOutput(), dsl->GetOutput(), 0.061, 24, 2.0);
 
+#ifndef USE_CUDA
+  std::cout << "\n\n****** Case 6: displaced detector weights applied with the FDK weights ******" << std::endl;
+  feldkamp->SetInput(1, slp->GetOutput());
+  feldkamp->GetWeightFilter()->SetDisplacedDetectorFilter(DDFType::New());
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(feldkamp->Update());
+  CheckImageQuality<OutputImageType>(feldkamp->GetOutput(), dsl->GetOutput(), 0.061, 24, 2.0);
+
+  // The fused weights give the same projections as the displaced detector
+  // filter followed by the FDK weights up to the float rounding, with (current
+  // origin) and without (centered origin) zero padding
+  using WeightType = rtk::FDKWeightProjectionFilter<OutputImageType>;
+  for (double originX : { origin[0], -254. })
+  {
+    origin[0] = originX;
+    projectionsSource->SetOrigin(origin);
+
+    WeightType::Pointer baseline = WeightType::New();
+    baseline->SetInput(ddf->GetOutput());
+    baseline->SetGeometry(geometry);
+    TRY_AND_EXIT_ON_ITK_EXCEPTION(baseline->Update());
+
+    WeightType::Pointer fused = WeightType::New();
+    fused->SetInput(slp->GetOutput());
+    fused->SetGeometry(geometry);
+    fused->SetDisplacedDetectorFilter(DDFType::New());
+    fused->InPlaceOn();
+    TRY_AND_EXIT_ON_ITK_EXCEPTION(fused->Update());
+
+    if (fused->GetOutput()->GetLargestPossibleRegion() != baseline->GetOutput()->GetLargestPossibleRegion())
+    {
+      std::cerr << "Test Failed, the fused weights do not pad the projections as the displaced detector filter"
+                << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    using IteratorType = itk::ImageRegionConstIterator<OutputImageType>;
+    IteratorType itBaseline(baseline->GetOutput(), baseline->GetOutput()->GetBufferedRegion());
+    IteratorType itFused(fused->GetOutput(), fused->GetOutput()->GetBufferedRegion());
+    double       maximum = 0.;
+    double       difference = 0.;
+    for (; !itBaseline.IsAtEnd(); ++itBaseline, ++itFused)
+    {
+      maximum = std::max(maximum, std::abs(static_cast<double>(itBaseline.Get())));
+      difference = std::max(difference, std::abs(static_cast<double>(itBaseline.Get()) - itFused.Get()));
+    }
+    if (difference > 1e-5 * maximum)
+    {
+      std::cerr << "Test Failed, the fused and baseline weights differ by " << difference << " for a maximum of "
+                << maximum << std::endl;
+      exit(EXIT_FAILURE);
+    }
+  }
+#endif
+
   std::cout << "\n\nTest PASSED! " << std::endl;
   return EXIT_SUCCESS;
 }
@@ -12,6 +12,8 @@
 #  include "rtkCudaFDKConeBeamReconstructionFilter.h"
 #else
 #  include "rtkFDKConeBeamReconstructionFilter.h"
+#  include "rtkOnlineFDKConeBeamReconstruction.h"
+#  include <itkExtractImageFilter.h>
 #endif
 
 /**
@@ -221,5 +223,75 @@ main(int, char **)
   TRY_AND_EXIT_ON_ITK_EXCEPTION(dsl->UpdateLargestPossibleRegion())
   CheckImageQuality<OutputImageType>(fov->GetOutput(), dsl->GetOutput(), 0.03, 26, 2.0);
   std::cout << "Test PASSED! " << std::endl;
+
+#ifndef USE_CUDA
+  std::cout << "\n\n****** Case 6: online reconstruction ******" << std::endl;
+  using OnlineFDKType = rtk::OnlineFDKConeBeamReconstruction<OutputImageType>;
+  OnlineFDKType::Pointer online = OnlineFDKType::New();
+  online->SetGeometry(geometry);
+
+  // The sources of the previous cases have been modified and their outputs
+  // released by the in place filters, the volume is therefore regenerated
+  ConstantImageSourceType::Pointer onlineVolumeSource = ConstantImageSourceType::New();
+  origin[0] = -127.;
+  origin[1] = -127.;
+  origin[2] = -127.;
+#if FAST_TESTS_NO_CHECKS
+  size[0] = 32;
+  size[1] = 32;
+  size[2] = 32;
+  spacing[0] = 8.;
+  spacing[1] = 8.;
+  spacing[2] = 8.;
+#else
+  size[0] = 128;
+  size[1] = 128;
+  size[2] = 128;
+  spacing[0] = 2.;
+  spacing[1] = 2.;
+  spacing[2] = 2.;
+#endif
+  onlineVolumeSource->SetOrigin(origin);
+  onlineVolumeSource->SetSpacing(spacing);
+  onlineVolumeSource->SetSize(size);
+  onlineVolumeSource->SetConstant(0.);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(onlineVolumeSource->Update());
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(online->SetVolume(onlineVolumeSource->GetOutput()));
+
+  // Reference reconstruction of all projections at once
+  FDKType::Pointer reference = FDKType::New();
+  reference->SetInput(0, onlineVolumeSource->GetOutput());
+  reference->SetInput(1, slp->GetOutput());
+  reference->SetGeometry(geometry);
+  reference->InPlaceOff();
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(reference->Update());
+  if (reference->GetOutput()->GetBufferedRegion().GetNumberOfPixels() != size[0] * size[1] * size[2])
+  {
+    std::cerr << "Test Failed, the reference reconstruction has "
+              << reference->GetOutput()->GetBufferedRegion().GetNumberOfPixels() << " pixels" << std::endl;
+    return EXIT_FAILURE;
+  }
+  using ExtractType = itk::ExtractImageFilter<OutputImageType, OutputImageType>;
+  ExtractType::Pointer extract = ExtractType::New();
+  extract->SetInput(slp->GetOutput());
+  extract->SetDirectionCollapseToSubmatrix();
+  for (unsigned int noProj = 0; noProj < NumberOfProjectionImages; noProj++)
+  {
+    OutputImageType::RegionType region = slp->GetOutput()->GetLargestPossibleRegion();
+    region.SetIndex(2, noProj);
+    region.SetSize(2, 1);
+    extract->SetExtractionRegion(region);
+    TRY_AND_EXIT_ON_ITK_EXCEPTION(extract->Update());
+    TRY_AND_EXIT_ON_ITK_EXCEPTION(online->AddProjections(extract->GetOutput(), noProj));
+  }
+  if (online->GetNumberOfProjections() != NumberOfProjectionImages)
+  {
+    std::cerr << "Test Failed, " << online->GetNumberOfProjections() << " projections instead of "
+              << NumberOfProjectionImages << std::endl;
+    return EXIT_FAILURE;
+  }
+  CheckImageQuality<OutputImageType>(online->GetSnapshot(), reference->GetOutput(), 0.001, 60, 2.0);
+  std::cout << "Test PASSED! " << std::endl;
+#endif
   return EXIT_SUCCESS;
 }
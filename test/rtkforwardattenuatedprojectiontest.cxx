@@ -258,6 +258,42 @@ main(int, char **)
   stream->Update();
 
   CheckImageQuality<OutputImageType>(stream->GetOutput(), customBinaryFilter->GetOutput(), 1.28, 44.0, 255.0);
+
+#ifndef USE_CUDA
+  std::cout << "\n\n****** Case 2: cached attenuation weights ******" << std::endl;
+
+  rtk::JosephAttenuationCache::Pointer cache = rtk::JosephAttenuationCache::New();
+  jfp->SetAttenuationCache(cache);
+  for (unsigned int i = 0; i < 2; i++)
+  {
+    jfp->Modified();
+    stream->Update();
+    CheckImageQuality<OutputImageType>(stream->GetOutput(), customBinaryFilter->GetOutput(), 1.28, 44.0, 255.0);
+  }
+  if (cache->GetNumberOfEntries() != NumberOfProjectionImages)
+  {
+    std::cerr << "Test Failed, " << cache->GetNumberOfEntries() << " cached projections instead of "
+              << NumberOfProjectionImages << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+#  if !FAST_TESTS_NO_CHECKS
+  // With the budget of one projection, the streamed stacks of five projections
+  // are not recorded but are still correctly projected
+  cache->SetMemoryBudget(cache->GetMemoryUsage() / NumberOfProjectionImages);
+  cache->Clear();
+  jfp->Modified();
+  stream->Update();
+  CheckImageQuality<OutputImageType>(stream->GetOutput(), customBinaryFilter->GetOutput(), 1.28, 44.0, 255.0);
+  if (cache->GetNumberOfEntries() != 0)
+  {
+    std::cerr << "Test Failed, " << cache->GetNumberOfEntries() << " cached projections beyond the memory budget"
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+#  endif
+#endif
+
   std::cout << "\n\nTest  PASSED! " << std::endl;
   return EXIT_SUCCESS;
 }
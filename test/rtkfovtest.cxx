@@ -130,6 +130,19 @@ main(int, char **)
   TRY_AND_EXIT_ON_ITK_EXCEPTION(threshold->Update());
 
   CheckImageQuality<OutputImageType>(fov->GetOutput(), threshold->GetOutput(), 0.02, 23.5, 2.0);
+
+  // The runs of the field of view must cover the voxels of the mask
+  itk::SizeValueType nInside = 0;
+  for (const auto & run : fov->GetRuns(fov->GetOutput()->GetLargestPossibleRegion()))
+    nInside += run.Length;
+  itk::ImageRegionConstIterator<OutputImageType> it(fov->GetOutput(), fov->GetOutput()->GetLargestPossibleRegion());
+  for (; !it.IsAtEnd(); ++it)
+    nInside -= (it.Get() != 0.);
+  if (nInside != 0)
+  {
+    std::cerr << "Test Failed, the runs do not match the field of view mask" << std::endl;
+    return EXIT_FAILURE;
+  }
   std::cout << "\n\nTest PASSED! " << std::endl;
 
   std::cout << "\n\n****** Case 2: offset detector ******" << std::endl;
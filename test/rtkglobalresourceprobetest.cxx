@@ -0,0 +1,195 @@
+#include "rtkTest.h"
+#include "rtkConstantImageSource.h"
+#include "rtkGlobalResourceProbe.h"
+
+#include <itkMultiplyImageFilter.h>
+
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * \file rtkglobalresourceprobetest.cxx
+ *
+ * \brief Test of the trace of rtk::GlobalResourceProbe
+ *
+ * This test records a trace with a watched filter, nested runs, an iteration
+ * and a run in another thread, then parses the Chrome trace and its summary.
+ * The trace is cleared in between to check that the threads record in new
+ * buffers.
+ */
+
+namespace
+{
+// Value of key in a line of the Chrome trace, which has one event per line
+std::string
+GetField(const std::string & line, const std::string & key)
+{
+  const std::string pattern = "\"" + key + "\":";
+  const size_t      start = line.find(pattern);
+  if (start == std::string::npos)
+    return std::string();
+  size_t begin = start + pattern.size();
+  size_t end = 0;
+  if (line[begin] == '"')
+    end = line.find('"', ++begin);
+  else
+    end = line.find_first_of(",}", begin);
+  return line.substr(begin, end - begin);
+}
+
+void
+CheckField(const std::string & line, const std::string & key, const std::string & expected)
+{
+  if (GetField(line, key) != expected)
+  {
+    std::cerr << "Test Failed, " << key << " is " << GetField(line, key) << " instead of " << expected << " in "
+              << line << std::endl;
+    exit(EXIT_FAILURE);
+  }
+}
+} // namespace
+
+int
+main(int, char **)
+{
+  using ImageType = itk::Image<float, 3>;
+  using ConstantImageSourceType = rtk::ConstantImageSource<ImageType>;
+  using MultiplyType = itk::MultiplyImageFilter<ImageType, ImageType>;
+
+  ConstantImageSourceType::SizeType size;
+  size.Fill(4);
+  ConstantImageSourceType::Pointer source = ConstantImageSourceType::New();
+  source->SetSize(size);
+  source->SetConstant(1.);
+  MultiplyType::Pointer multiply = MultiplyType::New();
+  multiply->SetInput(source->GetOutput());
+  multiply->SetConstant(2.);
+
+  rtk::GlobalResourceProbe::Pointer probe = rtk::GlobalResourceProbe::GetInstance();
+  probe->SetTracing(true);
+
+  // Events recorded before Clear, which must not be in the trace
+  probe->StartTrace(multiply, 1);
+  probe->StopTrace(multiply);
+  std::thread discarded([&probe, &multiply]() {
+    probe->StartTrace(multiply, 1);
+    probe->StopTrace(multiply);
+  });
+  discarded.join();
+  probe->Clear();
+
+  std::cout << "\n\n****** Case 1: Chrome trace ******" << std::endl;
+
+  // Run of a watched filter
+  probe->Watch(source);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(source->Update());
+
+  // Nested runs with an iteration of the outer run
+  probe->StartTrace(multiply, 1001);
+  probe->StartTrace(source, 1002);
+  probe->StopTrace(source);
+  probe->IterationTrace(multiply);
+  probe->StopTrace(multiply);
+
+  // Run in another thread
+  std::thread worker([&probe, &multiply]() {
+    probe->StartTrace(multiply, 1003);
+    probe->StopTrace(multiply);
+  });
+  worker.join();
+  probe->SetTracing(false);
+
+  std::ostringstream trace;
+  probe->WriteChromeTrace(trace);
+  std::istringstream       traceLines(trace.str());
+  std::string              line;
+  std::vector<std::string> events;
+  std::getline(traceLines, line);
+  if (line != "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[")
+  {
+    std::cerr << "Test Failed, wrong trace header " << line << std::endl;
+    return EXIT_FAILURE;
+  }
+  while (std::getline(traceLines, line) && line != "]}")
+    events.push_back(line);
+  if (line != "]}")
+  {
+    std::cerr << "Test Failed, the trace is not terminated" << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (events.size() != 5)
+  {
+    std::cerr << "Test Failed, " << events.size() << " events instead of 5" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // The first event is the run of the watched filter, the others are
+  // identified by their instance since their start times may be equal
+  CheckField(events[0], "name", source->GetNameOfClass());
+  CheckField(events[0], "ph", "X");
+  CheckField(events[0], "tid", "0");
+  CheckField(events[0], "parent", "0");
+  CheckField(events[0], "pixels", "64");
+  std::map<std::string, std::string> runs;
+  std::string                        iteration;
+  for (unsigned int i = 0; i < events.size(); i++)
+  {
+    if (i + 1 < events.size() && events[i].back() != ',')
+    {
+      std::cerr << "Test Failed, events are not separated by commas" << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (GetField(events[i], "ph") == "i")
+      iteration = events[i];
+    else
+      runs[GetField(events[i], "instance")] = events[i];
+  }
+  if (runs.size() != 4 || iteration.empty())
+  {
+    std::cerr << "Test Failed, wrong events in the trace" << std::endl << trace.str() << std::endl;
+    return EXIT_FAILURE;
+  }
+  CheckField(runs["1001"], "name", multiply->GetNameOfClass());
+  CheckField(runs["1001"], "tid", "0");
+  CheckField(runs["1001"], "parent", "0");
+  CheckField(runs["1002"], "name", source->GetNameOfClass());
+  CheckField(runs["1002"], "tid", "0");
+  CheckField(runs["1002"], "parent", GetField(runs["1001"], "id"));
+  CheckField(iteration, "name", "Iteration");
+  CheckField(iteration, "filter", multiply->GetNameOfClass());
+  CheckField(iteration, "instance", "1001");
+  CheckField(iteration, "parent", GetField(runs["1001"], "id"));
+  CheckField(iteration, "iteration", "1");
+  CheckField(runs["1003"], "name", multiply->GetNameOfClass());
+  CheckField(runs["1003"], "tid", "1");
+  CheckField(runs["1003"], "parent", "0");
+  std::cout << "\n\nTest PASSED! " << std::endl;
+
+  std::cout << "\n\n****** Case 2: trace summary ******" << std::endl;
+
+  // Header and one line per class of filter, sorted by name
+  std::ostringstream summary;
+  probe->WriteTraceSummary(summary);
+  std::istringstream       summaryLines(summary.str());
+  std::vector<std::string> rows;
+  while (std::getline(summaryLines, line))
+    rows.push_back(line);
+  if (rows.size() != 3 || rows[0].find("filter,runs,") != 0)
+  {
+    std::cerr << "Test Failed, wrong summary" << std::endl << summary.str() << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (rows[1].find(std::string(source->GetNameOfClass()) + ",2,") != 0 ||
+      rows[2].find(std::string(multiply->GetNameOfClass()) + ",2,") != 0)
+  {
+    std::cerr << "Test Failed, wrong number of runs in the summary" << std::endl << summary.str() << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "\n\nTest PASSED! " << std::endl;
+
+  probe->Clear();
+  return EXIT_SUCCESS;
+}
@@ -78,6 +78,56 @@ main(int, char **)
     TRY_AND_EXIT_ON_ITK_EXCEPTION(lagcorr->Update())
   }
 
+#ifndef USE_CUDA
+  std::cout << "\n\nTest of a block of projections processed by tiles..." << std::endl;
+
+  // Stack of projections with a pixel and time dependent signal
+  ImageType::RegionType stackRegion = region;
+  stackRegion.SetSize(0, 65);
+  stackRegion.SetSize(1, 70);
+  stackRegion.SetSize(2, Nprojections);
+  ImageType::Pointer stack = ImageType::New();
+  stack->SetRegions(stackRegion);
+  stack->Allocate();
+  PixelType * p = stack->GetBufferPointer();
+  for (unsigned int i = 0; i < stackRegion.GetNumberOfPixels(); i++)
+    p[i] = 1000.f * (1 + (i % 7)) * ((i / (65 * 70)) % 3 == 0);
+
+  // Small tiles which do not match the rows
+  LCImageFilterType::Pointer blockcorr = LCImageFilterType::New();
+  blockcorr->SetCoefficients(a, b);
+  blockcorr->SetTileSize(100);
+  blockcorr->SetInput(stack);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(blockcorr->Update())
+
+  // Sequential recurrence, projection by projection
+  std::vector<float> S(65 * 70 * ModelOrder, 0.f);
+  float              sumB = 1.f;
+  for (unsigned int n = 0; n < ModelOrder; n++)
+    sumB += b[n];
+  const PixelType * q = blockcorr->GetOutput()->GetBufferPointer();
+  for (unsigned int i = 0; i < stackRegion.GetNumberOfPixels(); i++)
+  {
+    float * s = &S[(i % (65 * 70)) * ModelOrder];
+    float   xk = p[i];
+    float   Sa[ModelOrder];
+    for (unsigned int n = 0; n < ModelOrder; n++)
+    {
+      Sa[n] = expf(-a[n]) * s[n];
+      xk -= b[n] * Sa[n];
+    }
+    xk = xk / sumB;
+    for (unsigned int n = 0; n < ModelOrder; n++)
+      s[n] = xk + Sa[n];
+    xk = (xk < 0.0f) ? 0.f : xk;
+    if (q[i] != xk)
+    {
+      std::cerr << "Test Failed! Pixel " << i << " is " << q[i] << " instead of " << xk << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+#endif
+
   std::cout << "\n\nTest PASSED! " << std::endl;
 
   return EXIT_SUCCESS;
@@ -0,0 +1,238 @@
+#include "rtkTest.h"
+#include "rtkDrawEllipsoidImageFilter.h"
+#include "rtkRayEllipsoidIntersectionImageFilter.h"
+#include "rtkConstantImageSource.h"
+#include "rtkSARTConeBeamReconstructionFilter.h"
+#include "rtkConjugateGradientConeBeamReconstructionFilter.h"
+#include "rtkMultiResolutionConeBeamReconstructionFilter.h"
+
+#include <vector>
+
+/**
+ * \file rtkmultiresolutiontest.cxx
+ *
+ * \brief Functional test for the coarse-to-fine reconstruction driver
+ *
+ * This test generates the projections of an ellipsoid and reconstructs the CT
+ * image with SART and with conjugate gradient driven by
+ * rtk::MultiResolutionConeBeamReconstructionFilter, i.e., with iterations on
+ * binned volumes and projections before a single iteration at full
+ * resolution. The generated results are compared to the expected results
+ * (analytical calculation).
+ */
+
+int
+main(int, char **)
+{
+  constexpr unsigned int Dimension = 3;
+  using OutputPixelType = float;
+
+  using OutputImageType = itk::Image<OutputPixelType, Dimension>;
+
+#if FAST_TESTS_NO_CHECKS
+  constexpr unsigned int NumberOfProjectionImages = 3;
+#else
+  constexpr unsigned int NumberOfProjectionImages = 180;
+#endif
+
+
+  // Constant image sources
+  using ConstantImageSourceType = rtk::ConstantImageSource<OutputImageType>;
+  ConstantImageSourceType::PointType   origin;
+  ConstantImageSourceType::SizeType    size;
+  ConstantImageSourceType::SpacingType spacing;
+
+  ConstantImageSourceType::Pointer tomographySource = ConstantImageSourceType::New();
+  origin[0] = -127.;
+  origin[1] = -127.;
+  origin[2] = -127.;
+#if FAST_TESTS_NO_CHECKS
+  size[0] = 2;
+  size[1] = 2;
+  size[2] = 2;
+  spacing[0] = 252.;
+  spacing[1] = 252.;
+  spacing[2] = 252.;
+#else
+  size[0] = 64;
+  size[1] = 64;
+  size[2] = 64;
+  spacing[0] = 4.;
+  spacing[1] = 4.;
+  spacing[2] = 4.;
+#endif
+  tomographySource->SetOrigin(origin);
+  tomographySource->SetSpacing(spacing);
+  tomographySource->SetSize(size);
+  tomographySource->SetConstant(0.);
+
+  ConstantImageSourceType::Pointer projectionsSource = ConstantImageSourceType::New();
+  origin[0] = -255.;
+  origin[1] = -255.;
+  origin[2] = -255.;
+#if FAST_TESTS_NO_CHECKS
+  size[0] = 2;
+  size[1] = 2;
+  size[2] = NumberOfProjectionImages;
+  spacing[0] = 504.;
+  spacing[1] = 504.;
+  spacing[2] = 504.;
+#else
+  size[0] = 64;
+  size[1] = 64;
+  size[2] = NumberOfProjectionImages;
+  spacing[0] = 8.;
+  spacing[1] = 8.;
+  spacing[2] = 8.;
+#endif
+  projectionsSource->SetOrigin(origin);
+  projectionsSource->SetSpacing(spacing);
+  projectionsSource->SetSize(size);
+  projectionsSource->SetConstant(0.);
+
+  // Geometry object
+  using GeometryType = rtk::ThreeDCircularProjectionGeometry;
+  GeometryType::Pointer geometry = GeometryType::New();
+  for (unsigned int noProj = 0; noProj < NumberOfProjectionImages; noProj++)
+    geometry->AddProjection(600., 1200., noProj * 360. / NumberOfProjectionImages);
+
+  // Create ellipsoid PROJECTIONS
+  using REIType = rtk::RayEllipsoidIntersectionImageFilter<OutputImageType, OutputImageType>;
+  REIType::Pointer rei;
+
+  rei = REIType::New();
+  REIType::VectorType semiprincipalaxis, center;
+  semiprincipalaxis.Fill(90.);
+  center.Fill(0.);
+  rei->SetAngle(0.);
+  rei->SetDensity(1.);
+  rei->SetCenter(center);
+  rei->SetAxis(semiprincipalaxis);
+
+  rei->SetInput(projectionsSource->GetOutput());
+  rei->SetGeometry(geometry);
+
+  // Update
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(rei->Update());
+
+  // Create REFERENCE object (3D ellipsoid).
+  using DEType = rtk::DrawEllipsoidImageFilter<OutputImageType, OutputImageType>;
+  DEType::Pointer dsl = DEType::New();
+  dsl->SetInput(tomographySource->GetOutput());
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(dsl->Update())
+
+  using MultiResolutionType = rtk::MultiResolutionConeBeamReconstructionFilter<OutputImageType>;
+  MultiResolutionType::Pointer multiResolution = MultiResolutionType::New();
+  multiResolution->SetInput(tomographySource->GetOutput());
+  multiResolution->SetInput(1, rei->GetOutput());
+
+  // Count the levels
+  unsigned int numberOfLevels = 0;
+  multiResolution->AddObserver(itk::IterationEvent(),
+                               [&numberOfLevels](const itk::EventObject &) { numberOfLevels++; });
+
+#if FAST_TESTS_NO_CHECKS
+  const std::vector<unsigned int> shrinkFactors = { 2, 1 };
+  const std::vector<unsigned int> numberOfIterations = { 2, 1 };
+#else
+  const std::vector<unsigned int> shrinkFactors = { 4, 2, 1 };
+  const std::vector<unsigned int> numberOfIterations = { 2, 2, 1 };
+#endif
+
+  std::cout << "\n\n****** Case 1: SART, invalid schedule ******" << std::endl;
+
+  using SARTType = rtk::SARTConeBeamReconstructionFilter<OutputImageType>;
+  SARTType::Pointer sart = SARTType::New();
+  sart->SetGeometry(geometry);
+  sart->SetLambda(0.5);
+  multiResolution->SetReconstructionFilter(sart);
+  multiResolution->SetSchedule({ 1, 2 }, { 1, 1 });
+  bool thrown = false;
+  try
+  {
+    multiResolution->Update();
+  }
+  catch (itk::ExceptionObject &)
+  {
+    thrown = true;
+  }
+  if (!thrown)
+  {
+    std::cerr << "Test Failed, an increasing schedule has been accepted" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "\n\nTest PASSED! " << std::endl;
+
+  std::cout << "\n\n****** Case 2: SART ******" << std::endl;
+
+  multiResolution->SetSchedule(shrinkFactors, numberOfIterations);
+  numberOfLevels = 0;
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(multiResolution->Update());
+  if (numberOfLevels != shrinkFactors.size())
+  {
+    std::cerr << "Test Failed, " << numberOfLevels << " levels instead of " << shrinkFactors.size() << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (multiResolution->GetOutput()->GetLargestPossibleRegion() !=
+      tomographySource->GetOutput()->GetLargestPossibleRegion())
+  {
+    std::cerr << "Test Failed, the output is not on the grid of the input volume" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  CheckImageQuality<OutputImageType>(multiResolution->GetOutput(), dsl->GetOutput(), 0.032, 28.6, 2.0);
+  std::cout << "\n\nTest PASSED! " << std::endl;
+
+  std::cout << "\n\n****** Case 3: Conjugate gradient with weights on the projection grid ******" << std::endl;
+
+  using ConjugateGradientType = rtk::ConjugateGradientConeBeamReconstructionFilter<OutputImageType>;
+  ConjugateGradientType::Pointer conjugategradient = ConjugateGradientType::New();
+  conjugategradient->SetGeometry(geometry);
+  conjugategradient->SetForwardProjectionFilter(ConjugateGradientType::FP_JOSEPH);
+  conjugategradient->SetBackProjectionFilter(ConjugateGradientType::BP_JOSEPH);
+  ConstantImageSourceType::Pointer uniformWeightsSource = ConstantImageSourceType::New();
+  uniformWeightsSource->SetInformationFromImage(projectionsSource->GetOutput());
+  uniformWeightsSource->SetConstant(1.0);
+  conjugategradient->SetInput(2, uniformWeightsSource->GetOutput());
+
+#if FAST_TESTS_NO_CHECKS
+  multiResolution->SetSchedule({ 2, 1 }, { 3, 2 });
+#else
+  multiResolution->SetSchedule({ 4, 2, 1 }, { 5, 3, 2 });
+#endif
+  multiResolution->SetReconstructionFilter(conjugategradient);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(multiResolution->Update());
+
+  CheckImageQuality<OutputImageType>(multiResolution->GetOutput(), dsl->GetOutput(), 0.08, 23, 2.0);
+  std::cout << "\n\nTest PASSED! " << std::endl;
+
+  std::cout << "\n\n****** Case 4: Conjugate gradient with weights on another grid ******" << std::endl;
+
+  // Same size as the projections but shifted by one pixel
+  ConstantImageSourceType::Pointer shiftedWeightsSource = ConstantImageSourceType::New();
+  shiftedWeightsSource->SetInformationFromImage(projectionsSource->GetOutput());
+  ConstantImageSourceType::PointType shiftedOrigin = projectionsSource->GetOutput()->GetOrigin();
+  shiftedOrigin[0] += projectionsSource->GetOutput()->GetSpacing()[0];
+  shiftedWeightsSource->SetOrigin(shiftedOrigin);
+  shiftedWeightsSource->SetConstant(1.0);
+  conjugategradient->SetInput(2, shiftedWeightsSource->GetOutput());
+  multiResolution->Modified();
+  thrown = false;
+  try
+  {
+    multiResolution->Update();
+  }
+  catch (itk::ExceptionObject &)
+  {
+    thrown = true;
+  }
+  if (!thrown)
+  {
+    std::cerr << "Test Failed, weights on neither the grid of the projections nor of the volume have been accepted"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "\n\nTest PASSED! " << std::endl;
+
+  return EXIT_SUCCESS;
+}
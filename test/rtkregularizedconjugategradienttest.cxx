@@ -164,7 +164,36 @@ main(int, char **)
   CheckImageQuality<OutputImageType>(regularizedConjugateGradient->GetOutput(), dsl->GetOutput(), 0.05, 23, 2.0);
   std::cout << "\n\nTest PASSED! " << std::endl;
 
-  std::cout << "\n\n****** Case 2: Wavelets ******" << std::endl;
+  std::cout << "\n\n****** Case 2: Positivity + TV regularization with momentum ******" << std::endl;
+
+  // The momentum of the TV denoising starts with its third iterate and only
+  // changes the output from its fourth iteration
+  regularizedConjugateGradient->SetTV_iterations(5);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(regularizedConjugateGradient->Update());
+  OutputImageType::Pointer withoutMomentum = regularizedConjugateGradient->GetOutput();
+  withoutMomentum->DisconnectPipeline();
+
+  regularizedConjugateGradient->SetTVMomentum(true);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(regularizedConjugateGradient->Update());
+  CheckImageQuality<OutputImageType>(regularizedConjugateGradient->GetOutput(), dsl->GetOutput(), 0.05, 23, 2.0);
+#if !FAST_TESTS_NO_CHECKS
+  itk::ImageRegionConstIterator<OutputImageType> itWith(regularizedConjugateGradient->GetOutput(),
+                                                        regularizedConjugateGradient->GetOutput()->GetBufferedRegion());
+  itk::ImageRegionConstIterator<OutputImageType> itWithout(withoutMomentum, withoutMomentum->GetBufferedRegion());
+  bool                                           changed = false;
+  for (; !itWith.IsAtEnd(); ++itWith, ++itWithout)
+    changed = changed || itWith.Get() != itWithout.Get();
+  if (!changed)
+  {
+    std::cerr << "Test Failed, the momentum has not changed the TV denoising" << std::endl;
+    return EXIT_FAILURE;
+  }
+#endif
+  regularizedConjugateGradient->SetTVMomentum(false);
+  regularizedConjugateGradient->SetTV_iterations(3);
+  std::cout << "\n\nTest PASSED! " << std::endl;
+
+  std::cout << "\n\n****** Case 3: Wavelets ******" << std::endl;
 
   regularizedConjugateGradient->SetPerformPositivity(false);
   regularizedConjugateGradient->SetPerformTVSpatialDenoising(false);
@@ -176,7 +205,7 @@ main(int, char **)
   std::cout << "\n\nTest PASSED! " << std::endl;
 
 #ifdef USE_CUDA
-  std::cout << "\n\n****** Case 3: CUDA Voxel-Based Backprojector and CUDA Forward projector, all regularization steps "
+  std::cout << "\n\n****** Case 4: CUDA Voxel-Based Backprojector and CUDA Forward projector, all regularization steps "
                "on ******"
             << std::endl;
 
@@ -10,6 +10,13 @@
 #endif
 #include "rtkSARTConeBeamReconstructionFilter.h"
 
+#include <itksys/SystemTools.hxx>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <utility>
+
 /**
  * \file rtksarttest.cxx
  *
@@ -165,8 +172,225 @@ main(int, char **)
   CheckImageQuality<OutputImageType>(sart->GetOutput(), dsl->GetOutput(), 0.032, 28.6, 2.0);
   std::cout << "\n\nTest PASSED! " << std::endl;
 
+  std::cout << "\n\n****** Case 4: Joseph Backprojector with a sensitivity cache ******" << std::endl;
+  rtk::SensitivityImageCache::Pointer cache = rtk::SensitivityImageCache::New();
+  sart->SetSensitivityCache(cache);
+  sart->SetNumberOfIterations(2);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(sart->Update());
+  if (cache->GetNumberOfEntries() != NumberOfProjectionImages + 1)
+  {
+    std::cerr << "Test Failed, " << cache->GetNumberOfEntries() << " cached images instead of "
+              << NumberOfProjectionImages + 1 << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  // Second run with the cached images only
+  sart->Modified();
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(sart->Update());
+
+  CheckImageQuality<OutputImageType>(sart->GetOutput(), dsl->GetOutput(), 0.032, 28.6, 2.0);
+  std::cout << "\n\nTest PASSED! " << std::endl;
+  sart->SetSensitivityCache(nullptr);
+  sart->SetNumberOfIterations(1);
+
+  std::cout << "\n\n****** Case 5: iteration telemetry and early stop ******" << std::endl;
+  constexpr unsigned int NumberOfSubsets = (NumberOfProjectionImages + 1) / 2;
+  rtk::IterationTelemetry::Pointer        telemetry = rtk::IterationTelemetry::New();
+  rtk::CSVIterationTelemetrySink::Pointer sink = rtk::CSVIterationTelemetrySink::New();
+  sink->SetFileName("rtksarttest_telemetry.csv");
+  telemetry->SetSink(sink);
+  sart->SetTelemetry(telemetry);
+  sart->SetBackProjectionFilter(SARTType::BP_VOXELBASED);
+  sart->SetForwardProjectionFilter(SARTType::FP_JOSEPH);
+  sart->SetNumberOfProjectionsPerSubset(2);
+  sart->SetNumberOfIterations(2);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(sart->Update());
+
+  // One record per subset followed by one record per iteration, with the
+  // forward projections counted since the start of the reconstruction
+  const std::vector<rtk::IterationTelemetryRecord> & records = telemetry->GetRecords();
+  if (records.size() != 2 * (NumberOfSubsets + 1))
+  {
+    std::cerr << "Test Failed, " << records.size() << " records instead of " << 2 * (NumberOfSubsets + 1)
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  for (unsigned int r = 0; r < records.size(); r++)
+  {
+    const unsigned int iter = r / (NumberOfSubsets + 1);
+    const unsigned int subset = r % (NumberOfSubsets + 1);
+    const int          expectedSubset = (subset == NumberOfSubsets) ? -1 : int(subset);
+    const unsigned int expectedForwardProjections =
+      iter * NumberOfProjectionImages + std::min(2 * (subset + 1), NumberOfProjectionImages);
+    if (records[r].Filter != sart->GetNameOfClass() || records[r].Iteration != iter ||
+        records[r].Subset != expectedSubset || records[r].ForwardProjections != expectedForwardProjections ||
+        !(records[r].ResidualNorm >= 0.) || records[r].Time < 0.)
+    {
+      std::cerr << "Test Failed, record " << r << " is " << records[r].Filter << ", iteration " << records[r].Iteration
+                << ", subset " << records[r].Subset << ", " << records[r].ForwardProjections
+                << " forward projections, residual norm " << records[r].ResidualNorm << std::endl;
+      exit(EXIT_FAILURE);
+    }
+  }
+  if (telemetry->GetStopRequested())
+  {
+    std::cerr << "Test Failed, stop requested without criterion: " << telemetry->GetStopReason() << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  // The sink has written a header and one line per record
+  std::ifstream csv("rtksarttest_telemetry.csv");
+  std::string   line;
+  unsigned int  numberOfLines = 0;
+  while (std::getline(csv, line))
+  {
+    if (numberOfLines == 0 && line.find("filter,iteration,subset,") != 0)
+    {
+      std::cerr << "Test Failed, wrong CSV header " << line << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    if (numberOfLines > 0 && line.find(std::string(sart->GetNameOfClass()) + ',') != 0)
+    {
+      std::cerr << "Test Failed, wrong CSV line " << line << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    numberOfLines++;
+  }
+  if (numberOfLines != records.size() + 1)
+  {
+    std::cerr << "Test Failed, " << numberOfLines << " CSV lines instead of " << records.size() + 1 << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  csv.close();
+  telemetry->SetSink(nullptr);
+  sink = nullptr;
+  itksys::SystemTools::RemoveFile("rtksarttest_telemetry.csv");
+
+  // Early stop after the first iteration when the time budget is exceeded
+  sart->SetNumberOfIterations(4);
+  telemetry->SetTimeBudget(1e-9);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(sart->Update());
+  if (!telemetry->GetStopRequested() || records.size() != NumberOfSubsets + 1 || records.back().Iteration != 0 ||
+      records.back().Subset != -1)
+  {
+    std::cerr << "Test Failed, the time budget did not stop the reconstruction after the first iteration, "
+              << records.size() << " records" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  telemetry->SetTimeBudget(0.);
+
+#if !FAST_TESTS_NO_CHECKS
+  // Early stop after the second iteration on a plateau of the residual norm
+  // since no decrease over one iteration can reach the tolerance. The fast
+  // tests project nothing of the ellipsoid so their residual norm is 0.
+  telemetry->SetResidualPlateauTolerance(1e9);
+  telemetry->SetResidualPlateauWindow(1);
+  sart->Modified();
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(sart->Update());
+  if (!telemetry->GetStopRequested() || records.size() != 2 * (NumberOfSubsets + 1) || records.back().Iteration != 1 ||
+      records.back().Subset != -1)
+  {
+    std::cerr << "Test Failed, the plateau did not stop the reconstruction after the second iteration, "
+              << records.size() << " records" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  std::cout << "Stopped: " << telemetry->GetStopReason() << std::endl;
+#endif
+  std::cout << "\n\nTest PASSED! " << std::endl;
+  sart->SetTelemetry(nullptr);
+  sart->SetNumberOfProjectionsPerSubset(1);
+  sart->SetNumberOfIterations(1);
+
+  std::cout << "\n\n****** Case 6: Voxel-Based Backprojector with momentum ******" << std::endl;
+  auto maximumDifference = [](const OutputImageType * a, const OutputImageType * b) {
+    itk::ImageRegionConstIterator<OutputImageType> itA(a, a->GetBufferedRegion());
+    itk::ImageRegionConstIterator<OutputImageType> itB(b, b->GetBufferedRegion());
+    double                                         difference = 0.;
+    for (; !itA.IsAtEnd(); ++itA, ++itB)
+      difference = std::max(difference, std::abs(static_cast<double>(itA.Get()) - itB.Get()));
+    return difference;
+  };
+
+  // Reference without momentum. The momentum has no effect on the first two
+  // updates, the extrapolation starts with the third one.
+  constexpr unsigned int MomentumIterations = 4;
+  sart->SetBackProjectionFilter(SARTType::BP_VOXELBASED);
+  sart->SetForwardProjectionFilter(SARTType::FP_JOSEPH);
+  sart->SetNumberOfIterations(MomentumIterations);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(sart->Update());
+  OutputImageType::Pointer withoutMomentum = sart->GetOutput();
+  withoutMomentum->DisconnectPipeline();
+
+  telemetry = rtk::IterationTelemetry::New();
+  sart->SetTelemetry(telemetry);
+  sart->SetMomentum(true);
+  // Momentum of the iterations with both restarts, then of the subsets
+  const std::vector<std::pair<bool, rtk::NesterovMomentum::RestartType>> momentumConfigurations = {
+    { false, rtk::NesterovMomentum::GRADIENT_RESTART },
+    { false, rtk::NesterovMomentum::FUNCTION_RESTART },
+    { true, rtk::NesterovMomentum::GRADIENT_RESTART }
+  };
+  for (const auto & configuration : momentumConfigurations)
+  {
+    sart->SetMomentumPerSubset(configuration.first);
+    sart->SetMomentumRestart(configuration.second);
+    TRY_AND_EXIT_ON_ITK_EXCEPTION(sart->Update());
+    CheckImageQuality<OutputImageType>(sart->GetOutput(), dsl->GetOutput(), 0.032, 28.6, 2.0);
+
+    // One forward projection per projection and per iteration
+    if (telemetry->GetRecords().back().ForwardProjections != MomentumIterations * NumberOfProjectionImages)
+    {
+      std::cerr << "Test Failed, " << telemetry->GetRecords().back().ForwardProjections
+                << " forward projections instead of " << MomentumIterations * NumberOfProjectionImages << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    if (sart->GetNumberOfMomentumRestarts() >= MomentumIterations * NumberOfProjectionImages)
+    {
+      std::cerr << "Test Failed, the momentum has been restarted at each update" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+#if !FAST_TESTS_NO_CHECKS
+    if (maximumDifference(sart->GetOutput(), withoutMomentum) == 0.)
+    {
+      std::cerr << "Test Failed, the momentum has not changed the reconstruction" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+#endif
+  }
+  sart->SetMomentumPerSubset(false);
+
+  // Diverging updates increase the residual norm at each iteration and the
+  // function restart then restarts the momentum after each iteration but the
+  // first one
+  sart->SetLambda(10.);
+  sart->SetNumberOfIterations(3);
+  sart->SetMomentumRestart(rtk::NesterovMomentum::NO_RESTART);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(sart->Update());
+  if (sart->GetNumberOfMomentumRestarts() != 0)
+  {
+    std::cerr << "Test Failed, " << sart->GetNumberOfMomentumRestarts() << " restarts without restart criterion"
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+#if !FAST_TESTS_NO_CHECKS
+  sart->SetMomentumRestart(rtk::NesterovMomentum::FUNCTION_RESTART);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(sart->Update());
+  if (sart->GetNumberOfMomentumRestarts() != 2)
+  {
+    std::cerr << "Test Failed, " << sart->GetNumberOfMomentumRestarts()
+              << " restarts of the momentum of diverging updates instead of 2" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+#endif
+  std::cout << "\n\nTest PASSED! " << std::endl;
+  sart->SetLambda(0.5);
+  sart->SetMomentum(false);
+  sart->SetMomentumRestart(rtk::NesterovMomentum::GRADIENT_RESTART);
+  sart->SetTelemetry(nullptr);
+  sart->SetNumberOfIterations(1);
+
 #ifdef USE_CUDA
-  std::cout << "\n\n****** Case 4: CUDA Voxel-Based Backprojector ******" << std::endl;
+  std::cout << "\n\n****** Case 7: CUDA Voxel-Based Backprojector ******" << std::endl;
 
   sart->SetBackProjectionFilter(SARTType::BP_CUDAVOXELBASED);
   sart->SetForwardProjectionFilter(SARTType::FP_CUDARAYCAST);
@@ -176,7 +400,7 @@ main(int, char **)
   std::cout << "\n\nTest PASSED! " << std::endl;
 #endif
 
-  std::cout << "\n\n****** Case 5: Voxel-Based Backprojector and gating ******" << std::endl;
+  std::cout << "\n\n****** Case 8: Voxel-Based Backprojector and gating ******" << std::endl;
 
   sart->SetBackProjectionFilter(SARTType::BP_VOXELBASED);
   sart->SetForwardProjectionFilter(SARTType::FP_JOSEPH);
@@ -1,5 +1,8 @@
 #include <itkImageRegionConstIterator.h>
 
+#include <algorithm>
+#include <cmath>
+
 #include "rtkTest.h"
 #include "rtkSheppLoganPhantomFilter.h"
 #include "rtkDrawSheppLoganFilter.h"
@@ -138,6 +141,52 @@ main(int, char **)
   TRY_AND_EXIT_ON_ITK_EXCEPTION(feldkamp->Update());
 
   CheckImageQuality<OutputImageType>(feldkamp->GetOutput(), dsl->GetOutput(), 0.09, 22, 2.0);
+
+#ifndef USE_CUDA
+  std::cout << "\n\n****** Short scan weights applied with the FDK weights ******" << std::endl;
+  feldkamp->SetInput(1, slp->GetOutput());
+  feldkamp->GetWeightFilter()->SetShortScanFilter(PSSFType::New());
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(feldkamp->Update());
+  CheckImageQuality<OutputImageType>(feldkamp->GetOutput(), dsl->GetOutput(), 0.09, 22, 2.0);
+
+  // The fused weights give the same projections as the displaced detector and
+  // short scan filters followed by the FDK weights up to the float rounding
+  using WeightType = rtk::FDKWeightProjectionFilter<OutputImageType>;
+  using DDFType = rtk::DisplacedDetectorImageFilter<OutputImageType>;
+  DDFType::Pointer ddf = DDFType::New();
+  ddf->SetInput(slp->GetOutput());
+  ddf->SetGeometry(geometry);
+  ddf->InPlaceOff();
+  pssf->SetInput(ddf->GetOutput());
+  WeightType::Pointer baseline = WeightType::New();
+  baseline->SetInput(pssf->GetOutput());
+  baseline->SetGeometry(geometry);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(baseline->Update());
+
+  WeightType::Pointer fused = WeightType::New();
+  fused->SetInput(slp->GetOutput());
+  fused->SetGeometry(geometry);
+  fused->SetDisplacedDetectorFilter(DDFType::New());
+  fused->SetShortScanFilter(PSSFType::New());
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(fused->Update());
+
+  using IteratorType = itk::ImageRegionConstIterator<OutputImageType>;
+  IteratorType itBaseline(baseline->GetOutput(), baseline->GetOutput()->GetBufferedRegion());
+  IteratorType itFused(fused->GetOutput(), fused->GetOutput()->GetBufferedRegion());
+  double       maximum = 0.;
+  double       difference = 0.;
+  for (; !itBaseline.IsAtEnd(); ++itBaseline, ++itFused)
+  {
+    maximum = std::max(maximum, std::abs(static_cast<double>(itBaseline.Get())));
+    difference = std::max(difference, std::abs(static_cast<double>(itBaseline.Get()) - itFused.Get()));
+  }
+  if (difference > 1e-5 * maximum)
+  {
+    std::cerr << "Test Failed, the fused and baseline weights differ by " << difference << " for a maximum of "
+              << maximum << std::endl;
+    exit(EXIT_FAILURE);
+  }
+#endif
   std::cout << "\n\nTest PASSED! " << std::endl;
   return EXIT_SUCCESS;
 }
@@ -1,4 +1,5 @@
 #include "itkRandomImageSource.h"
+#include "itkImageRegionConstIterator.h"
 #include "math.h"
 
 #include "rtkTotalVariationImageFilter.h"
@@ -113,10 +114,39 @@ main(int, char **)
   }
   TVdenoising->SetDimensionsProcessed(dimsProcessed);
 
+  std::cout << "\n\n****** Case 1: without momentum ******" << std::endl;
+
   // Update the TV denoising filter
   TRY_AND_EXIT_ON_ITK_EXCEPTION(TVdenoising->Update());
 
   CheckTotalVariation<OutputImageType>(randomVolumeSource->GetOutput(), TVdenoising->GetOutput());
+  OutputImageType::Pointer withoutMomentum = TVdenoising->GetOutput();
+  withoutMomentum->DisconnectPipeline();
+
+  std::cout << "\n\nTest PASSED! " << std::endl;
+
+  std::cout << "\n\n****** Case 2: with momentum ******" << std::endl;
+
+  TVdenoising->SetMomentum(true);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(TVdenoising->Update());
+
+  CheckTotalVariation<OutputImageType>(randomVolumeSource->GetOutput(), TVdenoising->GetOutput());
+  if (TVdenoising->GetNumberOfMomentumRestarts() >= static_cast<unsigned int>(TVdenoising->GetNumberOfIterations()))
+  {
+    std::cerr << "Test Failed: the momentum has been restarted at each iteration" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  itk::ImageRegionConstIterator<OutputImageType> itWith(TVdenoising->GetOutput(),
+                                                        TVdenoising->GetOutput()->GetBufferedRegion());
+  itk::ImageRegionConstIterator<OutputImageType> itWithout(withoutMomentum, withoutMomentum->GetBufferedRegion());
+  bool                                           changed = false;
+  for (; !itWith.IsAtEnd(); ++itWith, ++itWithout)
+    changed = changed || itWith.Get() != itWithout.Get();
+  if (!changed)
+  {
+    std::cerr << "Test Failed: the momentum has not changed the denoised image" << std::endl;
+    exit(EXIT_FAILURE);
+  }
 
   std::cout << "\n\nTest PASSED! " << std::endl;
 
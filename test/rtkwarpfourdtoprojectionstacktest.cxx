@@ -380,28 +380,11 @@ main(int, char **)
   warpforwardproject->SetWeights(phaseReader->GetOutput());
   warpforwardproject->SetSignal(rtk::ReadSignalFile(signalFileName));
 
-#ifndef USE_CUDA
-  std::cout
-    << "\n\n****** Case 1: Non-warped joseph forward projection (warped forward projection exists only in CUDA) ******"
-    << std::endl;
-  TRY_AND_EXIT_ON_ITK_EXCEPTION(warpforwardproject->Update());
-
-  // The warpforwardproject filter doesn't really need the data in pasteFilter->GetOutput().
-  // During the update, its requested region is set to empty, and its buffered region follows.
-  // To perform the CheckImageQuality, we need to recompute the data
-  pasteFilter->UpdateLargestPossibleRegion();
-
-  CheckImageQuality<ProjectionStackType>(warpforwardproject->GetOutput(), pasteFilter->GetOutput(), 0.25, 14, 2.0);
-  std::cout << "\n\nTest PASSED! " << std::endl;
-#endif
-
-#ifdef USE_CUDA
-  std::cout << "\n\n****** Case 2: CUDA warped forward projection ******" << std::endl;
+  std::cout << "\n\n****** Warped forward projection ******" << std::endl;
   TRY_AND_EXIT_ON_ITK_EXCEPTION(warpforwardproject->Update());
   CheckImageQuality<ProjectionStackType>(
     warpforwardproject->GetOutput(), pasteFilterStaticProjections->GetOutput(), 0.25, 14, 2.0);
   std::cout << "\n\nTest PASSED! " << std::endl;
-#endif
 
   itksys::SystemTools::RemoveFile(signalFileName.c_str());
   delete[] Volumes;
@@ -366,25 +366,12 @@ main(int, char **)
     warpbackproject->SetWeights(phaseReader->GetOutput());
     warpbackproject->SetSignal(rtk::ReadSignalFile(signalFileName));
 
-#ifndef USE_CUDA
-    std::cout << "\n\n****** Case " << 1 + 2 * radius
-              << ": Non-warped voxel based back projection (warped back projection exists only in CUDA) ******"
-              << std::endl;
+    std::cout << "\n\n****** Case " << 1 + radius << ": Warped back projection ******" << std::endl;
     if (radius)
       std::cout << "\n\n****** Cylindrical detector ******" << std::endl;
     TRY_AND_EXIT_ON_ITK_EXCEPTION(warpbackproject->Update());
     CheckImageQuality<VolumeSeriesType>(warpbackproject->GetOutput(), join->GetOutput(), 15, 33, 800.0);
     std::cout << "\n\nTest PASSED! " << std::endl;
-#endif
-
-#ifdef USE_CUDA
-    std::cout << "\n\n****** Case " << 2 + 2 * radius << ": CUDA warped back projection ******" << std::endl;
-    if (radius)
-      std::cout << "\n\n****** Cylindrical detector ******" << std::endl;
-    TRY_AND_EXIT_ON_ITK_EXCEPTION(warpbackproject->Update());
-    CheckImageQuality<VolumeSeriesType>(warpbackproject->GetOutput(), join->GetOutput(), 15, 33, 800.0);
-    std::cout << "\n\nTest PASSED! " << std::endl;
-#endif
 
     itksys::SystemTools::RemoveFile(signalFileName.c_str());
   }
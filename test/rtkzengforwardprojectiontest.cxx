@@ -3,8 +3,11 @@
 #include "rtkRayBoxIntersectionImageFilter.h"
 #include "rtkConstantImageSource.h"
 #include "rtkZengForwardProjectionImageFilter.h"
+#include "rtkZengBackProjectionImageFilter.h"
 #include <itkImageRegionSplitterDirection.h>
 #include <itkImageRegionIterator.h>
+#include <itkImageRegionConstIterator.h>
+#include <algorithm>
 #include <cmath>
 
 
@@ -15,7 +18,9 @@
  *
  * The test projects a volume filled with ones. The forward projector should
  * then return the intersection of the ray with the box and it is compared
- * with the analytical intersection of a box with a ray.
+ * with the analytical intersection of a box with a ray. The attenuated
+ * forward and back projections with a cache of the attenuation factors are
+ * then compared with the same projections without cache.
  *
  * \author Antoine Robert
  */
@@ -125,6 +130,101 @@ main(int, char **)
   CheckImageQuality<OutputImageType>(jfp->GetOutput(), rbi->GetOutput(), 1.28, 44.0, 255.0);
   std::cout << "\n\nTest PASSED! " << std::endl;
 
+  std::cout << "\n\n****** Case 2: cached attenuation factors ******" << std::endl;
+
+  // Largest absolute difference between two images
+  auto maximumDifference = [](const OutputImageType * a, const OutputImageType * b) {
+    itk::ImageRegionConstIterator<OutputImageType> itA(a, a->GetBufferedRegion());
+    itk::ImageRegionConstIterator<OutputImageType> itB(b, b->GetBufferedRegion());
+    double                                         difference = 0.;
+    for (; !itA.IsAtEnd(); ++itA, ++itB)
+      difference = std::max(difference, std::abs(static_cast<double>(itA.Get()) - itB.Get()));
+    return difference;
+  };
+  auto checkCache = [](rtk::ZengAttenuationCache * cache, unsigned int numberOfEntries) {
+    if (cache->GetNumberOfEntries() != numberOfEntries || cache->GetMemoryUsage() > cache->GetMemoryBudget())
+    {
+      std::cerr << "Test Failed, " << cache->GetNumberOfEntries() << " cached angles instead of " << numberOfEntries
+                << " and " << cache->GetMemoryUsage() << " bytes for a budget of " << cache->GetMemoryBudget()
+                << std::endl;
+      exit(EXIT_FAILURE);
+    }
+  };
+
+  // Attenuation map in the grid of the volume
+  const ConstantImageSourceType::Pointer attenuationSource = ConstantImageSourceType::New();
+  attenuationSource->SetInformationFromImage(volInput->GetOutput());
+  attenuationSource->SetConstant(0.01);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(attenuationSource->Update());
+  OutputImageType::Pointer attenuationMap = attenuationSource->GetOutput();
+  attenuationMap->DisconnectPipeline();
+
+  // Reference forward and back projections without cache
+  jfp->SetInput(2, attenuationMap);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(jfp->Update());
+  OutputImageType::Pointer forwardReference = jfp->GetOutput();
+  forwardReference->DisconnectPipeline();
+
+  using ZBPType = rtk::ZengBackProjectionImageFilter<OutputImageType, OutputImageType>;
+  ZBPType::Pointer zbp = ZBPType::New();
+  zbp->InPlaceOff();
+  zbp->SetInput(volInput->GetOutput());
+  zbp->SetInput(1, forwardReference);
+  zbp->SetInput(2, attenuationMap);
+  zbp->SetGeometry(geometry);
+  zbp->SetAlpha(0.);
+  zbp->SetSigmaZero(0.);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(zbp->Update());
+  OutputImageType::Pointer backReference = zbp->GetOutput();
+  backReference->DisconnectPipeline();
+
+  // The first forward projection fills the cache, the second one and the back
+  // projection, which has the same rotated grids, read it
+  rtk::ZengAttenuationCache::Pointer cache = rtk::ZengAttenuationCache::New();
+  jfp->SetAttenuationCache(cache);
+  zbp->SetAttenuationCache(cache);
+  for (unsigned int i = 0; i < 2; i++)
+  {
+    jfp->Modified();
+    TRY_AND_EXIT_ON_ITK_EXCEPTION(jfp->Update());
+    checkCache(cache, NumberOfProjectionImages);
+    if (maximumDifference(jfp->GetOutput(), forwardReference) > 1e-3)
+    {
+      std::cerr << "Test Failed, cached forward projection differs from the reference by "
+                << maximumDifference(jfp->GetOutput(), forwardReference) << std::endl;
+      exit(EXIT_FAILURE);
+    }
+  }
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(zbp->Update());
+  checkCache(cache, NumberOfProjectionImages);
+  if (maximumDifference(zbp->GetOutput(), backReference) > 1e-3)
+  {
+    std::cerr << "Test Failed, cached back projection differs from the reference by "
+              << maximumDifference(zbp->GetOutput(), backReference) << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  // With a budget of two angles, the least recently used angles are evicted
+  // and recomputed. With a budget below one angle, nothing is cached.
+  const itk::SizeValueType angleMemory = cache->GetMemoryUsage() / NumberOfProjectionImages;
+  cache->SetMemoryBudget(2 * angleMemory);
+  checkCache(cache, 2);
+  jfp->Modified();
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(jfp->Update());
+  checkCache(cache, 2);
+  cache->SetMemoryBudget(angleMemory - 1);
+  checkCache(cache, 0);
+  jfp->Modified();
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(jfp->Update());
+  checkCache(cache, 0);
+  if (maximumDifference(jfp->GetOutput(), forwardReference) > 1e-3)
+  {
+    std::cerr << "Test Failed, forward projection with a small cache differs from the reference by "
+              << maximumDifference(jfp->GetOutput(), forwardReference) << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  std::cout << "\n\nTest PASSED! " << std::endl;
+
 
   return EXIT_SUCCESS;
 }